@@ -42,7 +42,7 @@ public class FileListItem implements Comparable<FileListItem>
 
 				// The extensions we care about.
 				Set<String> allowedExtensions = new HashSet<String>(Arrays.asList(
-						".ciso", ".dff", ".dol", ".elf", ".gcm", ".gcz", ".iso", ".tgc", ".wad", ".wbfs"));
+						".ciso", ".dcz", ".dff", ".dol", ".elf", ".gcm", ".gcz", ".iso", ".tgc", ".wad", ".wbfs"));
 
 				// Check that the file has an extension we care about before trying to read out of it.
 				if (allowedExtensions.contains(fileExtension.toLowerCase()))
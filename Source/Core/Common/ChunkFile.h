@@ -70,8 +70,12 @@ public:
 
 public:
   PointerWrap(u8** ptr_, Mode mode_) : ptr(ptr_), mode(mode_) {}
+  // Writing more than size bytes switches to MODE_MEASURE, so that the required size is known
+  // when the buffer turns out to be too small.
+  PointerWrap(u8** ptr_, size_t size, Mode mode_) : ptr(ptr_), mode(mode_), m_end(*ptr_ + size) {}
   void SetMode(Mode mode_) { mode = mode_; }
   Mode GetMode() const { return mode; }
+  bool HasOverflowed() const { return m_overflowed; }
   template <typename K, class V>
   void Do(std::map<K, V>& x)
   {
@@ -266,6 +270,9 @@ public:
   }
 
 private:
+  u8* m_end = nullptr;
+  bool m_overflowed = false;
+
   template <typename T>
   void DoContainer(T& x)
   {
@@ -281,6 +288,12 @@ private:
       break;
 
     case MODE_WRITE:
+      if (m_end && size > static_cast<size_t>(m_end - *ptr))
+      {
+        mode = MODE_MEASURE;
+        m_overflowed = true;
+        break;
+      }
       memcpy(*ptr, data, size);
       break;
 
@@ -2,9 +2,21 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
 #include <mbedtls/aes.h>
+#include <memory>
 
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/AES.h"
+#include "Common/Intrinsics.h"
+
+#if defined(_M_ARM_64) && defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define HAVE_ARM_AES_INTRINSICS
+#endif
 
 namespace Common
 {
@@ -35,5 +47,260 @@ std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size)
 {
   return DecryptEncrypt(key, iv, src, size, Mode::Encrypt);
 }
+
+namespace
+{
+constexpr size_t BLOCK_SIZE = 16;
+constexpr size_t NUM_ROUNDS = 10;
+using RoundKeys = std::array<std::array<u8, BLOCK_SIZE>, NUM_ROUNDS + 1>;
+
+class ContextGeneric final : public Context
+{
+public:
+  ContextGeneric(const u8* key, Mode mode) : m_mode(mode)
+  {
+    mbedtls_aes_init(&m_ctx);
+    if (mode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_ctx, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_ctx, key, 128);
+  }
+
+  ~ContextGeneric() { mbedtls_aes_free(&m_ctx); }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    std::array<u8, BLOCK_SIZE> iv_tmp;
+    std::memcpy(iv_tmp.data(), iv, BLOCK_SIZE);
+    // mbed TLS only modifies the IV, not the key schedule
+    mbedtls_aes_crypt_cbc(const_cast<mbedtls_aes_context*>(&m_ctx),
+                          m_mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
+                          size, iv_tmp.data(), in, out);
+    if (iv_out)
+      std::memcpy(iv_out, iv_tmp.data(), BLOCK_SIZE);
+  }
+
+private:
+  mbedtls_aes_context m_ctx;
+  Mode m_mode;
+};
+
+#if defined(_M_X86) || defined(HAVE_ARM_AES_INTRINSICS)
+// Software AES-128 key expansion. The hardware paths only need this once per key.
+RoundKeys ExpandKey(const u8* key)
+{
+  static constexpr u8 sbox[256] = {
+      0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab,
+      0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4,
+      0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71,
+      0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2,
+      0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6,
+      0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb,
+      0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf, 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45,
+      0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+      0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44,
+      0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a,
+      0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49,
+      0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d,
+      0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08, 0xba, 0x78, 0x25,
+      0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e,
+      0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1,
+      0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+      0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb,
+      0x16};
+  static constexpr u8 rcon[NUM_ROUNDS] = {0x01, 0x02, 0x04, 0x08, 0x10,
+                                          0x20, 0x40, 0x80, 0x1b, 0x36};
+
+  RoundKeys round_keys;
+  std::memcpy(round_keys[0].data(), key, BLOCK_SIZE);
+  for (size_t round = 1; round <= NUM_ROUNDS; ++round)
+  {
+    const std::array<u8, BLOCK_SIZE>& prev = round_keys[round - 1];
+    std::array<u8, BLOCK_SIZE>& next = round_keys[round];
+
+    // RotWord, SubWord and Rcon on the last word of the previous round key
+    next[0] = prev[0] ^ sbox[prev[13]] ^ rcon[round - 1];
+    next[1] = prev[1] ^ sbox[prev[14]];
+    next[2] = prev[2] ^ sbox[prev[15]];
+    next[3] = prev[3] ^ sbox[prev[12]];
+    for (size_t i = 4; i < BLOCK_SIZE; ++i)
+      next[i] = prev[i] ^ next[i - 4];
+  }
+  return round_keys;
+}
+#endif
+
+#if defined(_M_X86)
+class ContextAESNI final : public Context
+{
+public:
+  ContextAESNI(const u8* key, Mode mode) : m_mode(mode) { Init(ExpandKey(key)); }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    if (m_mode == Mode::Encrypt)
+      Encrypt(iv, iv_out, in, out, size);
+    else
+      Decrypt(iv, iv_out, in, out, size);
+  }
+
+private:
+  FUNCTION_TARGET_AES void Init(const RoundKeys& round_keys)
+  {
+    for (size_t i = 0; i <= NUM_ROUNDS; ++i)
+      m_keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys[i].data()));
+
+    if (m_mode == Mode::Decrypt)
+    {
+      // Equivalent inverse cipher: reverse the schedule and apply InvMixColumns to the inner keys
+      std::reverse(std::begin(m_keys), std::end(m_keys));
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        m_keys[i] = _mm_aesimc_si128(m_keys[i]);
+    }
+  }
+
+  FUNCTION_TARGET_AES void Encrypt(const u8* iv, u8* iv_out, const u8* in, u8* out,
+                                   size_t size) const
+  {
+    // CBC encryption is inherently serial
+    __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+    {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+      state = _mm_xor_si128(_mm_xor_si128(block, state), m_keys[0]);
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        state = _mm_aesenc_si128(state, m_keys[i]);
+      state = _mm_aesenclast_si128(state, m_keys[NUM_ROUNDS]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), state);
+    }
+    if (iv_out)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), state);
+  }
+
+  FUNCTION_TARGET_AES void Decrypt(const u8* iv, u8* iv_out, const u8* in, u8* out,
+                                   size_t size) const
+  {
+    // CBC decryption has no dependency between blocks, so several blocks are kept in flight
+    // to hide the latency of the AES instructions.
+    constexpr size_t LANES = 8;
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t offset = 0;
+
+    for (; offset + LANES * BLOCK_SIZE <= size; offset += LANES * BLOCK_SIZE)
+    {
+      __m128i cipher[LANES];
+      __m128i state[LANES];
+      for (size_t lane = 0; lane < LANES; ++lane)
+      {
+        cipher[lane] =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset + lane * BLOCK_SIZE));
+        state[lane] = _mm_xor_si128(cipher[lane], m_keys[0]);
+      }
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+      {
+        for (size_t lane = 0; lane < LANES; ++lane)
+          state[lane] = _mm_aesdec_si128(state[lane], m_keys[i]);
+      }
+      for (size_t lane = 0; lane < LANES; ++lane)
+      {
+        state[lane] = _mm_aesdeclast_si128(state[lane], m_keys[NUM_ROUNDS]);
+        state[lane] = _mm_xor_si128(state[lane], lane == 0 ? prev : cipher[lane - 1]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset + lane * BLOCK_SIZE),
+                         state[lane]);
+      }
+      prev = cipher[LANES - 1];
+    }
+
+    for (; offset < size; offset += BLOCK_SIZE)
+    {
+      const __m128i cipher = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+      __m128i state = _mm_xor_si128(cipher, m_keys[0]);
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        state = _mm_aesdec_si128(state, m_keys[i]);
+      state = _mm_aesdeclast_si128(state, m_keys[NUM_ROUNDS]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_xor_si128(state, prev));
+      prev = cipher;
+    }
+
+    if (iv_out)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), prev);
+  }
+
+  __m128i m_keys[NUM_ROUNDS + 1];
+  Mode m_mode;
+};
+#endif
+
+#if defined(HAVE_ARM_AES_INTRINSICS)
+class ContextNeon final : public Context
+{
+public:
+  ContextNeon(const u8* key, Mode mode) : m_mode(mode)
+  {
+    const RoundKeys round_keys = ExpandKey(key);
+    for (size_t i = 0; i <= NUM_ROUNDS; ++i)
+      m_keys[i] = vld1q_u8(round_keys[i].data());
+
+    if (m_mode == Mode::Decrypt)
+    {
+      std::reverse(m_keys.begin(), m_keys.end());
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        m_keys[i] = vaesimcq_u8(m_keys[i]);
+    }
+  }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    uint8x16_t prev = vld1q_u8(iv);
+
+    if (m_mode == Mode::Encrypt)
+    {
+      for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+      {
+        uint8x16_t state = veorq_u8(vld1q_u8(in + offset), prev);
+        for (size_t i = 0; i < NUM_ROUNDS - 1; ++i)
+          state = vaesmcq_u8(vaeseq_u8(state, m_keys[i]));
+        state = veorq_u8(vaeseq_u8(state, m_keys[NUM_ROUNDS - 1]), m_keys[NUM_ROUNDS]);
+        vst1q_u8(out + offset, state);
+        prev = state;
+      }
+    }
+    else
+    {
+      for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+      {
+        const uint8x16_t cipher = vld1q_u8(in + offset);
+        uint8x16_t state = cipher;
+        for (size_t i = 0; i < NUM_ROUNDS - 1; ++i)
+          state = vaesimcq_u8(vaesdq_u8(state, m_keys[i]));
+        state = veorq_u8(vaesdq_u8(state, m_keys[NUM_ROUNDS - 1]), m_keys[NUM_ROUNDS]);
+        vst1q_u8(out + offset, veorq_u8(state, prev));
+        prev = cipher;
+      }
+    }
+
+    if (iv_out)
+      vst1q_u8(iv_out, prev);
+  }
+
+private:
+  std::array<uint8x16_t, NUM_ROUNDS + 1> m_keys;
+  Mode m_mode;
+};
+#endif
+}  // Anonymous namespace
+
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode)
+{
+#if defined(_M_X86)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextAESNI>(key, mode);
+#elif defined(HAVE_ARM_AES_INTRINSICS)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextNeon>(key, mode);
+#endif
+  return std::make_unique<ContextGeneric>(key, mode);
+}
+
 }  // namespace AES
 }  // namespace Common
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -23,5 +24,26 @@ std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size
 // Convenience functions
 std::vector<u8> Decrypt(const u8* key, u8* iv, const u8* src, size_t size);
 std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size);
+
+// An AES-128-CBC key schedule that can be reused for many operations.
+// Uses AES-NI or the ARMv8 crypto extensions when available, and mbed TLS otherwise.
+// Contexts are immutable after creation, so one context can be used by several threads at once.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // Processes size bytes, which must be a multiple of 16. The IV is not modified;
+  // if iv_out is not null, the IV to continue the chain with is written to it.
+  // in and out may point to the same buffer.
+  virtual void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const = 0;
+
+  void Crypt(const u8* iv, const u8* in, u8* out, size_t size) const
+  {
+    Crypt(iv, nullptr, in, out, size);
+  }
+};
+
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode);
 }  // namespace AES
 }  // namespace Common
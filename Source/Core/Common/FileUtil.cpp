@@ -102,6 +102,11 @@ u64 FileInfo::GetSize() const
   return IsFile() ? m_stat.st_size : 0;
 }
 
+s64 FileInfo::GetModificationTime() const
+{
+  return m_exists ? static_cast<s64>(m_stat.st_mtime) : 0;
+}
+
 // Returns true if the path exists
 bool Exists(const std::string& path)
 {
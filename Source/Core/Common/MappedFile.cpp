@@ -0,0 +1,131 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
+
+namespace File
+{
+static u64 GetMappingGranularity()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+#else
+  return static_cast<u64>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+  Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  Swap(other);
+  return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept
+{
+  std::swap(m_view, other.m_view);
+  std::swap(m_view_size, other.m_view_size);
+  std::swap(m_data, other.m_data);
+  std::swap(m_size, other.m_size);
+}
+
+bool MappedFile::Map(IOFile& file, u64 offset, u64 size)
+{
+  Unmap();
+
+  if (!file.IsOpen() || size == 0)
+    return false;
+
+  const u64 granularity = GetMappingGranularity();
+  const u64 aligned_offset = offset - offset % granularity;
+  const u64 view_size = size + (offset - aligned_offset);
+  if (view_size > std::numeric_limits<size_t>::max())
+    return false;
+
+#ifdef _WIN32
+  const HANDLE file_handle =
+      reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.GetHandle())));
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  const HANDLE mapping = CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+  {
+    ERROR_LOG(COMMON, "CreateFileMapping failed: %lu", GetLastError());
+    return false;
+  }
+
+  // The view keeps its own reference to the mapping object.
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(aligned_offset >> 32),
+                             static_cast<DWORD>(aligned_offset), static_cast<SIZE_T>(view_size));
+  CloseHandle(mapping);
+  if (!view)
+  {
+    ERROR_LOG(COMMON, "MapViewOfFile failed: %lu", GetLastError());
+    return false;
+  }
+#else
+  void* view = mmap(nullptr, static_cast<size_t>(view_size), PROT_READ, MAP_SHARED,
+                    fileno(file.GetHandle()), static_cast<off_t>(aligned_offset));
+  if (view == MAP_FAILED)
+  {
+    ERROR_LOG(COMMON, "mmap failed: %s", LastStrerrorString().c_str());
+    return false;
+  }
+#endif
+
+  m_view = view;
+  m_view_size = static_cast<size_t>(view_size);
+  m_data = static_cast<const u8*>(view) + (offset - aligned_offset);
+  m_size = size;
+  return true;
+}
+
+void MappedFile::Unmap()
+{
+  if (!m_view)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_view);
+#else
+  munmap(m_view, m_view_size);
+#endif
+
+  m_view = nullptr;
+  m_view_size = 0;
+  m_data = nullptr;
+  m_size = 0;
+}
+
+}  // namespace File
@@ -0,0 +1,47 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+namespace File
+{
+class IOFile;
+
+// A read-only memory mapping of a region of an already opened file.
+// The mapping stays valid after the IOFile is closed, but must not outlive modifications
+// to the underlying file (truncating a mapped file is undefined behaviour on most systems).
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  void Swap(MappedFile& other) noexcept;
+
+  // The offset does not need to be aligned to the page size.
+  bool Map(IOFile& file, u64 offset, u64 size);
+  void Unmap();
+
+  bool IsMapped() const { return m_data != nullptr; }
+  const u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+private:
+  void* m_view = nullptr;
+  size_t m_view_size = 0;
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+};
+
+}  // namespace File
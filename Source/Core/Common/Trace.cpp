@@ -0,0 +1,293 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Trace.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/File.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+namespace Common
+{
+namespace Trace
+{
+std::atomic<bool> g_recording{false};
+
+namespace
+{
+enum class EventType : u8
+{
+  Begin,
+  End,
+  Counter
+};
+
+struct Event
+{
+  u64 time_ns;
+  const char* name;
+  s64 value;
+  EventType type;
+};
+
+// Events are stored in fixed size chunks, so a thread never moves events while they're written out
+constexpr size_t EVENTS_PER_CHUNK = 4096;
+// About 64 MiB of events per thread
+constexpr size_t MAX_CHUNKS_PER_THREAD = 512;
+
+struct Chunk
+{
+  std::array<Event, EVENTS_PER_CHUNK> events;
+  // Events below the count are complete
+  std::atomic<size_t> count{0};
+  std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer
+{
+  u32 id = 0;
+  // Guarded by s_threads_lock
+  std::string name;
+
+  // Everything below is only changed by the thread the buffer belongs to. Chunks of the previous
+  // recording are freed by that thread too, when it records its first event of the next one.
+  std::atomic<u32> session{0};
+  std::atomic<Chunk*> first{nullptr};
+  Chunk* last = nullptr;
+  size_t num_chunks = 0;
+  std::atomic<u64> dropped_events{0};
+};
+
+std::mutex s_threads_lock;
+// Buffers are never freed, so the events of threads which have exited are still written out
+std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+std::atomic<u32> s_session{0};
+u64 s_start_ns = 0;
+std::string s_session_file;
+
+u64 GetTimeNs()
+{
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count());
+}
+
+ThreadBuffer* GetThreadBuffer()
+{
+  if (!t_buffer)
+  {
+    std::lock_guard<std::mutex> lk(s_threads_lock);
+    s_threads.push_back(std::make_unique<ThreadBuffer>());
+    t_buffer = s_threads.back().get();
+    t_buffer->id = static_cast<u32>(s_threads.size());
+  }
+  return t_buffer;
+}
+
+void FreeChunks(Chunk* chunk)
+{
+  while (chunk)
+  {
+    Chunk* next = chunk->next.load();
+    delete chunk;
+    chunk = next;
+  }
+}
+
+void Record(EventType type, const char* name, s64 value)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+
+  const u32 session = s_session.load(std::memory_order_acquire);
+  if (buffer->session.load(std::memory_order_relaxed) != session)
+  {
+    FreeChunks(buffer->first.exchange(nullptr));
+    buffer->last = nullptr;
+    buffer->num_chunks = 0;
+    buffer->dropped_events = 0;
+    buffer->session.store(session, std::memory_order_release);
+  }
+
+  Chunk* chunk = buffer->last;
+  size_t count = chunk ? chunk->count.load(std::memory_order_relaxed) : EVENTS_PER_CHUNK;
+  if (count == EVENTS_PER_CHUNK)
+  {
+    if (buffer->num_chunks == MAX_CHUNKS_PER_THREAD)
+    {
+      ++buffer->dropped_events;
+      return;
+    }
+
+    Chunk* new_chunk = new Chunk;
+    if (chunk)
+      chunk->next.store(new_chunk, std::memory_order_release);
+    else
+      buffer->first.store(new_chunk, std::memory_order_release);
+    buffer->last = new_chunk;
+    ++buffer->num_chunks;
+    chunk = new_chunk;
+    count = 0;
+  }
+
+  chunk->events[count] = {GetTimeNs(), name, value, type};
+  chunk->count.store(count + 1, std::memory_order_release);
+}
+
+std::string EscapeJSON(const std::string& text)
+{
+  std::string result;
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    if (static_cast<unsigned char>(c) < 0x20)
+      result += StringFromFormat("\\u%04x", c);
+    else
+      result += c;
+  }
+  return result;
+}
+}  // Anonymous namespace
+
+void Start()
+{
+  s_start_ns = GetTimeNs();
+  // Makes every thread drop the events it has recorded before
+  s_session.fetch_add(1, std::memory_order_release);
+  g_recording = true;
+}
+
+bool Stop(const std::string& path)
+{
+  g_recording = false;
+
+  File::IOFile file(path, "wb");
+  if (!file)
+  {
+    ERROR_LOG(COMMON, "Could not open %s to write the trace", path.c_str());
+    return false;
+  }
+
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                    "\"args\":{\"name\":\"Dolphin\"}}";
+  size_t num_events = 0;
+  u64 dropped_events = 0;
+
+  const u32 session = s_session.load();
+  std::lock_guard<std::mutex> lk(s_threads_lock);
+  for (const auto& buffer : s_threads)
+  {
+    if (buffer->session.load(std::memory_order_acquire) != session)
+      continue;
+
+    const u32 tid = buffer->id;
+    if (!buffer->name.empty())
+    {
+      out += StringFromFormat(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                              "\"args\":{\"name\":\"%s\"}}",
+                              tid, EscapeJSON(buffer->name).c_str());
+    }
+
+    // Threads can still be appending events, which are written if they're already complete
+    for (Chunk* chunk = buffer->first.load(std::memory_order_acquire); chunk;
+         chunk = chunk->next.load(std::memory_order_acquire))
+    {
+      const size_t count = chunk->count.load(std::memory_order_acquire);
+      for (size_t i = 0; i < count; ++i)
+      {
+        const Event& event = chunk->events[i];
+        // Timestamps are in microseconds
+        const double ts = event.time_ns > s_start_ns ? (event.time_ns - s_start_ns) / 1000.0 : 0.0;
+        switch (event.type)
+        {
+        case EventType::Begin:
+          out += StringFromFormat(",\n{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,"
+                                  "\"ts\":%.3f}",
+                                  EscapeJSON(event.name).c_str(), tid, ts);
+          break;
+        case EventType::End:
+          out += StringFromFormat(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tid, ts);
+          break;
+        case EventType::Counter:
+          out += StringFromFormat(",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,"
+                                  "\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                                  EscapeJSON(event.name).c_str(), tid, ts,
+                                  static_cast<long long>(event.value));
+          break;
+        }
+        ++num_events;
+
+        if (out.size() >= 1024 * 1024)
+        {
+          file.WriteBytes(out.data(), out.size());
+          out.clear();
+        }
+      }
+    }
+    dropped_events += buffer->dropped_events;
+  }
+
+  out += "\n]}\n";
+  if (!file.WriteBytes(out.data(), out.size()))
+  {
+    ERROR_LOG(COMMON, "Could not write the trace to %s", path.c_str());
+    return false;
+  }
+
+  NOTICE_LOG(COMMON, "Wrote %zu trace events to %s", num_events, path.c_str());
+  if (dropped_events)
+    WARN_LOG(COMMON, "%llu trace events were dropped because a thread's buffer was full",
+             static_cast<unsigned long long>(dropped_events));
+  return true;
+}
+
+void SetThreadName(const char* name)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lk(s_threads_lock);
+  buffer->name = name;
+}
+
+void BeginZone(const char* name)
+{
+  Record(EventType::Begin, name, 0);
+}
+
+void EndZone()
+{
+  Record(EventType::End, nullptr, 0);
+}
+
+void SetCounter(const char* name, s64 value)
+{
+  Record(EventType::Counter, name, value);
+}
+
+void SetSessionFile(const std::string& path)
+{
+  s_session_file = path;
+}
+
+void StartSession()
+{
+  if (!s_session_file.empty())
+    Start();
+}
+
+void StopSession()
+{
+  if (!s_session_file.empty() && IsRecording())
+    Stop(s_session_file);
+}
+}  // namespace Trace
+}  // namespace Common
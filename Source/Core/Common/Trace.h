@@ -0,0 +1,74 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// A timeline recorder for finding stalls between threads. Every thread appends zones and counters
+// to its own buffer without taking locks, and the recording is written in the Chrome trace event
+// format, which chrome://tracing, Perfetto and other timeline viewers open.
+//
+// Recording is off by default, and a disabled zone only costs a relaxed atomic load. Names must
+// be string literals, or otherwise outlive the recording.
+
+namespace Common
+{
+namespace Trace
+{
+extern std::atomic<bool> g_recording;
+
+inline bool IsRecording()
+{
+  return g_recording.load(std::memory_order_relaxed);
+}
+
+// Discards any previous recording
+void Start();
+// Stops recording, and writes the recording to the file. Returns false if it couldn't be written.
+bool Stop(const std::string& path);
+
+// Called by Common::SetCurrentThreadName
+void SetThreadName(const char* name);
+
+void BeginZone(const char* name);
+void EndZone();
+void SetCounter(const char* name, s64 value);
+
+// The emulation is recorded from boot to shutdown when a file is set, e.g. with --trace
+void SetSessionFile(const std::string& path);
+void StartSession();
+void StopSession();
+
+class ScopedZone final
+{
+public:
+  explicit ScopedZone(const char* name) : m_active(IsRecording())
+  {
+    if (m_active)
+      BeginZone(name);
+  }
+  ~ScopedZone()
+  {
+    if (m_active)
+      EndZone();
+  }
+
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+  bool m_active;
+};
+
+inline void Counter(const char* name, s64 value)
+{
+  if (IsRecording())
+    SetCounter(name, value);
+}
+}  // namespace Trace
+}  // namespace Common
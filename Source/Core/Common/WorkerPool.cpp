@@ -0,0 +1,115 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+WorkerPool::WorkerPool(const std::string& name, u32 num_threads) : m_name(name)
+{
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (u32 i = 0; i < num_threads; ++i)
+    m_threads.emplace_back([this] { ThreadLoop(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_shutdown = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+void WorkerPool::Schedule(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_tasks.push_back(std::move(task));
+  }
+  m_wakeup.notify_one();
+}
+
+void WorkerPool::WaitForIdle()
+{
+  std::unique_lock<std::mutex> lk(m_lock);
+  m_idle.wait(lk, [this] { return m_tasks.empty() && m_busy_threads == 0; });
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& function)
+{
+  if (count == 0)
+    return;
+
+  struct SharedState
+  {
+    std::atomic<size_t> next_index{0};
+    size_t remaining_helpers;
+    std::mutex lock;
+    std::condition_variable done;
+  };
+
+  // The state lives on this stack frame, which is only left once every helper has finished
+  SharedState state;
+  const size_t num_helpers = std::min<size_t>(m_threads.size(), count - 1);
+  state.remaining_helpers = num_helpers;
+
+  auto run = [&state, &function, count] {
+    for (size_t i = state.next_index++; i < count; i = state.next_index++)
+      function(i);
+  };
+
+  for (size_t i = 0; i < num_helpers; ++i)
+  {
+    Schedule([&state, &run] {
+      run();
+      std::lock_guard<std::mutex> lk(state.lock);
+      if (--state.remaining_helpers == 0)
+        state.done.notify_one();
+    });
+  }
+
+  run();
+
+  std::unique_lock<std::mutex> lk(state.lock);
+  state.done.wait(lk, [&state] { return state.remaining_helpers == 0; });
+}
+
+void WorkerPool::ThreadLoop()
+{
+  Common::SetCurrentThreadName(m_name.c_str());
+
+  std::unique_lock<std::mutex> lk(m_lock);
+  while (true)
+  {
+    m_wakeup.wait(lk, [this] { return m_shutdown || !m_tasks.empty(); });
+    if (m_tasks.empty())
+      break;
+
+    std::function<void()> task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    ++m_busy_threads;
+
+    lk.unlock();
+    task();
+    lk.lock();
+
+    --m_busy_threads;
+    if (m_tasks.empty() && m_busy_threads == 0)
+      m_idle.notify_all();
+  }
+}
+
+}  // namespace Common
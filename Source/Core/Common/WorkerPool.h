@@ -0,0 +1,57 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// A fixed set of worker threads that run queued tasks in no particular order.
+
+namespace Common
+{
+class WorkerPool
+{
+public:
+  // A thread count of 0 uses one thread per hardware thread.
+  explicit WorkerPool(const std::string& name, u32 num_threads = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  u32 GetThreadCount() const { return static_cast<u32>(m_threads.size()); }
+
+  void Schedule(std::function<void()> task);
+
+  // Blocks until the queue is empty and no task is running.
+  void WaitForIdle();
+
+  // Calls function(i) for every i in [0, count), spread over the workers and the calling thread.
+  // Returns once all calls have finished. Must not be called from within a task of this pool.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& function);
+
+private:
+  void ThreadLoop();
+
+  std::string m_name;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_lock;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_idle;
+  std::deque<std::function<void()>> m_tasks;
+  size_t m_busy_threads = 0;
+  bool m_shutdown = false;
+};
+
+}  // namespace Common
@@ -18,11 +18,23 @@
 #include <direct.h>
 #else
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
@@ -31,6 +43,7 @@
 #include "Core/ARBruteForcer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/HW/CPU.h"
 #include "Core/State.h"
 #include "VideoCommon/Statistics.h"
 
@@ -52,6 +65,9 @@ bool ch_bruteforce;
 bool ch_dont_save_settings;
 
 bool ch_screenshot_all = false;
+bool ch_exit_when_done = false;
+int ch_worker_index = 0;
+int ch_worker_count = 1;
 
 int original_prim_count;
 
@@ -60,12 +76,146 @@ std::vector<std::string> ch_map;
 std::string ch_title_id;
 std::string ch_code;
 
+// The state every code is tried from. It is only read from disk once per search.
+static std::vector<u8> s_base_state;
+static std::atomic<bool> s_code_faulted{false};
+
+// Replaces the windows messages that used to drive the search, so that it works on every platform
+static std::thread s_ticker;
+static Common::Event s_ticker_stop;
+static std::atomic<bool> s_ticker_running{false};
+constexpr auto TICK_INTERVAL = std::chrono::milliseconds(100);
+
+static std::string GetPositionPath(int worker)
+{
+  if (ch_worker_count > 1)
+    return File::GetUserPath(D_SCREENSHOTS_IDX) + StringFromFormat("position_%d.txt", worker);
+  return File::GetUserPath(D_SCREENSHOTS_IDX) + "position.txt";
+}
+
+static std::string GetCSVPath(int worker)
+{
+  const std::string dir = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/";
+  if (ch_worker_count > 1)
+    return dir + StringFromFormat("bruteforce_%d.csv", worker);
+  return dir + "bruteforce.csv";
+}
+
+static int LoadPosition(int worker)
+{
+  std::string line;
+  std::ifstream myfile(GetPositionPath(worker));
+  std::string aux;
+
+  if (myfile.is_open())
+  {
+    while (getline(myfile, line))
+    {
+      aux = line;
+    }
+    myfile.close();
+  }
+
+  std::istringstream iss(aux.c_str());
+  iss.imbue(std::locale("C"));
+  int tmp = -1;
+  if (iss >> tmp)
+    return tmp;
+  else
+    return -1;
+}
+
+static void SavePosition(int worker, int position)
+{
+  std::ofstream myfile(GetPositionPath(worker));
+  if (myfile.is_open())
+    myfile << position << "\n";
+}
+
+// Position -1 takes the original screenshot, without a code
+static int NextPosition(int worker, int position)
+{
+  return position < 0 ? worker : position + ch_worker_count;
+}
+
+static void FinishSearch()
+{
+  ch_first_search = false;
+  ch_bruteforce = false;
+  ch_begun = false;
+  s_base_state.clear();
+  s_base_state.shrink_to_fit();
+  // The last code can fault too. Nothing is rolled back, but the CPU must not stay stopped.
+  if (s_code_faulted.exchange(false))
+    CPU::EnableStepping(false);
+
+  // With several workers, the process that started them merges the results
+  if (ch_worker_count == 1)
+    PostProcessCSVFile();
+
+  if (ch_exit_when_done || ch_worker_count > 1)
+  {
+    NOTICE_LOG(VR, "Finished bruteforcing, stopping");
+    Core::Stop();
+  }
+  else
+  {
+    SuccessAlert(
+        "Finished brute forcing! To start again, delete position.txt in the screenshots folder.");
+  }
+}
+
+static void TickerThread()
+{
+  while (!s_ticker_stop.WaitFor(TICK_INTERVAL))
+  {
+    if (ch_bruteforce)
+      Core::QueueHostJob(ARBruteForceDriver);
+  }
+}
+
+void BeginSearch()
+{
+  ch_begin_search = true;
+  if (!s_ticker_running.exchange(true))
+  {
+    s_ticker_stop.Reset();
+    s_ticker = std::thread(TickerThread);
+  }
+}
+
+void OnCodeFaulted()
+{
+  if (!s_code_faulted.exchange(true))
+  {
+    WARN_LOG(VR, "Code %d faulted, rolling back", ch_current_position);
+    // Doesn't wait for the CPU, since this can be called on the CPU and GPU threads
+    CPU::Break();
+    Core::QueueHostJob(ARBruteForceDriver);
+  }
+}
+
+void Shutdown()
+{
+  if (s_ticker_running.exchange(false))
+  {
+    s_ticker_stop.Set();
+    s_ticker.join();
+  }
+  s_base_state.clear();
+  s_base_state.shrink_to_fit();
+}
+
 void ARBruteForceDriver()
 {
   ch_cycles_without_snapshot++;
   // if begining searching, start from the most recently saved position
   if (ch_begin_search)
   {
+    // The timer calls us again until the game is running
+    if (!Core::IsRunning())
+      return;
+
     NOTICE_LOG(VR, "begin search");
     ch_begin_search = false;
     ch_next_code = false;
@@ -74,15 +224,8 @@ void ARBruteForceDriver()
     ERROR_LOG(VR, "ch_current_position = %d, ch_map.size = %d", ch_current_position, (int)ch_map.size());
     if (ch_current_position >= (int)ch_map.size() && ch_bruteforce)
     {
-      ch_first_search = false;
-      ch_bruteforce = false;
-      ch_begun = false;
-
       NOTICE_LOG(VR, "Finished bruteforcing when starting");
-      PostProcessCSVFile();
-
-      SuccessAlert(
-          "Finished brute forcing! To start again, delete position.txt in the screenshots folder.");
+      FinishSearch();
     }
     else
     {
@@ -91,38 +234,45 @@ void ARBruteForceDriver()
       ch_first_search = true;
       ch_begun = true;
       State::Load(1);
-      // not sure why this is needed
-      State::Load(1);
+      if (!State::SaveToBuffer(s_base_state))
+      {
+        // Without a base state there is nothing to roll back to
+        ERROR_LOG(VR, "Couldn't save the base state, stopping");
+        FinishSearch();
+        return;
+      }
+      s_code_faulted = false;
       ERROR_LOG(VR, "Loaded first state, prim_count = %d", original_prim_count);
     }
   }
   // if we should move on to the next code then do so, and save where we are up to
-  // if we have received 30 windows messages without saving a screenshot, then this code is probably
-  // bad
+  // if we have had 30 ticks without saving a screenshot, then this code is probably bad
   // so skip to the next one
-  else if (ch_begun && (ch_next_code ||
+  else if (ch_begun && (ch_next_code || s_code_faulted ||
            (ch_current_position > 0 && ch_cycles_without_snapshot > 30 && ch_last_search) ||
            (ch_current_position >= 0 && ch_cycles_without_snapshot > 100)))
   {
-    WARN_LOG(VR, "Next code %d (position = %d, cycles = %d, last = %d)", ch_next_code, ch_current_position, ch_cycles_without_snapshot, ch_last_search);
+    WARN_LOG(VR, "Next code %d (position = %d, cycles = %d, last = %d, faulted = %d)", ch_next_code, ch_current_position, ch_cycles_without_snapshot, ch_last_search, s_code_faulted.load());
 
     ch_next_code = false;
     ch_first_search = false;
-    ch_current_position++;
+    ch_current_position = NextPosition(ch_worker_index, ch_current_position);
     SaveLastPosition(ch_current_position);
     ch_cycles_without_snapshot = 0;
     if (ch_current_position >= (int)ch_map.size())
     {
-      ch_bruteforce = 0;
       NOTICE_LOG(VR, "Finished bruteforcing");
-      PostProcessCSVFile();
-
-      SuccessAlert(
-          "Finished brute forcing! To start again, delete position.txt in the screenshots folder.");
+      FinishSearch();
     }
     else
     {
-      State::Load(1);
+      // Rolling back also recovers from codes that faulted, late faults of the previous code
+      // can't happen after the CPU and GPU have been synchronized for loading
+      State::LoadFromBuffer(s_base_state);
+      ch_take_screenshot = 3;
+      // A code that faulted stopped the CPU until now
+      if (s_code_faulted.exchange(false))
+        CPU::EnableStepping(false);
       WARN_LOG(VR, "Loaded next state");
     }
   }
@@ -138,19 +288,27 @@ void SetupScreenshotAndWriteCSV(Renderer *render)
   std::string addr;
   if (ch_current_position >= 0)
     addr = ch_map[ch_current_position];
-  std::string s_sAux = std::to_string(ch_current_position) + "," + addr +
-                       "," + ch_code + "," + std::to_string(stats.thisFrame.numPrims) + "," +
-                       std::to_string(stats.thisFrame.numDrawCalls) + "," +
-                       std::to_string(ch_take_screenshot);
-  std::ofstream myfile;
-  myfile.open(File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/bruteforce.csv",
-              std::ios_base::app);
-  myfile << s_sAux << "\n";
-  myfile.close();
+  // Every worker measures the original primitive count, but only the first one records it
+  const bool is_first_worker = ch_worker_index == 0;
+  if (ch_current_position >= 0 || is_first_worker)
+  {
+    std::string s_sAux = std::to_string(ch_current_position) + "," + addr + "," + ch_code + "," +
+                         std::to_string(stats.thisFrame.numPrims) + "," +
+                         std::to_string(stats.thisFrame.numDrawCalls) + "," +
+                         std::to_string(ch_take_screenshot);
+    std::ofstream myfile;
+    myfile.open(GetCSVPath(ch_worker_index), std::ios_base::app);
+    myfile << s_sAux << "\n";
+    myfile.close();
+  }
   if (ch_take_screenshot == 1)
   {
     int prims = stats.thisFrame.numPrims;
-    if (ch_current_position < 0)
+    if (ch_current_position < 0 && !is_first_worker)
+    {
+      original_prim_count = prims;
+    }
+    else if (ch_current_position < 0)
     {
       original_prim_count = prims;
       SConfig::GetInstance().m_OriginalPrimitiveCount = original_prim_count;
@@ -158,17 +316,18 @@ void SetupScreenshotAndWriteCSV(Renderer *render)
       SConfig::GetInstance().SaveSettings();
       NOTICE_LOG(VR, "Saved setting, prim_count = %d", prims);
     }
-    if (ch_current_position < 0 || prims != original_prim_count || ch_screenshot_all)
+    if ((ch_current_position < 0 && is_first_worker) ||
+        (ch_current_position >= 0 && (prims != original_prim_count || ch_screenshot_all)))
     {
       std::string filename;
       if (ch_current_position < 0)
         filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("original %d.png", prims);
       else if (prims == 0)
-        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("blank %s %s.png", addr, ch_code);
+        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("blank %s %s.png", addr.c_str(), ch_code.c_str());
       else if (prims > original_prim_count)
-        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("show %d %s %s.png", prims, addr, ch_code);
+        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("show %d %s %s.png", prims, addr.c_str(), ch_code.c_str());
       else
-        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("hide %d %s %s.png", prims, addr, ch_code);
+        filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" + StringFromFormat("hide %d %s %s.png", prims, addr.c_str(), ch_code.c_str());
       //filename = File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/" +
       //  std::to_string(ch_current_position) + "_" + addr +
       //  "_" + ch_code + ".png";
@@ -182,6 +341,8 @@ void SetupScreenshotAndWriteCSV(Renderer *render)
     ch_cycles_without_snapshot = 0;
     ch_last_search = true;
     ch_next_code = true;
+    // Move on right away instead of waiting for the next tick
+    Core::QueueHostJob(ARBruteForceDriver);
   }
 
   ch_take_screenshot--;
@@ -226,48 +387,21 @@ void ParseMapFile(std::string unique_id)
 void IncrementPositionTxt()
 {
   WARN_LOG(VR, "IncrementPositionTxt");
-  ch_current_position = LoadLastPosition();
-  SaveLastPosition(++ch_current_position);
+  ch_current_position = NextPosition(ch_worker_index, LoadLastPosition());
+  SaveLastPosition(ch_current_position);
   WARN_LOG(VR, "IncrementedPositionTxt");
 }
 
 // save last position
 void SaveLastPosition(int position)
 {
-  std::ofstream myfile(File::GetUserPath(D_SCREENSHOTS_IDX) + "position.txt");
-  if (myfile.is_open())
-  {
-    std::string Result;
-    std::ostringstream convert;  // stream used for the conversion
-    convert << position;  // insert the textual representation of 'Number' in the characters in the
-                          // stream
-    myfile << convert.str() + "\n";
-    myfile.close();
-  }
+  SavePosition(ch_worker_index, position);
 }
+
 // load last position
 int LoadLastPosition()
 {
-  std::string line;
-  std::ifstream myfile(File::GetUserPath(D_SCREENSHOTS_IDX) + "position.txt");
-  std::string aux;
-
-  if (myfile.is_open())
-  {
-    while (getline(myfile, line))
-    {
-      aux = line;
-    }
-    myfile.close();
-  }
-
-  std::istringstream iss(aux.c_str());
-  iss.imbue(std::locale("C"));
-  int tmp = -1;
-  if (iss >> tmp)
-    return tmp;
-  else
-    return -1;
+  return LoadPosition(ch_worker_index);
 }
 
 // Create a new processed.csv file that only contains the functions that changed how many objects
@@ -371,4 +505,113 @@ void StripModesFromCSV(std::string infilename, std::string outfilename,
   ofile.close();
 }
 
+// Combines the csv files of the workers into bruteforce.csv, ordered by position
+static void MergeWorkerCSVFiles(int count)
+{
+  std::vector<std::pair<int, std::string>> rows;
+  for (int worker = 0; worker < count; ++worker)
+  {
+    std::ifstream file(GetCSVPath(worker));
+    std::string line;
+    while (getline(file, line))
+    {
+      if (!line.empty())
+        rows.emplace_back(atoi(line.c_str()), line);
+    }
+  }
+
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::ofstream merged(File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/bruteforce.csv");
+  for (const auto& row : rows)
+    merged << row.second << "\n";
+}
+
+bool RunWorkerProcesses(const std::vector<std::string>& args, int count,
+                        const std::string& title_id)
+{
+#ifdef _WIN32
+  ERROR_LOG(VR, "Brute forcing with worker processes is not supported on Windows");
+  return false;
+#else
+  ch_title_id = title_id;
+  ch_worker_count = count;
+  File::CreateFullPath(File::GetUserPath(D_SCREENSHOTS_IDX) + ch_title_id + "/");
+
+  const auto start_worker = [&args](int worker) -> pid_t {
+    std::vector<std::string> worker_args = args;
+    worker_args.push_back("--bruteforce-worker");
+    worker_args.push_back(std::to_string(worker));
+
+    std::vector<char*> argv;
+    for (std::string& arg : worker_args)
+      argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    return pid;
+  };
+
+  std::unordered_map<pid_t, int> workers;
+  for (int worker = 0; worker < count; ++worker)
+  {
+    const pid_t pid = start_worker(worker);
+    if (pid < 0)
+    {
+      ERROR_LOG(VR, "Failed to start bruteforcer worker %d", worker);
+      return false;
+    }
+    workers.emplace(pid, worker);
+  }
+
+  bool success = true;
+  while (!workers.empty())
+  {
+    int status;
+    const pid_t pid = wait(&status);
+    if (pid < 0)
+      break;
+
+    auto it = workers.find(pid);
+    if (it == workers.end())
+      continue;
+    const int worker = it->second;
+    workers.erase(it);
+
+    if (WIFEXITED(status))
+    {
+      if (WEXITSTATUS(status) != 0)
+      {
+        ERROR_LOG(VR, "Bruteforcer worker %d exited with %d", worker, WEXITSTATUS(status));
+        success = false;
+      }
+      continue;
+    }
+
+    // The worker crashed on the code it was trying, so it is restarted past that code
+    const int position = NextPosition(worker, LoadPosition(worker));
+    WARN_LOG(VR, "Bruteforcer worker %d crashed, restarting at %d", worker, position);
+    SavePosition(worker, position);
+    const pid_t new_pid = start_worker(worker);
+    if (new_pid < 0)
+    {
+      ERROR_LOG(VR, "Failed to restart bruteforcer worker %d", worker);
+      success = false;
+      continue;
+    }
+    workers.emplace(new_pid, worker);
+  }
+
+  MergeWorkerCSVFiles(count);
+  PostProcessCSVFile();
+  return success;
+#endif
+}
+
 }  // namespace ARBruteForcer
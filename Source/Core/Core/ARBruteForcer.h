@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "VideoCommon/RenderBase.h"
 
 namespace ARBruteForcer
@@ -27,6 +30,12 @@ extern bool ch_bruteforce;
 extern bool ch_dont_save_settings;
 
 extern bool ch_screenshot_all;
+// stop emulation instead of showing a message when all codes have been tried
+extern bool ch_exit_when_done;
+// a search can be split between worker processes, each of which tries every ch_worker_count-th
+// code starting at ch_worker_index, and keeps its own position and csv file
+extern int ch_worker_index;
+extern int ch_worker_count;
 
 extern int original_prim_count;
 
@@ -35,6 +44,17 @@ extern std::string ch_title_id;
 extern std::string ch_code;
 
 void ARBruteForceDriver();
+// Called by the video backend once it is ready. Starts the search as soon as the game is running,
+// and drives it from a timer that also skips codes that hang the game.
+void BeginSearch();
+// Called instead of restarting Dolphin when a code makes the game do something invalid during a
+// search. The CPU is stopped, and the code is skipped by rolling back to the in-memory base state.
+void OnCodeFaulted();
+void Shutdown();
+// Runs the executable with the given arguments once per worker, restarts workers that crash past
+// the code they were trying, and merges their results. Returns false if a worker couldn't run.
+bool RunWorkerProcesses(const std::vector<std::string>& args, int count,
+                        const std::string& title_id);
 void SetupScreenshotAndWriteCSV(Renderer *render);
 void ParseMapFile(std::string unique_id);
 void IncrementPositionTxt();
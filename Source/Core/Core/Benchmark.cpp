@@ -0,0 +1,494 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <pthread.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "Common/Common.h"
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/Host.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/State.h"
+
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace Benchmark
+{
+namespace detail
+{
+std::atomic<bool> s_active{false};
+}
+
+namespace
+{
+constexpr u32 REPORT_VERSION = 1;
+
+// A handle that allows reading the CPU time of a thread from any other thread
+struct ThreadClock
+{
+  bool valid = false;
+#ifdef _WIN32
+  HANDLE handle = nullptr;
+#elif defined(__APPLE__)
+  mach_port_t port = MACH_PORT_NULL;
+#else
+  clockid_t id{};
+#endif
+};
+
+struct FrameSample
+{
+  double wall_ms;
+  double cpu_thread_ms;
+  double gpu_thread_ms;
+  double dsp_ms;
+  double jit_compile_ms;
+  double state_save_ms;
+  double state_load_ms;
+  int draw_calls;
+  int primitives;
+  int shader_changes;
+};
+
+std::array<std::atomic<u64>, static_cast<size_t>(Counter::NumCounters)> s_counters;
+
+std::mutex s_lock;
+std::string s_report_path;
+u32 s_num_frames = 0;
+u32 s_warmup_frames = 0;
+bool s_report_pending = false;
+bool s_report_written = true;
+bool s_state_round_trips = false;
+size_t s_state_size = 0;
+
+ThreadClock s_cpu_thread_clock;
+
+bool s_has_previous_frame = false;
+u32 s_frames_seen = 0;
+std::chrono::steady_clock::time_point s_previous_frame_time;
+u64 s_previous_cpu_thread_time = 0;
+u64 s_previous_gpu_thread_time = 0;
+std::array<u64, static_cast<size_t>(Counter::NumCounters)> s_previous_counters;
+std::vector<FrameSample> s_samples;
+
+ThreadClock GetCurrentThreadClock()
+{
+  ThreadClock clock;
+#ifdef _WIN32
+  clock.valid = DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(),
+                                &clock.handle, 0, FALSE, DUPLICATE_SAME_ACCESS) != 0;
+#elif defined(__APPLE__)
+  clock.port = pthread_mach_thread_np(pthread_self());
+  clock.valid = clock.port != MACH_PORT_NULL;
+#else
+  clock.valid = pthread_getcpuclockid(pthread_self(), &clock.id) == 0;
+#endif
+  return clock;
+}
+
+void ReleaseThreadClock(ThreadClock* clock)
+{
+#ifdef _WIN32
+  if (clock->valid)
+    CloseHandle(clock->handle);
+#endif
+  *clock = {};
+}
+
+// Returns the CPU time used by a thread in nanoseconds, or 0 if it is unknown
+u64 GetThreadCPUTime(const ThreadClock& clock)
+{
+  if (!clock.valid)
+    return 0;
+
+#ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(clock.handle, &creation, &exit, &kernel, &user))
+    return 0;
+  const u64 kernel_time = (u64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+  const u64 user_time = (u64(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+  return (kernel_time + user_time) * 100;
+#elif defined(__APPLE__)
+  thread_basic_info_data_t info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  if (thread_info(clock.port, THREAD_BASIC_INFO, reinterpret_cast<thread_info_t>(&info),
+                  &count) != KERN_SUCCESS)
+  {
+    return 0;
+  }
+  return (u64(info.user_time.seconds) + info.system_time.seconds) * 1000000000 +
+         (u64(info.user_time.microseconds) + info.system_time.microseconds) * 1000;
+#else
+  timespec time;
+  if (clock_gettime(clock.id, &time) != 0)
+    return 0;
+  return u64(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+}
+
+double ToMilliseconds(u64 nanoseconds)
+{
+  return nanoseconds / 1000000.0;
+}
+
+double CounterDelta(const std::array<u64, static_cast<size_t>(Counter::NumCounters)>& counters,
+                    Counter counter)
+{
+  const size_t index = static_cast<size_t>(counter);
+  return ToMilliseconds(counters[index] - s_previous_counters[index]);
+}
+
+// NOTE: Host Thread
+void RunStateRoundTrip()
+{
+  if (!IsActive())
+    return;
+
+  // Reused, so that only the serialization is measured after the first frame
+  static std::vector<u8> buffer;
+  if (!State::SaveToBuffer(buffer))
+    return;
+  State::LoadFromBuffer(buffer);
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_state_size = buffer.size();
+}
+
+template <typename T>
+std::string SummarizeSeries(const std::vector<FrameSample>& samples, T FrameSample::*member)
+{
+  std::vector<double> values;
+  values.reserve(samples.size());
+  for (const FrameSample& sample : samples)
+    values.push_back(sample.*member);
+  return SummarizeJSON(std::move(values));
+}
+
+template <typename T>
+std::string ListSeries(const std::vector<FrameSample>& samples, T FrameSample::*member)
+{
+  std::string result = "[";
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    if (i != 0)
+      result += ", ";
+    result += std::is_floating_point<T>() ? StringFromFormat("%.4f", double(samples[i].*member)) :
+                                            std::to_string(samples[i].*member);
+  }
+  return result + "]";
+}
+
+// Must be called with s_lock held
+bool WriteReport(bool complete)
+{
+  s_report_pending = false;
+
+  const SConfig& config = SConfig::GetInstance();
+
+  double total_wall_ms = 0;
+  for (const FrameSample& sample : s_samples)
+    total_wall_ms += sample.wall_ms;
+
+  std::string report = "{\n";
+  report += StringFromFormat("  \"version\": %u,\n", REPORT_VERSION);
+  report += StringFromFormat("  \"complete\": %s,\n", complete ? "true" : "false");
+  report += StringFromFormat("  \"game_id\": \"%s\",\n", EscapeJSON(config.GetGameID()).c_str());
+  report += StringFromFormat(
+      "  \"video_backend\": \"%s\",\n",
+      EscapeJSON(g_video_backend ? g_video_backend->GetName() : std::string()).c_str());
+  report += StringFromFormat("  \"cpu_core\": %d,\n", config.iCPUCore);
+  report += StringFromFormat("  \"dual_core\": %s,\n", config.bCPUThread ? "true" : "false");
+  report += StringFromFormat("  \"dsp_hle\": %s,\n", config.bDSPHLE ? "true" : "false");
+  report += StringFromFormat("  \"warmup_frames\": %u,\n", s_warmup_frames);
+  report += StringFromFormat("  \"state_round_trips\": %s,\n",
+                             s_state_round_trips ? "true" : "false");
+  if (s_state_round_trips)
+    report += StringFromFormat("  \"state_size_bytes\": %zu,\n", s_state_size);
+  report += StringFromFormat("  \"frames\": %zu,\n", s_samples.size());
+  report += StringFromFormat("  \"total_seconds\": %.4f,\n", total_wall_ms / 1000);
+  report += StringFromFormat("  \"average_fps\": %.4f,\n",
+                             total_wall_ms > 0 ? s_samples.size() * 1000 / total_wall_ms : 0.0);
+
+  static const struct
+  {
+    const char* name;
+    double FrameSample::*member;
+  } time_series[] = {
+      {"wall_ms", &FrameSample::wall_ms},
+      {"cpu_thread_ms", &FrameSample::cpu_thread_ms},
+      {"gpu_thread_ms", &FrameSample::gpu_thread_ms},
+      {"dsp_ms", &FrameSample::dsp_ms},
+      {"jit_compile_ms", &FrameSample::jit_compile_ms},
+      {"state_save_ms", &FrameSample::state_save_ms},
+      {"state_load_ms", &FrameSample::state_load_ms},
+  };
+  static const struct
+  {
+    const char* name;
+    int FrameSample::*member;
+  } count_series[] = {
+      {"draw_calls", &FrameSample::draw_calls},
+      {"primitives", &FrameSample::primitives},
+      {"shader_changes", &FrameSample::shader_changes},
+  };
+
+  report += "  \"summary\": {\n";
+  for (const auto& series : time_series)
+  {
+    report += StringFromFormat("    \"%s\": %s,\n", series.name,
+                               SummarizeSeries(s_samples, series.member).c_str());
+  }
+  for (size_t i = 0; i < ArraySize(count_series); ++i)
+  {
+    report += StringFromFormat("    \"%s\": %s%s\n", count_series[i].name,
+                               SummarizeSeries(s_samples, count_series[i].member).c_str(),
+                               i + 1 < ArraySize(count_series) ? "," : "");
+  }
+  report += "  },\n";
+
+  report += "  \"counters\": {\n";
+  report += StringFromFormat("    \"pixel_shaders_created\": %d,\n", stats.numPixelShadersCreated);
+  report += StringFromFormat("    \"pixel_shaders_alive\": %d,\n", stats.numPixelShadersAlive);
+  report +=
+      StringFromFormat("    \"vertex_shaders_created\": %d,\n", stats.numVertexShadersCreated);
+  report += StringFromFormat("    \"vertex_shaders_alive\": %d,\n", stats.numVertexShadersAlive);
+  report += StringFromFormat("    \"textures_created\": %d,\n", stats.numTexturesCreated);
+  report += StringFromFormat("    \"textures_uploaded\": %d,\n", stats.numTexturesUploaded);
+  report += StringFromFormat("    \"textures_alive\": %d,\n", stats.numTexturesAlive);
+  report += StringFromFormat("    \"vertex_loaders\": %d,\n", stats.numVertexLoaders);
+  report += StringFromFormat("    \"projection_cache_hits\": %d,\n", stats.numProjectionCacheHits);
+  report +=
+      StringFromFormat("    \"projection_cache_misses\": %d,\n", stats.numProjectionCacheMisses);
+  report += StringFromFormat("    \"tlb_hits\": %" PRIu64 ",\n", PowerPC::tlb_stats.hits);
+  report += StringFromFormat("    \"tlb_misses\": %" PRIu64 ",\n", PowerPC::tlb_stats.misses);
+  report +=
+      StringFromFormat("    \"tlb_page_walks\": %" PRIu64 "\n", PowerPC::tlb_stats.page_walks);
+  report += "  },\n";
+
+  report += "  \"per_frame\": {\n";
+  for (const auto& series : time_series)
+  {
+    report += StringFromFormat("    \"%s\": %s,\n", series.name,
+                               ListSeries(s_samples, series.member).c_str());
+  }
+  for (size_t i = 0; i < ArraySize(count_series); ++i)
+  {
+    report += StringFromFormat("    \"%s\": %s%s\n", count_series[i].name,
+                               ListSeries(s_samples, count_series[i].member).c_str(),
+                               i + 1 < ArraySize(count_series) ? "," : "");
+  }
+  report += "  }\n";
+  report += "}\n";
+
+  File::CreateFullPath(s_report_path);
+  if (!File::WriteStringToFile(report, s_report_path))
+  {
+    ERROR_LOG(CORE, "Failed to write the benchmark report to %s", s_report_path.c_str());
+    s_report_written = false;
+    return false;
+  }
+
+  s_report_written = true;
+  NOTICE_LOG(CORE, "Wrote benchmark report for %zu frames to %s", s_samples.size(),
+             s_report_path.c_str());
+  return true;
+}
+}  // Anonymous namespace
+
+std::string EscapeJSON(const std::string& str)
+{
+  std::string result;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+      result += std::string("\\") + c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      result += StringFromFormat("\\u%04x", c);
+    else
+      result += c;
+  }
+  return result;
+}
+
+std::string SummarizeJSON(std::vector<double> values)
+{
+  if (values.empty())
+    return "{}";
+
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (double value : values)
+    sum += value;
+
+  // Nearest-rank percentiles
+  const auto percentile = [&values](double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100 * values.size()));
+    return values[std::max<size_t>(rank, 1) - 1];
+  };
+
+  return StringFromFormat("{\"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, "
+                          "\"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                          sum / values.size(), values.front(), percentile(50), percentile(90),
+                          percentile(95), percentile(99), values.back());
+}
+
+void Start(u32 num_frames, u32 warmup_frames, const std::string& report_path,
+           bool state_round_trips)
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+
+  s_report_path = report_path;
+  s_num_frames = std::max(num_frames, 1u);
+  s_warmup_frames = warmup_frames;
+  s_report_pending = true;
+  s_state_round_trips = state_round_trips;
+  s_state_size = 0;
+
+  s_has_previous_frame = false;
+  s_frames_seen = 0;
+  s_samples.clear();
+  s_samples.reserve(s_num_frames);
+  for (std::atomic<u64>& counter : s_counters)
+    counter.store(0, std::memory_order_relaxed);
+
+  detail::s_active.store(true);
+}
+
+bool Stop()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  detail::s_active.store(false);
+
+  if (!s_report_pending)
+    return s_report_written;
+
+  return WriteReport(false);
+}
+
+void AddTime(Counter counter, u64 nanoseconds)
+{
+  s_counters[static_cast<size_t>(counter)].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void RegisterCPUThread()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  ReleaseThreadClock(&s_cpu_thread_clock);
+  s_cpu_thread_clock = GetCurrentThreadClock();
+}
+
+void UnregisterCPUThread()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  ReleaseThreadClock(&s_cpu_thread_clock);
+}
+
+u64 GetCPUThreadCPUTime()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  return GetThreadCPUTime(s_cpu_thread_clock);
+}
+
+u64 GetCurrentThreadCPUTime()
+{
+#ifdef _WIN32
+  ThreadClock clock;
+  clock.valid = true;
+  clock.handle = GetCurrentThread();
+  return GetThreadCPUTime(clock);
+#elif defined(__APPLE__)
+  return GetThreadCPUTime(GetCurrentThreadClock());
+#else
+  ThreadClock clock;
+  clock.valid = true;
+  clock.id = CLOCK_THREAD_CPUTIME_ID;
+  return GetThreadCPUTime(clock);
+#endif
+}
+
+void OnFramePresented()
+{
+  if (!IsActive())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lk(s_lock);
+    if (!s_report_pending)
+      return;
+
+    const auto now = std::chrono::steady_clock::now();
+    const u64 cpu_thread_time = GetThreadCPUTime(s_cpu_thread_clock);
+    const u64 gpu_thread_time = GetCurrentThreadCPUTime();
+    std::array<u64, static_cast<size_t>(Counter::NumCounters)> counters;
+    for (size_t i = 0; i < counters.size(); ++i)
+      counters[i] = s_counters[i].load(std::memory_order_relaxed);
+
+    // The first frame only marks the start of the measurements
+    if (s_has_previous_frame && ++s_frames_seen > s_warmup_frames)
+    {
+      const auto wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          now - s_previous_frame_time);
+
+      FrameSample sample;
+      sample.wall_ms = ToMilliseconds(wall_time.count());
+      sample.cpu_thread_ms = ToMilliseconds(cpu_thread_time - s_previous_cpu_thread_time);
+      sample.gpu_thread_ms = ToMilliseconds(gpu_thread_time - s_previous_gpu_thread_time);
+      sample.dsp_ms = CounterDelta(counters, Counter::DSP);
+      sample.jit_compile_ms = CounterDelta(counters, Counter::JITCompile);
+      sample.state_save_ms = CounterDelta(counters, Counter::StateSave);
+      sample.state_load_ms = CounterDelta(counters, Counter::StateLoad);
+      sample.draw_calls = stats.thisFrame.numDrawCalls;
+      sample.primitives = stats.thisFrame.numPrims;
+      sample.shader_changes = stats.thisFrame.numShaderChanges;
+      s_samples.push_back(sample);
+    }
+
+    s_has_previous_frame = true;
+    s_previous_frame_time = now;
+    s_previous_cpu_thread_time = cpu_thread_time;
+    s_previous_gpu_thread_time = gpu_thread_time;
+    s_previous_counters = counters;
+
+    if (s_samples.size() < s_num_frames)
+    {
+      // The round trip of a frame is counted in the next frame
+      if (s_state_round_trips)
+        Core::QueueHostJob(RunStateRoundTrip);
+      return;
+    }
+
+    detail::s_active.store(false);
+    WriteReport(true);
+  }
+
+  Host_Message(WM_USER_STOP);
+}
+}  // namespace Benchmark
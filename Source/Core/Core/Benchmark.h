@@ -0,0 +1,102 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Headless benchmarking.
+//
+// While a benchmark is active, every presented frame is timed: wall time, CPU time spent by the
+// CPU thread and by the thread that presents frames, and the time the CPU thread spends in the
+// DSP emulator, in the JIT compiler and in saving and loading savestates. After the requested
+// number of frames, a JSON report with the per-frame numbers, their percentiles and the counters
+// from the video Statistics and the software TLB is written and the host is asked to stop
+// emulation.
+//
+// Frame boundaries are taken on the GPU thread. In dual core mode, the CPU thread numbers of a
+// frame can therefore be skewed by up to the amount of work the CPU thread is running ahead.
+
+namespace Benchmark
+{
+enum class Counter
+{
+  JITCompile,
+  DSP,
+  StateSave,
+  StateLoad,
+  NumCounters
+};
+
+// Must be called before the core is booted. With state_round_trips, a savestate is saved to memory
+// and loaded again after every frame, which measures the cost of rolling back a frame.
+void Start(u32 num_frames, u32 warmup_frames, const std::string& report_path,
+           bool state_round_trips);
+// Writes a report with the frames that have been measured so far, unless one was already written.
+// Returns false if the report couldn't be written, now or when the benchmark finished.
+bool Stop();
+
+namespace detail
+{
+extern std::atomic<bool> s_active;
+}
+
+inline bool IsActive()
+{
+  return detail::s_active.load(std::memory_order_relaxed);
+}
+
+void AddTime(Counter counter, u64 nanoseconds);
+
+// Helpers for writing JSON reports
+std::string EscapeJSON(const std::string& str);
+// Returns a JSON object with the mean, minimum, maximum and percentiles of the values
+std::string SummarizeJSON(std::vector<double> values);
+
+// Called by the CPU thread (or the FIFO player thread) when it starts and stops, so that its CPU
+// time can be sampled from other threads.
+void RegisterCPUThread();
+void UnregisterCPUThread();
+
+// CPU time used by the registered CPU thread and by the calling thread, in nanoseconds. Returns 0
+// if it is unknown.
+u64 GetCPUThreadCPUTime();
+u64 GetCurrentThreadCPUTime();
+
+// Called on the GPU thread after a frame has been presented
+void OnFramePresented();
+
+class ScopedTimer final
+{
+public:
+  explicit ScopedTimer(Counter counter) : m_counter(counter), m_active(IsActive())
+  {
+    if (m_active)
+      m_start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedTimer()
+  {
+    if (m_active)
+    {
+      const auto elapsed = std::chrono::steady_clock::now() - m_start;
+      AddTime(m_counter,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Counter m_counter;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
+}  // namespace Benchmark
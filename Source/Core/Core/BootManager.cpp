@@ -83,6 +83,7 @@ private:
   bool bFPRF;
   bool bAccurateNaNs;
   bool bMMU;
+  int iTLBSize;
   bool bDCBZOFF;
   bool bLowDCBZHack;
   bool m_EnableJIT;
@@ -116,6 +117,7 @@ void ConfigCache::SaveConfig(const SConfig& config)
   bFPRF = config.bFPRF;
   bAccurateNaNs = config.bAccurateNaNs;
   bMMU = config.bMMU;
+  iTLBSize = config.iTLBSize;
   bDCBZOFF = config.bDCBZOFF;
   m_EnableJIT = config.m_DSPEnableJIT;
   bSyncGPU = config.bSyncGPU;
@@ -159,6 +161,7 @@ void ConfigCache::RestoreConfig(SConfig* config)
   config->bFPRF = bFPRF;
   config->bAccurateNaNs = bAccurateNaNs;
   config->bMMU = bMMU;
+  config->iTLBSize = iTLBSize;
   config->bDCBZOFF = bDCBZOFF;
   config->bLowDCBZHack = bLowDCBZHack;
   config->m_DSPEnableJIT = m_EnableJIT;
@@ -260,6 +263,7 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
     core_section->Get("FPRF", &StartUp.bFPRF, StartUp.bFPRF);
     core_section->Get("AccurateNaNs", &StartUp.bAccurateNaNs, StartUp.bAccurateNaNs);
     core_section->Get("MMU", &StartUp.bMMU, StartUp.bMMU);
+    core_section->Get("TLBSize", &StartUp.iTLBSize, StartUp.iTLBSize);
     core_section->Get("DCBZ", &StartUp.bDCBZOFF, StartUp.bDCBZOFF);
     core_section->Get("LowDCBZHack", &StartUp.bLowDCBZHack, StartUp.bLowDCBZHack);
     core_section->Get("SyncGPU", &StartUp.bSyncGPU, StartUp.bSyncGPU);
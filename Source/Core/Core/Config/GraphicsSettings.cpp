@@ -38,6 +38,8 @@ const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES{{System::GFX, "Settings", "Show
                                                  false};
 const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE{{System::GFX, "Settings", "LogRenderTimeToFile"},
                                                    false};
+const ConfigInfo<int> GFX_FAST_FORWARD_PRESENT_INTERVAL{
+    {System::GFX, "Settings", "FastForwardPresentInterval"}, 1};
 const ConfigInfo<bool> GFX_OVERLAY_STATS{{System::GFX, "Settings", "OverlayStats"}, false};
 const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS{{System::GFX, "Settings", "OverlayProjStats"}, false};
 const ConfigInfo<bool> GFX_DUMP_TEXTURES{{System::GFX, "Settings", "DumpTextures"}, false};
@@ -57,6 +59,12 @@ const ConfigInfo<std::string> GFX_DUMP_PATH{{System::GFX, "Settings", "DumpPath"
 const ConfigInfo<int> GFX_BITRATE_KBPS{{System::GFX, "Settings", "BitrateKbps"}, 2500};
 const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS{
     {System::GFX, "Settings", "InternalResolutionFrameDumps"}, false};
+const ConfigInfo<int> GFX_FRAME_DUMP_QUEUE_DEPTH{{System::GFX, "Settings", "FrameDumpQueueDepth"},
+                                                 4};
+const ConfigInfo<bool> GFX_FRAME_DUMP_DROP_FRAMES{{System::GFX, "Settings", "FrameDumpDropFrames"},
+                                                  false};
+const ConfigInfo<int> GFX_PNG_COMPRESSION_LEVEL{{System::GFX, "Settings", "PNGCompressionLevel"},
+                                                6};
 const ConfigInfo<bool> GFX_ENABLE_GPU_TEXTURE_DECODING{
     {System::GFX, "Settings", "EnableGPUTextureDecoding"}, false};
 const ConfigInfo<bool> GFX_ENABLE_PIXEL_LIGHTING{{System::GFX, "Settings", "EnablePixelLighting"},
@@ -130,6 +138,7 @@ const ConfigInfo<int> GFX_STEREO_DEPTH_PERCENTAGE{
 // Graphics.Hacks
 
 const ConfigInfo<bool> GFX_HACK_EFB_ACCESS_ENABLE{{System::GFX, "Hacks", "EFBAccessEnable"}, true};
+const ConfigInfo<int> GFX_HACK_EFB_PEEK_TILE_SIZE{{System::GFX, "Hacks", "EFBPeekTileSize"}, 64};
 const ConfigInfo<bool> GFX_HACK_BBOX_ENABLE{{System::GFX, "Hacks", "BBoxEnable"}, false};
 const ConfigInfo<bool> GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION{
     {System::GFX, "Hacks", "BBoxPreferStencilImplementation"}, false};
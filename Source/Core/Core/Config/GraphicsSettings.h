@@ -30,6 +30,7 @@ extern const ConfigInfo<bool> GFX_SHOW_FPS;
 extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_PING;
 extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES;
 extern const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE;
+extern const ConfigInfo<int> GFX_FAST_FORWARD_PRESENT_INTERVAL;
 extern const ConfigInfo<bool> GFX_OVERLAY_STATS;
 extern const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS;
 extern const ConfigInfo<bool> GFX_DUMP_TEXTURES;
@@ -45,6 +46,9 @@ extern const ConfigInfo<std::string> GFX_DUMP_CODEC;
 extern const ConfigInfo<std::string> GFX_DUMP_PATH;
 extern const ConfigInfo<int> GFX_BITRATE_KBPS;
 extern const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS;
+extern const ConfigInfo<int> GFX_FRAME_DUMP_QUEUE_DEPTH;
+extern const ConfigInfo<bool> GFX_FRAME_DUMP_DROP_FRAMES;
+extern const ConfigInfo<int> GFX_PNG_COMPRESSION_LEVEL;
 extern const ConfigInfo<bool> GFX_ENABLE_GPU_TEXTURE_DECODING;
 extern const ConfigInfo<bool> GFX_ENABLE_PIXEL_LIGHTING;
 extern const ConfigInfo<bool> GFX_FAST_DEPTH_CALC;
@@ -97,6 +101,7 @@ extern const ConfigInfo<int> GFX_STEREO_DEPTH_PERCENTAGE;
 // Graphics.Hacks
 
 extern const ConfigInfo<bool> GFX_HACK_EFB_ACCESS_ENABLE;
+extern const ConfigInfo<int> GFX_HACK_EFB_PEEK_TILE_SIZE;
 extern const ConfigInfo<bool> GFX_HACK_BBOX_ENABLE;
 extern const ConfigInfo<bool> GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION;
 extern const ConfigInfo<bool> GFX_HACK_FORCE_PROGRESSIVE;
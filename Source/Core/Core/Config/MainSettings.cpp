@@ -79,6 +79,13 @@ const ConfigInfo<int> MAIN_SYNC_GPU_MIN_DISTANCE{{System::Main, "Core", "SyncGpu
                                                  -200000};
 const ConfigInfo<float> MAIN_SYNC_GPU_OVERCLOCK{{System::Main, "Core", "SyncGpuOverclock"}, 1.0f};
 const ConfigInfo<bool> MAIN_FAST_DISC_SPEED{{System::Main, "Core", "FastDiscSpeed"}, false};
+const ConfigInfo<bool> MAIN_DVD_PREFETCH{{System::Main, "Core", "DVDPrefetch"}, true};
+const ConfigInfo<int> MAIN_DVD_PREFETCH_CACHE_SIZE{{System::Main, "Core", "DVDPrefetchCacheSize"},
+                                                   32};
+const ConfigInfo<bool> MAIN_DVD_READ_TRACES{{System::Main, "Core", "DVDReadTraces"}, false};
+const ConfigInfo<int> MAIN_SECTOR_CACHE_SIZE{{System::Main, "Core", "SectorCacheSize"}, 8};
+const ConfigInfo<bool> MAIN_SECTOR_CACHE_SPECULATIVE_FILL{
+    {System::Main, "Core", "SectorCacheSpeculativeFill"}, true};
 const ConfigInfo<bool> MAIN_DCBZ{{System::Main, "Core", "DCBZ"}, false};
 const ConfigInfo<bool> MAIN_LOW_DCBZ_HACK{{System::Main, "Core", "LowDCBZHack"}, false};
 const ConfigInfo<bool> MAIN_FPRF{{System::Main, "Core", "FPRF"}, false};
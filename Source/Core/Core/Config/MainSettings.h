@@ -54,6 +54,11 @@ extern const ConfigInfo<int> MAIN_SYNC_GPU_MAX_DISTANCE;
 extern const ConfigInfo<int> MAIN_SYNC_GPU_MIN_DISTANCE;
 extern const ConfigInfo<float> MAIN_SYNC_GPU_OVERCLOCK;
 extern const ConfigInfo<bool> MAIN_FAST_DISC_SPEED;
+extern const ConfigInfo<bool> MAIN_DVD_PREFETCH;
+extern const ConfigInfo<int> MAIN_DVD_PREFETCH_CACHE_SIZE;
+extern const ConfigInfo<bool> MAIN_DVD_READ_TRACES;
+extern const ConfigInfo<int> MAIN_SECTOR_CACHE_SIZE;
+extern const ConfigInfo<bool> MAIN_SECTOR_CACHE_SPECULATIVE_FILL;
 extern const ConfigInfo<bool> MAIN_DCBZ;
 extern const ConfigInfo<bool> MAIN_LOW_DCBZ_HACK;
 extern const ConfigInfo<bool> MAIN_FPRF;
@@ -31,7 +31,8 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_CROP.location, Config::GFX_USE_XFB.location, Config::GFX_USE_REAL_XFB.location,
       Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES.location, Config::GFX_SHOW_FPS.location,
       Config::GFX_SHOW_NETPLAY_PING.location, Config::GFX_SHOW_NETPLAY_MESSAGES.location,
-      Config::GFX_LOG_RENDER_TIME_TO_FILE.location, Config::GFX_OVERLAY_STATS.location,
+      Config::GFX_LOG_RENDER_TIME_TO_FILE.location,
+      Config::GFX_FAST_FORWARD_PRESENT_INTERVAL.location, Config::GFX_OVERLAY_STATS.location,
       Config::GFX_OVERLAY_PROJ_STATS.location, Config::GFX_DUMP_TEXTURES.location,
       Config::GFX_HIRES_TEXTURES.location, Config::GFX_CONVERT_HIRES_TEXTURES.location,
       Config::GFX_CACHE_HIRES_TEXTURES.location, Config::GFX_DUMP_EFB_TARGET.location,
@@ -39,6 +40,8 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_USE_FFV1.location, Config::GFX_DUMP_FORMAT.location,
       Config::GFX_DUMP_CODEC.location, Config::GFX_DUMP_PATH.location,
       Config::GFX_BITRATE_KBPS.location, Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS.location,
+      Config::GFX_FRAME_DUMP_QUEUE_DEPTH.location, Config::GFX_FRAME_DUMP_DROP_FRAMES.location,
+      Config::GFX_PNG_COMPRESSION_LEVEL.location,
       Config::GFX_ENABLE_GPU_TEXTURE_DECODING.location, Config::GFX_ENABLE_PIXEL_LIGHTING.location,
       Config::GFX_FAST_DEPTH_CALC.location, Config::GFX_MSAA.location, Config::GFX_SSAA.location,
       Config::GFX_EFB_SCALE.location, Config::GFX_TEXFMT_OVERLAY_ENABLE.location,
@@ -70,7 +73,8 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
 
       // Graphics.Hacks
 
-      Config::GFX_HACK_EFB_ACCESS_ENABLE.location, Config::GFX_HACK_BBOX_ENABLE.location,
+      Config::GFX_HACK_EFB_ACCESS_ENABLE.location, Config::GFX_HACK_EFB_PEEK_TILE_SIZE.location,
+      Config::GFX_HACK_BBOX_ENABLE.location,
       Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION.location,
       Config::GFX_HACK_FORCE_PROGRESSIVE.location, Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM.location,
       Config::GFX_HACK_COPY_EFB_ENABLED.location,
@@ -4,6 +4,7 @@
 
 #include "Core/ConfigManager.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <climits>
 #include <memory>
@@ -44,6 +45,7 @@
 #include "Core/TitleDatabase.h"
 #include "VideoCommon/HiresTextures.h"
 
+#include "DiscIO/Blob.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/WiiWad.h"
@@ -538,6 +540,11 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("WiimoteEnableSpeaker", m_WiimoteEnableSpeaker);
   core->Set("RunCompareServer", bRunCompareServer);
   core->Set("RunCompareClient", bRunCompareClient);
+  core->Set("DVDPrefetch", bDVDPrefetch);
+  core->Set("DVDPrefetchCacheSize", iDVDPrefetchCacheSize);
+  core->Set("DVDReadTraces", bDVDReadTraces);
+  core->Set("SectorCacheSize", iSectorCacheSize);
+  core->Set("SectorCacheSpeculativeFill", bSectorCacheSpeculativeFill);
   // if (!ARBruteForcer::ch_dont_save_settings)
   // 	core->Set("FrameLimit", m_Framelimit);
   core->Set("FrameSkip", m_FrameSkip);
@@ -556,6 +563,7 @@ void SConfig::SaveMovieSettings(IniFile& ini)
   IniFile::Section* movie = ini.GetOrCreateSection("Movie");
 
   movie->Set("PauseMovie", m_PauseMovie);
+  movie->Set("KeyframeInterval", m_MovieKeyframeInterval);
   movie->Set("Author", m_strMovieAuthor);
   movie->Set("DumpFrames", m_DumpFrames);
   movie->Set("DumpFramesSilent", m_DumpFramesSilent);
@@ -906,12 +914,20 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("RunCompareServer", &bRunCompareServer, false);
   core->Get("RunCompareClient", &bRunCompareClient, false);
   core->Get("MMU", &bMMU, false);
+  core->Get("TLBSize", &iTLBSize, 128);
   core->Get("BBDumpPort", &iBBDumpPort, -1);
   core->Get("SyncGPU", &bSyncGPU, false);
   core->Get("SyncGpuMaxDistance", &iSyncGpuMaxDistance, 200000);
   core->Get("SyncGpuMinDistance", &iSyncGpuMinDistance, -200000);
   core->Get("SyncGpuOverclock", &fSyncGpuOverclock, 1.0f);
   core->Get("FastDiscSpeed", &bFastDiscSpeed, false);
+  core->Get("DVDPrefetch", &bDVDPrefetch, true);
+  core->Get("DVDPrefetchCacheSize", &iDVDPrefetchCacheSize, 32);
+  core->Get("DVDReadTraces", &bDVDReadTraces, false);
+  core->Get("SectorCacheSize", &iSectorCacheSize, 8);
+  core->Get("SectorCacheSpeculativeFill", &bSectorCacheSpeculativeFill, true);
+  DiscIO::SectorReader::SetCacheSettings(static_cast<u64>(std::max(iSectorCacheSize, 0)) << 20,
+                                         bSectorCacheSpeculativeFill);
   core->Get("DCBZ", &bDCBZOFF, false);
   core->Get("LowDCBZHack", &bLowDCBZHack, false);
   // if (ARBruteForcer::ch_bruteforce)
@@ -940,6 +956,7 @@ void SConfig::LoadMovieSettings(IniFile& ini)
   IniFile::Section* movie = ini.GetOrCreateSection("Movie");
 
   movie->Get("PauseMovie", &m_PauseMovie, false);
+  movie->Get("KeyframeInterval", &m_MovieKeyframeInterval, 0);
   movie->Get("Author", &m_strMovieAuthor, "");
   movie->Get("DumpFrames", &m_DumpFrames, false);
   movie->Get("DumpFramesSilent", &m_DumpFramesSilent, false);
@@ -1132,6 +1149,7 @@ void SConfig::LoadDefaults()
   bFPRF = false;
   bAccurateNaNs = false;
   bMMU = false;
+  iTLBSize = 128;
   bDCBZOFF = false;
   bLowDCBZHack = false;
   iBBDumpPort = -1;
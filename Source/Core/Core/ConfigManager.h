@@ -40,8 +40,6 @@ class TMDReader;
 #define BACKEND_XAUDIO2 "XAudio2"
 #define BACKEND_OPENSLES "OpenSLES"
 
-typedef std::vector<u8> SkipEntry;
-
 enum GPUDeterminismMode
 {
   GPU_DETERMINISM_AUTO,
@@ -121,10 +119,17 @@ struct SConfig
   bool bRunCompareClient = false;
 
   bool bMMU = false;
+  // Number of entries in each software TLB, rounded up to a power of two
+  int iTLBSize = 128;
   bool bDCBZOFF = false;
   bool bLowDCBZHack = false;
   int iBBDumpPort = 0;
   bool bFastDiscSpeed = false;
+  bool bDVDPrefetch = true;
+  int iDVDPrefetchCacheSize = 32;  // MiB
+  bool bDVDReadTraces = false;
+  int iSectorCacheSize = 8;  // MiB
+  bool bSectorCacheSpeculativeFill = true;
 
   bool bSyncGPU = false;
   int iSyncGpuMaxDistance;
@@ -150,15 +155,12 @@ struct SConfig
   float fFreeLookSensitivity;
 
   // Remove Layer
-  std::vector<SkipEntry> object_removal_codes;
   u32 skip_objects_end = 0;
   u32 skip_objects_start = 0;
 #ifdef DEBUG_OBJECTS
   u32 skip_objects_end_two = 0;
   u32 skip_objects_start_two = 0;
 #endif
-  volatile bool hide_objects_updating = true;
-  volatile bool hide_objects_done = true;
 
   // Display settings
   std::string strFullscreenResolution;
@@ -307,6 +309,8 @@ struct SConfig
 
   std::string m_WirelessMac;
   bool m_PauseMovie;
+  // Frames between the savestates that are kept for seeking in recorded movies, 0 to disable
+  u32 m_MovieKeyframeInterval;
   bool m_ShowLag;
   bool m_ShowFrameCount;
   bool m_ShowRTC;
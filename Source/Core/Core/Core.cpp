@@ -31,9 +31,11 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Trace.h"
 
 #include "Core/ARBruteForcer.h"
 #include "Core/Analytics.h"
+#include "Core/Benchmark.h"
 #include "Core/BootManager.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -364,6 +366,7 @@ static void CPUSetInitialExecutionState()
 static void CpuThread()
 {
   DeclareAsCPUThread();
+  Benchmark::RegisterCPUThread();
 
   const SConfig& _CoreParameter = SConfig::GetInstance();
 
@@ -433,11 +436,14 @@ static void CpuThread()
 
   if (_CoreParameter.bFastmem)
     EMM::UninstallExceptionHandler();
+
+  Benchmark::UnregisterCPUThread();
 }
 
 static void FifoPlayerThread()
 {
   DeclareAsCPUThread();
+  Benchmark::RegisterCPUThread();
   const SConfig& _CoreParameter = SConfig::GetInstance();
 
   if (_CoreParameter.bCPUThread)
@@ -482,6 +488,8 @@ static void FifoPlayerThread()
 
   if (!_CoreParameter.bCPUThread)
     g_video_backend->Video_Cleanup();
+
+  Benchmark::UnregisterCPUThread();
 }
 
 #ifdef OCULUSSDK042
@@ -556,6 +564,10 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
 
   Common::SetCurrentThreadName("Emuthread - Starting");
 
+  // Written last, after every other thread has shut down
+  Common::Trace::StartSession();
+  Common::ScopeGuard trace_guard{Common::Trace::StopSession};
+
 #if 0
   if (SConfig::GetInstance().m_OCEnable)
     DisplayMessage("WARNING: running at non-native CPU clock! Game may not be stable.", 8000);
@@ -1172,12 +1184,21 @@ void Shutdown()
   if (s_emu_thread.joinable())
     s_emu_thread.join();
 
+  ARBruteForcer::Shutdown();
+
   // Make sure there's nothing left over in case we're about to exit.
   HostDispatchJobs();
 }
 
 void KillDolphinAndRestart()
 {
+  // Once a search has begun, the code that caused this is skipped by rolling back instead
+  if (ARBruteForcer::ch_bruteforce && ARBruteForcer::ch_begun)
+  {
+    ARBruteForcer::OnCodeFaulted();
+    return;
+  }
+
   // If it's the first time through and it crashes on the first function, we must advance the
   // position.
   if (ARBruteForcer::ch_bruteforce &&
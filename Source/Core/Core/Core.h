@@ -38,6 +38,8 @@ enum class State
 bool Init(std::unique_ptr<BootParameters> boot);
 void Stop();
 void Shutdown();
+// Restarts Dolphin after the game did something invalid. While the brute forcer is searching, this
+// returns instead, and the caller has to carry on safely until the code is rolled back.
 void KillDolphinAndRestart();
 
 void DeclareAsCPUThread();
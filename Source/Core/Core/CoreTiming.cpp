@@ -17,6 +17,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -320,6 +321,8 @@ void MoveEvents()
 
 void Advance()
 {
+  Common::Trace::ScopedZone trace_zone("CoreTiming::Advance");
+
   MoveEvents();
 
   int cyclesExecuted = g.slice_length - DowncountToCycles(PowerPC::ppcState.downcount);
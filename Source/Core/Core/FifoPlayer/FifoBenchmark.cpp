@@ -0,0 +1,336 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/FifoPlayer/FifoBenchmark.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "Core/Benchmark.h"
+#include "Core/ConfigManager.h"
+
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace FifoBenchmark
+{
+namespace detail
+{
+std::atomic<bool> s_active{false};
+}
+
+namespace
+{
+constexpr u32 REPORT_VERSION = 1;
+
+using Clock = std::chrono::steady_clock;
+
+struct ObjectTimes
+{
+  u64 decode_ns = 0;
+  u64 vertex_load_ns = 0;
+  u64 texture_load_ns = 0;
+  u32 primitives = 0;
+  u32 vertices = 0;
+};
+
+struct FrameRun
+{
+  u64 wall_ns = 0;
+  u32 first_object = 0;
+  // Decoding before the first object of the frame
+  ObjectTimes setup;
+  std::vector<ObjectTimes> objects;
+
+  ObjectTimes& Current() { return objects.empty() ? setup : objects.back(); }
+  ObjectTimes Total() const
+  {
+    ObjectTimes total = setup;
+    for (const ObjectTimes& object : objects)
+    {
+      total.decode_ns += object.decode_ns;
+      total.vertex_load_ns += object.vertex_load_ns;
+      total.texture_load_ns += object.texture_load_ns;
+      total.primitives += object.primitives;
+      total.vertices += object.vertices;
+    }
+    return total;
+  }
+};
+
+std::mutex s_lock;
+std::string s_report_path;
+
+// Every run of each frame, in the order they were played
+std::map<u32, std::vector<FrameRun>> s_frames;
+u32 s_current_frame = 0;
+FrameRun s_current_run;
+Clock::time_point s_frame_start;
+// Start of the part of the current decoder call that hasn't been counted yet
+Clock::time_point s_segment_start;
+bool s_decoding = false;
+
+// Only touched by the decoder, except for BeginFrame which runs while the GPU is idle
+std::atomic<bool> s_drawing{false};
+
+double ToMilliseconds(u64 nanoseconds)
+{
+  return nanoseconds / 1000000.0;
+}
+
+// Must be called with s_lock held
+void FinishSegment(Clock::time_point now)
+{
+  if (!s_decoding)
+    return;
+
+  s_current_run.Current().decode_ns +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_segment_start).count();
+  s_segment_start = now;
+}
+
+std::string ListJSON(const std::vector<double>& values)
+{
+  std::string result = "[";
+  for (size_t i = 0; i < values.size(); ++i)
+    result += StringFromFormat(i == 0 ? "%.4f" : ", %.4f", values[i]);
+  return result + "]";
+}
+
+std::string FormatObjects(const std::vector<FrameRun>& runs)
+{
+  size_t num_objects = 0;
+  for (const FrameRun& run : runs)
+    num_objects = std::max(num_objects, run.objects.size());
+
+  std::string result = "[";
+  for (size_t i = 0; i < num_objects; ++i)
+  {
+    u64 decode_sum = 0, vertex_load_sum = 0, texture_load_sum = 0;
+    u64 decode_min = UINT64_MAX;
+    u32 num_runs = 0;
+    const ObjectTimes* first = nullptr;
+    for (const FrameRun& run : runs)
+    {
+      if (i >= run.objects.size())
+        continue;
+
+      const ObjectTimes& object = run.objects[i];
+      decode_sum += object.decode_ns;
+      vertex_load_sum += object.vertex_load_ns;
+      texture_load_sum += object.texture_load_ns;
+      decode_min = std::min(decode_min, object.decode_ns);
+      if (!first)
+        first = &object;
+      ++num_runs;
+    }
+
+    result += StringFromFormat(
+        "%s\n        {\"object\": %u, \"decode_ms\": %.4f, \"min_decode_ms\": %.4f, "
+        "\"vertex_load_ms\": %.4f, \"texture_load_ms\": %.4f, \"primitives\": %u, "
+        "\"vertices\": %u}",
+        i == 0 ? "" : ",", static_cast<u32>(runs.front().first_object + i),
+        ToMilliseconds(decode_sum) / num_runs, ToMilliseconds(decode_min),
+        ToMilliseconds(vertex_load_sum) / num_runs, ToMilliseconds(texture_load_sum) / num_runs,
+        first->primitives, first->vertices);
+  }
+  return result + (num_objects ? "\n      ]" : "]");
+}
+
+// Must be called with s_lock held
+bool WriteReport()
+{
+  const SConfig& config = SConfig::GetInstance();
+
+  std::vector<double> all_wall, all_decode, all_vertex_load, all_texture_load;
+  for (const auto& frame : s_frames)
+  {
+    for (const FrameRun& run : frame.second)
+    {
+      const ObjectTimes total = run.Total();
+      all_wall.push_back(ToMilliseconds(run.wall_ns));
+      all_decode.push_back(ToMilliseconds(total.decode_ns));
+      all_vertex_load.push_back(ToMilliseconds(total.vertex_load_ns));
+      all_texture_load.push_back(ToMilliseconds(total.texture_load_ns));
+    }
+  }
+
+  std::string report = "{\n";
+  report += StringFromFormat("  \"version\": %u,\n", REPORT_VERSION);
+  report += StringFromFormat(
+      "  \"video_backend\": \"%s\",\n",
+      Benchmark::EscapeJSON(g_video_backend ? g_video_backend->GetName() : std::string())
+          .c_str());
+  report += StringFromFormat("  \"dual_core\": %s,\n", config.bCPUThread ? "true" : "false");
+  report += StringFromFormat("  \"frames_played\": %zu,\n", all_wall.size());
+  report += "  \"summary\": {\n";
+  report += StringFromFormat("    \"wall_ms\": %s,\n", Benchmark::SummarizeJSON(all_wall).c_str());
+  report +=
+      StringFromFormat("    \"decode_ms\": %s,\n", Benchmark::SummarizeJSON(all_decode).c_str());
+  report += StringFromFormat("    \"vertex_load_ms\": %s,\n",
+                             Benchmark::SummarizeJSON(all_vertex_load).c_str());
+  report += StringFromFormat("    \"texture_load_ms\": %s\n",
+                             Benchmark::SummarizeJSON(all_texture_load).c_str());
+  report += "  },\n";
+
+  report += "  \"frames\": [";
+  bool first_frame = true;
+  for (const auto& frame : s_frames)
+  {
+    const std::vector<FrameRun>& runs = frame.second;
+    std::vector<double> wall, decode, setup, vertex_load, texture_load;
+    for (const FrameRun& run : runs)
+    {
+      const ObjectTimes total = run.Total();
+      wall.push_back(ToMilliseconds(run.wall_ns));
+      decode.push_back(ToMilliseconds(total.decode_ns));
+      setup.push_back(ToMilliseconds(run.setup.decode_ns));
+      vertex_load.push_back(ToMilliseconds(total.vertex_load_ns));
+      texture_load.push_back(ToMilliseconds(total.texture_load_ns));
+    }
+
+    report += first_frame ? "\n" : ",\n";
+    first_frame = false;
+    report += "    {\n";
+    report += StringFromFormat("      \"frame\": %u,\n", frame.first);
+    report += StringFromFormat("      \"runs\": %zu,\n", runs.size());
+    report += StringFromFormat("      \"wall_ms\": %s,\n", ListJSON(wall).c_str());
+    report += StringFromFormat("      \"decode_ms\": %s,\n", ListJSON(decode).c_str());
+    report += StringFromFormat("      \"setup_decode_ms\": %s,\n", ListJSON(setup).c_str());
+    report += StringFromFormat("      \"vertex_load_ms\": %s,\n", ListJSON(vertex_load).c_str());
+    report +=
+        StringFromFormat("      \"texture_load_ms\": %s,\n", ListJSON(texture_load).c_str());
+    report += StringFromFormat("      \"objects\": %s\n", FormatObjects(runs).c_str());
+    report += "    }";
+  }
+  report += s_frames.empty() ? "]\n" : "\n  ]\n";
+  report += "}\n";
+
+  File::CreateFullPath(s_report_path);
+  if (!File::WriteStringToFile(report, s_report_path))
+  {
+    ERROR_LOG(VIDEO, "Failed to write the FIFO playback report to %s", s_report_path.c_str());
+    return false;
+  }
+
+  NOTICE_LOG(VIDEO, "Wrote FIFO playback report for %zu frames to %s", all_wall.size(),
+             s_report_path.c_str());
+  return true;
+}
+}  // Anonymous namespace
+
+void Start(const std::string& report_path)
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+
+  s_report_path = report_path;
+  s_frames.clear();
+  s_current_run = {};
+  s_decoding = false;
+  s_drawing.store(false, std::memory_order_relaxed);
+
+  detail::s_active.store(true);
+}
+
+bool Stop()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  if (!detail::s_active.exchange(false))
+    return true;
+
+  const bool result = s_frames.empty() || WriteReport();
+  s_frames.clear();
+  return result;
+}
+
+void BeginFrame(u32 frame, u32 first_object)
+{
+  if (!IsActive())
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_current_frame = frame;
+  s_current_run = {};
+  s_current_run.first_object = first_object;
+  s_frame_start = Clock::now();
+  if (s_decoding)
+    s_segment_start = s_frame_start;
+
+  // Every frame is analyzed separately by FifoPlaybackAnalyzer
+  s_drawing.store(false, std::memory_order_relaxed);
+}
+
+void EndFrame()
+{
+  if (!IsActive())
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  const Clock::time_point now = Clock::now();
+  FinishSegment(now);
+
+  s_current_run.wall_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_frame_start).count();
+  s_frames[s_current_frame].push_back(std::move(s_current_run));
+  s_current_run = {};
+}
+
+void OnRegisterLoad()
+{
+  s_drawing.store(false, std::memory_order_relaxed);
+}
+
+void OnPrimitive()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  if (!s_drawing.exchange(true, std::memory_order_relaxed))
+  {
+    FinishSegment(Clock::now());
+    s_current_run.objects.emplace_back();
+  }
+}
+
+void AddVertexLoadTime(u64 nanoseconds, u32 num_vertices)
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  ObjectTimes& object = s_current_run.Current();
+  object.vertex_load_ns += nanoseconds;
+  ++object.primitives;
+  object.vertices += num_vertices;
+}
+
+void AddTextureLoadTime(u64 nanoseconds)
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_current_run.Current().texture_load_ns += nanoseconds;
+}
+
+DecodeScope::DecodeScope(bool enabled) : m_active(enabled && IsActive())
+{
+  if (!m_active)
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_decoding = true;
+  s_segment_start = Clock::now();
+}
+
+DecodeScope::~DecodeScope()
+{
+  if (!m_active)
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  FinishSegment(Clock::now());
+  s_decoding = false;
+}
+}  // namespace FifoBenchmark
@@ -0,0 +1,94 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Timings for FIFO log playback.
+//
+// While active, the time that the GPU side spends decoding the FIFO data of each played frame is
+// measured, along with the parts of it spent in the vertex loaders and the texture cache. Decoding
+// time is split into objects using the same rules as FifoPlaybackAnalyzer: an object starts with
+// the first primitive after a register load and lasts until the next object starts, so the work
+// done by the register loads that flush an object is counted towards that object.
+//
+// Only time spent inside the decoder is counted, so the numbers don't include time the GPU side
+// spends waiting for the FIFO player. Frames are expected to be played by FifoPlayer, which waits
+// for the GPU to become idle at the end of each frame.
+
+namespace FifoBenchmark
+{
+void Start(const std::string& report_path);
+// Writes the report, unless nothing was measured. Returns false if it couldn't be written.
+bool Stop();
+
+namespace detail
+{
+extern std::atomic<bool> s_active;
+}
+
+inline bool IsActive()
+{
+  return detail::s_active.load(std::memory_order_relaxed);
+}
+
+// Called by FifoPlayer around each played frame. first_object is the index of the first object
+// that is played, since the objects before the object range are skipped.
+void BeginFrame(u32 frame, u32 first_object);
+void EndFrame();
+
+// Called by the opcode decoder for top-level commands
+void OnRegisterLoad();
+void OnPrimitive();
+// Counts a primitive that has been fully loaded
+void AddVertexLoadTime(u64 nanoseconds, u32 num_vertices);
+void AddTextureLoadTime(u64 nanoseconds);
+
+// Measures the time spent in one call of the opcode decoder
+class DecodeScope final
+{
+public:
+  explicit DecodeScope(bool enabled);
+  ~DecodeScope();
+
+  DecodeScope(const DecodeScope&) = delete;
+  DecodeScope& operator=(const DecodeScope&) = delete;
+
+private:
+  bool m_active;
+};
+
+// Measures the duration of its scope and passes it to AddTextureLoadTime
+class ScopedTextureLoadTimer final
+{
+public:
+  ScopedTextureLoadTimer() : m_active(IsActive())
+  {
+    if (m_active)
+      m_start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedTextureLoadTimer()
+  {
+    if (m_active)
+    {
+      AddTextureLoadTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - m_start)
+                             .count());
+    }
+  }
+
+  ScopedTextureLoadTimer(const ScopedTextureLoadTimer&) = delete;
+  ScopedTextureLoadTimer& operator=(const ScopedTextureLoadTimer&) = delete;
+
+private:
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
+}  // namespace FifoBenchmark
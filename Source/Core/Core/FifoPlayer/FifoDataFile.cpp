@@ -6,19 +6,35 @@
 
 #include <algorithm>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include <xxhash.h>
+#include <zlib.h>
+
 #include "Common/File.h"
+#include "Common/Logging/Log.h"
 
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 4,
-  MIN_LOADER_VERSION = 1,
+  VERSION_NUMBER = 5,
+  MIN_LOADER_VERSION = 5,
+  // The first version that stores frames compressed
+  COMPRESSED_VERSION = 5,
 };
 
+// Decompressed frames and memory update payloads that are kept around while streaming
+constexpr size_t FRAME_CACHE_SIZE = 64 * 1024 * 1024;
+constexpr size_t PAYLOAD_CACHE_SIZE = 64 * 1024 * 1024;
+
+// Payloads are identified by two hashes with different seeds and their size
+constexpr u64 PAYLOAD_HASH_SEED = 0x46494650;  // "FIFP"
+
 #pragma pack(push, 1)
 
 struct FileHeader
@@ -39,7 +55,10 @@ struct FileHeader
   u32 flags;
   u64 texMemOffset;
   u32 texMemSize;
-  u8 reserved[40];
+  // Version 5 and later
+  u64 payloadListOffset;
+  u32 payloadCount;
+  u8 reserved[28];
 };
 static_assert(sizeof(FileHeader) == 128, "FileHeader should be 128 bytes");
 
@@ -66,8 +85,58 @@ struct FileMemoryUpdate
 };
 static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 bytes");
 
+// Version 5 and later. The data of a frame is a zlib compressed block (or an uncompressed one if
+// compressedSize equals the uncompressed size) with the FIFO data followed by numMemoryUpdates
+// FileMemoryUpdateRef entries.
+struct FileCompressedFrame
+{
+  u64 dataOffset;
+  u32 compressedSize;
+  u32 fifoDataSize;
+  u32 fifoStart;
+  u32 fifoEnd;
+  u32 numMemoryUpdates;
+  u8 reserved[36];
+};
+static_assert(sizeof(FileCompressedFrame) == 64, "FileCompressedFrame should be 64 bytes");
+
+struct FileMemoryUpdateRef
+{
+  u32 fifoPosition;
+  u32 address;
+  u32 payloadIndex;
+  u8 type;
+  u8 reserved[3];
+};
+static_assert(sizeof(FileMemoryUpdateRef) == 16, "FileMemoryUpdateRef should be 16 bytes");
+
+// Compressed the same way as frames
+struct FilePayload
+{
+  u64 offset;
+  u32 compressedSize;
+  u32 size;
+};
+static_assert(sizeof(FilePayload) == 16, "FilePayload should be 16 bytes");
+
 #pragma pack(pop)
 
+static void CompressBlock(const u8* data, size_t size, std::vector<u8>* out)
+{
+  uLongf compressed_size = compressBound(static_cast<uLong>(size));
+  out->resize(compressed_size);
+  if (compress2(out->data(), &compressed_size, data, static_cast<uLong>(size),
+                Z_DEFAULT_COMPRESSION) != Z_OK ||
+      compressed_size >= size)
+  {
+    // Store the data as is
+    out->assign(data, data + size);
+    return;
+  }
+
+  out->resize(compressed_size);
+}
+
 FifoDataFile::FifoDataFile() = default;
 
 FifoDataFile::~FifoDataFile() = default;
@@ -89,7 +158,74 @@ bool FifoDataFile::GetIsWii() const
 
 void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  m_Frames.push_back(std::make_shared<FifoFrameInfo>(frameInfo));
+}
+
+u32 FifoDataFile::GetFrameCount() const
+{
+  if (m_StreamFile)
+    return static_cast<u32>(m_StreamedFrames.size());
+
+  return static_cast<u32>(m_Frames.size());
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame) const
+{
+  if (!m_StreamFile)
+    return m_Frames[frame];
+
+  std::lock_guard<std::mutex> lk(m_StreamLock);
+
+  auto it = std::find_if(m_FrameCache.begin(), m_FrameCache.end(),
+                         [frame](const auto& entry) { return entry.first == frame; });
+  if (it != m_FrameCache.end())
+  {
+    m_FrameCache.splice(m_FrameCache.begin(), m_FrameCache, it);
+    return it->second;
+  }
+
+  // Failed reads aren't cached, so that they are reported every time the frame is needed
+  std::shared_ptr<const FifoFrameInfo> result = ReadStreamedFrame(frame, true);
+  if (!result)
+    return nullptr;
+
+  size_t size = result->fifoData.size();
+  for (const MemoryUpdate& update : result->memoryUpdates)
+    size += update.data.size();
+
+  // Always keep the newest frame, even if it's larger than the cache
+  while (!m_FrameCache.empty() && m_FrameCacheBytes + size > FRAME_CACHE_SIZE)
+  {
+    const FifoFrameInfo& evicted = *m_FrameCache.back().second;
+    m_FrameCacheBytes -= evicted.fifoData.size();
+    for (const MemoryUpdate& update : evicted.memoryUpdates)
+      m_FrameCacheBytes -= update.data.size();
+    m_FrameCache.pop_back();
+  }
+
+  m_FrameCache.emplace_front(frame, result);
+  m_FrameCacheBytes += size;
+  return result;
+}
+
+std::shared_ptr<const std::vector<u8>> FifoDataFile::GetFifoData(u32 frame) const
+{
+  std::shared_ptr<const FifoFrameInfo> frame_info;
+  if (!m_StreamFile)
+  {
+    frame_info = m_Frames[frame];
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lk(m_StreamLock);
+    auto it = std::find_if(m_FrameCache.begin(), m_FrameCache.end(),
+                           [frame](const auto& entry) { return entry.first == frame; });
+    frame_info = it != m_FrameCache.end() ? it->second : ReadStreamedFrame(frame, false);
+    if (!frame_info)
+      return nullptr;
+  }
+
+  return std::shared_ptr<const std::vector<u8>>(frame_info, &frame_info->fifoData);
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -98,12 +234,14 @@ bool FifoDataFile::Save(const std::string& filename)
   if (!file.Open(filename, "wb"))
     return false;
 
+  const u32 frameCount = GetFrameCount();
+
   // Add space for header
   PadFile(sizeof(FileHeader), file);
 
   // Add space for frame list
   u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
+  PadFile(frameCount * sizeof(FileCompressedFrame), file);
 
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem, BP_MEM_SIZE);
@@ -120,8 +258,73 @@ bool FifoDataFile::Save(const std::string& filename)
   u64 texMemOffset = file.Tell();
   file.WriteArray(m_TexMem, TEX_MEM_SIZE);
 
+  // Write frames. Games upload the same textures and vertex data over and over again, so each
+  // distinct memory update payload is only written once.
+  std::vector<FileCompressedFrame> frameList(frameCount);
+  std::vector<FilePayload> payloadList;
+  std::map<std::tuple<u64, u64, u32>, u32> payloadIndices;
+  std::vector<u8> block;
+  std::vector<u8> compressed;
+
+  for (u32 i = 0; i < frameCount; ++i)
+  {
+    const std::shared_ptr<const FifoFrameInfo> srcFrame = GetFrame(i);
+    if (!srcFrame)
+      return false;
+
+    block.assign(srcFrame->fifoData.begin(), srcFrame->fifoData.end());
+    block.reserve(block.size() + srcFrame->memoryUpdates.size() * sizeof(FileMemoryUpdateRef));
+
+    for (const MemoryUpdate& srcUpdate : srcFrame->memoryUpdates)
+    {
+      const u8* data = srcUpdate.data.data();
+      const u32 size = static_cast<u32>(srcUpdate.data.size());
+      const auto key = std::make_tuple(XXH64(data, size, 0), XXH64(data, size, PAYLOAD_HASH_SEED),
+                                       size);
+
+      auto payload = payloadIndices.find(key);
+      if (payload == payloadIndices.end())
+      {
+        CompressBlock(data, size, &compressed);
+
+        FilePayload dstPayload;
+        dstPayload.offset = file.Tell();
+        dstPayload.compressedSize = static_cast<u32>(compressed.size());
+        dstPayload.size = size;
+        file.WriteBytes(compressed.data(), compressed.size());
+
+        payload = payloadIndices.emplace(key, static_cast<u32>(payloadList.size())).first;
+        payloadList.push_back(dstPayload);
+      }
+
+      FileMemoryUpdateRef dstUpdate = {};
+      dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+      dstUpdate.address = srcUpdate.address;
+      dstUpdate.payloadIndex = payload->second;
+      dstUpdate.type = srcUpdate.type;
+
+      const u8* dstUpdateBytes = reinterpret_cast<const u8*>(&dstUpdate);
+      block.insert(block.end(), dstUpdateBytes, dstUpdateBytes + sizeof(dstUpdate));
+    }
+
+    CompressBlock(block.data(), block.size(), &compressed);
+
+    FileCompressedFrame& dstFrame = frameList[i];
+    dstFrame = {};
+    dstFrame.dataOffset = file.Tell();
+    dstFrame.compressedSize = static_cast<u32>(compressed.size());
+    dstFrame.fifoDataSize = static_cast<u32>(srcFrame->fifoData.size());
+    dstFrame.fifoStart = srcFrame->fifoStart;
+    dstFrame.fifoEnd = srcFrame->fifoEnd;
+    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame->memoryUpdates.size());
+    file.WriteBytes(compressed.data(), compressed.size());
+  }
+
+  u64 payloadListOffset = file.Tell();
+  file.WriteArray(payloadList.data(), payloadList.size());
+
   // Write header
-  FileHeader header;
+  FileHeader header = {};
   header.fileId = FILE_ID;
   header.file_version = VERSION_NUMBER;
   header.min_loader_version = MIN_LOADER_VERSION;
@@ -142,7 +345,10 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = frameCount;
+
+  header.payloadListOffset = payloadListOffset;
+  header.payloadCount = static_cast<u32>(payloadList.size());
 
   header.flags = m_Flags;
 
@@ -150,32 +356,10 @@ bool FifoDataFile::Save(const std::string& filename)
   file.WriteBytes(&header, sizeof(FileHeader));
 
   // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
-  {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
-
-    // Write FIFO data
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
-    dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
-
-    // Write frame info
-    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
-  }
+  file.Seek(frameListOffset, SEEK_SET);
+  file.WriteArray(frameList.data(), frameList.size());
 
-  if (!file.Close())
+  if (!file.IsGood() || !file.Close())
     return false;
 
   return true;
@@ -183,17 +367,17 @@ bool FifoDataFile::Save(const std::string& filename)
 
 std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bool flagsOnly)
 {
-  File::IOFile file;
-  file.Open(filename, "rb");
-  if (!file)
+  auto file = std::make_unique<File::IOFile>();
+  file->Open(filename, "rb");
+  if (!*file)
     return nullptr;
 
   FileHeader header;
-  file.ReadBytes(&header, sizeof(header));
+  file->ReadBytes(&header, sizeof(header));
 
   if (header.fileId != FILE_ID || header.min_loader_version > VERSION_NUMBER)
   {
-    file.Close();
+    file->Close();
     return nullptr;
   }
 
@@ -204,62 +388,213 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
 
   if (flagsOnly)
   {
-    file.Close();
+    file->Close();
     return dataFile;
   }
 
   u32 size = std::min<u32>(BP_MEM_SIZE, header.bpMemSize);
-  file.Seek(header.bpMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_BPMem, size);
+  file->Seek(header.bpMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_BPMem, size);
 
   size = std::min<u32>(CP_MEM_SIZE, header.cpMemSize);
-  file.Seek(header.cpMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_CPMem, size);
+  file->Seek(header.cpMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_CPMem, size);
 
   size = std::min<u32>(XF_MEM_SIZE, header.xfMemSize);
-  file.Seek(header.xfMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_XFMem, size);
+  file->Seek(header.xfMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_XFMem, size);
 
   size = std::min<u32>(XF_REGS_SIZE, header.xfRegsSize);
-  file.Seek(header.xfRegsOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_XFRegs, size);
+  file->Seek(header.xfRegsOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_XFRegs, size);
 
   // Texture memory saving was added in version 4.
   std::memset(dataFile->m_TexMem, 0, TEX_MEM_SIZE);
   if (dataFile->m_Version >= 4)
   {
     size = std::min<u32>(TEX_MEM_SIZE, header.texMemSize);
-    file.Seek(header.texMemOffset, SEEK_SET);
-    file.ReadArray(dataFile->m_TexMem, size);
+    file->Seek(header.texMemOffset, SEEK_SET);
+    file->ReadArray(dataFile->m_TexMem, size);
+  }
+
+  // Compressed frames are read when they are needed
+  if (dataFile->m_Version >= COMPRESSED_VERSION)
+  {
+    dataFile->m_StreamFile = std::move(file);
+    if (!dataFile->LoadStreamedIndex(header.frameListOffset, header.frameCount,
+                                     header.payloadListOffset, header.payloadCount))
+    {
+      return nullptr;
+    }
+
+    return dataFile;
   }
 
   // Read frames
   for (u32 i = 0; i < header.frameCount; ++i)
   {
     u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
+    file->Seek(frameOffset, SEEK_SET);
     FileFrameInfo srcFrame;
-    file.ReadBytes(&srcFrame, sizeof(FileFrameInfo));
+    file->ReadBytes(&srcFrame, sizeof(FileFrameInfo));
 
-    FifoFrameInfo dstFrame;
-    dstFrame.fifoData.resize(srcFrame.fifoDataSize);
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
+    auto dstFrame = std::make_shared<FifoFrameInfo>();
+    dstFrame->fifoData.resize(srcFrame.fifoDataSize);
+    dstFrame->fifoStart = srcFrame.fifoStart;
+    dstFrame->fifoEnd = srcFrame.fifoEnd;
 
-    file.Seek(srcFrame.fifoDataOffset, SEEK_SET);
-    file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
+    file->Seek(srcFrame.fifoDataOffset, SEEK_SET);
+    file->ReadBytes(dstFrame->fifoData.data(), srcFrame.fifoDataSize);
 
     ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-                      dstFrame.memoryUpdates, file);
+                      dstFrame->memoryUpdates, *file);
 
-    dataFile->AddFrame(dstFrame);
+    dataFile->m_Frames.push_back(std::move(dstFrame));
   }
 
-  file.Close();
+  file->Close();
 
   return dataFile;
 }
 
+bool FifoDataFile::LoadStreamedIndex(u64 frameListOffset, u32 frameCount, u64 payloadListOffset,
+                                     u32 payloadCount)
+{
+  File::IOFile& file = *m_StreamFile;
+  const u64 fileSize = file.GetSize();
+  if (frameListOffset + u64(frameCount) * sizeof(FileCompressedFrame) > fileSize ||
+      payloadListOffset + u64(payloadCount) * sizeof(FilePayload) > fileSize)
+  {
+    return false;
+  }
+
+  std::vector<FileCompressedFrame> frames(frameCount);
+  file.Seek(frameListOffset, SEEK_SET);
+  if (!file.ReadArray(frames.data(), frames.size()))
+    return false;
+
+  std::vector<FilePayload> payloads(payloadCount);
+  file.Seek(payloadListOffset, SEEK_SET);
+  if (!file.ReadArray(payloads.data(), payloads.size()))
+    return false;
+
+  m_StreamedFrames.reserve(frameCount);
+  for (const FileCompressedFrame& frame : frames)
+  {
+    m_StreamedFrames.push_back({frame.dataOffset, frame.compressedSize, frame.fifoDataSize,
+                                frame.fifoStart, frame.fifoEnd, frame.numMemoryUpdates});
+  }
+
+  m_StreamedPayloads.reserve(payloadCount);
+  for (const FilePayload& payload : payloads)
+    m_StreamedPayloads.push_back({payload.offset, payload.compressedSize, payload.size});
+
+  return true;
+}
+
+bool FifoDataFile::ReadStreamedBlock(u64 offset, u32 compressedSize, u32 size,
+                                     std::vector<u8>* out) const
+{
+  // A failed read shouldn't make every later read fail too
+  m_StreamFile->Clear();
+
+  out->resize(size);
+  if (compressedSize == size)
+    return m_StreamFile->Seek(offset, SEEK_SET) && m_StreamFile->ReadBytes(out->data(), size);
+
+  std::vector<u8> compressed(compressedSize);
+  if (!m_StreamFile->Seek(offset, SEEK_SET) ||
+      !m_StreamFile->ReadBytes(compressed.data(), compressedSize))
+  {
+    return false;
+  }
+
+  uLongf decompressedSize = size;
+  return uncompress(out->data(), &decompressedSize, compressed.data(), compressedSize) == Z_OK &&
+         decompressedSize == size;
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::ReadStreamedFrame(u32 frame,
+                                                                     bool includeMemory) const
+{
+  const StreamedFrame& srcFrame = m_StreamedFrames[frame];
+  auto dstFrame = std::make_shared<FifoFrameInfo>();
+  dstFrame->fifoStart = srcFrame.fifoStart;
+  dstFrame->fifoEnd = srcFrame.fifoEnd;
+
+  std::vector<u8> block;
+  const u64 blockSize =
+      srcFrame.fifoDataSize + u64(srcFrame.numMemoryUpdates) * sizeof(FileMemoryUpdateRef);
+  if (blockSize > UINT32_MAX ||
+      !ReadStreamedBlock(srcFrame.offset, srcFrame.compressedSize, static_cast<u32>(blockSize),
+                         &block))
+  {
+    ERROR_LOG(VIDEO, "Failed to read frame %u of the FIFO log", frame);
+    return nullptr;
+  }
+
+  dstFrame->fifoData.assign(block.begin(), block.begin() + srcFrame.fifoDataSize);
+
+  dstFrame->memoryUpdates.resize(srcFrame.numMemoryUpdates);
+  for (u32 i = 0; i < srcFrame.numMemoryUpdates; ++i)
+  {
+    FileMemoryUpdateRef srcUpdate;
+    std::memcpy(&srcUpdate, &block[srcFrame.fifoDataSize + i * sizeof(FileMemoryUpdateRef)],
+                sizeof(FileMemoryUpdateRef));
+
+    MemoryUpdate& dstUpdate = dstFrame->memoryUpdates[i];
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+
+    if (!includeMemory)
+      continue;
+
+    const std::shared_ptr<const std::vector<u8>> payload = GetPayload(srcUpdate.payloadIndex);
+    if (!payload)
+    {
+      ERROR_LOG(VIDEO, "Failed to read a memory update of frame %u of the FIFO log", frame);
+      return nullptr;
+    }
+
+    dstUpdate.data = *payload;
+  }
+
+  return dstFrame;
+}
+
+std::shared_ptr<const std::vector<u8>> FifoDataFile::GetPayload(u32 index) const
+{
+  if (index >= m_StreamedPayloads.size())
+    return nullptr;
+
+  auto it = std::find_if(m_PayloadCache.begin(), m_PayloadCache.end(),
+                         [index](const auto& entry) { return entry.first == index; });
+  if (it != m_PayloadCache.end())
+  {
+    m_PayloadCache.splice(m_PayloadCache.begin(), m_PayloadCache, it);
+    return it->second;
+  }
+
+  const StreamedPayload& srcPayload = m_StreamedPayloads[index];
+  auto payload = std::make_shared<std::vector<u8>>();
+  if (!ReadStreamedBlock(srcPayload.offset, srcPayload.compressedSize, srcPayload.size,
+                         payload.get()))
+  {
+    return nullptr;
+  }
+
+  while (!m_PayloadCache.empty() && m_PayloadCacheBytes + payload->size() > PAYLOAD_CACHE_SIZE)
+  {
+    m_PayloadCacheBytes -= m_PayloadCache.back().second->size();
+    m_PayloadCache.pop_back();
+  }
+
+  m_PayloadCache.emplace_front(index, payload);
+  m_PayloadCacheBytes += payload->size();
+  return payload;
+}
+
 void FifoDataFile::PadFile(size_t numBytes, File::IOFile& file)
 {
   for (size_t i = 0; i < numBytes; ++i)
@@ -279,37 +614,6 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
-{
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
-
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
-
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
-
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
-
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
-  }
-
-  return updateListOffset;
-}
-
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                      std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
 {
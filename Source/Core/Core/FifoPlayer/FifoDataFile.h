@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -67,8 +70,13 @@ public:
   u32* GetXFRegs() { return m_XFRegs; }
   u8* GetTexMem() { return m_TexMem; }
   void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
-  u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
+  // Frames of compressed files are read from disk when they are needed and only a few of them are
+  // kept in memory, so the returned pointer must be held for as long as the frame is used.
+  // Returns nullptr if the frame can't be read from the file.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame) const;
+  // Skips reading the memory updates, which is much faster for compressed files
+  std::shared_ptr<const std::vector<u8>> GetFifoData(u32 frame) const;
+  u32 GetFrameCount() const;
   bool Save(const std::string& filename);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
@@ -84,10 +92,34 @@ private:
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
   static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                 std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
 
+  // Files since version 5 store frames compressed, with each distinct memory update payload
+  // stored once, and are streamed from disk
+  struct StreamedFrame
+  {
+    u64 offset;
+    u32 compressedSize;
+    u32 fifoDataSize;
+    u32 fifoStart;
+    u32 fifoEnd;
+    u32 numMemoryUpdates;
+  };
+
+  struct StreamedPayload
+  {
+    u64 offset;
+    u32 compressedSize;
+    u32 size;
+  };
+
+  bool LoadStreamedIndex(u64 frameListOffset, u32 frameCount, u64 payloadListOffset,
+                         u32 payloadCount);
+  bool ReadStreamedBlock(u64 offset, u32 compressedSize, u32 size, std::vector<u8>* out) const;
+  std::shared_ptr<const FifoFrameInfo> ReadStreamedFrame(u32 frame, bool includeMemory) const;
+  std::shared_ptr<const std::vector<u8>> GetPayload(u32 index) const;
+
   u32 m_BPMem[BP_MEM_SIZE];
   u32 m_CPMem[CP_MEM_SIZE];
   u32 m_XFMem[XF_MEM_SIZE];
@@ -97,5 +129,19 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  // Frames that are held in memory, either because they were recorded or because the file
+  // is in an uncompressed format
+  std::vector<std::shared_ptr<FifoFrameInfo>> m_Frames;
+
+  std::unique_ptr<File::IOFile> m_StreamFile;
+  std::vector<StreamedFrame> m_StreamedFrames;
+  std::vector<StreamedPayload> m_StreamedPayloads;
+  // Guards m_StreamFile and the caches, since the FIFO player dialogs read frames while the
+  // FIFO player is running
+  mutable std::mutex m_StreamLock;
+  // Most recently used first
+  mutable std::list<std::pair<u32, std::shared_ptr<const FifoFrameInfo>>> m_FrameCache;
+  mutable std::list<std::pair<u32, std::shared_ptr<const std::vector<u8>>>> m_PayloadCache;
+  mutable size_t m_FrameCacheBytes = 0;
+  mutable size_t m_PayloadCacheBytes = 0;
 };
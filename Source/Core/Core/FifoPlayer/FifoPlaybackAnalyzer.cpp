@@ -4,6 +4,7 @@
 
 #include "Core/FifoPlayer/FifoPlaybackAnalyzer.h"
 
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -40,37 +41,32 @@ void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
 
   for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
   {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
+    // Memory updates aren't needed for the analysis
+    const std::shared_ptr<const std::vector<u8>> fifoData = file->GetFifoData(frameIdx);
+    if (!fifoData)
+      return;
+
     AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
 
     s_DrawingObject = false;
 
     u32 cmdStart = 0;
-    u32 nextMemUpdate = 0;
 
 #if LOG_FIFO_CMDS
     // Debugging
     std::vector<CmdData> prevCmds;
 #endif
 
-    while (cmdStart < frame.fifoData.size())
+    while (cmdStart < fifoData->size())
     {
-      // Add memory updates that have occurred before this point in the frame
-      while (nextMemUpdate < frame.memoryUpdates.size() &&
-             frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-      {
-        analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-        ++nextMemUpdate;
-      }
-
       bool wasDrawing = s_DrawingObject;
 
-      u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DECODE_PLAYBACK);
+      u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&(*fifoData)[cmdStart], DECODE_PLAYBACK);
 
 #if LOG_FIFO_CMDS
       CmdData cmdData;
       cmdData.offset = cmdStart;
-      cmdData.ptr = &frame.fifoData[cmdStart];
+      cmdData.ptr = &(*fifoData)[cmdStart];
       cmdData.size = cmdSize;
       prevCmds.push_back(cmdData);
 #endif
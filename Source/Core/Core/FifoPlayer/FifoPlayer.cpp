@@ -5,6 +5,7 @@
 #include "Core/FifoPlayer/FifoPlayer.h"
 
 #include <algorithm>
+#include <memory>
 #include <mutex>
 
 #include "Common/Assert.h"
@@ -13,6 +14,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/FifoPlayer/FifoAnalyzer.h"
+#include "Core/FifoPlayer/FifoBenchmark.h"
 #include "Core/FifoPlayer/FifoDataFile.h"
 #include "Core/HW/CPU.h"
 #include "Core/HW/GPFifo.h"
@@ -80,6 +82,7 @@ public:
     IsPlayingBackFifologWithBrokenEFBCopies = m_parent->m_File->HasBrokenEFBCopies();
 
     m_parent->m_CurrentFrame = m_parent->m_FrameRangeStart;
+    m_parent->m_CompletedLoops = 0;
     m_parent->LoadMemory();
   }
 
@@ -127,7 +130,8 @@ CPU::State FifoPlayer::AdvanceFrame()
 {
   if (m_CurrentFrame >= m_FrameRangeEnd)
   {
-    if (!m_Loop)
+    ++m_CompletedLoops;
+    if (m_LoopCount != 0 ? m_CompletedLoops >= m_LoopCount : !m_Loop)
       return CPU::State::PowerDown;
     // If there are zero frames in the range then sleep instead of busy spinning
     if (m_FrameRangeStart >= m_FrameRangeEnd)
@@ -148,7 +152,14 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(m_CurrentFrame);
+  if (!frame)
+  {
+    PanicAlertT("Failed to read frame %u of the FIFO log.", m_CurrentFrame);
+    return CPU::State::PowerDown;
+  }
+
+  WriteFrame(*frame, m_FrameInfo[m_CurrentFrame]);
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -224,6 +235,8 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
   u32 drawStart = std::min(numObjects, m_ObjectRangeStart);
   u32 drawEnd = std::min(numObjects - 1, m_ObjectRangeEnd);
 
+  FifoBenchmark::BeginFrame(m_CurrentFrame, drawStart);
+
   u32 position = 0;
   u32 memoryUpdate = 0;
 
@@ -276,6 +289,8 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     CoreTiming::Idle();
     CoreTiming::Advance();
   }
+
+  FifoBenchmark::EndFrame();
 }
 
 void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
@@ -285,7 +300,7 @@ void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
 
   while (nextMemUpdate < frame.memoryUpdates.size() && dataStart < dataEnd)
   {
-    const MemoryUpdate& memUpdate = info.memoryUpdates[nextMemUpdate];
+    const MemoryUpdate& memUpdate = frame.memoryUpdates[nextMemUpdate];
 
     if (memUpdate.fifoPosition < dataEnd)
     {
@@ -316,8 +331,11 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    if (!frame)
+      continue;
+
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -372,7 +390,12 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  // AdvanceFrame reports the failure if the frame can't be read
+  const std::shared_ptr<const FifoFrameInfo> frame_ptr = m_File->GetFrame(m_CurrentFrame);
+  if (!frame_ptr)
+    return;
+
+  const FifoFrameInfo& frame = *frame_ptr;
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
@@ -89,6 +89,9 @@ public:
   // If enabled then all memory updates happen at once before the first frame
   // Default is disabled
   void SetEarlyMemoryUpdates(bool enabled) { m_EarlyMemoryUpdates = enabled; }
+  // Stops playback after the frame range has been played the given number of times.
+  // If 0, the LoopReplay setting decides whether the frame range is played more than once.
+  void SetLoopCount(u32 count) { m_LoopCount = count; }
   // Callbacks
   void SetFileLoadedCallback(CallbackFunc callback) { m_FileLoadedCb = callback; }
   void SetFrameWrittenCallback(CallbackFunc callback) { m_FrameWrittenCb = callback; }
@@ -134,6 +137,8 @@ private:
   static bool IsHighWatermarkSet();
 
   bool m_Loop;
+  u32 m_LoopCount = 0;
+  u32 m_CompletedLoops = 0;
 
   u32 m_CurrentFrame = 0;
   u32 m_FrameRangeStart = 0;
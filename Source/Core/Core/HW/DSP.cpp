@@ -30,6 +30,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/MemoryUtil.h"
+#include "Core/Benchmark.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -422,6 +423,7 @@ void GenerateDSPInterruptFromDSPEmu(DSPInterruptType type, int cycles_into_futur
 // called whenever SystemTimers thinks the DSP deserves a few more cycles
 void UpdateDSPSlice(int cycles)
 {
+  Benchmark::ScopedTimer timer(Benchmark::Counter::DSP);
   if (s_dsp_is_lle)
   {
     // use up the rest of the slice(if any)
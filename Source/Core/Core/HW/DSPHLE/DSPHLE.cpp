@@ -7,6 +7,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
+#include "Common/Trace.h"
 #include "Core/Core.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 #include "Core/HW/SystemTimers.h"
@@ -50,6 +51,8 @@ void DSPHLE::Shutdown()
 
 void DSPHLE::DSP_Update(int cycles)
 {
+  Common::Trace::ScopedZone trace_zone("DSPHLE::Update");
+
   if (m_ucode != nullptr)
     m_ucode->Update();
 }
@@ -0,0 +1,335 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HW/DVD/DVDPrefetcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "DiscIO/Volume.h"
+
+namespace DVDThread
+{
+// Two blocks of decrypted Wii partition data, so that aligned prefetches of Wii partitions
+// can be decrypted without touching any block twice
+constexpr u64 CHUNK_SIZE = 0xF800;
+// The largest amount of data read by a single call to DoPendingWork
+constexpr u64 MAX_STEP_CHUNKS = 8;
+
+// Sequential read-ahead starts small and doubles with each read that continues the stream
+constexpr u64 MIN_READAHEAD = 0x20000;
+constexpr u64 MAX_READAHEAD = 0x400000;
+constexpr u32 MAX_STRIDE_PREDICTIONS = 4;
+
+constexpr u32 TRACE_LOOKAHEAD = 8;
+constexpr u32 MAX_TRACE_ENTRIES = 0x10000;
+constexpr u32 TRACE_MAGIC = 0x43525444;  // "DTRC"
+constexpr u32 TRACE_VERSION = 1;
+
+struct TraceHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_entries;
+  u32 reserved;
+};
+
+void Prefetcher::SetDisc(const DiscIO::Volume* volume, bool enabled, u64 cache_size,
+                         bool use_traces)
+{
+  if (m_use_traces)
+    SaveTrace();
+
+  m_cache.clear();
+  m_lru.clear();
+  m_pending.clear();
+
+  m_last_read = {};
+  m_last_stride = 0;
+  m_sequential_hits = 0;
+  m_stride_hits = 0;
+
+  m_trace_path.clear();
+  m_trace.clear();
+  m_trace_positions.clear();
+  m_trace_cursor = 0;
+  m_recorded_trace.clear();
+
+  m_stats = {};
+
+  m_max_chunks = cache_size / CHUNK_SIZE;
+  m_enabled = enabled && volume && m_max_chunks != 0;
+  m_use_traces = false;
+
+  if (m_enabled && use_traces)
+  {
+    const std::string game_id = volume->GetGameID();
+    if (!game_id.empty())
+    {
+      m_use_traces = true;
+      m_trace_path = File::GetUserPath(D_CACHE_IDX) + "DVDTraces/" +
+                     StringFromFormat("%s_r%u_d%u.trace", game_id.c_str(),
+                                      volume->GetRevision().value_or(0),
+                                      volume->GetDiscNumber().value_or(0));
+      LoadTrace();
+    }
+  }
+}
+
+bool Prefetcher::Read(const DiscIO::Volume& volume, const DiscIO::Partition& partition,
+                      u64 offset, u64 length, u8* out_ptr)
+{
+  if (!m_enabled)
+    return volume.Read(offset, length, out_ptr, partition);
+
+  Learn(partition.offset, offset, length);
+  m_stats.requested_bytes += length;
+
+  const u64 end = offset + length;
+  u64 position = offset;
+  while (position < end)
+  {
+    const ChunkKey key(partition.offset, position / CHUNK_SIZE);
+    const u64 chunk_end = std::min(end, (key.second + 1) * CHUNK_SIZE);
+
+    if (const CachedChunk* chunk = FindChunk(key))
+    {
+      std::memcpy(out_ptr + (position - offset), chunk->data.data() + position % CHUNK_SIZE,
+                  static_cast<size_t>(chunk_end - position));
+      m_stats.cached_bytes += chunk_end - position;
+      position = chunk_end;
+      continue;
+    }
+
+    // Read all consecutive chunks that aren't cached with a single call
+    u64 run_end = chunk_end;
+    while (run_end < end && !m_cache.count(ChunkKey(partition.offset, run_end / CHUNK_SIZE)))
+      run_end = std::min(end, run_end + CHUNK_SIZE);
+
+    if (!volume.Read(position, run_end - position, out_ptr + (position - offset), partition))
+      return false;
+    position = run_end;
+  }
+
+  return true;
+}
+
+void Prefetcher::DoPendingWork(const DiscIO::Volume& volume)
+{
+  if (m_pending.empty())
+    return;
+
+  Range& range = m_pending.front();
+  u64 first_chunk = range.offset / CHUNK_SIZE;
+  const u64 last_chunk = (range.offset + range.length - 1) / CHUNK_SIZE;
+
+  while (first_chunk <= last_chunk && m_cache.count(ChunkKey(range.partition, first_chunk)))
+    ++first_chunk;
+
+  if (first_chunk > last_chunk)
+  {
+    m_pending.pop_front();
+    return;
+  }
+
+  u64 num_chunks = 1;
+  while (num_chunks < MAX_STEP_CHUNKS && first_chunk + num_chunks <= last_chunk &&
+         !m_cache.count(ChunkKey(range.partition, first_chunk + num_chunks)))
+  {
+    ++num_chunks;
+  }
+
+  std::vector<u8> buffer(num_chunks * CHUNK_SIZE);
+  if (!volume.Read(first_chunk * CHUNK_SIZE, buffer.size(), buffer.data(),
+                   DiscIO::Partition(range.partition)))
+  {
+    // Most likely the end of the disc or partition. Whatever the game reads there
+    // will be read directly.
+    m_pending.pop_front();
+    return;
+  }
+
+  for (u64 i = 0; i < num_chunks; ++i)
+  {
+    const auto chunk_begin = buffer.begin() + i * CHUNK_SIZE;
+    InsertChunk(ChunkKey(range.partition, first_chunk + i),
+                std::vector<u8>(chunk_begin, chunk_begin + CHUNK_SIZE));
+  }
+  m_stats.prefetched_bytes += buffer.size();
+
+  const u64 range_end = range.offset + range.length;
+  const u64 done_end = (first_chunk + num_chunks) * CHUNK_SIZE;
+  if (done_end >= range_end)
+  {
+    m_pending.pop_front();
+  }
+  else
+  {
+    range.length = range_end - done_end;
+    range.offset = done_end;
+  }
+}
+
+const Prefetcher::CachedChunk* Prefetcher::FindChunk(const ChunkKey& key)
+{
+  auto it = m_cache.find(key);
+  if (it == m_cache.end())
+    return nullptr;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lru_position);
+  return &it->second;
+}
+
+void Prefetcher::InsertChunk(const ChunkKey& key, std::vector<u8> data)
+{
+  while (m_cache.size() >= m_max_chunks)
+  {
+    m_cache.erase(m_lru.back());
+    m_lru.pop_back();
+  }
+
+  m_lru.push_front(key);
+  m_cache.emplace(key, CachedChunk{std::move(data), m_lru.begin()});
+}
+
+void Prefetcher::Learn(u64 partition, u64 offset, u64 length)
+{
+  if (m_use_traces && m_recorded_trace.size() < MAX_TRACE_ENTRIES)
+    m_recorded_trace.push_back({partition, offset, length});
+
+  // Only the newest predictions are worth acting on
+  m_pending.clear();
+
+  PredictFromTrace(partition, offset, length);
+  PredictFromPattern(partition, offset, length);
+
+  m_last_read = {partition, offset, length};
+}
+
+void Prefetcher::PredictFromPattern(u64 partition, u64 offset, u64 length)
+{
+  if (m_last_read.partition == partition && m_last_read.length != 0)
+  {
+    if (offset == m_last_read.offset + m_last_read.length)
+    {
+      ++m_sequential_hits;
+      m_stride_hits = 0;
+    }
+    else
+    {
+      const s64 stride = static_cast<s64>(offset - m_last_read.offset);
+      m_sequential_hits = 0;
+      m_stride_hits = stride != 0 && stride == m_last_stride ? m_stride_hits + 1 : 0;
+      m_last_stride = stride;
+    }
+  }
+  else
+  {
+    m_sequential_hits = 0;
+    m_stride_hits = 0;
+    m_last_stride = 0;
+  }
+
+  // Leave room in the cache for the data that the game is currently working with
+  const u64 budget = std::min(MAX_READAHEAD, m_max_chunks * CHUNK_SIZE / 2);
+
+  if (m_sequential_hits != 0)
+  {
+    const u64 window = MIN_READAHEAD << std::min(m_sequential_hits - 1, 5u);
+    m_pending.push_back({partition, offset + length, std::min(window, budget)});
+  }
+  else if (m_stride_hits != 0 && length <= budget)
+  {
+    u64 next_offset = offset;
+    for (u32 i = 0; i < MAX_STRIDE_PREDICTIONS && (i + 1) * length <= budget; ++i)
+    {
+      next_offset += m_last_stride;
+      // Stop before wrapping around the start of the disc
+      if ((m_last_stride < 0) != (next_offset < offset))
+        break;
+      m_pending.push_back({partition, next_offset, length});
+    }
+  }
+}
+
+void Prefetcher::PredictFromTrace(u64 partition, u64 offset, u64 length)
+{
+  const auto it = m_trace_positions.find({partition, offset});
+  if (it == m_trace_positions.end())
+    return;
+
+  // Prefer the first occurrence after the previous match, since games tend to
+  // read the same files in the same order every time they are played
+  const std::vector<u32>& positions = it->second;
+  auto position_it = std::lower_bound(positions.begin(), positions.end(), m_trace_cursor);
+  const u32 position = position_it != positions.end() ? *position_it : positions.front();
+  m_trace_cursor = position + 1;
+
+  const u64 budget = m_max_chunks * CHUNK_SIZE / 2;
+  u64 bytes = 0;
+  for (u32 i = position + 1; i < m_trace.size() && i <= position + TRACE_LOOKAHEAD; ++i)
+  {
+    bytes += m_trace[i].length;
+    if (bytes > budget)
+      break;
+    m_pending.push_back(m_trace[i]);
+  }
+}
+
+void Prefetcher::LoadTrace()
+{
+  File::IOFile file(m_trace_path, "rb");
+  if (!file)
+    return;
+
+  TraceHeader header;
+  if (!file.ReadArray(&header, 1) || header.magic != TRACE_MAGIC ||
+      header.version != TRACE_VERSION || header.num_entries > MAX_TRACE_ENTRIES)
+  {
+    WARN_LOG(DVDINTERFACE, "Ignoring invalid DVD read trace %s", m_trace_path.c_str());
+    return;
+  }
+
+  m_trace.resize(header.num_entries);
+  if (!file.ReadArray(m_trace.data(), m_trace.size()))
+  {
+    WARN_LOG(DVDINTERFACE, "Ignoring truncated DVD read trace %s", m_trace_path.c_str());
+    m_trace.clear();
+    return;
+  }
+
+  for (u32 i = 0; i < m_trace.size(); ++i)
+    m_trace_positions[{m_trace[i].partition, m_trace[i].offset}].push_back(i);
+
+  INFO_LOG(DVDINTERFACE, "Loaded DVD read trace with %zu reads from %s", m_trace.size(),
+           m_trace_path.c_str());
+}
+
+void Prefetcher::SaveTrace() const
+{
+  // A longer trace covers more of the game, so don't replace one with a shorter recording
+  if (m_trace_path.empty() || m_recorded_trace.size() <= m_trace.size())
+    return;
+
+  File::CreateFullPath(m_trace_path);
+  File::IOFile file(m_trace_path, "wb");
+  const TraceHeader header{TRACE_MAGIC, TRACE_VERSION, static_cast<u32>(m_recorded_trace.size()),
+                           0};
+  if (!file.WriteArray(&header, 1) ||
+      !file.WriteArray(m_recorded_trace.data(), m_recorded_trace.size()))
+  {
+    ERROR_LOG(DVDINTERFACE, "Failed to write DVD read trace %s", m_trace_path.c_str());
+  }
+}
+}  // namespace DVDThread
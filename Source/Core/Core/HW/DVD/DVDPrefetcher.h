@@ -0,0 +1,111 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DiscIO
+{
+struct Partition;
+class Volume;
+}
+
+// Predictive read-ahead for the DVD thread.
+//
+// The prefetcher watches the reads issued by the emulated software and guesses which data will
+// be read next, either from sequential and strided access patterns or from a trace of the reads
+// made the last time the same game was played. The DVD thread reads the guessed data into a
+// bounded cache while it has nothing else to do, so that slow images (compressed, on a network
+// share, ...) don't stall FinishRead on the CPU thread. It doesn't affect emulated timings.
+//
+// All functions except Clear/SetDisc/CancelPendingWork must be called on the DVD thread.
+// Those three must only be called while the DVD thread isn't working.
+
+namespace DVDThread
+{
+class Prefetcher
+{
+public:
+  struct Stats
+  {
+    u64 requested_bytes = 0;
+    u64 cached_bytes = 0;     // Bytes that were served from the cache
+    u64 prefetched_bytes = 0;
+  };
+
+  // Drops everything that was learned about the previous disc. If use_traces is set,
+  // the trace of the previous disc is saved and the trace of the new one is loaded.
+  void SetDisc(const DiscIO::Volume* volume, bool enabled, u64 cache_size, bool use_traces);
+  void Clear() { SetDisc(nullptr, false, 0, false); }
+
+  // Reads data for the emulated software, using the cache where possible.
+  bool Read(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 offset,
+            u64 length, u8* out_ptr);
+
+  bool HasPendingWork() const { return !m_pending.empty(); }
+  // Prefetches a small amount of data, so that new requests don't have to wait for long
+  void DoPendingWork(const DiscIO::Volume& volume);
+  void CancelPendingWork() { m_pending.clear(); }
+
+  const Stats& GetStats() const { return m_stats; }
+
+private:
+  struct Range
+  {
+    u64 partition;
+    u64 offset;
+    u64 length;
+  };
+
+  // A (partition offset, chunk index) pair
+  using ChunkKey = std::pair<u64, u64>;
+
+  struct CachedChunk
+  {
+    std::vector<u8> data;
+    std::list<ChunkKey>::iterator lru_position;
+  };
+
+  const CachedChunk* FindChunk(const ChunkKey& key);
+  void InsertChunk(const ChunkKey& key, std::vector<u8> data);
+
+  void Learn(u64 partition, u64 offset, u64 length);
+  void PredictFromPattern(u64 partition, u64 offset, u64 length);
+  void PredictFromTrace(u64 partition, u64 offset, u64 length);
+
+  void LoadTrace();
+  void SaveTrace() const;
+
+  bool m_enabled = false;
+  u64 m_max_chunks = 0;
+
+  std::map<ChunkKey, CachedChunk> m_cache;
+  std::list<ChunkKey> m_lru;  // Most recently used first
+  std::deque<Range> m_pending;
+
+  // Pattern detection
+  Range m_last_read{};
+  s64 m_last_stride = 0;
+  u32 m_sequential_hits = 0;
+  u32 m_stride_hits = 0;
+
+  // Read traces
+  bool m_use_traces = false;
+  std::string m_trace_path;
+  std::vector<Range> m_trace;
+  std::map<std::pair<u64, u64>, std::vector<u32>> m_trace_positions;
+  u32 m_trace_cursor = 0;
+  std::vector<Range> m_recorded_trace;
+
+  Stats m_stats;
+};
+}  // namespace DVDThread
@@ -4,6 +4,7 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <map>
 #include <memory>
@@ -22,11 +23,13 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/DVD/DVDInterface.h"
+#include "Core/HW/DVD/DVDPrefetcher.h"
 #include "Core/HW/DVD/FileMonitor.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
@@ -40,6 +43,9 @@ namespace DVDThread
 struct ReadRequest
 {
   bool copy_to_ram;
+  // If set, the DVD thread didn't read the data. FinishRead copies it straight from
+  // the disc image instead (see BlobReader::GetDirectPointer).
+  bool read_directly;
   u32 output_address;
   u64 dvd_offset;
   u32 length;
@@ -89,11 +95,13 @@ static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// Only used by the DVD thread, except while it is idle
+static Prefetcher s_prefetcher;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
 
-  s_request_queue_expanded.Reset();
   s_result_queue_expanded.Reset();
   s_request_queue.Clear();
   s_result_queue.Clear();
@@ -109,12 +117,30 @@ static void StartDVDThread()
 {
   _assert_(!s_dvd_thread.joinable());
   s_dvd_thread_exiting.Clear();
+
+  // Predictions are made again once the next request comes in. Not carrying them over
+  // keeps the DVD thread from touching s_disc until then, which WaitUntilIdle relies on.
+  // The wakeup left over from stopping the previous thread would defeat that, so drop it too.
+  s_prefetcher.CancelPendingWork();
+  s_request_queue_expanded.Reset();
+
   s_dvd_thread = std::thread(DVDThread);
 }
 
 void Stop()
 {
   StopDVDThread();
+
+  const Prefetcher::Stats& stats = s_prefetcher.GetStats();
+  if (stats.requested_bytes != 0)
+  {
+    INFO_LOG(DVDINTERFACE,
+             "DVD prefetching: %" PRIu64 " of %" PRIu64 " read bytes came from the cache, "
+             "%" PRIu64 " bytes were prefetched",
+             stats.cached_bytes, stats.requested_bytes, stats.prefetched_bytes);
+  }
+  s_prefetcher.Clear();
+
   s_disc.reset();
 }
 
@@ -161,7 +187,7 @@ void DoState(PointerWrap& p)
     if (had_disc)
       PanicAlertT("An inserted disc was expected but not found.");
     else
-      s_disc.reset();
+      SetDisc(nullptr);
   }
 
   // TODO: Savestates can be smaller if the buffers of results aren't saved,
@@ -179,6 +205,11 @@ void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+
+  const SConfig& config = SConfig::GetInstance();
+  s_prefetcher.SetDisc(s_disc.get(), config.bDVDPrefetch,
+                       static_cast<u64>(std::max(config.iDVDPrefetchCacheSize, 0)) * 1024 * 1024,
+                       config.bDVDReadTraces);
 }
 
 bool HasDisc()
@@ -256,6 +287,7 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
   ReadRequest request;
 
   request.copy_to_ram = copy_to_ram;
+  request.read_directly = false;
   request.output_address = output_address;
   request.dvd_offset = dvd_offset;
   request.length = length;
@@ -309,7 +341,7 @@ static void FinishRead(u64 id, s64 cycles_late)
   // We have now obtained the right ReadResult.
 
   const ReadRequest& request = result.first;
-  const std::vector<u8>& buffer = result.second;
+  std::vector<u8>& buffer = result.second;
 
   DEBUG_LOG(DVDINTERFACE, "Disc has been read. Real time: %" PRIu64 " us. "
                           "Real time including delay: %" PRIu64 " us. "
@@ -319,7 +351,27 @@ static void FinishRead(u64 id, s64 cycles_late)
             (CoreTiming::GetTicks() - request.time_started_ticks) /
                 (SystemTimers::GetTicksPerSecond() / 1000000));
 
-  if (buffer.size() != request.length)
+  const u8* data = buffer.data();
+  bool success = buffer.size() == request.length;
+  if (request.read_directly)
+  {
+    data = s_disc ? s_disc->GetDirectPointer(request.dvd_offset, request.length,
+                                             request.partition) :
+                    nullptr;
+    success = data != nullptr;
+
+    // This only fails if a savestate was made by a Dolphin instance that could map the disc
+    // image and loaded by one that can't, so reading synchronously is good enough.
+    if (!success && s_disc)
+    {
+      WaitUntilIdle();
+      buffer.resize(request.length);
+      success = s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition);
+      data = buffer.data();
+    }
+  }
+
+  if (!success)
   {
     PanicAlertT("The disc could not be read (at 0x%" PRIx64 " - 0x%" PRIx64 ").",
                 request.dvd_offset, request.dvd_offset + request.length);
@@ -327,7 +379,7 @@ static void FinishRead(u64 id, s64 cycles_late)
   else
   {
     if (request.copy_to_ram)
-      Memory::CopyToEmu(request.output_address, buffer.data(), request.length);
+      Memory::CopyToEmu(request.output_address, data, request.length);
   }
 
   // Notify the emulated software that the command has been executed
@@ -335,13 +387,29 @@ static void FinishRead(u64 id, s64 cycles_late)
                                        buffer);
 }
 
+// Makes the OS load mapped data from disk on the calling thread,
+// so that the thread that copies the data later doesn't stall
+static void PrefaultPages(const u8* data, u32 length)
+{
+  constexpr u32 PREFAULT_STRIDE = 0x1000;  // The smallest common page size
+  u8 sum = 0;
+  for (u32 i = 0; i < length; i += PREFAULT_STRIDE)
+    sum += static_cast<const volatile u8*>(data)[i];
+  if (length != 0)
+    sum += static_cast<const volatile u8*>(data)[length - 1];
+  static_cast<void>(sum);
+}
+
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
 
   while (true)
   {
-    s_request_queue_expanded.Wait();
+    // Prefetching happens in small steps while there are no requests, so don't block if
+    // there is more to prefetch
+    if (!s_prefetcher.HasPendingWork())
+      s_request_queue_expanded.Wait();
 
     if (s_dvd_thread_exiting.IsSet())
       return;
@@ -349,11 +417,32 @@ static void DVDThread()
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
+      Common::Trace::ScopedZone trace_zone("DVD read");
+
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
-      std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      // Data that goes to emulated RAM and can be accessed in place is copied there directly
+      // by FinishRead, saving a copy. The DVD thread still makes sure the data is in memory.
+      const u8* direct_data =
+          request.copy_to_ram ?
+              s_disc->GetDirectPointer(request.dvd_offset, request.length, request.partition) :
+              nullptr;
+
+      std::vector<u8> buffer;
+      if (direct_data)
+      {
+        PrefaultPages(direct_data, request.length);
+        request.read_directly = true;
+      }
+      else
+      {
+        buffer.resize(request.length);
+        if (!s_prefetcher.Read(*s_disc, request.partition, request.dvd_offset, request.length,
+                               buffer.data()))
+        {
+          buffer.resize(0);
+        }
+      }
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
@@ -363,6 +452,12 @@ static void DVDThread()
       if (s_dvd_thread_exiting.IsSet())
         return;
     }
+
+    // The disc can be ejected (or never inserted) while the thread is running
+    if (s_disc)
+      s_prefetcher.DoPendingWork(*s_disc);
+    else
+      s_prefetcher.CancelPendingWork();
   }
 }
 }
@@ -13,6 +13,8 @@
 #include <string>
 #include <vector>
 
+#include <xxhash.h>
+
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -177,6 +179,8 @@ void GCMemcardDirectory::FlushThread()
       StringFromFormat("Memcard %d flushing thread", m_card_index).c_str());
 
   constexpr std::chrono::seconds flush_interval{1};
+  // Games that keep writing are still flushed this often
+  constexpr std::chrono::seconds max_flush_delay{5};
   while (true)
   {
     // no-op until signalled
@@ -185,7 +189,9 @@ void GCMemcardDirectory::FlushThread()
     if (m_exiting.TestAndClear())
       return;
     // no-op as long as signalled within flush_interval
-    while (m_flush_trigger.WaitFor(flush_interval))
+    const auto flush_deadline = std::chrono::steady_clock::now() + max_flush_delay;
+    while (std::chrono::steady_clock::now() < flush_deadline &&
+           m_flush_trigger.WaitFor(flush_interval))
     {
       if (m_exiting.TestAndClear())
         return;
@@ -206,6 +212,8 @@ GCMemcardDirectory::~GCMemcardDirectory()
 
 s32 GCMemcardDirectory::Read(u32 src_address, s32 length, u8* dest_address)
 {
+  // The flush thread unloads save data
+  std::unique_lock<std::mutex> l(m_write_mutex);
   s32 block = src_address / BLOCK_SIZE;
   u32 offset = src_address % BLOCK_SIZE;
   s32 extra = 0;  // used for read calls that are across multiple blocks
@@ -256,6 +264,8 @@ s32 GCMemcardDirectory::Read(u32 src_address, s32 length, u8* dest_address)
   }
 
   memcpy(dest_address, m_last_block_address + offset, length);
+
+  l.unlock();
   if (extra)
     extra = Read(src_address + length, extra, dest_address + length);
   return length + extra;
@@ -520,11 +530,44 @@ bool GCMemcardDirectory::SetUsedBlocks(int save_index)
   return true;
 }
 
+// Writes the file next to its destination first and syncs the rename, so that a crash while
+// writing doesn't leave a truncated save behind
+static bool WriteGCIFile(const std::string& filename, const DEntry& header,
+                         const std::vector<GCMBlock>& save_data)
+{
+  const std::string temp_filename = filename + ".tmp";
+  {
+    File::IOFile gci(temp_filename, "wb");
+    if (!gci || !gci.WriteBytes(&header, DENTRY_SIZE) ||
+        !gci.WriteBytes(save_data.data(), BLOCK_SIZE * save_data.size()) || !gci.Close())
+    {
+      File::Delete(temp_filename);
+      return false;
+    }
+  }
+
+  if (!File::RenameSync(temp_filename, filename))
+  {
+    File::Delete(temp_filename);
+    return false;
+  }
+  return true;
+}
+
 void GCMemcardDirectory::FlushToFile()
 {
+  // The saves are copied while the lock is held and written afterwards, so that the emulated card
+  // isn't blocked by the file system
+  struct PendingWrite
+  {
+    std::string filename;
+    DEntry header;
+    std::vector<GCMBlock> save_data;
+  };
+  std::vector<PendingWrite> pending_writes;
+  std::vector<std::string> pending_deletes;
+
   std::unique_lock<std::mutex> l(m_write_mutex);
-  int errors = 0;
-  DEntry invalid;
   for (u16 i = 0; i < m_saves.size(); ++i)
   {
     if (m_saves[i].m_dirty)
@@ -557,36 +600,13 @@ void GCMemcardDirectory::FlushToFile()
                         default_save_name.c_str());
           m_saves[i].m_filename = default_save_name;
         }
-        File::IOFile gci(m_saves[i].m_filename, "wb");
-        if (gci)
-        {
-          gci.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-          gci.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
-
-          if (gci.IsGood())
-          {
-            Core::DisplayMessage(
-                StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-          }
-          else
-          {
-            ++errors;
-            Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s",
-                                                  m_saves[i].m_filename.c_str()),
-                                 4000);
-            ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s",
-                      m_saves[i].m_filename.c_str());
-          }
-        }
+        pending_writes.push_back(
+            {m_saves[i].m_filename, m_saves[i].m_gci_header, m_saves[i].m_save_data});
       }
       else if (m_saves[i].m_filename.length() != 0)
       {
         m_saves[i].m_dirty = false;
-        std::string& old_name = m_saves[i].m_filename;
-        std::string deleted_name = old_name + ".deleted";
-        if (File::Exists(deleted_name))
-          File::Delete(deleted_name);
-        File::Rename(old_name, deleted_name);
+        pending_deletes.push_back(std::move(m_saves[i].m_filename));
         m_saves[i].m_filename.clear();
         m_saves[i].m_save_data.clear();
         m_saves[i].m_used_blocks.clear();
@@ -604,8 +624,45 @@ void GCMemcardDirectory::FlushToFile()
       INFO_LOG(EXPANSIONINTERFACE, "Flushing savedata to disk for %s",
                m_saves[i].m_filename.c_str());
       m_saves[i].m_save_data.clear();
+      // The cached block may have pointed into the data
+      m_last_block = -1;
+    }
+  }
+  l.unlock();
+
+  for (const std::string& old_name : pending_deletes)
+  {
+    m_written_hashes.erase(old_name);
+    std::string deleted_name = old_name + ".deleted";
+    if (File::Exists(deleted_name))
+      File::Delete(deleted_name);
+    File::Rename(old_name, deleted_name);
+  }
+
+  for (const PendingWrite& write : pending_writes)
+  {
+    // Games often write the same data again, which doesn't need to touch the disk
+    const u64 hash = XXH64(write.save_data.data(), BLOCK_SIZE * write.save_data.size(),
+                           XXH64(&write.header, DENTRY_SIZE, 0));
+    auto written = m_written_hashes.find(write.filename);
+    if (written != m_written_hashes.end() && written->second == hash)
+      continue;
+
+    if (WriteGCIFile(write.filename, write.header, write.save_data))
+    {
+      m_written_hashes[write.filename] = hash;
+      Core::DisplayMessage(StringFromFormat("Wrote save contents to %s", write.filename.c_str()),
+                           4000);
+    }
+    else
+    {
+      m_written_hashes.erase(write.filename);
+      Core::DisplayMessage(
+          StringFromFormat("Failed to write save contents to %s", write.filename.c_str()), 4000);
+      ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", write.filename.c_str());
     }
   }
+
 #if _WRITE_MC_HEADER
   u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
   Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -59,4 +60,6 @@ private:
   std::mutex m_write_mutex;
   Common::Flag m_exiting;
   std::thread m_flush_thread;
+  // Hashes of the files that were last written by the flush thread
+  std::map<std::string, u64> m_written_hashes;
 };
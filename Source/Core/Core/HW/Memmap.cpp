@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -408,12 +409,13 @@ u8* GetPointer(u32 address)
   if (ARBruteForcer::ch_bruteforce)
   {
     Core::KillDolphinAndRestart();
-  }
-  else
-  {
-    PanicAlert("Unknown Pointer 0x%08x PC 0x%08x LR 0x%08x", address, PC, LR);
+    // Callers don't expect a null pointer here. Hand out scratch memory until the CPU stops, so
+    // the faulting access can't clobber emulated RAM.
+    static std::vector<u8> s_fault_scratch(EXRAM_SIZE);
+    return s_fault_scratch.data();
   }
 
+  PanicAlert("Unknown Pointer 0x%08x PC 0x%08x LR 0x%08x", address, PC, LR);
   return nullptr;
 }
 
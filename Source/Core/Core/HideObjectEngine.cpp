@@ -5,6 +5,12 @@
 // HideObjectEngine
 // Supports the removal of objects/effects from the rendering loop
 
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Common/BitSet.h"
 #include "Common/StringUtil.h"
 #include "Core/HideObjectEngine.h"
 #include "Core/ConfigManager.h"
@@ -18,6 +24,65 @@ std::vector<std::string> HideObjectTypeStrings = {
 
 static std::vector<HideObject> HideObjectCodes;
 
+// Replaced as a whole when codes are applied, the GPU thread keeps using the previous matcher
+// until it sees the new generation
+static std::shared_ptr<const Matcher> s_matcher;
+static std::atomic<u32> s_matcher_generation{0};
+
+size_t Matcher::PrefixHash::operator()(const Prefix& prefix) const
+{
+  const u64 hash = (prefix.high * 0x9E3779B97F4A7C15ULL) ^ prefix.low;
+  return static_cast<size_t>(hash ^ (hash >> 29));
+}
+
+Matcher::Prefix Matcher::MakePrefix(const u8* data, size_t length)
+{
+  u8 bytes[MAX_LENGTH] = {};
+  std::memcpy(bytes, data, length);
+
+  Prefix prefix;
+  std::memcpy(&prefix.high, bytes, sizeof(u64));
+  std::memcpy(&prefix.low, bytes + sizeof(u64), sizeof(u64));
+  return prefix;
+}
+
+Matcher::Matcher(const std::vector<HideObject>& codes)
+{
+  for (const HideObject& code : codes)
+  {
+    if (!code.active)
+      continue;
+
+    for (const HideObjectEntry& entry : code.entries)
+    {
+      // The value is stored big endian, the bytes beyond 8 in the upper half
+      u8 bytes[MAX_LENGTH];
+      const size_t length = GetHideObjectTypeCharLength(entry.type) >> 1;
+      for (size_t i = 0; i < length; ++i)
+      {
+        const size_t shift = length - 1 - i;
+        const u64 value = shift >= 8 ? entry.value_upper : entry.value_lower;
+        bytes[i] = static_cast<u8>(value >> ((shift % 8) * 8));
+      }
+
+      if (m_prefixes[length - 1].insert(MakePrefix(bytes, length)).second)
+        ++m_entry_count;
+      m_lengths_by_first_byte[bytes[0]] |= 1 << (length - 1);
+    }
+  }
+}
+
+bool Matcher::Matches(const u8* data) const
+{
+  for (int i : BitSet32(m_lengths_by_first_byte[data[0]]))
+  {
+    const size_t length = i + 1;
+    if (m_prefixes[i].count(MakePrefix(data, length)))
+      return true;
+  }
+  return false;
+}
+
 void LoadHideObjectSection(const std::string& section, std::vector<HideObject>& HideObjectects,
                            IniFile& globalIni, IniFile& localIni)
 {
@@ -112,48 +177,8 @@ void LoadHideObjects()
 
 void ApplyHideObjects(const std::vector<HideObject>& HideObjectects)
 {
-  // Make the rendering code skip over checking skip entries
-  SConfig::GetInstance().hide_objects_updating = true;
-
-  // Wait until the next time the next time the rendering thread finishes checking the skip entries.
-  if (Core::IsRunning())
-    while (SConfig::GetInstance().hide_objects_done == false)
-    {
-    }
-
-  SConfig::GetInstance().object_removal_codes.clear();
-
-  for (const HideObject& HideObjectect : HideObjectects)
-  {
-    if (HideObjectect.active)
-    {
-      for (const HideObjectEntry& entry : HideObjectect.entries)
-      {
-        u64 value_add_lower = entry.value_lower;
-        u64 value_add_upper = entry.value_upper;
-        SkipEntry skipEntry;
-        int size = GetHideObjectTypeCharLength(entry.type) >> 1;
-
-        if (size > 8)
-        {
-          size -= 8;
-          for (int j = size; j > 0; --j)
-          {
-            skipEntry.push_back((0xFF & (value_add_upper >> ((j - 1) * 8))));
-          }
-          size = 8;
-        }
-
-        for (int j = size; j > 0; --j)
-        {
-          skipEntry.push_back((0xFF & (value_add_lower >> ((j - 1) * 8))));
-        }
-
-        SConfig::GetInstance().object_removal_codes.push_back(skipEntry);
-      }
-    }
-  }
-  SConfig::GetInstance().hide_objects_updating = false;
+  std::atomic_store(&s_matcher, std::make_shared<const Matcher>(HideObjectects));
+  s_matcher_generation.fetch_add(1);
 }
 
 void ApplyFrameHideObjects()
@@ -164,6 +189,17 @@ void ApplyFrameHideObjects()
 void Shutdown()
 {
   HideObjectCodes.clear();
+  ApplyHideObjects(HideObjectCodes);
+}
+
+u32 GetMatcherGeneration()
+{
+  return s_matcher_generation.load();
+}
+
+std::shared_ptr<const Matcher> GetMatcher()
+{
+  return std::atomic_load(&s_matcher);
 }
 
 }  // namespace
@@ -4,6 +4,14 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
 class IniFile;
 
 namespace HideObjectEngine
@@ -50,13 +58,59 @@ struct HideObject
   bool user_defined;  // False if this code is shipped with Dolphin.
 };
 
+// The active entries of a set of codes, compiled for testing the vertex data of every draw.
+// Entries are grouped by length, and each group is a hash set of the bytes a draw has to start
+// with, so a test costs at most one lookup per length, and usually none.
+class Matcher final
+{
+public:
+  explicit Matcher(const std::vector<HideObject>& codes);
+
+  bool IsEmpty() const { return m_entry_count == 0; }
+  // Reads as many bytes from data as the longest entry that can match its first byte
+  bool Matches(const u8* data) const;
+
+private:
+  static constexpr size_t MAX_LENGTH = 16;
+
+  struct Prefix
+  {
+    u64 high = 0;
+    u64 low = 0;
+
+    bool operator==(const Prefix& other) const
+    {
+      return high == other.high && low == other.low;
+    }
+  };
+
+  struct PrefixHash
+  {
+    size_t operator()(const Prefix& prefix) const;
+  };
+
+  static Prefix MakePrefix(const u8* data, size_t length);
+
+  // Indexed by length - 1
+  std::array<std::unordered_set<Prefix, PrefixHash>, MAX_LENGTH> m_prefixes;
+  // Which lengths have an entry that starts with a given byte
+  std::array<u16, 256> m_lengths_by_first_byte{};
+  size_t m_entry_count = 0;
+};
+
 void LoadHideObjectSection(const std::string& section, std::vector<HideObject>& patches,
                            IniFile& globalIni, IniFile& localIni);
 void LoadHideObjects();
+// Compiles the active codes and publishes them to the GPU thread, without waiting for it
 void ApplyHideObjects(const std::vector<HideObject>& HideObjectects);
 void ApplyFrameHideObjects();
 void Shutdown();
 
+// The generation changes every time codes are applied, so that the GPU thread only has to fetch
+// the matcher again when it did.
+u32 GetMatcherGeneration();
+std::shared_ptr<const Matcher> GetMatcher();
+
 inline int GetHideObjectTypeCharLength(HideObjectType type)
 {
   return (type + 1) << 1;
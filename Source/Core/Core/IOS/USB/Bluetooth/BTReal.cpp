@@ -292,11 +292,10 @@ void BluetoothReal::DoState(PointerWrap& p)
     return;
   }
 
-  // Prevent the transfer callbacks from messing with m_current_transfers after we have started
-  // writing a savestate. We cannot use a scoped lock here because DoState is called twice and
-  // we would lose the lock between the two calls.
-  if (p.GetMode() == PointerWrap::MODE_MEASURE || p.GetMode() == PointerWrap::MODE_VERIFY)
-    m_transfers_mutex.lock();
+  // Prevent the transfer callbacks from messing with m_current_transfers while the savestate is
+  // written. The lock is only held for this pass: a write can switch to measuring halfway
+  // through, and State retries any write whose size changed in between.
+  std::lock_guard<std::mutex> lk(m_transfers_mutex);
 
   std::vector<u32> addresses_to_discard;
   if (p.GetMode() != PointerWrap::MODE_READ)
@@ -330,10 +329,6 @@ void BluetoothReal::DoState(PointerWrap& p)
                     OSD::Duration::VERY_LONG);
     s_has_shown_savestate_warning = true;
   }
-
-  // We have finished the savestate now, so the transfers mutex can be unlocked.
-  if (p.GetMode() == PointerWrap::MODE_WRITE)
-    m_transfers_mutex.unlock();
 }
 
 void BluetoothReal::UpdateSyncButtonState(const bool is_held)
@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <cinttypes>
 #include <iomanip>
 #include <iterator>
 #include <mbedtls/config.h>
@@ -48,6 +50,7 @@
 #include "Core/HW/WiimoteEmu/WiimoteEmu.h"
 #include "Core/IOS/USB/Bluetooth/BTEmu.h"
 #include "Core/IOS/USB/Bluetooth/WiimoteDevice.h"
+#include "Core/MovieKeyframes.h"
 #include "Core/NetPlayProto.h"
 #include "Core/State.h"
 
@@ -107,7 +110,15 @@ static WiiManipFunction s_wii_manip_func;
 
 static std::string s_current_file_name;
 
+static KeyframeStore s_keyframes;
+// Frame at which the next keyframe is captured while recording
+static u64 s_next_keyframe_frame = 0;
+// Set by SeekToFrame until FrameUpdate reaches s_seek_target
+static std::atomic<bool> s_seeking{false};
+static u64 s_seek_target = 0;
+
 static void GetSettings();
+static void CaptureKeyframe();
 static bool IsMovieHeader(u8 magic[4])
 {
   return magic[0] == 'D' && magic[1] == 'T' && magic[2] == 'M' && magic[3] == 0x1A;
@@ -200,9 +211,93 @@ void FrameUpdate()
   if (s_framesToSkip)
     FrameSkipping();
 
+  const u32 keyframe_interval = SConfig::GetInstance().m_MovieKeyframeInterval;
+  if (IsRecordingInput() && keyframe_interval != 0 && s_currentFrame >= s_next_keyframe_frame)
+  {
+    s_next_keyframe_frame = s_currentFrame + keyframe_interval;
+    Core::QueueHostJob(CaptureKeyframe);
+  }
+
+  if (s_seeking.load() && s_currentFrame >= s_seek_target)
+  {
+    s_seeking.store(false);
+    CPU::Break();
+    Core::QueueHostJob([] {
+      Core::SetIsThrottlerTempDisabled(false);
+      Core::DisplayMessage(StringFromFormat("Reached frame %" PRIu64, s_seek_target), 2000);
+    });
+  }
+
   s_bPolled = false;
 }
 
+// NOTE: Host Thread
+static void CaptureKeyframe()
+{
+  Core::RunAsCPUThread([] {
+    // Recording may have stopped since the keyframe was requested
+    if (!IsRecordingInput())
+      return;
+
+    std::vector<u8> state;
+    if (!State::SaveToBuffer(state))
+      return;
+    s_keyframes.Add(s_currentFrame, s_currentByte,
+                    KeyframeStore::HashInput(s_temp_input.data(), s_currentByte), std::move(state));
+  });
+}
+
+// NOTE: Host Thread
+bool SeekToFrame(u64 frame)
+{
+  if (!IsPlayingInput() || frame > s_totalFrames)
+    return false;
+
+  KeyframeStore::Keyframe keyframe;
+  const bool has_keyframe = s_keyframes.FindBefore(frame, &keyframe);
+  if (frame < s_currentFrame && !has_keyframe)
+    return false;
+
+  // Running from the current frame is faster than loading a keyframe that is behind it
+  if (has_keyframe && (frame < s_currentFrame || keyframe.frame > s_currentFrame))
+  {
+    std::vector<u8> state;
+    if (!s_keyframes.ReadState(keyframe, &state))
+    {
+      PanicAlertT("Failed to read the movie keyframe at frame %" PRIu64, keyframe.frame);
+      return false;
+    }
+    State::LoadFromBuffer(state);
+  }
+
+  if (s_currentFrame >= frame)
+  {
+    Core::DisplayMessage(StringFromFormat("Reached frame %" PRIu64, s_currentFrame), 2000);
+    return true;
+  }
+
+  s_seek_target = frame;
+  s_seeking.store(true);
+  Core::SetIsThrottlerTempDisabled(true);
+  Core::SetState(Core::State::Running);
+  return true;
+}
+
+// NOTE: Host Thread
+bool SaveKeyframes(const std::string& movie_filename)
+{
+  if (s_keyframes.IsEmpty())
+    return true;
+
+  const std::string filename = movie_filename + ".dtk";
+  if (!s_keyframes.Save(filename))
+  {
+    PanicAlertT("Failed to write the movie keyframes to %s", filename.c_str());
+    return false;
+  }
+  return true;
+}
+
 static void CheckMD5();
 static void GetMD5();
 
@@ -568,6 +663,9 @@ bool BeginRecordingInput(int controllers)
       GetSettings();
     }
 
+    s_keyframes.Clear();
+    s_next_keyframe_frame = s_currentFrame + SConfig::GetInstance().m_MovieKeyframeInterval;
+
     // Wiimotes cause desync issues if they're not reset before launching the game
     if (!Core::IsRunningAndStarted())
     {
@@ -937,6 +1035,11 @@ bool PlayInput(const std::string& filename)
   s_currentByte = 0;
   recording_file.Close();
 
+  s_seeking.store(false);
+  const size_t num_keyframes = s_keyframes.Load(filename + ".dtk", s_temp_input);
+  if (num_keyframes != 0)
+    Core::DisplayMessage(StringFromFormat("Loaded %zu movie keyframes", num_keyframes), 2000);
+
   // Load savestate (and skip to frame data)
   if (tmpHeader.bFromSaveState)
   {
@@ -989,6 +1092,10 @@ void LoadInput(const std::string& filename)
     tmpHeader.numRerecords = s_rerecords;
     t_record.Seek(0, SEEK_SET);
     t_record.WriteArray(&tmpHeader, 1);
+
+    // The input after the loaded state is about to be recorded again
+    s_keyframes.Truncate(s_currentByte);
+    s_next_keyframe_frame = s_currentFrame + SConfig::GetInstance().m_MovieKeyframeInterval;
   }
 
   ChangePads(true);
@@ -1300,6 +1407,7 @@ void EndPlayInput(bool cont)
     _assert_(IsMovieActive());
 
     s_playMode = MODE_RECORDING;
+    s_next_keyframe_frame = s_currentFrame + SConfig::GetInstance().m_MovieKeyframeInterval;
     Core::DisplayMessage("Reached movie end. Resuming recording.", 2000);
   }
   else if (s_playMode != MODE_NONE)
@@ -1311,6 +1419,7 @@ void EndPlayInput(bool cont)
     s_rerecords = 0;
     s_currentByte = 0;
     s_playMode = MODE_NONE;
+    s_seeking.store(false);
     Core::DisplayMessage("Movie End.", 2000);
     s_bRecordingFromSaveState = false;
     // we don't clear these things because otherwise we can't resume playback if we load a movie
@@ -1525,5 +1634,7 @@ void Shutdown()
 {
   s_currentInputCount = s_totalInputCount = s_totalFrames = s_tickCountAtLastInput = 0;
   s_temp_input.clear();
+  s_keyframes.Clear();
+  s_seeking.store(false);
 }
 };
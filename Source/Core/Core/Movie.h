@@ -166,6 +166,11 @@ bool PlayWiimote(int wiimote, u8* data, const struct WiimoteEmu::ReportFeatures&
                  const wiimote_key key);
 void EndPlayInput(bool cont);
 void SaveRecording(const std::string& filename);
+// Writes the keyframes that were captured while recording to filename.dtk
+bool SaveKeyframes(const std::string& movie_filename);
+// Loads the closest keyframe before the frame if there is one, and runs the playback to the frame
+// without throttling before pausing
+bool SeekToFrame(u64 frame);
 void DoState(PointerWrap& p);
 void Shutdown();
 void CheckPadStatus(GCPadStatus* PadStatus, int controllerID);
@@ -0,0 +1,278 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/MovieKeyframes.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <xxhash.h>
+#include <zlib.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace Movie
+{
+namespace
+{
+constexpr u32 KEYFRAME_FILE_MAGIC = 0x1A4B5444;  // "DTK" 0x1A
+constexpr u32 KEYFRAME_FILE_VERSION = 1;
+
+#pragma pack(push, 1)
+
+struct KeyframeFileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 count;
+  u32 reserved;
+};
+
+// Followed by the compressed savestates
+struct KeyframeFileEntry
+{
+  u64 frame;
+  u64 input_byte;
+  u64 input_hash;
+  u64 offset;
+  u32 compressed_size;
+  u32 size;
+};
+
+#pragma pack(pop)
+
+bool ReadCompressed(File::IOFile& file, const KeyframeStore::Keyframe& keyframe,
+                    std::vector<u8>* compressed)
+{
+  compressed->resize(keyframe.compressed_size);
+  return file.Seek(keyframe.offset, SEEK_SET) &&
+         file.ReadBytes(compressed->data(), compressed->size());
+}
+}  // Anonymous namespace
+
+KeyframeStore::KeyframeStore() = default;
+
+KeyframeStore::~KeyframeStore()
+{
+  WaitForWriter();
+}
+
+u64 KeyframeStore::HashInput(const u8* input, u64 size)
+{
+  return XXH64(input, static_cast<size_t>(size), 0);
+}
+
+std::string KeyframeStore::GetTempPath() const
+{
+  return File::GetUserPath(D_STATESAVES_IDX) + "dtm_keyframes.tmp";
+}
+
+void KeyframeStore::WaitForWriter()
+{
+  if (m_writer.joinable())
+    m_writer.join();
+}
+
+void KeyframeStore::Clear()
+{
+  WaitForWriter();
+
+  m_keyframes.clear();
+  m_loaded_path.clear();
+  m_temp_file_size = 0;
+  File::Delete(GetTempPath());
+}
+
+void KeyframeStore::Add(u64 frame, u64 input_byte, u64 input_hash, std::vector<u8> state)
+{
+  WaitForWriter();
+
+  m_writer = std::thread([this, frame, input_byte, input_hash, state = std::move(state)] {
+    uLongf compressed_size = compressBound(static_cast<uLong>(state.size()));
+    std::vector<u8> compressed(compressed_size);
+    // Keyframes are captured while the game is running, so speed matters more than size
+    if (compress2(compressed.data(), &compressed_size, state.data(),
+                  static_cast<uLong>(state.size()), Z_BEST_SPEED) != Z_OK)
+    {
+      ERROR_LOG(CORE, "Failed to compress the movie keyframe at frame %" PRIu64, frame);
+      return;
+    }
+
+    File::IOFile file(GetTempPath(), "ab");
+    if (!file || !file.WriteBytes(compressed.data(), compressed_size))
+    {
+      ERROR_LOG(CORE, "Failed to write the movie keyframe at frame %" PRIu64, frame);
+      return;
+    }
+
+    m_keyframes.push_back({frame, input_byte, input_hash, true, m_temp_file_size,
+                           static_cast<u32>(compressed_size), static_cast<u32>(state.size())});
+    m_temp_file_size += compressed_size;
+  });
+}
+
+void KeyframeStore::Truncate(u64 input_byte)
+{
+  WaitForWriter();
+
+  m_keyframes.erase(std::remove_if(m_keyframes.begin(), m_keyframes.end(),
+                                   [input_byte](const Keyframe& keyframe) {
+                                     return keyframe.input_byte > input_byte;
+                                   }),
+                    m_keyframes.end());
+}
+
+bool KeyframeStore::Save(const std::string& path)
+{
+  WaitForWriter();
+
+  if (m_keyframes.empty())
+    return true;
+
+  // The keyframes may be copied from the file that is being replaced
+  const std::string out_path = path + ".tmp";
+  File::IOFile out(out_path, "wb");
+  File::IOFile temp_file(GetTempPath(), "rb");
+  File::IOFile loaded_file;
+  if (!m_loaded_path.empty())
+    loaded_file.Open(m_loaded_path, "rb");
+  if (!out)
+    return false;
+
+  KeyframeFileHeader header = {};
+  header.magic = KEYFRAME_FILE_MAGIC;
+  header.version = KEYFRAME_FILE_VERSION;
+  header.count = static_cast<u32>(m_keyframes.size());
+
+  std::vector<KeyframeFileEntry> entries;
+  u64 offset = sizeof(KeyframeFileHeader) + m_keyframes.size() * sizeof(KeyframeFileEntry);
+  for (const Keyframe& keyframe : m_keyframes)
+  {
+    entries.push_back({keyframe.frame, keyframe.input_byte, keyframe.input_hash, offset,
+                       keyframe.compressed_size, keyframe.size});
+    offset += keyframe.compressed_size;
+  }
+
+  out.WriteBytes(&header, sizeof(header));
+  out.WriteArray(entries.data(), entries.size());
+
+  std::vector<u8> compressed;
+  for (const Keyframe& keyframe : m_keyframes)
+  {
+    File::IOFile& source = keyframe.in_temp_file ? temp_file : loaded_file;
+    if (!source || !ReadCompressed(source, keyframe, &compressed) ||
+        !out.WriteBytes(compressed.data(), compressed.size()))
+    {
+      out.Close();
+      File::Delete(out_path);
+      return false;
+    }
+  }
+
+  loaded_file.Close();
+  if (!out.Close() || !File::Rename(out_path, path))
+  {
+    File::Delete(out_path);
+    return false;
+  }
+
+  // Later exports copy the keyframes from the saved file
+  for (size_t i = 0; i < m_keyframes.size(); ++i)
+  {
+    m_keyframes[i].in_temp_file = false;
+    m_keyframes[i].offset = entries[i].offset;
+  }
+  m_loaded_path = path;
+  return true;
+}
+
+size_t KeyframeStore::Load(const std::string& path, const std::vector<u8>& input)
+{
+  Clear();
+
+  File::IOFile file(path, "rb");
+  KeyframeFileHeader header;
+  if (!file || !file.ReadArray(&header, 1) || header.magic != KEYFRAME_FILE_MAGIC ||
+      header.version != KEYFRAME_FILE_VERSION)
+  {
+    return 0;
+  }
+
+  // Don't trust the count with an allocation before knowing that the entries fit in the file
+  const u64 file_size = file.GetSize();
+  if (file_size < sizeof(header) ||
+      header.count > (file_size - sizeof(header)) / sizeof(KeyframeFileEntry))
+  {
+    return 0;
+  }
+
+  std::vector<KeyframeFileEntry> entries(header.count);
+  if (!file.ReadArray(entries.data(), entries.size()))
+    return 0;
+
+  for (const KeyframeFileEntry& entry : entries)
+  {
+    if (entry.offset + entry.compressed_size > file_size || entry.input_byte > input.size() ||
+        HashInput(input.data(), entry.input_byte) != entry.input_hash)
+    {
+      continue;
+    }
+
+    m_keyframes.push_back({entry.frame, entry.input_byte, entry.input_hash, false, entry.offset,
+                           entry.compressed_size, entry.size});
+  }
+
+  std::sort(m_keyframes.begin(), m_keyframes.end(),
+            [](const Keyframe& a, const Keyframe& b) { return a.frame < b.frame; });
+  if (m_keyframes.size() != entries.size())
+  {
+    WARN_LOG(CORE, "Ignored %zu keyframes from %s that don't match the movie",
+             entries.size() - m_keyframes.size(), path.c_str());
+  }
+
+  m_loaded_path = path;
+  return m_keyframes.size();
+}
+
+bool KeyframeStore::IsEmpty()
+{
+  WaitForWriter();
+  return m_keyframes.empty();
+}
+
+bool KeyframeStore::FindBefore(u64 frame, Keyframe* keyframe)
+{
+  WaitForWriter();
+
+  auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), frame,
+                             [](u64 value, const Keyframe& k) { return value < k.frame; });
+  if (it == m_keyframes.begin())
+    return false;
+
+  *keyframe = *(it - 1);
+  return true;
+}
+
+bool KeyframeStore::ReadState(const Keyframe& keyframe, std::vector<u8>* state)
+{
+  WaitForWriter();
+
+  File::IOFile file(keyframe.in_temp_file ? GetTempPath() : m_loaded_path, "rb");
+  std::vector<u8> compressed;
+  if (!file || !ReadCompressed(file, keyframe, &compressed))
+    return false;
+
+  state->resize(keyframe.size);
+  uLongf size = keyframe.size;
+  return uncompress(state->data(), &size, compressed.data(), keyframe.compressed_size) == Z_OK &&
+         size == keyframe.size;
+}
+}  // namespace Movie
@@ -0,0 +1,72 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Movie
+{
+// Savestates that are captured every few frames while a movie is being recorded, so that playback
+// can seek by loading the closest keyframe and running to the requested frame.
+//
+// While recording, compressed keyframes are appended to a temporary file. Exporting a movie saves
+// them into a .dtk file next to the .dtm, which is loaded again when the movie is played. Every
+// keyframe stores a hash of the movie input that was recorded before it, so keyframes that don't
+// belong to the movie they are loaded with are ignored.
+class KeyframeStore final
+{
+public:
+  struct Keyframe
+  {
+    u64 frame;
+    // Position in the movie input
+    u64 input_byte;
+    u64 input_hash;
+    // Location of the compressed savestate in the temporary file or the loaded .dtk file
+    bool in_temp_file;
+    u64 offset;
+    u32 compressed_size;
+    u32 size;
+  };
+
+  KeyframeStore();
+  ~KeyframeStore();
+
+  KeyframeStore(const KeyframeStore&) = delete;
+  KeyframeStore& operator=(const KeyframeStore&) = delete;
+
+  static u64 HashInput(const u8* input, u64 size);
+
+  // Drops all keyframes and starts a new temporary file
+  void Clear();
+  // Compresses and stores the state on a background thread
+  void Add(u64 frame, u64 input_byte, u64 input_hash, std::vector<u8> state);
+  // Drops the keyframes that were captured after the given input position, for when recording
+  // continues from an earlier savestate
+  void Truncate(u64 input_byte);
+
+  bool Save(const std::string& path);
+  // Returns the number of keyframes that match the movie input
+  size_t Load(const std::string& path, const std::vector<u8>& input);
+
+  bool IsEmpty();
+  // Returns the last keyframe at or before the frame, if there is one
+  bool FindBefore(u64 frame, Keyframe* keyframe);
+  bool ReadState(const Keyframe& keyframe, std::vector<u8>* state);
+
+private:
+  void WaitForWriter();
+  std::string GetTempPath() const;
+
+  std::vector<Keyframe> m_keyframes;
+  std::string m_loaded_path;
+  u64 m_temp_file_size = 0;
+  std::thread m_writer;
+};
+}  // namespace Movie
@@ -5,9 +5,11 @@
 #include "Core/NetPlayClient.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstddef>
 #include <cstring>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -18,12 +20,14 @@
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/ENetUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/MD5.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
 #include "Core/HW/SI/SI.h"
 #include "Core/HW/SI/SI_DeviceGCController.h"
@@ -32,6 +36,7 @@
 #include "Core/HW/WiimoteReal/WiimoteReal.h"
 #include "Core/IOS/USB/Bluetooth/BTEmu.h"
 #include "Core/Movie.h"
+#include "Core/State.h"
 #include "InputCommon/GCAdapter.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
@@ -40,6 +45,21 @@ static std::mutex crit_netplay_client;
 static NetPlayClient* netplay_client = nullptr;
 NetSettings g_NetPlaySettings;
 
+// How far a remote pad can be predicted ahead of its confirmed input. Every poll that is
+// predicted may have to be emulated again.
+constexpr u64 MAX_PREDICTED_POLLS = 12;
+constexpr u64 NO_MISPREDICTION = std::numeric_limits<u64>::max();
+// Buffers of dropped save points that are kept to be reused by the next ones
+constexpr size_t MAX_SPARE_STATES = 2;
+
+static bool IsSamePadStatus(const GCPadStatus& a, const GCPadStatus& b)
+{
+  return a.button == b.button && a.stickX == b.stickX && a.stickY == b.stickY &&
+         a.substickX == b.substickX && a.substickY == b.substickY &&
+         a.triggerLeft == b.triggerLeft && a.triggerRight == b.triggerRight &&
+         a.analogA == b.analogA && a.analogB == b.analogB && a.err == b.err;
+}
+
 // called from ---GUI--- thread
 NetPlayClient::~NetPlayClient()
 {
@@ -323,33 +343,50 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 
   case NP_MSG_PAD_DATA:
   {
-    PadMapping map = 0;
-    GCPadStatus pad;
-    packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-        pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+    u64 entries = 0;
+    while (!packet.endOfPacket())
+    {
+      PadMapping map = 0;
+      GCPadStatus pad;
+      if (!m_pad_decoder.DecodePad(packet, &map, &pad))
+      {
+        ERROR_LOG(NETPLAY, "Received malformed pad data");
+        break;
+      }
+
+      // add to pad buffer
+      m_pad_buffer[map].Push(pad);
+      ++entries;
+    }
 
-    // Trusting server for good map value (>=0 && <4)
-    // add to pad buffer
-    m_pad_buffer.at(map).Push(pad);
+    m_pad_data_stats.messages_received++;
+    m_pad_data_stats.entries_received += entries;
+    m_pad_data_stats.bytes_received += packet.getDataSize();
     m_gc_pad_event.Set();
   }
   break;
 
   case NP_MSG_WIIMOTE_DATA:
   {
-    PadMapping map = 0;
-    NetWiimote nw;
-    u8 size;
-    packet >> map >> size;
-
-    nw.resize(size);
+    u64 entries = 0;
+    while (!packet.endOfPacket())
+    {
+      PadMapping map = 0;
+      NetWiimote nw;
+      if (!m_pad_decoder.DecodeWiimote(packet, &map, &nw))
+      {
+        ERROR_LOG(NETPLAY, "Received malformed Wiimote data");
+        break;
+      }
 
-    for (unsigned int i = 0; i < size; ++i)
-      packet >> nw[i];
+      // add to Wiimote buffer
+      m_wiimote_buffer[map].Push(std::move(nw));
+      ++entries;
+    }
 
-    // Trusting server for good map value (>=0 && <4)
-    // add to Wiimote buffer
-    m_wiimote_buffer.at(map).Push(nw);
+    m_pad_data_stats.messages_received++;
+    m_pad_data_stats.entries_received += entries;
+    m_pad_data_stats.bytes_received += packet.getDataSize();
     m_wii_pad_event.Set();
   }
   break;
@@ -427,6 +464,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
       g_NetPlaySettings.m_EXIDevice[0] = static_cast<ExpansionInterface::TEXIDevices>(tmp);
       packet >> tmp;
       g_NetPlaySettings.m_EXIDevice[1] = static_cast<ExpansionInterface::TEXIDevices>(tmp);
+      packet >> g_NetPlaySettings.m_Rollback;
 
       u32 time_low, time_high;
       packet >> time_low;
@@ -434,6 +472,9 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
       g_netplay_initial_rtc = time_low | ((u64)time_high << 32);
     }
 
+    // Pad data of the new game is only relayed after this message
+    m_pad_decoder.Reset();
+
     m_dialog->OnMsgStartGame();
   }
   break;
@@ -747,30 +788,90 @@ void NetPlayClient::SendChatMessage(const std::string& msg)
 }
 
 // called from ---CPU--- thread
-void NetPlayClient::SendPadState(const int in_game_pad, const GCPadStatus& pad)
+void NetPlayClient::SendInputData(sf::Packet&& packet, const u32 num_entries)
 {
-  sf::Packet packet;
-  packet << static_cast<MessageId>(NP_MSG_PAD_DATA);
-  packet << static_cast<PadMapping>(in_game_pad);
-  packet << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
-         << pad.substickY << pad.triggerLeft << pad.triggerRight;
+  m_pad_data_stats.messages_sent++;
+  m_pad_data_stats.entries_sent += num_entries;
+  m_pad_data_stats.bytes_sent += packet.getDataSize();
 
   SendAsync(std::move(packet));
 }
 
 // called from ---CPU--- thread
-void NetPlayClient::SendWiimoteState(const int in_game_pad, const NetWiimote& nw)
+void NetPlayClient::AddInputWaitTime(const u64 wait_us)
 {
-  sf::Packet packet;
-  packet << static_cast<MessageId>(NP_MSG_WIIMOTE_DATA);
-  packet << static_cast<PadMapping>(in_game_pad);
-  packet << static_cast<u8>(nw.size());
-  for (auto it : nw)
+  m_pad_data_stats.input_waits++;
+  m_pad_data_stats.input_wait_us += wait_us;
+
+  // Only the CPU thread writes the maximum
+  if (wait_us > m_pad_data_stats.max_input_wait_us)
+    m_pad_data_stats.max_input_wait_us = wait_us;
+}
+
+NetPlayClient::PadDataStats NetPlayClient::GetPadDataStats() const
+{
+  PadDataStats stats;
+  stats.messages_sent = m_pad_data_stats.messages_sent;
+  stats.entries_sent = m_pad_data_stats.entries_sent;
+  stats.bytes_sent = m_pad_data_stats.bytes_sent;
+  stats.messages_received = m_pad_data_stats.messages_received;
+  stats.entries_received = m_pad_data_stats.entries_received;
+  stats.bytes_received = m_pad_data_stats.bytes_received;
+  stats.input_waits = m_pad_data_stats.input_waits;
+  stats.input_wait_us = m_pad_data_stats.input_wait_us;
+  stats.max_input_wait_us = m_pad_data_stats.max_input_wait_us;
+  stats.save_points = m_pad_data_stats.save_points;
+  stats.save_point_us = m_pad_data_stats.save_point_us;
+  stats.max_save_point_us = m_pad_data_stats.max_save_point_us;
+  stats.rollbacks = m_pad_data_stats.rollbacks;
+  stats.rollback_us = m_pad_data_stats.rollback_us;
+  stats.max_rollback_us = m_pad_data_stats.max_rollback_us;
+  stats.rolled_back_polls = m_pad_data_stats.rolled_back_polls;
+  return stats;
+}
+
+void NetPlayClient::ResetPadDataStats()
+{
+  m_pad_data_stats.messages_sent = 0;
+  m_pad_data_stats.entries_sent = 0;
+  m_pad_data_stats.bytes_sent = 0;
+  m_pad_data_stats.messages_received = 0;
+  m_pad_data_stats.entries_received = 0;
+  m_pad_data_stats.bytes_received = 0;
+  m_pad_data_stats.input_waits = 0;
+  m_pad_data_stats.input_wait_us = 0;
+  m_pad_data_stats.max_input_wait_us = 0;
+  m_pad_data_stats.save_points = 0;
+  m_pad_data_stats.save_point_us = 0;
+  m_pad_data_stats.max_save_point_us = 0;
+  m_pad_data_stats.rollbacks = 0;
+  m_pad_data_stats.rollback_us = 0;
+  m_pad_data_stats.max_rollback_us = 0;
+  m_pad_data_stats.rolled_back_polls = 0;
+}
+
+void NetPlayClient::LogPadDataStats() const
+{
+  const PadDataStats stats = GetPadDataStats();
+  NOTICE_LOG(NETPLAY, "Input data sent: %" PRIu64 " messages, %" PRIu64 " entries, %" PRIu64
+                      " bytes",
+             stats.messages_sent, stats.entries_sent, stats.bytes_sent);
+  NOTICE_LOG(NETPLAY, "Input data received: %" PRIu64 " messages, %" PRIu64 " entries, %" PRIu64
+                      " bytes",
+             stats.messages_received, stats.entries_received, stats.bytes_received);
+  NOTICE_LOG(NETPLAY, "Waited for input %" PRIu64 " times, %" PRIu64 " ms in total, %" PRIu64
+                      " ms at most",
+             stats.input_waits, stats.input_wait_us / 1000, stats.max_input_wait_us / 1000);
+  if (m_rollback)
   {
-    packet << it;
+    NOTICE_LOG(NETPLAY, "Took %" PRIu64 " save points, %" PRIu64 " ms in total, %" PRIu64
+                        " ms at most",
+               stats.save_points, stats.save_point_us / 1000, stats.max_save_point_us / 1000);
+    NOTICE_LOG(NETPLAY, "Rolled back %" PRIu64 " times, %" PRIu64 " ms in total, %" PRIu64
+                        " ms at most, %" PRIu64 " pad polls emulated again",
+               stats.rollbacks, stats.rollback_us / 1000, stats.max_rollback_us / 1000,
+               stats.rolled_back_polls);
   }
-
-  SendAsync(std::move(packet));
 }
 
 // called from ---GUI--- thread
@@ -810,6 +911,9 @@ bool NetPlayClient::StartGame(const std::string& path)
   NetPlay_Enable(this);
 
   ClearBuffers();
+  ResetRollback();
+  m_pad_encoder.Reset();
+  ResetPadDataStats();
 
   if (m_dialog->IsRecording())
   {
@@ -968,6 +1072,10 @@ bool NetPlayClient::GetNetPads(const int pad_nb, GCPadStatus* pad_status)
   // clients.
   if (IsFirstInGamePad(pad_nb))
   {
+    sf::Packet packet;
+    packet << static_cast<MessageId>(NP_MSG_PAD_DATA);
+    u32 num_entries = 0;
+
     const int num_local_pads = NumLocalPads();
     for (int local_pad = 0; local_pad < num_local_pads; local_pad++)
     {
@@ -986,31 +1094,51 @@ bool NetPlayClient::GetNetPads(const int pad_nb, GCPadStatus* pad_status)
 
       // adjust the buffer either up or down
       // inserting multiple padstates or dropping states
-      while (m_pad_buffer[ingame_pad].Size() <= m_target_buffer_size)
+      while (BufferedPadStates(ingame_pad) <= m_target_buffer_size)
       {
         // add to buffer
-        m_pad_buffer[ingame_pad].Push(*pad_status);
+        if (m_rollback)
+          m_pad_history[ingame_pad].push_back(*pad_status);
+        else
+          m_pad_buffer[ingame_pad].Push(*pad_status);
 
-        // send
-        SendPadState(ingame_pad, *pad_status);
+        m_pad_encoder.EncodePad(packet, ingame_pad, *pad_status);
+        ++num_entries;
       }
     }
+
+    // send all local pads at once
+    if (num_entries != 0)
+      SendInputData(std::move(packet), num_entries);
   }
 
-  // Now, we either use the data pushed earlier, or wait for the
-  // other clients to send it to us
-  while (m_pad_buffer[pad_nb].Size() == 0)
+  if (m_rollback)
   {
-    if (!m_is_running.IsSet())
-    {
+    if (!GetPadWithRollback(pad_nb, pad_status))
       return false;
+  }
+  else
+  {
+    // Now, we either use the data pushed earlier, or wait for the
+    // other clients to send it to us
+    if (m_pad_buffer[pad_nb].Size() == 0)
+    {
+      const u64 wait_start = Common::Timer::GetTimeUs();
+      while (m_pad_buffer[pad_nb].Size() == 0)
+      {
+        if (!m_is_running.IsSet())
+        {
+          return false;
+        }
+
+        m_gc_pad_event.Wait();
+      }
+      AddInputWaitTime(Common::Timer::GetTimeUs() - wait_start);
     }
 
-    m_gc_pad_event.Wait();
+    m_pad_buffer[pad_nb].Pop(*pad_status);
   }
 
-  m_pad_buffer[pad_nb].Pop(*pad_status);
-
   if (Movie::IsRecordingInput())
   {
     Movie::RecordInput(pad_status, pad_nb);
@@ -1024,6 +1152,311 @@ bool NetPlayClient::GetNetPads(const int pad_nb, GCPadStatus* pad_status)
   return true;
 }
 
+// called from ---GUI--- thread
+void NetPlayClient::ResetRollback()
+{
+  // Recorded inputs are written as they are polled, and Wii Remote data can't be predicted
+  const bool has_wiimotes = std::any_of(m_wiimote_map.begin(), m_wiimote_map.end(),
+                                        [](PadMapping mapping) { return mapping > 0; });
+  m_rollback = g_NetPlaySettings.m_Rollback && !m_dialog->IsRecording() && !has_wiimotes;
+  if (g_NetPlaySettings.m_Rollback && !m_rollback)
+    OSD::AddMessage("Rollback is disabled while recording inputs or using Wii Remotes", 5000);
+
+  for (int pad = 0; pad < 4; pad++)
+  {
+    m_pad_history[pad].clear();
+    m_pad_history_start[pad] = 0;
+    m_pad_polled[pad] = 0;
+    m_pad_predictions[pad].clear();
+    m_pad_mispredicted[pad] = NO_MISPREDICTION;
+  }
+  m_save_points.clear();
+  m_spare_states.clear();
+  m_pending_timebases.clear();
+  m_timebase_frames_sent = 0;
+  m_save_point_requested = false;
+  m_rollback_requested = false;
+}
+
+u64 NetPlayClient::BufferedPadStates(const int ingame_pad) const
+{
+  if (m_rollback)
+    return ConfirmedPolls(ingame_pad) - m_pad_polled[ingame_pad];
+  return m_pad_buffer[ingame_pad].Size();
+}
+
+u64 NetPlayClient::ConfirmedPolls(const int ingame_pad) const
+{
+  return m_pad_history_start[ingame_pad] + m_pad_history[ingame_pad].size();
+}
+
+bool NetPlayClient::HasMisprediction() const
+{
+  return std::any_of(m_pad_mispredicted.begin(), m_pad_mispredicted.end(),
+                     [](u64 poll) { return poll != NO_MISPREDICTION; });
+}
+
+// Whether the emulation up to the given number of polls ran on the real inputs
+bool NetPlayClient::IsConfirmed(const std::array<u64, 4>& polled) const
+{
+  for (int pad = 0; pad < 4; pad++)
+  {
+    if (polled[pad] > ConfirmedPolls(pad) || polled[pad] > m_pad_mispredicted[pad])
+      return false;
+  }
+  return true;
+}
+
+bool NetPlayClient::CanPredict(const int ingame_pad) const
+{
+  // A prediction can only be undone by a save point from before it
+  return ConfirmedPolls(ingame_pad) != 0 &&
+         m_pad_polled[ingame_pad] < ConfirmedPolls(ingame_pad) + MAX_PREDICTED_POLLS &&
+         !m_save_points.empty() && IsConfirmed(m_save_points.front().polled);
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::GetPadWithRollback(const int pad_nb, GCPadStatus* pad_status)
+{
+  ConfirmPredictions();
+
+  const u64 poll = m_pad_polled[pad_nb];
+  if (poll >= ConfirmedPolls(pad_nb) && !CanPredict(pad_nb))
+  {
+    const u64 wait_start = Common::Timer::GetTimeUs();
+    while (poll >= ConfirmedPolls(pad_nb) && !CanPredict(pad_nb))
+    {
+      if (!m_is_running.IsSet())
+        return false;
+
+      m_gc_pad_event.Wait();
+      ConfirmPredictions();
+    }
+    AddInputWaitTime(Common::Timer::GetTimeUs() - wait_start);
+  }
+
+  if (poll < ConfirmedPolls(pad_nb))
+  {
+    *pad_status = m_pad_history[pad_nb][poll - m_pad_history_start[pad_nb]];
+  }
+  else
+  {
+    // The pad is predicted to keep its last confirmed input
+    *pad_status = m_pad_history[pad_nb].back();
+    m_pad_predictions[pad_nb].push_back(*pad_status);
+  }
+
+  m_pad_polled[pad_nb]++;
+  return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::ConfirmPredictions()
+{
+  for (int pad = 0; pad < 4; pad++)
+  {
+    GCPadStatus status;
+    while (m_pad_buffer[pad].Pop(status))
+    {
+      if (!m_pad_predictions[pad].empty())
+      {
+        if (m_pad_mispredicted[pad] == NO_MISPREDICTION &&
+            !IsSamePadStatus(m_pad_predictions[pad].front(), status))
+        {
+          m_pad_mispredicted[pad] = ConfirmedPolls(pad);
+        }
+        m_pad_predictions[pad].pop_front();
+      }
+      m_pad_history[pad].push_back(status);
+    }
+  }
+
+  if (HasMisprediction() && !m_rollback_requested)
+  {
+    m_rollback_requested = true;
+    Core::QueueHostJob([] { RunPausedJob(&NetPlayClient::RollBack); });
+  }
+
+  SendConfirmedTimeBases();
+  TrimRollbackHistory();
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::SendConfirmedTimeBases()
+{
+  while (!m_pending_timebases.empty() && IsConfirmed(m_pending_timebases.front().polled))
+  {
+    const PendingTimeBase& pending = m_pending_timebases.front();
+    // Frames that are emulated again after a rollback have been reported already
+    if (pending.frame >= m_timebase_frames_sent)
+    {
+      SendTimeBasePacket(pending.frame, pending.timebase);
+      m_timebase_frames_sent = pending.frame + 1;
+    }
+    m_pending_timebases.pop_front();
+  }
+}
+
+void NetPlayClient::TrimRollbackHistory()
+{
+  // Only the newest confirmed save point and the ones after it can still be rolled back to
+  while (m_save_points.size() > 1 && IsConfirmed(m_save_points[1].polled))
+  {
+    RecycleState(std::move(m_save_points.front().state));
+    m_save_points.pop_front();
+  }
+
+  // Inputs from before the oldest save point are never polled again. The last confirmed input is
+  // kept for predictions.
+  for (int pad = 0; pad < 4; pad++)
+  {
+    const u64 oldest_poll =
+        m_save_points.empty() ? m_pad_polled[pad] : m_save_points.front().polled[pad];
+    while (m_pad_history[pad].size() > 1 && m_pad_history_start[pad] < oldest_poll)
+    {
+      m_pad_history[pad].pop_front();
+      m_pad_history_start[pad]++;
+    }
+  }
+}
+
+void NetPlayClient::RecycleState(std::vector<u8>&& state)
+{
+  if (m_spare_states.size() < MAX_SPARE_STATES)
+    m_spare_states.push_back(std::move(state));
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::RequestSavePoint()
+{
+  // Save points taken on wrong predictions would be dropped by the rollback anyway
+  if (m_save_point_requested || HasMisprediction())
+    return;
+
+  m_save_point_requested = true;
+  Core::QueueHostJob([] { RunPausedJob(&NetPlayClient::TakeSavePoint); });
+}
+
+// called from ---GUI--- thread
+// Savestates can't be taken or loaded in the middle of the CoreTiming event that polls the pads,
+// so the rollback state is only changed between CPU slices, with the CPU paused.
+void NetPlayClient::RunPausedJob(void (NetPlayClient::*job)())
+{
+  if (!Core::IsRunningAndStarted())
+    return;
+
+  Core::RunAsCPUThread([job] {
+    NetPlayClient* client;
+    {
+      std::lock_guard<std::mutex> lk(crit_netplay_client);
+      client = netplay_client;
+    }
+
+    // The client is only destroyed on this thread, so it can be used without the lock
+    if (client && client->m_rollback && client->m_is_running.IsSet())
+      (client->*job)();
+  });
+}
+
+// called from ---GUI--- thread while the CPU is paused
+void NetPlayClient::TakeSavePoint()
+{
+  m_save_point_requested = false;
+  if (HasMisprediction())
+    return;
+
+  SavePoint save_point;
+  save_point.polled = m_pad_polled;
+  save_point.timebase_frame = m_timebase_frame;
+  if (!m_spare_states.empty())
+  {
+    save_point.state = std::move(m_spare_states.back());
+    m_spare_states.pop_back();
+  }
+
+  const u64 save_start = Common::Timer::GetTimeUs();
+  if (!State::SaveToBuffer(save_point.state))
+  {
+    RecycleState(std::move(save_point.state));
+    return;
+  }
+  const u64 save_us = Common::Timer::GetTimeUs() - save_start;
+
+  m_pad_data_stats.save_points++;
+  m_pad_data_stats.save_point_us += save_us;
+  if (save_us > m_pad_data_stats.max_save_point_us)
+    m_pad_data_stats.max_save_point_us = save_us;
+
+  m_save_points.push_back(std::move(save_point));
+  TrimRollbackHistory();
+}
+
+// called from ---GUI--- thread while the CPU is paused
+void NetPlayClient::RollBack()
+{
+  m_rollback_requested = false;
+  if (!HasMisprediction())
+    return;
+
+  // The newest save point from before every wrong prediction
+  size_t index = m_save_points.size();
+  while (index != 0)
+  {
+    const SavePoint& save_point = m_save_points[index - 1];
+    bool before_mispredictions = true;
+    for (int pad = 0; pad < 4; pad++)
+      before_mispredictions &= save_point.polled[pad] <= m_pad_mispredicted[pad];
+    if (before_mispredictions)
+      break;
+    index--;
+  }
+
+  if (index == 0)
+  {
+    // Predictions are only made while there is a confirmed save point, so this can't happen
+    PanicAlertT("Netplay has desynced. There is no way to recover from this.");
+    m_pad_mispredicted.fill(NO_MISPREDICTION);
+    return;
+  }
+
+  // Later save points ran on wrong predictions
+  while (m_save_points.size() > index)
+  {
+    RecycleState(std::move(m_save_points.back().state));
+    m_save_points.pop_back();
+  }
+  SavePoint& save_point = m_save_points.back();
+
+  const u64 load_start = Common::Timer::GetTimeUs();
+  State::LoadFromBufferForNetPlay(save_point.state);
+  const u64 load_us = Common::Timer::GetTimeUs() - load_start;
+
+  u64 rolled_back_polls = 0;
+  for (int pad = 0; pad < 4; pad++)
+  {
+    rolled_back_polls += m_pad_polled[pad] - save_point.polled[pad];
+    m_pad_polled[pad] = save_point.polled[pad];
+
+    // Predictions from before the save point are still checked against the real inputs
+    const u64 confirmed = ConfirmedPolls(pad);
+    m_pad_predictions[pad].resize(m_pad_polled[pad] > confirmed ? m_pad_polled[pad] - confirmed :
+                                                                   0);
+    m_pad_mispredicted[pad] = NO_MISPREDICTION;
+  }
+
+  m_timebase_frame = save_point.timebase_frame;
+  while (!m_pending_timebases.empty() && m_pending_timebases.back().frame >= m_timebase_frame)
+    m_pending_timebases.pop_back();
+
+  m_pad_data_stats.rollbacks++;
+  m_pad_data_stats.rollback_us += load_us;
+  if (load_us > m_pad_data_stats.max_rollback_us)
+    m_pad_data_stats.max_rollback_us = load_us;
+  m_pad_data_stats.rolled_back_polls += rolled_back_polls;
+
+  TrimRollbackHistory();
+}
+
 // called from ---CPU--- thread
 bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size, u8 reporting_mode)
 {
@@ -1035,28 +1468,40 @@ bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size, u8 repor
     if (m_wiimote_map[_number] == m_local_player->pid)
     {
       nw.assign(data, data + size);
+
+      sf::Packet packet;
+      packet << static_cast<MessageId>(NP_MSG_WIIMOTE_DATA);
+      u32 num_entries = 0;
       do
       {
         // add to buffer
         m_wiimote_buffer[_number].Push(nw);
 
-        SendWiimoteState(_number, nw);
+        m_pad_encoder.EncodeWiimote(packet, _number, nw);
+        ++num_entries;
       } while (m_wiimote_buffer[_number].Size() <=
                m_target_buffer_size * 200 /
                    120);  // TODO: add a seperate setting for wiimote buffer?
+
+      SendInputData(std::move(packet), num_entries);
     }
 
   }  // unlock players
 
-  while (m_wiimote_buffer[_number].Size() == 0)
+  if (m_wiimote_buffer[_number].Size() == 0)
   {
-    if (!m_is_running.IsSet())
+    const u64 wait_start = Common::Timer::GetTimeUs();
+    while (m_wiimote_buffer[_number].Size() == 0)
     {
-      return false;
-    }
+      if (!m_is_running.IsSet())
+      {
+        return false;
+      }
 
-    // wait for receiving thread to push some data
-    m_wii_pad_event.Wait();
+      // wait for receiving thread to push some data
+      m_wii_pad_event.Wait();
+    }
+    AddInputWaitTime(Common::Timer::GetTimeUs() - wait_start);
   }
 
   m_wiimote_buffer[_number].Pop(nw);
@@ -1101,7 +1546,8 @@ bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size, u8 repor
 // called from ---GUI--- thread and ---NETPLAY--- thread (client side)
 bool NetPlayClient::StopGame()
 {
-  m_is_running.Clear();
+  if (m_is_running.TestAndClear())
+    LogPadDataStats();
 
   // stop waiting for input
   m_gc_pad_event.Set();
@@ -1199,13 +1645,28 @@ void NetPlayClient::SendTimeBase()
 
   u64 timebase = SystemTimers::GetFakeTimeBase();
 
+  if (netplay_client->m_rollback)
+  {
+    // Frames that ran on predicted inputs are only reported once their inputs are confirmed
+    netplay_client->m_pending_timebases.push_back(
+        {netplay_client->m_timebase_frame++, timebase, netplay_client->m_pad_polled});
+    netplay_client->SendConfirmedTimeBases();
+    netplay_client->RequestSavePoint();
+    return;
+  }
+
+  netplay_client->SendTimeBasePacket(netplay_client->m_timebase_frame++, timebase);
+}
+
+void NetPlayClient::SendTimeBasePacket(const u32 frame, const u64 timebase)
+{
   sf::Packet packet;
   packet << static_cast<MessageId>(NP_MSG_TIMEBASE);
   packet << static_cast<u32>(timebase);
   packet << static_cast<u32>(timebase << 32);
-  packet << netplay_client->m_timebase_frame++;
+  packet << frame;
 
-  netplay_client->SendAsync(std::move(packet));
+  SendAsync(std::move(packet));
 }
 
 bool NetPlayClient::DoAllPlayersHaveGame()
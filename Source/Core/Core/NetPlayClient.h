@@ -6,6 +6,8 @@
 
 #include <SFML/Network/Packet.hpp>
 #include <array>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
@@ -15,6 +17,7 @@
 #include "Common/Event.h"
 #include "Common/FifoQueue.h"
 #include "Common/TraversalClient.h"
+#include "Core/NetPlayPadData.h"
 #include "Core/NetPlayProto.h"
 #include "InputCommon/GCPadStatus.h"
 
@@ -98,6 +101,30 @@ public:
   static void SendTimeBase();
   bool DoAllPlayersHaveGame();
 
+  // Counters for the pad and Wiimote data of the current game
+  struct PadDataStats
+  {
+    u64 messages_sent;
+    u64 entries_sent;
+    u64 bytes_sent;
+    u64 messages_received;
+    u64 entries_received;
+    u64 bytes_received;
+    // Time the CPU thread spent waiting for input from other players
+    u64 input_waits;
+    u64 input_wait_us;
+    u64 max_input_wait_us;
+    // Rollback mode: savestates taken and loaded, and the pad polls that were emulated again
+    u64 save_points;
+    u64 save_point_us;
+    u64 max_save_point_us;
+    u64 rollbacks;
+    u64 rollback_us;
+    u64 max_rollback_us;
+    u64 rolled_back_polls;
+  };
+  PadDataStats GetPadDataStats() const;
+
 protected:
   void ClearBuffers();
 
@@ -146,14 +173,51 @@ private:
     Failure
   };
 
+  // A state to roll back to, with the number of times each in-game pad had been polled and the
+  // number of the next frame whose timebase is reported
+  struct SavePoint
+  {
+    std::array<u64, 4> polled;
+    u32 timebase_frame;
+    std::vector<u8> state;
+  };
+
+  // A frame timebase that waits for the inputs of the frame to be confirmed
+  struct PendingTimeBase
+  {
+    u32 frame;
+    u64 timebase;
+    std::array<u64, 4> polled;
+  };
+
   bool LocalPlayerHasControllerMapped() const;
 
   void SendStartGamePacket();
   void SendStopGamePacket();
 
   void UpdateDevices();
-  void SendPadState(int in_game_pad, const GCPadStatus& np);
-  void SendWiimoteState(int in_game_pad, const NetWiimote& nw);
+  void SendInputData(sf::Packet&& packet, u32 num_entries);
+  void SendTimeBasePacket(u32 frame, u64 timebase);
+
+  void ResetRollback();
+  bool GetPadWithRollback(int pad_nb, GCPadStatus* pad_status);
+  u64 BufferedPadStates(int ingame_pad) const;
+  u64 ConfirmedPolls(int ingame_pad) const;
+  bool HasMisprediction() const;
+  bool IsConfirmed(const std::array<u64, 4>& polled) const;
+  bool CanPredict(int ingame_pad) const;
+  void ConfirmPredictions();
+  void SendConfirmedTimeBases();
+  void TrimRollbackHistory();
+  void RecycleState(std::vector<u8>&& state);
+  void RequestSavePoint();
+  void TakeSavePoint();
+  void RollBack();
+  static void RunPausedJob(void (NetPlayClient::*job)());
+
+  void AddInputWaitTime(u64 wait_us);
+  void ResetPadDataStats();
+  void LogPadDataStats() const;
   unsigned int OnData(sf::Packet& packet);
   void Send(const sf::Packet& packet);
   void Disconnect();
@@ -176,7 +240,53 @@ private:
   Common::Event m_gc_pad_event;
   Common::Event m_wii_pad_event;
 
+  // The encoder is used on the CPU thread and the decoder on the netplay thread
+  NetPlay::PadDataCodec m_pad_encoder;
+  NetPlay::PadDataCodec m_pad_decoder;
+
+  struct
+  {
+    std::atomic<u64> messages_sent{0};
+    std::atomic<u64> entries_sent{0};
+    std::atomic<u64> bytes_sent{0};
+    std::atomic<u64> messages_received{0};
+    std::atomic<u64> entries_received{0};
+    std::atomic<u64> bytes_received{0};
+    std::atomic<u64> input_waits{0};
+    std::atomic<u64> input_wait_us{0};
+    std::atomic<u64> max_input_wait_us{0};
+    std::atomic<u64> save_points{0};
+    std::atomic<u64> save_point_us{0};
+    std::atomic<u64> max_save_point_us{0};
+    std::atomic<u64> rollbacks{0};
+    std::atomic<u64> rollback_us{0};
+    std::atomic<u64> max_rollback_us{0};
+    std::atomic<u64> rolled_back_polls{0};
+  } m_pad_data_stats;
+
   u32 m_timebase_frame = 0;
+
+  // Rollback mode, see NetSettings::m_Rollback. Remote pads whose input hasn't arrived yet are
+  // predicted to keep their last input. When a prediction turns out wrong, the emulation is rolled
+  // back to a save point and runs again with the real inputs. These are used on the CPU thread, or
+  // by the host thread while the CPU is paused.
+  bool m_rollback = false;
+  // Confirmed inputs of each in-game pad, starting at poll m_pad_history_start[pad]. Local inputs
+  // go here directly, remote inputs once they have been taken from m_pad_buffer.
+  std::array<std::deque<GCPadStatus>, 4> m_pad_history;
+  std::array<u64, 4> m_pad_history_start{};
+  std::array<u64, 4> m_pad_polled{};
+  // Predictions for the polls between the confirmed inputs and m_pad_polled
+  std::array<std::deque<GCPadStatus>, 4> m_pad_predictions;
+  // First poll of each pad that was predicted wrong, or NO_MISPREDICTION
+  std::array<u64, 4> m_pad_mispredicted{};
+  // The oldest save point is the newest one that no longer depends on predictions
+  std::deque<SavePoint> m_save_points;
+  std::vector<std::vector<u8>> m_spare_states;
+  std::deque<PendingTimeBase> m_pending_timebases;
+  u32 m_timebase_frames_sent = 0;
+  bool m_save_point_requested = false;
+  bool m_rollback_requested = false;
 };
 
 void NetPlay_Enable(NetPlayClient* const np);
@@ -0,0 +1,157 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/NetPlayPadData.h"
+
+#include <array>
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+namespace NetPlay
+{
+namespace
+{
+// Bit 0 of the field mask stands for the buttons, the next bits for these values in order
+constexpr std::array<u8 GCPadStatus::*, 8> ANALOG_FIELDS = {
+    {&GCPadStatus::analogA, &GCPadStatus::analogB, &GCPadStatus::stickX, &GCPadStatus::stickY,
+     &GCPadStatus::substickX, &GCPadStatus::substickY, &GCPadStatus::triggerLeft,
+     &GCPadStatus::triggerRight}};
+
+constexpr u16 BUTTON_FIELD = 1;
+constexpr u16 ALL_FIELDS = (1 << (ANALOG_FIELDS.size() + 1)) - 1;
+
+constexpr u16 AnalogField(size_t index)
+{
+  return static_cast<u16>(2 << index);
+}
+
+bool IsValidMapping(PadMapping map)
+{
+  return map >= 0 && map < 4;
+}
+
+// Applies the changed fields of an entry to the previous state of its pad
+bool ReadPad(sf::Packet& packet, PadMapping* map, std::array<GCPadStatus, 4>* pads)
+{
+  u16 fields = 0;
+  if (!(packet >> *map >> fields) || !IsValidMapping(*map) || (fields & ~ALL_FIELDS) != 0)
+    return false;
+
+  GCPadStatus& pad = (*pads)[*map];
+  if (fields & BUTTON_FIELD)
+    packet >> pad.button;
+  for (size_t i = 0; i < ANALOG_FIELDS.size(); ++i)
+  {
+    if (fields & AnalogField(i))
+      packet >> pad.*ANALOG_FIELDS[i];
+  }
+
+  return static_cast<bool>(packet);
+}
+
+// A report with no data repeats the previous report
+bool ReadWiimote(sf::Packet& packet, PadMapping* map, std::array<NetWiimote, 4>* wiimotes)
+{
+  u8 size = 0;
+  if (!(packet >> *map >> size) || !IsValidMapping(*map))
+    return false;
+
+  if (size == 0)
+    return true;
+
+  NetWiimote& wiimote = (*wiimotes)[*map];
+  wiimote.resize(size);
+  for (u8& byte : wiimote)
+    packet >> byte;
+
+  return static_cast<bool>(packet);
+}
+}  // Anonymous namespace
+
+PadDataCodec::PadDataCodec()
+{
+  Reset();
+}
+
+void PadDataCodec::Reset()
+{
+  m_pads.fill({});
+  for (NetWiimote& wiimote : m_wiimotes)
+    wiimote.clear();
+}
+
+void PadDataCodec::EncodePad(sf::Packet& packet, PadMapping map, const GCPadStatus& pad)
+{
+  GCPadStatus& previous = m_pads.at(map);
+
+  u16 fields = 0;
+  if (pad.button != previous.button)
+    fields |= BUTTON_FIELD;
+  for (size_t i = 0; i < ANALOG_FIELDS.size(); ++i)
+  {
+    if (pad.*ANALOG_FIELDS[i] != previous.*ANALOG_FIELDS[i])
+      fields |= AnalogField(i);
+  }
+
+  packet << map << fields;
+  if (fields & BUTTON_FIELD)
+    packet << pad.button;
+  for (size_t i = 0; i < ANALOG_FIELDS.size(); ++i)
+  {
+    if (fields & AnalogField(i))
+      packet << pad.*ANALOG_FIELDS[i];
+  }
+
+  previous.button = pad.button;
+  for (u8 GCPadStatus::*field : ANALOG_FIELDS)
+    previous.*field = pad.*field;
+}
+
+void PadDataCodec::EncodeWiimote(sf::Packet& packet, PadMapping map, const NetWiimote& wiimote)
+{
+  NetWiimote& previous = m_wiimotes.at(map);
+
+  packet << map;
+  if (!wiimote.empty() && wiimote == previous)
+  {
+    packet << static_cast<u8>(0);
+    return;
+  }
+
+  packet << static_cast<u8>(wiimote.size());
+  packet.append(wiimote.data(), wiimote.size());
+  previous = wiimote;
+}
+
+bool PadDataCodec::DecodePad(sf::Packet& packet, PadMapping* map, GCPadStatus* pad)
+{
+  if (!ReadPad(packet, map, &m_pads))
+    return false;
+
+  *pad = m_pads[*map];
+  return true;
+}
+
+bool PadDataCodec::DecodeWiimote(sf::Packet& packet, PadMapping* map, NetWiimote* wiimote)
+{
+  if (!ReadWiimote(packet, map, &m_wiimotes) || m_wiimotes[*map].empty())
+    return false;
+
+  *wiimote = m_wiimotes[*map];
+  return true;
+}
+
+bool PadDataCodec::SkipPad(sf::Packet& packet, PadMapping* map)
+{
+  std::array<GCPadStatus, 4> pads;
+  return ReadPad(packet, map, &pads);
+}
+
+bool PadDataCodec::SkipWiimote(sf::Packet& packet, PadMapping* map)
+{
+  std::array<NetWiimote, 4> wiimotes;
+  return ReadWiimote(packet, map, &wiimotes);
+}
+}  // namespace NetPlay
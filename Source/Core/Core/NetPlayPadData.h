@@ -0,0 +1,46 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "Common/CommonTypes.h"
+#include "Core/NetPlayProto.h"
+#include "InputCommon/GCPadStatus.h"
+
+namespace NetPlay
+{
+// Compact encoding of the entries of NP_MSG_PAD_DATA and NP_MSG_WIIMOTE_DATA. A message holds the
+// entries for all inputs that were polled at once, and is read until the end of the packet.
+//
+// A GC pad entry only contains the fields that changed since the previous state of the same
+// in-game pad, and a Wiimote entry that repeats the previous report has no data. Messages are
+// reliable and ordered, so every receiver decodes the same states that the sender encoded, as
+// long as both ends are reset when a game starts.
+class PadDataCodec final
+{
+public:
+  PadDataCodec();
+
+  void Reset();
+
+  void EncodePad(sf::Packet& packet, PadMapping map, const GCPadStatus& pad);
+  void EncodeWiimote(sf::Packet& packet, PadMapping map, const NetWiimote& wiimote);
+
+  // These return false if the entry is malformed
+  bool DecodePad(sf::Packet& packet, PadMapping* map, GCPadStatus* pad);
+  bool DecodeWiimote(sf::Packet& packet, PadMapping* map, NetWiimote* wiimote);
+
+  // Reads past an entry without decoding it, for relaying
+  static bool SkipPad(sf::Packet& packet, PadMapping* map);
+  static bool SkipWiimote(sf::Packet& packet, PadMapping* map);
+
+private:
+  std::array<GCPadStatus, 4> m_pads;
+  std::array<NetWiimote, 4> m_wiimotes;
+};
+}  // namespace NetPlay
@@ -25,6 +25,8 @@ struct NetSettings
   bool m_OCEnable;
   float m_OCFactor;
   ExpansionInterface::TEXIDevices m_EXIDevice[2];
+  // Predict the inputs of other players and roll back when they differ, see NetPlayClient
+  bool m_Rollback;
 };
 
 struct NetTraversalConfig
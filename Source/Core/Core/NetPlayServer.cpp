@@ -24,6 +24,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/HW/Sram.h"
 #include "Core/NetPlayClient.h"  //for NetPlayUI
+#include "Core/NetPlayPadData.h"
 #include "InputCommon/GCPadStatus.h"
 #if !defined(_WIN32)
 #include <sys/socket.h>
@@ -517,25 +518,20 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (player.current_game != m_current_game)
       break;
 
-    PadMapping map = 0;
-    GCPadStatus pad;
-    packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-        pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
-
-    // If the data is not from the correct player,
-    // then disconnect them.
-    if (m_pad_map.at(map) != player.pid)
+    while (!packet.endOfPacket())
     {
-      return 1;
-    }
+      PadMapping map = 0;
 
-    // Relay to clients
-    sf::Packet spac;
-    spac << (MessageId)NP_MSG_PAD_DATA;
-    spac << map << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
-         << pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight;
+      // If the data is not from the correct player,
+      // then disconnect them.
+      if (!NetPlay::PadDataCodec::SkipPad(packet, &map) || m_pad_map[map] != player.pid)
+      {
+        return 1;
+      }
+    }
 
-    SendToClients(spac, player.pid);
+    // Relay to clients as is, since they decode the entries themselves
+    SendToClients(packet, player.pid);
   }
   break;
 
@@ -545,29 +541,20 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (player.current_game != m_current_game)
       break;
 
-    PadMapping map = 0;
-    u8 size;
-    packet >> map >> size;
-    std::vector<u8> data(size);
-    for (size_t i = 0; i < data.size(); ++i)
-      packet >> data[i];
-
-    // If the data is not from the correct player,
-    // then disconnect them.
-    if (m_wiimote_map.at(map) != player.pid)
+    while (!packet.endOfPacket())
     {
-      return 1;
-    }
+      PadMapping map = 0;
 
-    // relay to clients
-    sf::Packet spac;
-    spac << (MessageId)NP_MSG_WIIMOTE_DATA;
-    spac << map;
-    spac << size;
-    for (const u8& byte : data)
-      spac << byte;
+      // If the data is not from the correct player,
+      // then disconnect them.
+      if (!NetPlay::PadDataCodec::SkipWiimote(packet, &map) || m_wiimote_map[map] != player.pid)
+      {
+        return 1;
+      }
+    }
 
-    SendToClients(spac, player.pid);
+    // Relay to clients as is
+    SendToClients(packet, player.pid);
   }
   break;
 
@@ -825,6 +812,7 @@ bool NetPlayServer::StartGame()
   spac << m_settings.m_OCFactor;
   spac << m_settings.m_EXIDevice[0];
   spac << m_settings.m_EXIDevice[1];
+  spac << m_settings.m_Rollback;
   spac << (u32)g_netplay_initial_rtc;
   spac << (u32)(g_netplay_initial_rtc >> 32);
 
@@ -838,13 +826,19 @@ bool NetPlayServer::StartGame()
 // called from multiple threads
 void NetPlayServer::SendToClients(const sf::Packet& packet, const PlayerId skip_pid)
 {
+  // All clients share one copy of the data, which ENet frees once every peer is done with it
+  ENetPacket* epac =
+      enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
   for (auto& p : m_players)
   {
     if (p.second.pid && p.second.pid != skip_pid)
     {
-      Send(p.second.socket, packet);
+      enet_peer_send(p.second.socket, 0, epac);
     }
   }
+
+  if (epac->referenceCount == 0)
+    enet_packet_destroy(epac);
 }
 
 void NetPlayServer::Send(ENetPeer* socket, const sf::Packet& packet)
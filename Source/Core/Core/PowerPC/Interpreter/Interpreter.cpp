@@ -314,7 +314,10 @@ void Interpreter::Run()
 void Interpreter::unknown_instruction(UGeckoInstruction inst)
 {
   if (ARBruteForcer::ch_bruteforce)
+  {
     Core::KillDolphinAndRestart();
+    return;
+  }
 
   std::string disasm = GekkoDisassembler::Disassemble(PowerPC::HostRead_U32(last_pc), last_pc);
   NOTICE_LOG(POWERPC, "Last PC = %08x : %s", last_pc, disasm.c_str());
@@ -18,6 +18,7 @@
 #include "Common/MemoryUtil.h"
 #include "Common/PerformanceCounter.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 #include "Common/x64ABI.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -566,6 +567,8 @@ void Jit64::Trace()
 
 void Jit64::Jit(u32 em_address)
 {
+  Common::Trace::ScopedZone trace_zone("JIT compile");
+
   if (m_cleanup_after_stackfault)
   {
     ClearCache();
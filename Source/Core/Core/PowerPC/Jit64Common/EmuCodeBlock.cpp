@@ -4,7 +4,9 @@
 
 #include "Core/PowerPC/Jit64Common/EmuCodeBlock.h"
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
 
 #include "Common/Assert.h"
@@ -114,6 +116,99 @@ FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_
   return J_CC(CC_Z, m_far_code.Enabled());
 }
 
+FixupBranch EmuCodeBlock::TLBL0Access(const OpArg& reg_value, X64Reg reg_addr, int accessSize,
+                                      bool write, bool swap, bool signExtend,
+                                      BitSet32 registers_in_use)
+{
+  // Get ourselves two registers that don't hold the address or the value, preferring ones that
+  // don't have to be saved
+  BitSet32 reserved;
+  reserved[reg_addr] = true;
+  if (reg_value.IsSimpleReg())
+    reserved[reg_value.GetSimpleReg()] = true;
+
+  static constexpr X64Reg candidates[] = {RSCRATCH, RSCRATCH2, RSCRATCH_EXTRA, R8, R9, R10, R11};
+  X64Reg temps[2] = {INVALID_REG, INVALID_REG};
+  size_t num_temps = 0;
+  for (bool allow_in_use : {false, true})
+  {
+    for (X64Reg reg : candidates)
+    {
+      const bool in_use = registers_in_use[reg];
+      if (num_temps < 2 && !reserved[reg] && in_use == allow_in_use)
+      {
+        temps[num_temps++] = reg;
+        reserved[reg] = true;
+      }
+    }
+  }
+  const X64Reg entry = temps[0];
+  const X64Reg paddr = temps[1];
+
+  for (X64Reg reg : temps)
+  {
+    if (registers_in_use[reg])
+      PUSH(reg);
+  }
+
+  const PowerPC::TLBL0& l0 = write ? PowerPC::write_tlb_l0 : PowerPC::read_tlb_l0;
+  const int bytes = accessSize >> 3;
+
+  MOV(32, R(paddr), R(reg_addr));
+  SHR(32, R(paddr), Imm8(PowerPC::HW_PAGE_INDEX_SHIFT));
+  AND(32, R(paddr), Imm32(PowerPC::TLB_L0_SIZE - 1));
+  MOV(64, R(entry), ImmPtr(l0.data()));
+  LEA(64, entry, MComplex(entry, paddr, SCALE_8, 0));
+
+  MOV(32, R(paddr), R(reg_addr));
+  AND(32, R(paddr), Imm32(~static_cast<u32>(PowerPC::HW_PAGE_SIZE - 1)));
+  CMP(32, R(paddr), MDisp(entry, static_cast<int>(offsetof(PowerPC::TLBL0Entry, tag))));
+  FixupBranch tag_miss = J_CC(CC_NE);
+
+  // Accesses that cross into the next page may need a different translation
+  MOV(32, R(paddr), R(reg_addr));
+  AND(32, R(paddr), Imm32(PowerPC::HW_PAGE_SIZE - 1));
+  CMP(32, R(paddr), Imm32(PowerPC::HW_PAGE_SIZE - bytes));
+  FixupBranch crosses_page = J_CC(CC_A);
+
+  ADD(32, R(paddr), MDisp(entry, static_cast<int>(offsetof(PowerPC::TLBL0Entry, paddr))));
+  MOV(64, R(entry), ImmPtr(&Memory::physical_base));
+  MOV(64, R(entry), MatR(entry));
+  const OpArg memory = MComplex(entry, paddr, SCALE_1, 0);
+  if (!write)
+  {
+    LoadAndSwap(accessSize, reg_value.GetSimpleReg(), memory, signExtend);
+  }
+  else if (reg_value.IsImm())
+  {
+    MOV(accessSize, memory, swap ? SwapImmediate(accessSize, reg_value) : reg_value);
+  }
+  else if (swap)
+  {
+    SwapAndStore(accessSize, memory, reg_value.GetSimpleReg());
+  }
+  else
+  {
+    MOV(accessSize, memory, reg_value);
+  }
+
+  for (auto it = std::rbegin(temps); it != std::rend(temps); ++it)
+  {
+    if (registers_in_use[*it])
+      POP(*it);
+  }
+  FixupBranch hit = J(true);
+
+  SetJumpTarget(tag_miss);
+  SetJumpTarget(crosses_page);
+  for (auto it = std::rbegin(temps); it != std::rend(temps); ++it)
+  {
+    if (registers_in_use[*it])
+      POP(*it);
+  }
+  return hit;
+}
+
 void EmuCodeBlock::UnsafeLoadRegToReg(X64Reg reg_addr, X64Reg reg_value, int accessSize, s32 offset,
                                       bool signExtend)
 {
@@ -398,6 +493,15 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
       exit = J(true);
     SetJumpTarget(slow);
   }
+
+  FixupBranch tlb_hit;
+  bool tlb_probe = dr_set && g_jit->jo.tlb_probe;
+  if (tlb_probe)
+  {
+    tlb_hit = TLBL0Access(R(reg_value), reg_addr, accessSize, false, true, signExtend,
+                          registersInUse);
+  }
+
   size_t rsp_alignment = (flags & SAFE_LOADSTORE_NO_PROLOG) ? 8 : 0;
   ABI_PushRegistersAndAdjustStack(registersInUse, rsp_alignment);
   switch (accessSize)
@@ -428,6 +532,9 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     MOVZX(64, accessSize, reg_value, R(ABI_RETURN));
   }
 
+  if (tlb_probe)
+    SetJumpTarget(tlb_hit);
+
   if (fast_check_address)
   {
     if (m_far_code.Enabled())
@@ -554,6 +661,13 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     SetJumpTarget(slow);
   }
 
+  FixupBranch tlb_hit;
+  bool tlb_probe = dr_set && g_jit->jo.tlb_probe;
+  if (tlb_probe)
+  {
+    tlb_hit = TLBL0Access(reg_value, reg_addr, accessSize, true, swap, false, registersInUse);
+  }
+
   // PC is used by memory watchpoints (if enabled) or to print accurate PC locations in debug logs
   MOV(32, PPCSTATE(pc), Imm32(g_jit->js.compilerPC));
 
@@ -591,6 +705,9 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
   MemoryExceptionCheck();
 
+  if (tlb_probe)
+    SetJumpTarget(tlb_hit);
+
   if (fast_check_address)
   {
     if (m_far_code.Enabled())
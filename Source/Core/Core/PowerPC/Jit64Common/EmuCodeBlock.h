@@ -49,6 +49,10 @@ public:
 
   Gen::FixupBranch CheckIfSafeAddress(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
                                       BitSet32 registers_in_use);
+  // Performs a page table translated access if the page is in the TLB L0. Falls through on a miss,
+  // the returned branch is taken after a hit.
+  Gen::FixupBranch TLBL0Access(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr, int accessSize,
+                               bool write, bool swap, bool signExtend, BitSet32 registers_in_use);
   void UnsafeLoadRegToReg(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
                           s32 offset = 0, bool signExtend = false);
   void UnsafeLoadRegToRegNoSwap(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
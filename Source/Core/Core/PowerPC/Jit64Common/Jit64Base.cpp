@@ -50,9 +50,14 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
   if (it == m_back_patch_info.end())
   {
     if (ARBruteForcer::ch_bruteforce)
+    {
       Core::KillDolphinAndRestart();
-    else
-      PanicAlert("BackPatch: no register use entry for address %p", codePtr);
+      // The fault stopped the CPU, so leave the block through the timing check. That exits the
+      // JIT without running the faulting access or anything that depends on it.
+      ctx->CTX_PC = reinterpret_cast<u64>(GetAsmRoutines()->doTiming);
+      return true;
+    }
+    PanicAlert("BackPatch: no register use entry for address %p", codePtr);
     return false;
   }
 
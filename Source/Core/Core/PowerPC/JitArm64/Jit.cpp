@@ -12,6 +12,7 @@
 #include "Common/MathUtil.h"
 #include "Common/PerformanceCounter.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -533,6 +534,8 @@ void JitArm64::SingleStep()
 
 void JitArm64::Jit(u32)
 {
+  Common::Trace::ScopedZone trace_zone("JIT compile");
+
   if (m_cleanup_after_stackfault)
   {
     ClearCache();
@@ -5,6 +5,7 @@
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #include "Common/CommonTypes.h"
+#include "Core/Benchmark.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/PPCAnalyst.h"
@@ -14,6 +15,7 @@ JitBase* g_jit;
 
 void JitTrampoline(u32 em_address)
 {
+  Benchmark::ScopedTimer timer(Benchmark::Counter::JITCompile);
   g_jit->Jit(em_address);
 }
 
@@ -48,4 +50,5 @@ void JitBase::UpdateMemoryOptions()
   bool any_watchpoints = PowerPC::memchecks.HasAny();
   jo.fastmem = SConfig::GetInstance().bFastmem && (UReg_MSR(MSR).DR || !any_watchpoints);
   jo.memcheck = SConfig::GetInstance().bMMU || any_watchpoints;
+  jo.tlb_probe = SConfig::GetInstance().bMMU && !any_watchpoints;
 }
@@ -52,6 +52,8 @@ protected:
     bool accurateSinglePrecision;
     bool fastmem;
     bool memcheck;
+    // Probe the TLB L0 inline before calling into the MMU for translated accesses
+    bool tlb_probe;
   };
   struct JitState
   {
@@ -2,12 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "Common/Atomic.h"
 #include "Common/BitUtils.h"
+#include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 
 #include "Core/ARBruteForcer.h"
@@ -28,9 +31,8 @@
 
 namespace PowerPC
 {
-constexpr size_t HW_PAGE_SIZE = 4096;
-constexpr u32 HW_PAGE_INDEX_SHIFT = 12;
-constexpr u32 HW_PAGE_INDEX_MASK = 0x3f;
+// Selects the set of a page in the TLBs, depends on the configured TLB size
+static u32 s_tlb_index_mask = TLB_SIZE / TLB_WAYS - 1;
 
 // EFB RE
 /*
@@ -165,6 +167,10 @@ static void EFB_Write(u32 data, u32 addr)
 BatTable ibat_table;
 BatTable dbat_table;
 
+TLBL0 read_tlb_l0;
+TLBL0 write_tlb_l0;
+TLBStats tlb_stats;
+
 static void GenerateDSIException(u32 _EffectiveAddress, bool _bWrite);
 
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
@@ -978,10 +984,47 @@ enum TLBLookupResult
   TLB_UPDATE_C
 };
 
+static void ClearTLBL0()
+{
+  read_tlb_l0.fill({});
+  write_tlb_l0.fill({});
+}
+
+static void InvalidateTLBL0(const u32 tag)
+{
+  const u32 page_address = tag << HW_PAGE_INDEX_SHIFT;
+  for (TLBL0* l0 : {&read_tlb_l0, &write_tlb_l0})
+  {
+    TLBL0Entry& entry = (*l0)[tag & (TLB_L0_SIZE - 1)];
+    if (entry.tag == page_address)
+      entry = {};
+  }
+}
+
+// Adds a data translation to the L0 that the JIT probes, if it points to RAM. Everything else
+// goes through ReadFromHardware and WriteToHardware.
+static void UpdateTLBL0(const XCheckTLBFlag flag, const u32 address, const u32 paddr)
+{
+  if (flag != FLAG_READ && flag != FLAG_WRITE)
+    return;
+
+  const u32 page = paddr & ~(HW_PAGE_SIZE - 1);
+  const bool is_ram = page < Memory::RAM_SIZE ||
+                      (Memory::m_pEXRAM && (page >> 28) == 0x1 &&
+                       (page & 0x0FFFFFFF) < Memory::EXRAM_SIZE);
+  if (!is_ram)
+    return;
+
+  TLBL0& l0 = flag == FLAG_WRITE ? write_tlb_l0 : read_tlb_l0;
+  TLBL0Entry& entry = l0[(address >> HW_PAGE_INDEX_SHIFT) & (TLB_L0_SIZE - 1)];
+  entry.tag = address & ~(HW_PAGE_SIZE - 1);
+  entry.paddr = page;
+}
+
 static TLBLookupResult LookupTLBPageAddress(const XCheckTLBFlag flag, const u32 vpa, u32* paddr)
 {
   const u32 tag = vpa >> HW_PAGE_INDEX_SHIFT;
-  TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
+  TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & s_tlb_index_mask];
 
   if (tlbe.tag[0] == tag)
   {
@@ -1035,9 +1078,11 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
   if (IsNoExceptionFlag(flag))
     return;
 
-  const int tag = address >> HW_PAGE_INDEX_SHIFT;
-  TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & s_tlb_index_mask];
   const int index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  if (!IsOpcodeFlag(flag) && tlbe.tag[index] != TLBEntry::INVALID_TAG)
+    InvalidateTLBL0(tlbe.tag[index]);
   tlbe.recent = index;
   tlbe.paddr[index] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = PTE2.Hex;
@@ -1046,7 +1091,8 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
 
 void InvalidateTLBEntry(u32 address)
 {
-  const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
+  const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & s_tlb_index_mask;
+  InvalidateTLBL0(address >> HW_PAGE_INDEX_SHIFT);
 
   TLBEntry& tlbe = ppcState.tlb[0][entry_index];
   tlbe.tag[0] = TLBEntry::INVALID_TAG;
@@ -1057,6 +1103,52 @@ void InvalidateTLBEntry(u32 address)
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
 }
 
+void ResetTLB()
+{
+  // The set index is a mask of the page number, so the size is rounded up to a power of two
+  size_t size = TLB_SIZE;
+  const size_t configured_size = static_cast<size_t>(std::max(SConfig::GetInstance().iTLBSize, 0));
+  while (size < configured_size && size < MAX_TLB_SIZE)
+    size *= 2;
+  s_tlb_index_mask = static_cast<u32>(size / TLB_WAYS - 1);
+
+  for (auto& tlb : ppcState.tlb)
+    tlb.fill({});
+  ClearTLBL0();
+  tlb_stats = {};
+}
+
+void DoTLBState(PointerWrap& p)
+{
+  // The size is stored so that states stay loadable when the configured size changes, in which
+  // case the TLBs start out empty
+  u32 num_sets = s_tlb_index_mask + 1;
+  p.Do(num_sets);
+  if (p.GetMode() == PointerWrap::MODE_READ && num_sets > MAX_TLB_SIZE / TLB_WAYS)
+  {
+    p.SetMode(PointerWrap::MODE_MEASURE);
+    return;
+  }
+
+  const bool size_matches = num_sets == s_tlb_index_mask + 1;
+  for (auto& tlb : ppcState.tlb)
+  {
+    if (size_matches)
+    {
+      p.DoArray(tlb.data(), num_sets);
+    }
+    else
+    {
+      std::vector<TLBEntry> ignored(num_sets);
+      p.DoArray(ignored.data(), num_sets);
+      tlb.fill({});
+    }
+  }
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    ClearTLBL0();
+}
+
 // Page Address Translation
 static TranslateAddressResult TranslatePageAddress(const u32 address, const XCheckTLBFlag flag)
 {
@@ -1067,7 +1159,15 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
   u32 translatedAddress = 0;
   TLBLookupResult res = LookupTLBPageAddress(flag, address, &translatedAddress);
   if (res == TLB_FOUND)
+  {
+    tlb_stats.hits++;
+    UpdateTLBL0(flag, address, translatedAddress);
     return TranslateAddressResult{TranslateAddressResult::PAGE_TABLE_TRANSLATED, translatedAddress};
+  }
+
+  if (res == TLB_NOTFOUND)
+    tlb_stats.misses++;
+  tlb_stats.page_walks++;
 
   u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
 
@@ -1138,6 +1238,7 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
         // We already updated the TLB entry if this was caused by a C bit.
         if (res != TLB_UPDATE_C)
           UpdateTLBEntry(flag, PTE2, address);
+        UpdateTLBL0(flag, address, PTE2.RPN << HW_PAGE_INDEX_SHIFT);
 
         return TranslateAddressResult{TranslateAddressResult::PAGE_TABLE_TRANSLATED,
                                       (PTE2.RPN << 12) | offset};
@@ -1239,6 +1340,8 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
 
 void DBATUpdated()
 {
+  // Pages that are now covered by a BAT must no longer hit in the L0
+  ClearTLBL0();
   dbat_table = {};
   UpdateBATs(dbat_table, SPR_DBAT0U);
   bool extended_bats = SConfig::GetInstance().bWii && HID4.SBE;
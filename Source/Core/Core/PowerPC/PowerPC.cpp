@@ -89,7 +89,7 @@ void DoState(PointerWrap& p)
   p.DoArray(ppcState.ps);
   p.DoArray(ppcState.sr);
   p.DoArray(ppcState.spr);
-  p.DoArray(ppcState.tlb);
+  DoTLBState(p);
   p.Do(ppcState.pagetable_base);
   p.Do(ppcState.pagetable_hashmask);
 
@@ -228,7 +228,7 @@ void Reset()
 {
   ppcState.pagetable_base = 0;
   ppcState.pagetable_hashmask = 0;
-  ppcState.tlb = {};
+  ResetTLB();
 
   ResetRegisters();
   ppcState.iCache.Reset();
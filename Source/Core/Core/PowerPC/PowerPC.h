@@ -37,8 +37,14 @@ enum class CoreMode
   JIT,
 };
 
+constexpr size_t HW_PAGE_SIZE = 4096;
+constexpr u32 HW_PAGE_INDEX_SHIFT = 12;
+
 // TLB cache
 constexpr size_t TLB_SIZE = 128;
+// The TLBs can be configured to be larger than the hardware's, which saves page table walks in
+// games that use the MMU heavily
+constexpr size_t MAX_TLB_SIZE = 4096;
 constexpr size_t NUM_TLBS = 2;
 constexpr size_t TLB_WAYS = 2;
 
@@ -52,6 +58,30 @@ struct TLBEntry
   u8 recent = 0;
 };
 
+// Direct-mapped cache in front of the data TLB, which the JIT probes inline before it calls into
+// the MMU. It only holds translations to RAM, which are added from the data TLB and removed
+// together with the TLB entry.
+constexpr size_t TLB_L0_SIZE = 1024;
+
+struct TLBL0Entry
+{
+  // Not page aligned, so it never matches
+  static constexpr u32 INVALID_TAG = 1;
+
+  u32 tag = INVALID_TAG;  // effective page address
+  u32 paddr = 0;          // physical page address
+};
+static_assert(sizeof(TLBL0Entry) == 8, "The JIT indexes the TLB L0 with a scale of 8");
+
+using TLBL0 = std::array<TLBL0Entry, TLB_L0_SIZE>;
+
+struct TLBStats
+{
+  u64 hits;
+  u64 misses;
+  u64 page_walks;
+};
+
 // This contains the entire state of the emulated PowerPC "Gekko" CPU.
 struct GC_ALIGNED64(PowerPCState)
 {
@@ -116,7 +146,8 @@ struct GC_ALIGNED64(PowerPCState)
   // Storage for the stack pointer of the BLR optimization.
   u8* stored_stack_pointer;
 
-  std::array<std::array<TLBEntry, TLB_SIZE / TLB_WAYS>, NUM_TLBS> tlb;
+  // Only the first sets are used, depending on the configured TLB size
+  std::array<std::array<TLBEntry, MAX_TLB_SIZE / TLB_WAYS>, NUM_TLBS> tlb;
 
   u32 pagetable_base;
   u32 pagetable_hashmask;
@@ -274,6 +305,9 @@ void ClearCacheLine(u32 address);  // Zeroes 32 bytes; address should be 32-byte
 // TLB functions
 void SDRUpdated();
 void InvalidateTLBEntry(u32 address);
+// Applies the configured TLB size and drops all entries
+void ResetTLB();
+void DoTLBState(PointerWrap& p);
 void DBATUpdated();
 void IBATUpdated();
 
@@ -300,6 +334,11 @@ constexpr u32 BAT_RESULT_MASK = UINT32_C(~0x3);
 using BatTable = std::array<u32, 1 << (32 - BAT_INDEX_SHIFT)>;  // 128 KB
 extern BatTable ibat_table;
 extern BatTable dbat_table;
+
+extern TLBL0 read_tlb_l0;
+// Only holds pages whose changed bit is already set in the page table
+extern TLBL0 write_tlb_l0;
+extern TLBStats tlb_stats;
 inline bool TranslateBatAddess(const BatTable& bat_table, u32* address)
 {
   u32 bat_result = bat_table[*address >> BAT_INDEX_SHIFT];
@@ -25,6 +25,7 @@
 #include "Common/Version.h"
 
 #include "Core/ARBruteForcer.h"
+#include "Core/Benchmark.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -63,17 +64,15 @@ static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
 
 static std::string g_last_filename;
 
-static std::string g_bruteforce_filename;
-
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
 // Temporary undo state buffer
 static std::vector<u8> g_undo_load_buffer;
 static std::vector<u8> g_current_buffer;
+// Size of the last state that was saved, only used on the CPU thread
+static size_t s_last_state_size = 0;
 static int g_loadDepth = 0;
 
-static std::vector<u8> g_bruteforce_buffer;
-
 static std::mutex g_cs_undo_load_buffer;
 static std::mutex g_cs_current_buffer;
 static Common::Event g_compressAndDumpStateSyncEvent;
@@ -81,7 +80,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 92;  // Last changed in PR 6173
+static const u32 STATE_VERSION = 94;  // Last changed when making the TLB size configurable
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
@@ -207,35 +206,74 @@ static std::string DoState(PointerWrap& p)
   return version_created_by;
 }
 
-void LoadFromBuffer(std::vector<u8>& buffer)
+// Must be called on the CPU thread. Returns false if DoState aborted the save.
+static bool DoStateToBuffer(std::vector<u8>& buffer)
 {
-  if (NetPlay::IsNetPlayRunning())
+  // The state is written directly into a buffer of the previous size, which saves a measuring
+  // pass through DoState unless the state has grown.
+  size_t buffer_size = s_last_state_size;
+  if (buffer_size == 0)
   {
-    OSD::AddMessage("Loading savestates is disabled in Netplay to prevent desyncs");
-    return;
+    u8* ptr = nullptr;
+    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+    DoState(p);
+    buffer_size = reinterpret_cast<size_t>(ptr);
   }
 
+  // Every pass is a separate DoState call, so nothing may stay locked from one pass to the next.
+  // A write that doesn't fit has measured the size it needs instead, and the state is written
+  // again in case it grew.
+  while (true)
+  {
+    buffer.resize(buffer_size);
+    u8* ptr = buffer.data();
+    PointerWrap p(&ptr, buffer.size(), PointerWrap::MODE_WRITE);
+    DoState(p);
+
+    buffer_size = static_cast<size_t>(ptr - buffer.data());
+    if (!p.HasOverflowed())
+    {
+      buffer.resize(buffer_size);
+      s_last_state_size = buffer_size;
+      return p.GetMode() == PointerWrap::MODE_WRITE;
+    }
+  }
+}
+
+static void DoLoadFromBuffer(std::vector<u8>& buffer)
+{
   Core::RunAsCPUThread([&] {
+    Benchmark::ScopedTimer timer(Benchmark::Counter::StateLoad);
     u8* ptr = &buffer[0];
     PointerWrap p(&ptr, PointerWrap::MODE_READ);
     DoState(p);
   });
 }
 
-void SaveToBuffer(std::vector<u8>& buffer)
+void LoadFromBuffer(std::vector<u8>& buffer)
 {
-  Core::RunAsCPUThread([&] {
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  if (NetPlay::IsNetPlayRunning())
+  {
+    OSD::AddMessage("Loading savestates is disabled in Netplay to prevent desyncs");
+    return;
+  }
 
-    DoState(p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-    buffer.resize(buffer_size);
+  DoLoadFromBuffer(buffer);
+}
 
-    ptr = &buffer[0];
-    p.SetMode(PointerWrap::MODE_WRITE);
-    DoState(p);
+void LoadFromBufferForNetPlay(std::vector<u8>& buffer)
+{
+  DoLoadFromBuffer(buffer);
+}
+
+bool SaveToBuffer(std::vector<u8>& buffer)
+{
+  bool saved = false;
+  Core::RunAsCPUThread([&] {
+    Benchmark::ScopedTimer timer(Benchmark::Counter::StateSave);
+    saved = DoStateToBuffer(buffer);
   });
+  return saved;
 }
 
 void VerifyBuffer(std::vector<u8>& buffer)
@@ -402,22 +440,13 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 void SaveAs(const std::string& filename, bool wait)
 {
   Core::RunAsCPUThread([&] {
-    // Measure the size of the buffer.
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-
-    // Then actually do the write.
+    bool saved;
     {
       std::lock_guard<std::mutex> lk(g_cs_current_buffer);
-      g_current_buffer.resize(buffer_size);
-      ptr = &g_current_buffer[0];
-      p.SetMode(PointerWrap::MODE_WRITE);
-      DoState(p);
+      saved = DoStateToBuffer(g_current_buffer);
     }
 
-    if (p.GetMode() == PointerWrap::MODE_WRITE)
+    if (saved)
     {
       Core::DisplayMessage("Saving State...", 1000);
 
@@ -555,7 +584,8 @@ void LoadAs(const std::string& filename)
     if (!ARBruteForcer::ch_bruteforce && !Movie::IsJustStartingRecordingInputFromSaveState())
     {
       std::lock_guard<std::mutex> lk(g_cs_undo_load_buffer);
-      SaveToBuffer(g_undo_load_buffer);
+      if (!SaveToBuffer(g_undo_load_buffer))
+        g_undo_load_buffer.clear();
       if (Movie::IsMovieActive())
         Movie::SaveRecording(File::GetUserPath(D_STATESAVES_IDX) + "undo.dtm");
       else if (File::Exists(File::GetUserPath(D_STATESAVES_IDX) + "undo.dtm"))
@@ -571,38 +601,15 @@ void LoadAs(const std::string& filename)
       std::vector<u8> buffer;
       LoadFileStateData(filename, buffer);
 
-      // load from memory during culling code bruteforcing, because we are loading state tens of
-      // thousands of times.
-      if (ARBruteForcer::ch_bruteforce && !g_bruteforce_buffer.empty() &&
-          filename == g_bruteforce_filename)
+      if (!buffer.empty())
       {
-        u8* ptr = &g_bruteforce_buffer[0];
+        u8* ptr = &buffer[0];
         PointerWrap p(&ptr, PointerWrap::MODE_READ);
         version_created_by = DoState(p);
         loaded = true;
         loadedSuccessfully = (p.GetMode() == PointerWrap::MODE_READ);
       }
-      else
-      // brackets here are so buffer2 gets freed ASAP
-      {
-        std::vector<u8> buffer2;
-        LoadFileStateData(filename, buffer2);
-
-        if (!buffer2.empty())
-        {
-          u8* ptr = &buffer2[0];
-          PointerWrap p(&ptr, PointerWrap::MODE_READ);
-          version_created_by = DoState(p);
-          loaded = true;
-          loadedSuccessfully = (p.GetMode() == PointerWrap::MODE_READ);
-          if (ARBruteForcer::ch_bruteforce && loadedSuccessfully)
-          {
-            g_bruteforce_filename = filename;
-            g_bruteforce_buffer.swap(buffer2);
-          }
-        }
-	  }
-	}
+    }
 
     if (loaded)
     {
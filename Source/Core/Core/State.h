@@ -49,8 +49,12 @@ void SaveAs(const std::string& filename, bool wait = false);
 void LoadAs(const std::string& filename);
 void VerifyAt(const std::string& filename);
 
-void SaveToBuffer(std::vector<u8>& buffer);
+// Returns false if the state couldn't be saved. The buffer mustn't be loaded then.
+bool SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
+// Loads a state during netplay, which LoadFromBuffer refuses. Only the netplay rollback may use
+// this, because it restores the same inputs on every player.
+void LoadFromBufferForNetPlay(std::vector<u8>& buffer);
 void VerifyBuffer(std::vector<u8>& buffer);
 
 void LoadLastSaved(int i = 1);
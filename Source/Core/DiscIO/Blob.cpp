@@ -3,19 +3,26 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
+#include <cinttypes>
 #include <cstddef>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
+#include "Common/Assert.h"
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/Logging/Log.h"
+#include "Common/WorkerPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/CISOBlob.h"
 #include "DiscIO/CompressedBlob.h"
+#include "DiscIO/DCZBlob.h"
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/DriveBlob.h"
 #include "DiscIO/FileBlob.h"
@@ -24,74 +31,190 @@
 
 namespace DiscIO
 {
+// Used for readers created from now on
+static std::atomic<u64> s_cache_size{8 * 1024 * 1024};
+static std::atomic<bool> s_speculative_fill{true};
+
+// Minimum number of cache lines regardless of the configured size
+constexpr size_t MIN_CACHE_LINES = 4;
+
+static Common::WorkerPool& GetSpeculativeFillPool()
+{
+  static Common::WorkerPool s_pool("Sector Cache", 2);
+  return s_pool;
+}
+
+void SectorReader::SetCacheSettings(u64 cache_size, bool speculative_fill)
+{
+  s_cache_size = cache_size;
+  s_speculative_fill = speculative_fill;
+}
+
 void SectorReader::SetSectorSize(int blocksize)
 {
   m_block_size = std::max(blocksize, 0);
-  for (auto& cache_entry : m_cache)
-  {
-    cache_entry.Reset();
-    cache_entry.data.resize(m_chunk_blocks * m_block_size);
-  }
+  ResetCache();
 }
 
 void SectorReader::SetChunkSize(int block_cnt)
 {
   m_chunk_blocks = std::max(block_cnt, 1);
-  // Clear cache and resize the data arrays
-  SetSectorSize(m_block_size);
+  ResetCache();
+}
+
+void SectorReader::ResetCache()
+{
+  std::lock_guard<std::mutex> lk(m_cache_lock);
+  m_lines.clear();
+  m_line_map.clear();
+
+  const u64 line_size = std::max<u64>(u64(m_chunk_blocks) * m_block_size, 1);
+  m_max_lines = std::max<size_t>(static_cast<size_t>(s_cache_size / line_size), MIN_CACHE_LINES);
 }
 
 SectorReader::~SectorReader()
 {
+  _assert_msg_(DISCIO, m_inflight_chunks.empty(),
+               "DisableSpeculativeFill must be called by the derived destructor");
+
+  if (m_stats.hits + m_stats.misses != 0)
+  {
+    INFO_LOG(DISCIO, "Sector cache: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64
+                     " speculative fills (%" PRIu64 " used)",
+             m_stats.hits, m_stats.misses, m_stats.speculative_fills, m_stats.speculative_hits);
+  }
+}
+
+SectorReader::CacheStats SectorReader::GetCacheStats() const
+{
+  std::lock_guard<std::mutex> lk(m_cache_lock);
+  return m_stats;
+}
+
+void SectorReader::EnableSpeculativeFill()
+{
+  std::lock_guard<std::mutex> lk(m_cache_lock);
+  m_speculative_fill = s_speculative_fill;
+}
+
+void SectorReader::DisableSpeculativeFill()
+{
+  std::unique_lock<std::mutex> lk(m_cache_lock);
+  m_speculative_fill = false;
+  // Queued fills notice that speculative fill is disabled and return early
+  m_inflight_done.wait(lk, [this] { return m_inflight_chunks.empty(); });
 }
 
-const SectorReader::Cache* SectorReader::FindCacheLine(u64 block_num)
+SectorReader::CacheLine* SectorReader::FindCacheLine(std::unique_lock<std::mutex>& lock,
+                                                     u64 chunk_idx)
 {
-  auto itr = std::find_if(m_cache.begin(), m_cache.end(),
-                          [&](const Cache& entry) { return entry.Contains(block_num); });
-  if (itr == m_cache.end())
+  m_inflight_done.wait(lock, [&] { return !m_inflight_chunks.count(chunk_idx); });
+
+  auto itr = m_line_map.find(chunk_idx);
+  if (itr == m_line_map.end())
     return nullptr;
 
-  itr->MarkUsed();
-  return &*itr;
+  m_lines.splice(m_lines.begin(), m_lines, itr->second);
+  return &*itr->second;
 }
 
-SectorReader::Cache* SectorReader::GetEmptyCacheLine()
+std::vector<u8> SectorReader::TakeSpareBuffer()
 {
-  Cache* oldest = &m_cache[0];
-  // Find the Least Recently Used cache line to replace.
-  std::for_each(m_cache.begin() + 1, m_cache.end(), [&](Cache& line) {
-    if (line.IsLessRecentlyUsedThan(*oldest))
-    {
-      oldest->ShiftLRU();
-      oldest = &line;
-      return;
-    }
-    line.ShiftLRU();
-  });
-  oldest->Reset();
-  return oldest;
+  if (m_lines.size() < m_max_lines)
+    return std::vector<u8>(m_chunk_blocks * m_block_size);
+
+  CacheLine& oldest = m_lines.back();
+  std::vector<u8> buffer = std::move(oldest.data);
+  m_line_map.erase(oldest.chunk_idx);
+  m_lines.pop_back();
+  return buffer;
 }
 
-const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
+const SectorReader::CacheLine* SectorReader::InsertCacheLine(u64 chunk_idx, std::vector<u8> data,
+                                                             u32 num_blocks, bool speculative)
 {
-  if (auto entry = FindCacheLine(block_num))
-    return entry;
+  // Another fill of the same chunk may have won the race
+  auto itr = m_line_map.find(chunk_idx);
+  if (itr != m_line_map.end())
+    return &*itr->second;
+
+  if (m_lines.size() >= m_max_lines)
+  {
+    m_line_map.erase(m_lines.back().chunk_idx);
+    m_lines.pop_back();
+  }
+
+  m_lines.push_front(CacheLine{std::move(data), chunk_idx, num_blocks, speculative});
+  m_line_map.emplace(chunk_idx, m_lines.begin());
+  return &m_lines.front();
+}
+
+const SectorReader::CacheLine* SectorReader::GetCacheLine(std::unique_lock<std::mutex>& lock,
+                                                          u64 chunk_idx)
+{
+  if (CacheLine* line = FindCacheLine(lock, chunk_idx))
+  {
+    ++m_stats.hits;
+    if (line->speculative)
+    {
+      ++m_stats.speculative_hits;
+      line->speculative = false;
+      // The reader is keeping up with the worker, so keep it one chunk ahead
+      ScheduleSpeculativeFill(chunk_idx + 1);
+    }
+    return line;
+  }
 
   // Cache miss. Fault in the missing entry.
-  Cache* cache = GetEmptyCacheLine();
-  // We only read aligned chunks, this avoids duplicate overlapping entries.
-  u64 chunk_idx = block_num / m_chunk_blocks;
-  u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
+  ++m_stats.misses;
+  std::vector<u8> buffer = TakeSpareBuffer();
+  lock.unlock();
+  u32 blocks_read;
+  {
+    std::lock_guard<std::mutex> io_lk(m_io_lock);
+    blocks_read = ReadChunk(buffer.data(), chunk_idx);
+  }
+  lock.lock();
+
   if (!blocks_read)
     return nullptr;
-  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
 
-  // Secondary check for out-of-bounds read.
-  // If we got less than m_chunk_blocks, we may still have missed.
-  // We do this after the cache fill since the cache line itself is
-  // fine, the problem is being asked to read past the end of the disk.
-  return cache->Contains(block_num) ? cache : nullptr;
+  const CacheLine* line = InsertCacheLine(chunk_idx, std::move(buffer), blocks_read, false);
+  ScheduleSpeculativeFill(chunk_idx + 1);
+  return line;
+}
+
+void SectorReader::ScheduleSpeculativeFill(u64 chunk_idx)
+{
+  if (!m_speculative_fill || m_line_map.count(chunk_idx) || m_inflight_chunks.count(chunk_idx))
+    return;
+  if (chunk_idx * m_chunk_blocks * m_block_size >= GetDataSize())
+    return;
+
+  m_inflight_chunks.insert(chunk_idx);
+  GetSpeculativeFillPool().Schedule([this, chunk_idx] {
+    std::unique_lock<std::mutex> lk(m_cache_lock);
+    if (m_speculative_fill && !m_line_map.count(chunk_idx))
+    {
+      std::vector<u8> buffer = TakeSpareBuffer();
+      lk.unlock();
+      u32 blocks_read;
+      {
+        std::lock_guard<std::mutex> io_lk(m_io_lock);
+        blocks_read = ReadChunk(buffer.data(), chunk_idx);
+      }
+      lk.lock();
+
+      if (blocks_read)
+      {
+        InsertCacheLine(chunk_idx, std::move(buffer), blocks_read, true);
+        ++m_stats.speculative_fills;
+      }
+    }
+
+    m_inflight_chunks.erase(chunk_idx);
+    m_inflight_done.notify_all();
+  });
 }
 
 bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
@@ -100,16 +223,22 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   u64 block = 0;
   u32 position_in_block = static_cast<u32>(offset % m_block_size);
 
+  std::unique_lock<std::mutex> lk(m_cache_lock);
   while (remain > 0)
   {
     block = offset / m_block_size;
 
-    const Cache* cache = GetCacheLine(block);
-    if (!cache)
+    // We only read aligned chunks, this avoids duplicate overlapping entries.
+    const CacheLine* cache = GetCacheLine(lk, block / m_chunk_blocks);
+    // If we got less than m_chunk_blocks, we may still have missed,
+    // because we are being asked to read past the end of the disk.
+    if (!cache || !cache->Contains(block, m_chunk_blocks))
       return false;
 
     // Cache entries are aligned chunks, we may not want to read from the start
-    u32 read_offset = static_cast<u32>(block - cache->block_idx) * m_block_size + position_in_block;
+    u32 read_offset =
+        static_cast<u32>(block - cache->chunk_idx * m_chunk_blocks) * m_block_size +
+        position_in_block;
     u32 can_read = m_block_size * cache->num_blocks - read_offset;
     u32 was_read = static_cast<u32>(std::min<u64>(can_read, remain));
 
@@ -196,6 +325,8 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
   {
   case CISO_MAGIC:
     return CISOFileReader::Create(std::move(file));
+  case DCZ_MAGIC:
+    return DCZFileReader::Create(std::move(file), filename);
   case GCZ_MAGIC:
     return CompressedBlobReader::Create(std::move(file), filename);
   case TGC_MAGIC:
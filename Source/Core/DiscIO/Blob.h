@@ -15,9 +15,14 @@
 // automatically do the right thing.
 
 #include <array>
+#include <condition_variable>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -34,7 +39,8 @@ enum class BlobType
   GCZ,
   CISO,
   WBFS,
-  TGC
+  TGC,
+  DCZ
 };
 
 class BlobReader
@@ -56,12 +62,19 @@ public:
     return Common::FromBigEndian(temp);
   }
 
-  virtual bool SupportsReadWiiDecrypted() const { return false; }
+  // Whether ReadWiiDecrypted can read the given partition. If not, VolumeWii decrypts the data
+  // that Read returns instead.
+  virtual bool SupportsReadWiiDecrypted(u64 partition_offset) const { return false; }
   virtual bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_offset)
   {
     return false;
   }
 
+  // Returns a pointer to the data at offset that stays valid for as long as the reader exists,
+  // or nullptr if the data can't be accessed without copying it. Unlike Read, this is
+  // thread-safe. The first access to the data may still block on disk I/O.
+  virtual const u8* GetDirectPointer(u64 offset, u64 size) const { return nullptr; }
+
 protected:
   BlobReader() {}
 };
@@ -76,6 +89,18 @@ public:
 
   bool Read(u64 offset, u64 size, u8* out_ptr) override;
 
+  struct CacheStats
+  {
+    u64 hits = 0;
+    u64 misses = 0;
+    u64 speculative_fills = 0;
+    u64 speculative_hits = 0;  // Hits on lines that were filled speculatively
+  };
+  CacheStats GetCacheStats() const;
+
+  // Only affects readers that are created afterwards.
+  static void SetCacheSettings(u64 cache_size, bool speculative_fill);
+
 protected:
   void SetSectorSize(int blocksize);
   int GetSectorSize() const { return m_block_size; }
@@ -94,53 +119,44 @@ protected:
   // overridden in derived classes where possible.
   virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr);
 
+  // When a chunk misses the cache, the chunk after it is then read on a worker thread so that
+  // sequential reads don't have to wait for it. Calls to GetBlock and ReadMultipleAlignedBlocks
+  // are still serialized. Derived classes that enable this must call DisableSpeculativeFill in
+  // their destructor, since the worker may be using their members.
+  void EnableSpeculativeFill();
+  void DisableSpeculativeFill();
+
 private:
-  struct Cache
+  struct CacheLine
   {
     std::vector<u8> data;
-    u64 block_idx = 0;
+    u64 chunk_idx = 0;
     u32 num_blocks = 0;
+    bool speculative = false;  // Filled by the worker thread and not read yet
 
-    // [Pseudo-] Least Recently Used Shift Register
-    // When an empty cache line is needed, the line with the lowest value
-    // is taken and reset; the LRU register is then shifted down 1 place
-    // on all lines (low bit discarded). When a line is used, the high bit
-    // is set marking it as most recently used.
-    u32 lru_sreg = 0;
-
-    void Reset()
+    bool Contains(u64 block, u32 chunk_blocks) const
     {
-      block_idx = 0;
-      num_blocks = 0;
-      lru_sreg = 0;
+      return block - chunk_idx * chunk_blocks < num_blocks;
     }
-    void Fill(u64 block, u32 count)
-    {
-      block_idx = block;
-      num_blocks = count;
-      // NOTE: Setting only the high bit means the newest line will
-      //   be selected for eviction if every line in the cache was
-      //   touched. This gives MRU behavior which is probably
-      //   desirable in that case.
-      MarkUsed();
-    }
-    bool Contains(u64 block) const { return block >= block_idx && block - block_idx < num_blocks; }
-    void MarkUsed() { lru_sreg |= 0x80000000; }
-    void ShiftLRU() { lru_sreg >>= 1; }
-    bool IsLessRecentlyUsedThan(const Cache& other) const { return lru_sreg < other.lru_sreg; }
   };
+  using CacheLineList = std::list<CacheLine>;
+
+  void ResetCache();
+
+  // Returns the line holding the given chunk and marks it as most recently used, or nullptr.
+  // Waits if the chunk is being filled on the worker thread. m_cache_lock must be held.
+  CacheLine* FindCacheLine(std::unique_lock<std::mutex>& lock, u64 chunk_idx);
 
-  // Gets the cache line that contains the given block, or nullptr.
-  // NOTE: The cache record only lasts until it expires (next GetEmptyCacheLine)
-  const Cache* FindCacheLine(u64 block_num);
+  // Returns a line for the given chunk, loading it if needed. Returns nullptr if the read failed.
+  // m_cache_lock must be held; it is released while reading.
+  const CacheLine* GetCacheLine(std::unique_lock<std::mutex>& lock, u64 chunk_idx);
 
-  // Finds the least recently used cache line, resets and returns it.
-  Cache* GetEmptyCacheLine();
+  // Takes ownership of the buffer of the least recently used line if the cache is full.
+  std::vector<u8> TakeSpareBuffer();
+  const CacheLine* InsertCacheLine(u64 chunk_idx, std::vector<u8> data, u32 num_blocks,
+                                   bool speculative);
 
-  // Combines FindCacheLine with GetEmptyCacheLine and ReadChunk.
-  // Always returns a valid cache line (loading the data if needed).
-  // May return nullptr only if the cache missed and the read failed.
-  const Cache* GetCacheLine(u64 block_num);
+  void ScheduleSpeculativeFill(u64 chunk_idx);
 
   // Read all bytes from a chunk of blocks into a buffer.
   // Returns the number of blocks read (may be less than m_chunk_blocks
@@ -148,14 +164,22 @@ private:
   // evenly divisible into chunks). Returns zero if it fails.
   u32 ReadChunk(u8* buffer, u64 chunk_num);
 
-#if defined(_MSC_VER) && _MSC_VER <= 1800
-#define CACHE_LINES 32
-#else
-	static constexpr int CACHE_LINES = 32;
-#endif
-	u32 m_block_size   = 0;  // Bytes in a sector/block
-	u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
-	std::array<Cache, CACHE_LINES> m_cache;
+  u32 m_block_size = 0;    // Bytes in a sector/block
+  u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
+
+  // Guards everything below. Lines are only allocated once they are needed.
+  mutable std::mutex m_cache_lock;
+  CacheLineList m_lines;  // Most recently used first
+  std::unordered_map<u64, CacheLineList::iterator> m_line_map;
+  size_t m_max_lines = 0;
+  CacheStats m_stats;
+
+  // Serializes GetBlock and ReadMultipleAlignedBlocks between the reading thread and the worker
+  std::mutex m_io_lock;
+
+  bool m_speculative_fill = false;
+  std::set<u64> m_inflight_chunks;  // Chunks that are scheduled on or being read by the worker
+  std::condition_variable m_inflight_done;
 };
 
 // Factory function - examines the path to choose the right type of BlobReader, and returns one.
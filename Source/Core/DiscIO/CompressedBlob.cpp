@@ -40,6 +40,8 @@ CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string&
   m_file.ReadArray(&m_header, 1);
 
   SetSectorSize(m_header.block_size);
+  // Inflating a block takes long enough that reading sequentially benefits from working ahead
+  EnableSpeculativeFill();
 
   // cache block pointers and hashes
   m_block_pointers.resize(m_header.num_blocks);
@@ -70,6 +72,7 @@ std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+  DisableSpeculativeFill();
 }
 
 // IMPORTANT: Calling this function invalidates all earlier pointers gotten from this function.
@@ -0,0 +1,1093 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/DCZBlob.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <lzo/lzo1x.h>
+#include <mbedtls/aes.h>
+#include <mbedtls/sha1.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#include "Common/Align.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/Enums.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace DiscIO
+{
+static constexpr u32 BLOCK_TOTAL_SIZE = VolumeWii::BLOCK_TOTAL_SIZE;
+static constexpr u32 BLOCK_HEADER_SIZE = VolumeWii::BLOCK_HEADER_SIZE;
+static constexpr u32 BLOCK_DATA_SIZE = VolumeWii::BLOCK_DATA_SIZE;
+static constexpr u32 BLOCKS_PER_GROUP = 64;
+static constexpr u32 GROUP_TOTAL_SIZE = BLOCK_TOTAL_SIZE * BLOCKS_PER_GROUP;
+
+static constexpr u32 INVALID_CHUNK = std::numeric_limits<u32>::max();
+
+// Offsets within the (decrypted) hash header of a block
+static constexpr u32 H0_OFFSET = 0x000;
+static constexpr u32 H0_SIZE = 31 * 20;
+static constexpr u32 H1_OFFSET = 0x280;
+static constexpr u32 H1_SIZE = 8 * 20;
+static constexpr u32 H2_OFFSET = 0x340;
+static constexpr u32 H2_SIZE = 8 * 20;
+static constexpr u32 IV_OFFSET = 0x3D0;
+
+bool IsDCZCodecSupported(DCZCodec codec)
+{
+  switch (codec)
+  {
+  case DCZCodec::None:
+  case DCZCodec::Deflate:
+  case DCZCodec::LZO:
+    return true;
+#ifdef HAVE_LZMA
+  case DCZCodec::LZMA:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+DCZCodec GetDefaultDCZCodec()
+{
+  return IsDCZCodecSupported(DCZCodec::LZMA) ? DCZCodec::LZMA : DCZCodec::Deflate;
+}
+
+static bool IsValidChunkSize(u32 chunk_size)
+{
+  return chunk_size >= DCZ_MIN_CHUNK_SIZE && chunk_size <= DCZ_MAX_CHUNK_SIZE &&
+         MathUtil::IsPow2(chunk_size);
+}
+
+static u64 GetBlocksPerChunk(u32 chunk_size)
+{
+  return chunk_size / BLOCK_TOTAL_SIZE;
+}
+
+// The number of bytes stored for a full chunk of the given region
+static u64 GetStoredChunkSize(const DCZRegionEntry& region, u32 chunk_size)
+{
+  if (region.partition_index == DCZ_NO_PARTITION)
+    return chunk_size;
+  return GetBlocksPerChunk(chunk_size) * BLOCK_DATA_SIZE;
+}
+
+static u64 GetStoredRegionSize(const DCZRegionEntry& region)
+{
+  if (region.partition_index == DCZ_NO_PARTITION)
+    return region.raw_size;
+  return region.raw_size / BLOCK_TOTAL_SIZE * BLOCK_DATA_SIZE;
+}
+
+static u32 GetRegionChunkCount(const DCZRegionEntry& region, u32 chunk_size)
+{
+  const u64 chunk_data_size = GetStoredChunkSize(region, chunk_size);
+  return static_cast<u32>((GetStoredRegionSize(region) + chunk_data_size - 1) / chunk_data_size);
+}
+
+#ifdef HAVE_LZMA
+static bool GetLZMAFilters(int level, u32 chunk_size, lzma_options_lzma* options,
+                           std::array<lzma_filter, 2>* filters)
+{
+  if (lzma_lzma_preset(options, static_cast<u32>(MathUtil::Clamp(level, 0, 9))))
+    return false;
+
+  // The decoder must use a dictionary at least as large as the encoder's. Nothing is gained
+  // from a dictionary that is larger than a chunk, so both sides simply use the chunk size.
+  options->dict_size = std::max<u32>(LZMA_DICT_SIZE_MIN, chunk_size);
+
+  *filters = {{{LZMA_FILTER_LZMA2, options}, {LZMA_VLI_UNKNOWN, nullptr}}};
+  return true;
+}
+#endif
+
+// Returns false if the data couldn't be compressed to less than its original size.
+// (This is not an error; the chunk is then stored uncompressed.)
+static bool CompressChunk(DCZCodec codec, int level, u32 chunk_size, const u8* in, size_t in_size,
+                          std::vector<u8>* out, std::vector<u8>* work_memory)
+{
+  switch (codec)
+  {
+  case DCZCodec::Deflate:
+  {
+    out->resize(in_size);
+    uLongf out_size = static_cast<uLongf>(out->size());
+    if (compress2(out->data(), &out_size, in, static_cast<uLong>(in_size),
+                  MathUtil::Clamp(level, 1, 9)) != Z_OK)
+    {
+      return false;
+    }
+    out->resize(out_size);
+    return out_size < in_size;
+  }
+
+  case DCZCodec::LZO:
+  {
+    // LZO doesn't check the output size, so we need room for the worst case
+    out->resize(in_size + in_size / 16 + 64 + 3);
+    work_memory->resize(LZO1X_1_MEM_COMPRESS);
+    lzo_uint out_size;
+    if (lzo1x_1_compress(in, static_cast<lzo_uint>(in_size), out->data(), &out_size,
+                         work_memory->data()) != LZO_E_OK)
+    {
+      return false;
+    }
+    out->resize(out_size);
+    return out_size < in_size;
+  }
+
+#ifdef HAVE_LZMA
+  case DCZCodec::LZMA:
+  {
+    lzma_options_lzma options;
+    std::array<lzma_filter, 2> filters;
+    if (!GetLZMAFilters(level, chunk_size, &options, &filters))
+      return false;
+
+    out->resize(in_size);
+    size_t out_size = 0;
+    if (lzma_raw_buffer_encode(filters.data(), nullptr, in, in_size, out->data(), &out_size,
+                               out->size()) != LZMA_OK)
+    {
+      return false;
+    }
+    out->resize(out_size);
+    return out_size < in_size;
+  }
+#endif
+
+  default:
+    return false;
+  }
+}
+
+static bool DecompressChunk(DCZCodec codec, u32 chunk_size, const u8* in, size_t in_size, u8* out,
+                            size_t out_size)
+{
+  switch (codec)
+  {
+  case DCZCodec::Deflate:
+  {
+    uLongf decompressed_size = static_cast<uLongf>(out_size);
+    return uncompress(out, &decompressed_size, in, static_cast<uLong>(in_size)) == Z_OK &&
+           decompressed_size == out_size;
+  }
+
+  case DCZCodec::LZO:
+  {
+    lzo_uint decompressed_size = static_cast<lzo_uint>(out_size);
+    return lzo1x_decompress_safe(in, static_cast<lzo_uint>(in_size), out, &decompressed_size,
+                                 nullptr) == LZO_E_OK &&
+           decompressed_size == out_size;
+  }
+
+#ifdef HAVE_LZMA
+  case DCZCodec::LZMA:
+  {
+    lzma_options_lzma options;
+    std::array<lzma_filter, 2> filters;
+    if (!GetLZMAFilters(6, chunk_size, &options, &filters))
+      return false;
+
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+    return lzma_raw_buffer_decode(filters.data(), nullptr, in, &in_pos, in_size, out, &out_pos,
+                                  out_size) == LZMA_OK &&
+           out_pos == out_size;
+  }
+#endif
+
+  default:
+    return false;
+  }
+}
+
+// Generates the (unencrypted) hash headers of a group of blocks whose data is already in place.
+// See http://wiibrew.org/wiki/Wii_Disc#Encrypted for the layout.
+static void GenerateGroupHashes(u8* group, u32 num_blocks)
+{
+  u8 h1_tables[BLOCKS_PER_GROUP / 8][H1_SIZE] = {};
+  u8 h2_table[H2_SIZE] = {};
+
+  for (u32 block = 0; block < num_blocks; ++block)
+  {
+    u8* header = group + block * BLOCK_TOTAL_SIZE;
+    const u8* data = header + BLOCK_HEADER_SIZE;
+    std::memset(header, 0, BLOCK_HEADER_SIZE);
+
+    for (u32 i = 0; i < H0_SIZE / 20; ++i)
+      mbedtls_sha1(data + i * 0x400, 0x400, header + H0_OFFSET + i * 20);
+
+    mbedtls_sha1(header + H0_OFFSET, H0_SIZE, h1_tables[block / 8] + block % 8 * 20);
+  }
+
+  for (u32 subgroup = 0; subgroup * 8 < num_blocks; ++subgroup)
+    mbedtls_sha1(h1_tables[subgroup], H1_SIZE, h2_table + subgroup * 20);
+
+  for (u32 block = 0; block < num_blocks; ++block)
+  {
+    u8* header = group + block * BLOCK_TOTAL_SIZE;
+    std::memcpy(header + H1_OFFSET, h1_tables[block / 8], H1_SIZE);
+    std::memcpy(header + H2_OFFSET, h2_table, H2_SIZE);
+  }
+}
+
+DCZFileReader::DCZFileReader(File::IOFile file, const std::string& path)
+    : m_file(std::move(file)), m_path(path)
+{
+  m_file_size = m_file.GetSize();
+}
+
+DCZFileReader::~DCZFileReader() = default;
+
+std::unique_ptr<DCZFileReader> DCZFileReader::Create(File::IOFile file, const std::string& path)
+{
+  DCZHeader header;
+  if (!file.Seek(0, SEEK_SET) || !file.ReadArray(&header, 1) || header.magic != DCZ_MAGIC)
+    return nullptr;
+
+  std::unique_ptr<DCZFileReader> reader(new DCZFileReader(std::move(file), path));
+  if (!reader->Initialize())
+    return nullptr;
+
+  return reader;
+}
+
+bool DCZFileReader::Initialize()
+{
+  m_file.Seek(0, SEEK_SET);
+  if (!m_file.ReadArray(&m_header, 1))
+    return false;
+
+  if (m_header.version != DCZ_VERSION)
+  {
+    ERROR_LOG(DISCIO, "%s: unsupported DCZ version %u", m_path.c_str(), m_header.version);
+    return false;
+  }
+
+  if (!IsDCZCodecSupported(static_cast<DCZCodec>(m_header.codec)))
+  {
+    PanicAlertT("The disc image \"%s\" uses a compression method that is not supported by this "
+                "build of Dolphin.",
+                m_path.c_str());
+    return false;
+  }
+
+  if (!IsValidChunkSize(m_header.chunk_size))
+  {
+    ERROR_LOG(DISCIO, "%s: invalid chunk size %u", m_path.c_str(), m_header.chunk_size);
+    return false;
+  }
+
+  // The tables must fit before the index, and the index and the exceptions must fit in the file.
+  // This also keeps corrupt counts from making us allocate huge amounts of memory.
+  const u64 tables_end = sizeof(DCZHeader) +
+                         u64(m_header.num_partitions) * sizeof(DCZPartitionEntry) +
+                         u64(m_header.num_regions) * sizeof(DCZRegionEntry);
+  const u64 index_size = u64(m_header.num_chunks) * sizeof(DCZChunkEntry);
+  const u64 exceptions_size = u64(m_header.num_exceptions) * sizeof(DCZExceptionEntry);
+  if (tables_end > m_header.index_offset || m_header.index_offset > m_file_size ||
+      index_size > m_file_size - m_header.index_offset ||
+      m_header.exceptions_offset > m_file_size ||
+      exceptions_size > m_file_size - m_header.exceptions_offset)
+  {
+    NOTICE_LOG(DISCIO, "The disc image \"%s\" is truncated, some of the data is missing.",
+               m_path.c_str());
+    return false;
+  }
+
+  m_partitions.resize(m_header.num_partitions);
+  m_regions.resize(m_header.num_regions);
+  if (!m_file.ReadArray(m_partitions.data(), m_partitions.size()) ||
+      !m_file.ReadArray(m_regions.data(), m_regions.size()))
+  {
+    return false;
+  }
+
+  // Check that the regions cover the disc and that the index covers the regions,
+  // so that no bounds checks are needed when reading later.
+  u64 expected_offset = 0;
+  u32 expected_chunk = 0;
+  for (const DCZRegionEntry& region : m_regions)
+  {
+    const bool is_partition = region.partition_index != DCZ_NO_PARTITION;
+    if (region.raw_offset != expected_offset || region.first_chunk != expected_chunk ||
+        (is_partition && (region.partition_index >= m_partitions.size() ||
+                          region.raw_size % BLOCK_TOTAL_SIZE != 0)))
+    {
+      ERROR_LOG(DISCIO, "%s: invalid region table", m_path.c_str());
+      return false;
+    }
+    expected_offset += region.raw_size;
+    expected_chunk += GetRegionChunkCount(region, m_header.chunk_size);
+  }
+  if (expected_offset != m_header.data_size || expected_chunk != m_header.num_chunks)
+  {
+    ERROR_LOG(DISCIO, "%s: invalid region table", m_path.c_str());
+    return false;
+  }
+
+  if (m_header.num_chunks != 0)
+  {
+    if (m_index_mapping.Map(m_file, m_header.index_offset, index_size))
+    {
+      m_index = reinterpret_cast<const DCZChunkEntry*>(m_index_mapping.GetData());
+    }
+    else
+    {
+      WARN_LOG(DISCIO, "%s: could not map the chunk index, reading it instead", m_path.c_str());
+      m_index_fallback.resize(m_header.num_chunks);
+      if (!m_file.Seek(m_header.index_offset, SEEK_SET) ||
+          !m_file.ReadArray(m_index_fallback.data(), m_index_fallback.size()))
+      {
+        return false;
+      }
+      m_index = m_index_fallback.data();
+    }
+  }
+
+  m_exceptions.resize(m_header.num_exceptions);
+  if (!m_exceptions.empty() && (!m_file.Seek(m_header.exceptions_offset, SEEK_SET) ||
+                                !m_file.ReadArray(m_exceptions.data(), m_exceptions.size())))
+  {
+    return false;
+  }
+
+  m_chunk_buffer.resize(m_header.chunk_size);
+  return true;
+}
+
+const DCZRegionEntry* DCZFileReader::FindRegion(u64 raw_offset) const
+{
+  auto it = std::upper_bound(
+      m_regions.begin(), m_regions.end(), raw_offset,
+      [](u64 offset, const DCZRegionEntry& region) { return offset < region.raw_offset; });
+  if (it == m_regions.begin())
+    return nullptr;
+
+  --it;
+  return raw_offset - it->raw_offset < it->raw_size ? &*it : nullptr;
+}
+
+const DCZRegionEntry* DCZFileReader::FindPartitionRegion(u64 partition_offset) const
+{
+  auto partition =
+      std::find_if(m_partitions.begin(), m_partitions.end(), [&](const DCZPartitionEntry& entry) {
+        return entry.partition_offset == partition_offset;
+      });
+  if (partition == m_partitions.end())
+    return nullptr;
+
+  const u32 partition_index = static_cast<u32>(std::distance(m_partitions.begin(), partition));
+  auto it = std::find_if(m_regions.begin(), m_regions.end(), [&](const DCZRegionEntry& region) {
+    return region.partition_index == partition_index;
+  });
+  return it != m_regions.end() ? &*it : nullptr;
+}
+
+u32 DCZFileReader::GetChunkDataSize(const DCZRegionEntry& region, u32 chunk_in_region) const
+{
+  const u64 chunk_data_size = GetStoredChunkSize(region, m_header.chunk_size);
+  const u64 chunk_start = chunk_in_region * chunk_data_size;
+  return static_cast<u32>(std::min(chunk_data_size, GetStoredRegionSize(region) - chunk_start));
+}
+
+const u8* DCZFileReader::GetChunk(const DCZRegionEntry& region, u32 chunk_in_region)
+{
+  const u32 chunk_index = region.first_chunk + chunk_in_region;
+  if (chunk_index == m_cached_chunk)
+    return m_chunk_buffer.data();
+
+  m_cached_chunk = INVALID_CHUNK;
+
+  const DCZChunkEntry& entry = m_index[chunk_index];
+  const u32 data_size = GetChunkDataSize(region, chunk_in_region);
+
+  if (entry.flags & DCZ_CHUNK_ZERO)
+  {
+    std::fill_n(m_chunk_buffer.begin(), data_size, 0);
+    m_cached_chunk = chunk_index;
+    return m_chunk_buffer.data();
+  }
+
+  const bool uncompressed = (entry.flags & DCZ_CHUNK_UNCOMPRESSED) != 0;
+  if ((uncompressed && entry.compressed_size != data_size) ||
+      entry.compressed_size > m_header.chunk_size)
+  {
+    ERROR_LOG(DISCIO, "%s: chunk %u has an invalid size", m_path.c_str(), chunk_index);
+    return nullptr;
+  }
+
+  u8* read_buffer = m_chunk_buffer.data();
+  if (!uncompressed)
+  {
+    m_compressed_buffer.resize(entry.compressed_size);
+    read_buffer = m_compressed_buffer.data();
+  }
+
+  if (!m_file.Seek(entry.file_offset, SEEK_SET) ||
+      !m_file.ReadBytes(read_buffer, entry.compressed_size))
+  {
+    NOTICE_LOG(DISCIO, "The disc image \"%s\" is truncated, some of the data is missing.",
+               m_path.c_str());
+    m_file.Clear();
+    return nullptr;
+  }
+
+  if (!uncompressed &&
+      !DecompressChunk(static_cast<DCZCodec>(m_header.codec), m_header.chunk_size, read_buffer,
+                       entry.compressed_size, m_chunk_buffer.data(), data_size))
+  {
+    NOTICE_LOG(DISCIO, "The disc image \"%s\" is corrupt. Chunk %u could not be decompressed.",
+               m_path.c_str(), chunk_index);
+    return nullptr;
+  }
+
+  m_cached_chunk = chunk_index;
+  return m_chunk_buffer.data();
+}
+
+// The offset is relative to the start of the data stored for the region,
+// which for partitions is the decrypted data.
+bool DCZFileReader::ReadRegion(const DCZRegionEntry& region, u64 offset, u64 size, u8* out_ptr)
+{
+  if (offset + size > GetStoredRegionSize(region))
+    return false;
+
+  const u64 chunk_data_size = GetStoredChunkSize(region, m_header.chunk_size);
+  while (size > 0)
+  {
+    const u32 chunk_in_region = static_cast<u32>(offset / chunk_data_size);
+    const u64 offset_in_chunk = offset % chunk_data_size;
+    const u64 bytes_to_read =
+        std::min(size, GetChunkDataSize(region, chunk_in_region) - offset_in_chunk);
+
+    const u8* chunk = GetChunk(region, chunk_in_region);
+    if (!chunk)
+      return false;
+    std::copy_n(chunk + offset_in_chunk, bytes_to_read, out_ptr);
+
+    offset += bytes_to_read;
+    size -= bytes_to_read;
+    out_ptr += bytes_to_read;
+  }
+
+  return true;
+}
+
+bool DCZFileReader::ReadEncryptedGroup(const DCZRegionEntry& region, u64 group)
+{
+  if (m_cached_group_region == &region && m_cached_group == group)
+    return true;
+
+  m_cached_group_region = nullptr;
+  m_group_buffer.resize(GROUP_TOTAL_SIZE);
+
+  const u64 first_block = group * BLOCKS_PER_GROUP;
+  const u32 num_blocks = static_cast<u32>(
+      std::min<u64>(BLOCKS_PER_GROUP, region.raw_size / BLOCK_TOTAL_SIZE - first_block));
+
+  for (u32 i = 0; i < num_blocks; ++i)
+  {
+    u8* block = m_group_buffer.data() + i * BLOCK_TOTAL_SIZE;
+    if (!ReadRegion(region, (first_block + i) * BLOCK_DATA_SIZE, BLOCK_DATA_SIZE,
+                    block + BLOCK_HEADER_SIZE))
+    {
+      return false;
+    }
+  }
+
+  mbedtls_aes_context aes_context;
+  mbedtls_aes_init(&aes_context);
+  mbedtls_aes_setkey_enc(&aes_context, m_partitions[region.partition_index].title_key.data(), 128);
+
+  const u64 group_offset = region.raw_offset + first_block * BLOCK_TOTAL_SIZE;
+  auto exception = std::lower_bound(
+      m_exceptions.begin(), m_exceptions.end(), group_offset,
+      [](const DCZExceptionEntry& entry, u64 offset) { return entry.group_offset < offset; });
+
+  if (exception != m_exceptions.end() && exception->group_offset == group_offset)
+  {
+    // The original hash headers couldn't be regenerated, so they are stored already encrypted
+    if (exception->num_blocks != num_blocks || !m_file.Seek(exception->file_offset, SEEK_SET))
+    {
+      mbedtls_aes_free(&aes_context);
+      return false;
+    }
+    for (u32 i = 0; i < num_blocks; ++i)
+    {
+      if (!m_file.ReadBytes(m_group_buffer.data() + i * BLOCK_TOTAL_SIZE, BLOCK_HEADER_SIZE))
+      {
+        m_file.Clear();
+        mbedtls_aes_free(&aes_context);
+        return false;
+      }
+    }
+  }
+  else
+  {
+    GenerateGroupHashes(m_group_buffer.data(), num_blocks);
+    for (u32 i = 0; i < num_blocks; ++i)
+    {
+      u8* header = m_group_buffer.data() + i * BLOCK_TOTAL_SIZE;
+      u8 iv[16] = {};
+      mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_HEADER_SIZE, iv, header,
+                            header);
+    }
+  }
+
+  // The data of each block is encrypted using bytes from its encrypted header as the IV
+  for (u32 i = 0; i < num_blocks; ++i)
+  {
+    u8* block = m_group_buffer.data() + i * BLOCK_TOTAL_SIZE;
+    u8 iv[16];
+    std::copy_n(block + IV_OFFSET, sizeof(iv), iv);
+    mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_DATA_SIZE, iv,
+                          block + BLOCK_HEADER_SIZE, block + BLOCK_HEADER_SIZE);
+  }
+
+  mbedtls_aes_free(&aes_context);
+
+  m_cached_group_region = &region;
+  m_cached_group = group;
+  return true;
+}
+
+bool DCZFileReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  while (size > 0)
+  {
+    const DCZRegionEntry* region = FindRegion(offset);
+    if (!region)
+      return false;
+
+    const u64 offset_in_region = offset - region->raw_offset;
+    u64 bytes_to_read = std::min(size, region->raw_size - offset_in_region);
+
+    if (region->partition_index == DCZ_NO_PARTITION)
+    {
+      if (!ReadRegion(*region, offset_in_region, bytes_to_read, out_ptr))
+        return false;
+    }
+    else
+    {
+      const u64 group = offset_in_region / GROUP_TOTAL_SIZE;
+      const u64 offset_in_group = offset_in_region % GROUP_TOTAL_SIZE;
+      bytes_to_read = std::min(bytes_to_read, GROUP_TOTAL_SIZE - offset_in_group);
+
+      if (!ReadEncryptedGroup(*region, group))
+        return false;
+      std::copy_n(m_group_buffer.data() + offset_in_group, bytes_to_read, out_ptr);
+    }
+
+    offset += bytes_to_read;
+    size -= bytes_to_read;
+    out_ptr += bytes_to_read;
+  }
+
+  return true;
+}
+
+bool DCZFileReader::ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_offset)
+{
+  const DCZRegionEntry* region = FindPartitionRegion(partition_offset);
+  return region && ReadRegion(*region, offset, size, out_ptr);
+}
+
+namespace
+{
+struct PartitionToConvert
+{
+  u64 data_offset;
+  u64 data_size;
+  DCZPartitionEntry entry;
+};
+
+class DCZWriter
+{
+public:
+  DCZWriter(File::IOFile* outfile, DCZCodec codec, int compression_level, u32 chunk_size)
+      : m_outfile(outfile), m_codec(codec), m_compression_level(compression_level),
+        m_chunk_size(chunk_size)
+  {
+  }
+
+  bool WriteChunk(const u8* data, size_t size)
+  {
+    DCZChunkEntry entry{m_position, 0, 0};
+
+    if (std::all_of(data, data + size, [](u8 byte) { return byte == 0; }))
+    {
+      entry.flags = DCZ_CHUNK_ZERO;
+      m_index.push_back(entry);
+      return true;
+    }
+
+    const u8* write_data;
+    if (m_codec == DCZCodec::None || !CompressChunk(m_codec, m_compression_level, m_chunk_size,
+                                                    data, size, &m_compressed, &m_work_memory))
+    {
+      entry.flags = DCZ_CHUNK_UNCOMPRESSED;
+      write_data = data;
+      entry.compressed_size = static_cast<u32>(size);
+    }
+    else
+    {
+      write_data = m_compressed.data();
+      entry.compressed_size = static_cast<u32>(m_compressed.size());
+    }
+
+    m_index.push_back(entry);
+    m_bytes_in += size;
+    return Write(write_data, entry.compressed_size);
+  }
+
+  bool Write(const u8* data, size_t size)
+  {
+    if (!m_outfile->WriteBytes(data, size))
+      return false;
+    m_position += size;
+    return true;
+  }
+
+  void SetPosition(u64 position) { m_position = position; }
+  u64 GetPosition() const { return m_position; }
+  // Used for the compression ratio shown while converting
+  u64 GetBytesIn() const { return m_bytes_in; }
+  const std::vector<DCZChunkEntry>& GetIndex() const { return m_index; }
+
+private:
+  File::IOFile* m_outfile;
+  DCZCodec m_codec;
+  int m_compression_level;
+  u32 m_chunk_size;
+
+  u64 m_position = 0;
+  u64 m_bytes_in = 0;
+  std::vector<DCZChunkEntry> m_index;
+  std::vector<u8> m_compressed;
+  std::vector<u8> m_work_memory;
+};
+}  // Anonymous namespace
+
+static std::vector<PartitionToConvert> GetPartitionsToConvert(const std::string& path,
+                                                              u64 disc_size)
+{
+  std::vector<PartitionToConvert> result;
+
+  std::unique_ptr<Volume> volume = CreateVolumeFromFilename(path);
+  if (!volume || volume->GetVolumeType() != Platform::WII_DISC)
+    return result;
+
+  for (const Partition& partition : volume->GetPartitions())
+  {
+    const IOS::ES::TicketReader& ticket = volume->GetTicket(partition);
+    const std::optional<u64> data_offset =
+        volume->ReadSwappedAndShifted(partition.offset + 0x2b8, PARTITION_NONE);
+    const std::optional<u64> data_size =
+        volume->ReadSwappedAndShifted(partition.offset + 0x2bc, PARTITION_NONE);
+    if (!ticket.IsValid() || !data_offset || !data_size)
+      continue;
+
+    PartitionToConvert to_convert;
+    to_convert.data_offset = partition.offset + *data_offset;
+    if (to_convert.data_offset >= disc_size)
+      continue;
+
+    // Only whole blocks can be stored decrypted
+    const u64 available_size = disc_size - to_convert.data_offset;
+    to_convert.data_size =
+        Common::AlignDown(std::min(*data_size, available_size), u64(BLOCK_TOTAL_SIZE));
+    to_convert.entry.partition_offset = partition.offset;
+    to_convert.entry.title_key = ticket.GetTitleKey();
+    if (to_convert.data_size != 0)
+      result.push_back(to_convert);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const PartitionToConvert& a, const PartitionToConvert& b) {
+              return a.data_offset < b.data_offset;
+            });
+
+  // Overlapping partitions can't be stored decrypted, so they are stored as-is
+  u64 end_of_previous = 0;
+  result.erase(std::remove_if(result.begin(), result.end(),
+                              [&](const PartitionToConvert& partition) {
+                                if (partition.data_offset < end_of_previous)
+                                  return true;
+                                end_of_previous = partition.data_offset + partition.data_size;
+                                return false;
+                              }),
+               result.end());
+
+  return result;
+}
+
+bool ConvertToDCZ(const std::string& infile_path, const std::string& outfile_path,
+                  DCZCodec codec, int compression_level, u32 chunk_size, CompressCB callback,
+                  void* arg)
+{
+  if (!IsValidChunkSize(chunk_size))
+  {
+    PanicAlertT("The chunk size must be a power of two between %u and %u bytes.",
+                DCZ_MIN_CHUNK_SIZE, DCZ_MAX_CHUNK_SIZE);
+    return false;
+  }
+
+  if (!IsDCZCodecSupported(codec))
+  {
+    PanicAlertT("The selected compression method is not supported by this build of Dolphin.");
+    return false;
+  }
+
+  std::unique_ptr<BlobReader> reader = CreateBlobReader(infile_path);
+  if (!reader)
+  {
+    PanicAlertT("Failed to open the input file \"%s\".", infile_path.c_str());
+    return false;
+  }
+
+  if (reader->GetBlobType() == BlobType::DCZ)
+  {
+    PanicAlertT("\"%s\" is already compressed! Cannot compress it further.", infile_path.c_str());
+    return false;
+  }
+
+  if (reader->GetBlobType() == BlobType::DIRECTORY)
+  {
+    PanicAlertT("\"%s\" is an extracted disc and cannot be converted.", infile_path.c_str());
+    return false;
+  }
+
+  const u64 data_size = reader->GetDataSize();
+  const std::vector<PartitionToConvert> partitions =
+      GetPartitionsToConvert(infile_path, data_size);
+
+  // Split the disc into regions
+  std::vector<DCZPartitionEntry> partition_entries;
+  std::vector<DCZRegionEntry> regions;
+  u32 num_chunks = 0;
+  auto add_region = [&](u64 offset, u64 size, u32 partition_index) {
+    if (size == 0)
+      return;
+    DCZRegionEntry region{offset, size, num_chunks, partition_index};
+    num_chunks += GetRegionChunkCount(region, chunk_size);
+    regions.push_back(region);
+  };
+
+  u64 position = 0;
+  for (const PartitionToConvert& partition : partitions)
+  {
+    add_region(position, partition.data_offset - position, DCZ_NO_PARTITION);
+    add_region(partition.data_offset, partition.data_size,
+               static_cast<u32>(partition_entries.size()));
+    partition_entries.push_back(partition.entry);
+    position = partition.data_offset + partition.data_size;
+  }
+  add_region(position, data_size - position, DCZ_NO_PARTITION);
+
+  File::IOFile outfile(outfile_path, "wb");
+  if (!outfile)
+  {
+    PanicAlertT("Failed to open the output file \"%s\".\n"
+                "Check that you have permissions to write the target folder and that the media can "
+                "be written.",
+                outfile_path.c_str());
+    return false;
+  }
+
+  if (callback)
+    callback(GetStringT("Files opened, ready to compress."), 0, arg);
+
+  DCZHeader header = {};
+  header.magic = DCZ_MAGIC;
+  header.version = DCZ_VERSION;
+  header.codec = static_cast<u32>(codec);
+  header.chunk_size = chunk_size;
+  header.data_size = data_size;
+  header.num_partitions = static_cast<u32>(partition_entries.size());
+  header.num_regions = static_cast<u32>(regions.size());
+  header.num_chunks = num_chunks;
+  header.index_offset =
+      Common::AlignUp(sizeof(DCZHeader) + sizeof(DCZPartitionEntry) * partition_entries.size() +
+                          sizeof(DCZRegionEntry) * regions.size(),
+                      DCZ_INDEX_ALIGNMENT);
+
+  // Seek past the header and the index (we will write them at the end)
+  const u64 data_start = header.index_offset + sizeof(DCZChunkEntry) * u64(num_chunks);
+  outfile.Seek(data_start, SEEK_SET);
+
+  DCZWriter writer(&outfile, codec, compression_level, chunk_size);
+  writer.SetPosition(data_start);
+
+  std::vector<DCZExceptionEntry> exceptions;
+  std::vector<u8> buffer(chunk_size);
+  std::vector<u8> group_buffer;
+  std::vector<u8> encrypted_headers;
+  std::vector<u8> decrypted_headers;
+
+  u64 bytes_done = 0;
+  u64 next_progress_update = 0;
+  const u64 progress_interval = std::max<u64>(data_size / 1000, chunk_size);
+  auto report_progress = [&]() -> bool {
+    if (!callback || bytes_done < next_progress_update)
+      return true;
+    next_progress_update = bytes_done + progress_interval;
+
+    const int ratio =
+        writer.GetBytesIn() ? static_cast<int>(100 * (writer.GetPosition() - data_start) /
+                                               writer.GetBytesIn()) :
+                              0;
+    const std::string text = StringFromFormat(
+        GetStringT("%i of %i MiB. Compression ratio %i%%").c_str(),
+        static_cast<int>(bytes_done >> 20), static_cast<int>(data_size >> 20), ratio);
+    return callback(text, static_cast<float>(bytes_done) / static_cast<float>(data_size), arg);
+  };
+
+  auto read_error = [&]() {
+    PanicAlertT("Failed to read from the input file \"%s\".", infile_path.c_str());
+  };
+
+  bool success = true;
+  for (const DCZRegionEntry& region : regions)
+  {
+    if (!success)
+      break;
+
+    if (region.partition_index == DCZ_NO_PARTITION)
+    {
+      for (u64 offset = 0; offset < region.raw_size && success; offset += chunk_size)
+      {
+        const size_t size =
+            static_cast<size_t>(std::min<u64>(chunk_size, region.raw_size - offset));
+        if (!reader->Read(region.raw_offset + offset, size, buffer.data()))
+        {
+          read_error();
+          success = false;
+        }
+        else if (!writer.WriteChunk(buffer.data(), size))
+        {
+          success = false;
+        }
+        bytes_done += size;
+        if (success && !report_progress())
+          success = false;
+      }
+      continue;
+    }
+
+    mbedtls_aes_context aes_context;
+    mbedtls_aes_init(&aes_context);
+    mbedtls_aes_setkey_dec(&aes_context,
+                           partition_entries[region.partition_index].title_key.data(), 128);
+
+    const u64 total_blocks = region.raw_size / BLOCK_TOTAL_SIZE;
+    const u64 blocks_per_chunk = GetBlocksPerChunk(chunk_size);
+    u64 blocks_in_buffer = 0;
+    group_buffer.resize(GROUP_TOTAL_SIZE);
+
+    for (u64 first_block = 0; first_block < total_blocks && success;
+         first_block += BLOCKS_PER_GROUP)
+    {
+      const u32 num_blocks =
+          static_cast<u32>(std::min<u64>(BLOCKS_PER_GROUP, total_blocks - first_block));
+      const u64 group_offset = region.raw_offset + first_block * BLOCK_TOTAL_SIZE;
+      if (!reader->Read(group_offset, num_blocks * BLOCK_TOTAL_SIZE, group_buffer.data()))
+      {
+        read_error();
+        success = false;
+        break;
+      }
+
+      encrypted_headers.resize(num_blocks * BLOCK_HEADER_SIZE);
+      decrypted_headers.resize(num_blocks * BLOCK_HEADER_SIZE);
+      for (u32 i = 0; i < num_blocks; ++i)
+      {
+        u8* block = group_buffer.data() + i * BLOCK_TOTAL_SIZE;
+        std::copy_n(block, BLOCK_HEADER_SIZE, encrypted_headers.data() + i * BLOCK_HEADER_SIZE);
+
+        u8 iv[16];
+        std::copy_n(block + IV_OFFSET, sizeof(iv), iv);
+        mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, iv,
+                              block + BLOCK_HEADER_SIZE, block + BLOCK_HEADER_SIZE);
+
+        u8 header_iv[16] = {};
+        mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_DECRYPT, BLOCK_HEADER_SIZE, header_iv,
+                              block, decrypted_headers.data() + i * BLOCK_HEADER_SIZE);
+      }
+
+      // If the hashes can't be regenerated exactly, keep the original ones
+      GenerateGroupHashes(group_buffer.data(), num_blocks);
+      bool hashes_match = true;
+      for (u32 i = 0; i < num_blocks && hashes_match; ++i)
+      {
+        hashes_match = std::equal(decrypted_headers.begin() + i * BLOCK_HEADER_SIZE,
+                                  decrypted_headers.begin() + (i + 1) * BLOCK_HEADER_SIZE,
+                                  group_buffer.begin() + i * BLOCK_TOTAL_SIZE);
+      }
+      if (!hashes_match)
+      {
+        exceptions.push_back({group_offset, writer.GetPosition(), num_blocks, 0});
+        if (!writer.Write(encrypted_headers.data(), encrypted_headers.size()))
+        {
+          success = false;
+          break;
+        }
+      }
+
+      for (u32 i = 0; i < num_blocks && success; ++i)
+      {
+        std::copy_n(group_buffer.data() + i * BLOCK_TOTAL_SIZE + BLOCK_HEADER_SIZE,
+                    BLOCK_DATA_SIZE, buffer.data() + blocks_in_buffer * BLOCK_DATA_SIZE);
+        ++blocks_in_buffer;
+
+        if (blocks_in_buffer == blocks_per_chunk || first_block + i + 1 == total_blocks)
+        {
+          success = writer.WriteChunk(buffer.data(), blocks_in_buffer * BLOCK_DATA_SIZE);
+          blocks_in_buffer = 0;
+        }
+      }
+
+      bytes_done += num_blocks * BLOCK_TOTAL_SIZE;
+      if (success && !report_progress())
+        success = false;
+    }
+
+    mbedtls_aes_free(&aes_context);
+  }
+
+  if (success)
+  {
+    header.num_exceptions = static_cast<u32>(exceptions.size());
+    header.exceptions_offset = writer.GetPosition();
+
+    success = outfile.WriteArray(exceptions.data(), exceptions.size()) &&
+              outfile.Seek(0, SEEK_SET) && outfile.WriteArray(&header, 1) &&
+              outfile.WriteArray(partition_entries.data(), partition_entries.size()) &&
+              outfile.WriteArray(regions.data(), regions.size()) &&
+              outfile.Seek(header.index_offset, SEEK_SET) &&
+              outfile.WriteArray(writer.GetIndex().data(), writer.GetIndex().size());
+  }
+
+  if (!success)
+  {
+    if (!outfile.IsGood())
+    {
+      PanicAlertT("Failed to write the output file \"%s\".\n"
+                  "Check that you have enough space available on the target drive.",
+                  outfile_path.c_str());
+    }
+
+    // Remove the incomplete output file.
+    outfile.Close();
+    File::Delete(outfile_path);
+    return false;
+  }
+
+  INFO_LOG(DISCIO, "Converted %s to DCZ: %zu chunks, %zu hash exceptions", infile_path.c_str(),
+           writer.GetIndex().size(), exceptions.size());
+
+  if (callback)
+    callback(GetStringT("Done compressing disc image."), 1.0f, arg);
+  return true;
+}
+
+bool ConvertDCZToPlain(const std::string& infile_path, const std::string& outfile_path,
+                       CompressCB callback, void* arg)
+{
+  std::unique_ptr<DCZFileReader> reader;
+  {
+    File::IOFile infile(infile_path, "rb");
+    reader = DCZFileReader::Create(std::move(infile), infile_path);
+  }
+
+  if (!reader)
+  {
+    PanicAlertT("Failed to open the input file \"%s\".", infile_path.c_str());
+    return false;
+  }
+
+  File::IOFile outfile(outfile_path, "wb");
+  if (!outfile)
+  {
+    PanicAlertT("Failed to open the output file \"%s\".\n"
+                "Check that you have permissions to write the target folder and that the media can "
+                "be written.",
+                outfile_path.c_str());
+    return false;
+  }
+
+  // Reading whole groups at a time avoids regenerating the hashes of Wii partitions twice
+  const u64 buffer_size = std::max<u64>(reader->GetHeader().chunk_size, GROUP_TOTAL_SIZE);
+  const u64 data_size = reader->GetDataSize();
+  const u64 num_buffers = (data_size + buffer_size - 1) / buffer_size;
+  const u64 progress_monitor = std::max<u64>(1, num_buffers / 100);
+  std::vector<u8> buffer(buffer_size);
+  bool success = true;
+
+  for (u64 i = 0; i < num_buffers; ++i)
+  {
+    if (callback && i % progress_monitor == 0)
+    {
+      const bool was_cancelled =
+          !callback(GetStringT("Unpacking"), static_cast<float>(i) / num_buffers, arg);
+      if (was_cancelled)
+      {
+        success = false;
+        break;
+      }
+    }
+
+    const u64 offset = i * buffer_size;
+    const size_t size = static_cast<size_t>(std::min(buffer_size, data_size - offset));
+    if (!reader->Read(offset, size, buffer.data()))
+    {
+      PanicAlertT("Failed to read from the input file \"%s\".", infile_path.c_str());
+      success = false;
+      break;
+    }
+
+    if (!outfile.WriteBytes(buffer.data(), size))
+    {
+      PanicAlertT("Failed to write the output file \"%s\".\n"
+                  "Check that you have enough space available on the target drive.",
+                  outfile_path.c_str());
+      success = false;
+      break;
+    }
+  }
+
+  if (!success)
+  {
+    // Remove the incomplete output file.
+    outfile.Close();
+    File::Delete(outfile_path);
+  }
+
+  return success;
+}
+
+}  // namespace DiscIO
@@ -0,0 +1,191 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// WARNING Code not big-endian safe.
+
+// DCZ is a seekable, chunk-compressed disc image format.
+//
+// Unlike GCZ, the chunk size and the codec can be chosen when converting, and the chunk index
+// is stored page-aligned so that it can be memory-mapped instead of being read into memory.
+//
+// The data of Wii partitions is stored decrypted and without the 0x400-byte hash headers of
+// each 0x8000-byte block, which makes it compressible. The hashes are regenerated and the data
+// is re-encrypted when the encrypted data is read. For groups where the regenerated hashes do
+// not match the original ones (e.g. scrubbed discs), the original encrypted hash headers are
+// stored as exceptions, which keeps the conversion lossless.
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/MappedFile.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+static constexpr u32 DCZ_MAGIC = 0x015A4344;  // "DCZ\x01" (byteswapped to little endian)
+static constexpr u32 DCZ_VERSION = 1;
+
+static constexpr u32 DCZ_MIN_CHUNK_SIZE = 0x8000;
+static constexpr u32 DCZ_MAX_CHUNK_SIZE = 0x2000000;
+static constexpr u32 DCZ_DEFAULT_CHUNK_SIZE = 0x20000;
+
+enum class DCZCodec : u32
+{
+  None = 0,
+  Deflate = 1,
+  LZO = 2,
+  LZMA = 3,
+};
+
+// Returns false for codecs that were not compiled in (LZMA requires liblzma).
+bool IsDCZCodecSupported(DCZCodec codec);
+// The codec used when converting from the UI: LZMA if it is supported, otherwise Deflate
+DCZCodec GetDefaultDCZCodec();
+
+static constexpr int DCZ_DEFAULT_COMPRESSION_LEVEL = 6;
+
+// File structure:
+// DCZHeader
+// DCZPartitionEntry[num_partitions]
+// DCZRegionEntry[num_regions]
+// (padding up to index_offset, which is aligned to DCZ_INDEX_ALIGNMENT)
+// DCZChunkEntry[num_chunks]
+// compressed chunk data, interleaved with the encrypted hash headers of the exception groups
+// DCZExceptionEntry[num_exceptions] at exceptions_offset, sorted by group_offset
+
+static constexpr u64 DCZ_INDEX_ALIGNMENT = 0x1000;
+
+struct DCZHeader  // 64 bytes
+{
+  u32 magic;
+  u32 version;
+  u32 codec;
+  u32 chunk_size;
+  u64 data_size;
+  u64 index_offset;
+  u64 exceptions_offset;
+  u32 num_partitions;
+  u32 num_regions;
+  u32 num_chunks;
+  u32 num_exceptions;
+  u64 reserved;
+};
+static_assert(sizeof(DCZHeader) == 64, "Wrong size for DCZHeader");
+
+struct DCZPartitionEntry  // 24 bytes
+{
+  u64 partition_offset;
+  std::array<u8, 16> title_key;
+};
+static_assert(sizeof(DCZPartitionEntry) == 24, "Wrong size for DCZPartitionEntry");
+
+// The regions cover the whole disc without gaps and are sorted by raw_offset.
+// Regions that belong to a partition store its data decrypted (0x7C00 bytes per 0x8000-byte
+// block), so each of their chunks holds chunk_size / 0x8000 blocks. Other regions are stored as-is.
+static constexpr u32 DCZ_NO_PARTITION = 0xFFFFFFFF;
+
+struct DCZRegionEntry  // 24 bytes
+{
+  u64 raw_offset;
+  u64 raw_size;
+  u32 first_chunk;
+  u32 partition_index;
+};
+static_assert(sizeof(DCZRegionEntry) == 24, "Wrong size for DCZRegionEntry");
+
+enum DCZChunkFlags : u32
+{
+  DCZ_CHUNK_UNCOMPRESSED = 1 << 0,
+  DCZ_CHUNK_ZERO = 1 << 1,  // No data is stored, the chunk only contains zeroes
+};
+
+struct DCZChunkEntry  // 16 bytes
+{
+  u64 file_offset;
+  u32 compressed_size;
+  u32 flags;
+};
+static_assert(sizeof(DCZChunkEntry) == 16, "Wrong size for DCZChunkEntry");
+
+struct DCZExceptionEntry  // 24 bytes
+{
+  u64 group_offset;  // Raw offset of the first block of the group
+  u64 file_offset;   // Location of num_blocks * 0x400 bytes of encrypted hash headers
+  u32 num_blocks;
+  u32 reserved;
+};
+static_assert(sizeof(DCZExceptionEntry) == 24, "Wrong size for DCZExceptionEntry");
+
+class DCZFileReader : public BlobReader
+{
+public:
+  static std::unique_ptr<DCZFileReader> Create(File::IOFile file, const std::string& path);
+  ~DCZFileReader();
+
+  BlobType GetBlobType() const override { return BlobType::DCZ; }
+  u64 GetDataSize() const override { return m_header.data_size; }
+  u64 GetRawSize() const override { return m_file_size; }
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+  // Partitions that couldn't be decrypted when converting are stored as-is
+  bool SupportsReadWiiDecrypted(u64 partition_offset) const override
+  {
+    return FindPartitionRegion(partition_offset) != nullptr;
+  }
+  bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_offset) override;
+
+  const DCZHeader& GetHeader() const { return m_header; }
+
+private:
+  DCZFileReader(File::IOFile file, const std::string& path);
+  bool Initialize();
+
+  const DCZRegionEntry* FindRegion(u64 raw_offset) const;
+  const DCZRegionEntry* FindPartitionRegion(u64 partition_offset) const;
+  u32 GetChunkDataSize(const DCZRegionEntry& region, u32 chunk_in_region) const;
+
+  // Returns the decompressed contents of a chunk, or nullptr on failure.
+  // The returned pointer is valid until the next call.
+  const u8* GetChunk(const DCZRegionEntry& region, u32 chunk_in_region);
+
+  bool ReadRegion(const DCZRegionEntry& region, u64 offset, u64 size, u8* out_ptr);
+  bool ReadEncryptedGroup(const DCZRegionEntry& region, u64 group);
+
+  File::IOFile m_file;
+  std::string m_path;
+  u64 m_file_size;
+
+  DCZHeader m_header;
+  std::vector<DCZPartitionEntry> m_partitions;
+  std::vector<DCZRegionEntry> m_regions;
+  std::vector<DCZExceptionEntry> m_exceptions;
+
+  // Points into m_index_mapping, or into m_index_fallback if the index couldn't be mapped
+  const DCZChunkEntry* m_index = nullptr;
+  File::MappedFile m_index_mapping;
+  std::vector<DCZChunkEntry> m_index_fallback;
+
+  u32 m_cached_chunk = std::numeric_limits<u32>::max();
+  std::vector<u8> m_chunk_buffer;
+  std::vector<u8> m_compressed_buffer;
+
+  const DCZRegionEntry* m_cached_group_region = nullptr;
+  u64 m_cached_group = 0;
+  std::vector<u8> m_group_buffer;
+};
+
+bool ConvertToDCZ(const std::string& infile_path, const std::string& outfile_path,
+                  DCZCodec codec, int compression_level, u32 chunk_size,
+                  CompressCB callback = nullptr, void* arg = nullptr);
+bool ConvertDCZToPlain(const std::string& infile_path, const std::string& outfile_path,
+                       CompressCB callback = nullptr, void* arg = nullptr);
+
+}  // namespace DiscIO
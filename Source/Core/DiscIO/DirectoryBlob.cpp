@@ -378,7 +378,7 @@ bool DirectoryBlobReader::Read(u64 offset, u64 length, u8* buffer)
       .Read(offset, length, buffer);
 }
 
-bool DirectoryBlobReader::SupportsReadWiiDecrypted() const
+bool DirectoryBlobReader::SupportsReadWiiDecrypted(u64 partition_offset) const
 {
   return m_is_wii;
 }
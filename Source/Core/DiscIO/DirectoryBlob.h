@@ -138,7 +138,7 @@ public:
   DirectoryBlobReader& operator=(DirectoryBlobReader&&) = default;
 
   bool Read(u64 offset, u64 length, u8* buffer) override;
-  bool SupportsReadWiiDecrypted() const override;
+  bool SupportsReadWiiDecrypted(u64 partition_offset) const override;
   bool ReadWiiDecrypted(u64 offset, u64 size, u8* buffer, u64 partition_offset) override;
 
   BlobType GetBlobType() const override;
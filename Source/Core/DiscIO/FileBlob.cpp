@@ -2,10 +2,12 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "Common/Logging/Log.h"
 #include "DiscIO/FileBlob.h"
 
 namespace DiscIO
@@ -13,6 +15,9 @@ namespace DiscIO
 PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
 {
   m_size = m_file.GetSize();
+
+  if (sizeof(void*) >= 8 && m_size > 0 && !m_mapping.Map(m_file, 0, m_size))
+    WARN_LOG(DISCIO, "Failed to map disc image, falling back to regular reads");
 }
 
 std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
@@ -25,6 +30,16 @@ std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
 
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (m_mapping.IsMapped())
+  {
+    const u8* data = GetDirectPointer(offset, nbytes);
+    if (!data)
+      return false;
+
+    std::memcpy(out_ptr, data, static_cast<size_t>(nbytes));
+    return true;
+  }
+
   if (m_file.Seek(offset, SEEK_SET) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -36,4 +51,15 @@ bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
   }
 }
 
+const u8* PlainFileReader::GetDirectPointer(u64 offset, u64 size) const
+{
+  if (!m_mapping.IsMapped() || offset > m_mapping.GetSize() ||
+      size > m_mapping.GetSize() - offset)
+  {
+    return nullptr;
+  }
+
+  return m_mapping.GetData() + offset;
+}
+
 }  // namespace
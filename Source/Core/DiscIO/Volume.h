@@ -44,6 +44,11 @@ public:
   Volume() {}
   virtual ~Volume() {}
   virtual bool Read(u64 _Offset, u64 _Length, u8* _pBuffer, const Partition& partition) const = 0;
+  // See BlobReader::GetDirectPointer. Always returns nullptr for encrypted data.
+  virtual const u8* GetDirectPointer(u64 offset, u64 length, const Partition& partition) const
+  {
+    return nullptr;
+  }
   template <typename T>
   std::optional<T> ReadSwapped(u64 offset, const Partition& partition) const
   {
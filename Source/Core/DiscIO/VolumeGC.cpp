@@ -56,6 +56,14 @@ bool VolumeGC::Read(u64 _Offset, u64 _Length, u8* _pBuffer, const Partition& par
   return m_pReader->Read(_Offset, _Length, _pBuffer);
 }
 
+const u8* VolumeGC::GetDirectPointer(u64 offset, u64 length, const Partition& partition) const
+{
+  if (partition != PARTITION_NONE)
+    return nullptr;
+
+  return m_pReader->GetDirectPointer(offset, length);
+}
+
 const FileSystem* VolumeGC::GetFileSystem(const Partition& partition) const
 {
   return m_file_system->get();
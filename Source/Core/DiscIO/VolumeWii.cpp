@@ -9,19 +9,21 @@
 #include <cstddef>
 #include <cstring>
 #include <map>
-#include <mbedtls/aes.h>
 #include <mbedtls/sha1.h>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/WorkerPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -35,9 +37,24 @@ namespace DiscIO
 {
 constexpr u64 PARTITION_DATA_OFFSET = 0x20000;
 
+// Number of decrypted blocks kept around for small reads (about 1 MiB)
+constexpr size_t BLOCK_CACHE_SIZE = 32;
+// Reads of whole blocks are split into batches of at most this many blocks (one hash group)
+constexpr u64 MAX_BULK_BLOCKS = 64;
+// Batches smaller than this are decrypted on the calling thread
+constexpr u64 MIN_PARALLEL_BLOCKS = 8;
+
+static Common::WorkerPool& GetDecryptionPool()
+{
+  // AES-NI decrypts a block in a few microseconds, so a handful of threads is plenty
+  static Common::WorkerPool s_pool(
+      "Wii Decryption", std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u));
+  return s_pool;
+}
+
 VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
     : m_pReader(std::move(reader)), m_game_partition(PARTITION_NONE),
-      m_last_decrypted_block(UINT64_MAX)
+      m_block_cache(BLOCK_CACHE_SIZE)
 {
   _assert_(m_pReader);
 
@@ -103,14 +120,12 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
         return IOS::ES::TMDReader{std::move(tmd_buffer)};
       };
 
-      auto get_key = [this, partition]() -> std::unique_ptr<mbedtls_aes_context> {
+      auto get_key = [this, partition]() -> std::unique_ptr<Common::AES::Context> {
         const IOS::ES::TicketReader& ticket = *m_partitions[partition].ticket;
         if (!ticket.IsValid())
           return nullptr;
         const std::array<u8, 16> key = ticket.GetTitleKey();
-        std::unique_ptr<mbedtls_aes_context> aes_context = std::make_unique<mbedtls_aes_context>();
-        mbedtls_aes_setkey_dec(aes_context.get(), key.data(), 128);
-        return aes_context;
+        return Common::AES::CreateContext(key.data(), Common::AES::Mode::Decrypt);
       };
 
       auto get_file_system = [this, partition]() -> std::unique_ptr<FileSystem> {
@@ -119,7 +134,7 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
       };
 
       m_partitions.emplace(
-          partition, PartitionDetails{Common::Lazy<std::unique_ptr<mbedtls_aes_context>>(get_key),
+          partition, PartitionDetails{Common::Lazy<std::unique_ptr<Common::AES::Context>>(get_key),
                                       Common::Lazy<IOS::ES::TicketReader>(get_ticket),
                                       Common::Lazy<IOS::ES::TMDReader>(get_tmd),
                                       Common::Lazy<std::unique_ptr<FileSystem>>(get_file_system),
@@ -137,18 +152,17 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
   if (partition == PARTITION_NONE)
     return m_pReader->Read(_ReadOffset, _Length, _pBuffer);
 
-  if (m_pReader->SupportsReadWiiDecrypted())
+  if (m_pReader->SupportsReadWiiDecrypted(partition.offset))
     return m_pReader->ReadWiiDecrypted(_ReadOffset, _Length, _pBuffer, partition.offset);
 
   // Get the decryption key for the partition
   auto it = m_partitions.find(partition);
   if (it == m_partitions.end())
     return false;
-  mbedtls_aes_context* aes_context = it->second.key->get();
+  const Common::AES::Context* aes_context = it->second.key->get();
   if (!aes_context)
     return false;
 
-  std::vector<u8> read_buffer(BLOCK_TOTAL_SIZE);
   while (_Length > 0)
   {
     // Calculate offsets
@@ -156,30 +170,28 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
         partition.offset + PARTITION_DATA_OFFSET + _ReadOffset / BLOCK_DATA_SIZE * BLOCK_TOTAL_SIZE;
     u64 data_offset_in_block = _ReadOffset % BLOCK_DATA_SIZE;
 
-    if (m_last_decrypted_block != block_offset_on_disc)
+    // Large reads that cover whole blocks bypass the cache and are decrypted in batches
+    const u64 whole_blocks = data_offset_in_block == 0 ? _Length / BLOCK_DATA_SIZE : 0;
+    if (whole_blocks >= 2 && !FindCachedBlock(block_offset_on_disc))
     {
-      // Read the current block
-      if (!m_pReader->Read(block_offset_on_disc, BLOCK_TOTAL_SIZE, read_buffer.data()))
+      const u64 num_blocks = std::min(whole_blocks, MAX_BULK_BLOCKS);
+      if (!DecryptBlocks(*aes_context, block_offset_on_disc, num_blocks, _pBuffer))
         return false;
 
-      // Decrypt the block's data.
-      // 0x3D0 - 0x3DF in read_buffer will be overwritten,
-      // but that won't affect anything, because we won't
-      // use the content of read_buffer anymore after this
-      mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, &read_buffer[0x3D0],
-                            &read_buffer[BLOCK_HEADER_SIZE], m_last_decrypted_block_data);
-      m_last_decrypted_block = block_offset_on_disc;
-
-      // The only thing we currently use from the 0x000 - 0x3FF part
-      // of the block is the IV (at 0x3D0), but it also contains SHA-1
-      // hashes that IOS uses to check that discs aren't tampered with.
-      // http://wiibrew.org/wiki/Wii_Disc#Encrypted
+      const u64 copy_size = num_blocks * BLOCK_DATA_SIZE;
+      _Length -= copy_size;
+      _pBuffer += copy_size;
+      _ReadOffset += copy_size;
+      continue;
     }
 
+    const CachedBlock* block = GetCachedBlock(*aes_context, block_offset_on_disc);
+    if (!block)
+      return false;
+
     // Copy the decrypted data
     u64 copy_size = std::min(_Length, BLOCK_DATA_SIZE - data_offset_in_block);
-    memcpy(_pBuffer, &m_last_decrypted_block_data[data_offset_in_block],
-           static_cast<size_t>(copy_size));
+    memcpy(_pBuffer, &block->data[data_offset_in_block], static_cast<size_t>(copy_size));
 
     // Update offsets
     _Length -= copy_size;
@@ -190,6 +202,80 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
   return true;
 }
 
+const u8* VolumeWii::GetDirectPointer(u64 offset, u64 length, const Partition& partition) const
+{
+  if (partition != PARTITION_NONE)
+    return nullptr;
+
+  return m_pReader->GetDirectPointer(offset, length);
+}
+
+bool VolumeWii::DecryptBlocks(const Common::AES::Context& key, u64 block_offset_on_disc,
+                              u64 num_blocks, u8* out_ptr) const
+{
+  m_read_buffer.resize(num_blocks * BLOCK_TOTAL_SIZE);
+  if (!m_pReader->Read(block_offset_on_disc, m_read_buffer.size(), m_read_buffer.data()))
+    return false;
+
+  // The IV of each block's data is stored at 0x3D0 in its (still encrypted) header.
+  // The only other thing in 0x000 - 0x3FF is a set of SHA-1 hashes that IOS uses to check
+  // that discs aren't tampered with. http://wiibrew.org/wiki/Wii_Disc#Encrypted
+  const u8* read_buffer = m_read_buffer.data();
+  auto decrypt_block = [&key, read_buffer, out_ptr](size_t i) {
+    const u8* block = read_buffer + i * BLOCK_TOTAL_SIZE;
+    key.Crypt(&block[0x3D0], &block[BLOCK_HEADER_SIZE], out_ptr + i * BLOCK_DATA_SIZE,
+              BLOCK_DATA_SIZE);
+  };
+
+  if (num_blocks >= MIN_PARALLEL_BLOCKS)
+  {
+    GetDecryptionPool().ParallelFor(static_cast<size_t>(num_blocks), decrypt_block);
+  }
+  else
+  {
+    for (size_t i = 0; i < num_blocks; ++i)
+      decrypt_block(i);
+  }
+
+  return true;
+}
+
+const VolumeWii::CachedBlock* VolumeWii::FindCachedBlock(u64 block_offset_on_disc) const
+{
+  for (CachedBlock& block : m_block_cache)
+  {
+    if (block.offset_on_disc == block_offset_on_disc)
+    {
+      block.last_use = ++m_block_cache_tick;
+      return &block;
+    }
+  }
+  return nullptr;
+}
+
+const VolumeWii::CachedBlock* VolumeWii::GetCachedBlock(const Common::AES::Context& key,
+                                                        u64 block_offset_on_disc) const
+{
+  if (const CachedBlock* block = FindCachedBlock(block_offset_on_disc))
+    return block;
+
+  CachedBlock& victim =
+      *std::min_element(m_block_cache.begin(), m_block_cache.end(),
+                        [](const CachedBlock& a, const CachedBlock& b) {
+                          return a.last_use < b.last_use;
+                        });
+
+  // Invalidate the slot first so that a failed read doesn't leave stale data behind
+  victim.offset_on_disc = UINT64_MAX;
+  victim.last_use = 0;
+  if (!DecryptBlocks(key, block_offset_on_disc, 1, victim.data.data()))
+    return nullptr;
+
+  victim.offset_on_disc = block_offset_on_disc;
+  victim.last_use = ++m_block_cache_tick;
+  return &victim;
+}
+
 std::vector<Partition> VolumeWii::GetPartitions() const
 {
   std::vector<Partition> partitions;
@@ -361,7 +447,7 @@ bool VolumeWii::CheckIntegrity(const Partition& partition) const
   auto it = m_partitions.find(partition);
   if (it == m_partitions.end())
     return false;
-  mbedtls_aes_context* aes_context = it->second.key->get();
+  const Common::AES::Context* aes_context = it->second.key->get();
   if (!aes_context)
     return false;
 
@@ -384,7 +470,7 @@ bool VolumeWii::CheckIntegrity(const Partition& partition) const
       WARN_LOG(DISCIO, "Integrity Check: fail at cluster %d: could not read metadata", clusterID);
       return false;
     }
-    mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, 0x400, IV, clusterMDCrypted, clusterMD);
+    aes_context->Crypt(IV, clusterMDCrypted, clusterMD, 0x400);
 
     // Some clusters have invalid data and metadata because they aren't
     // meant to be read by the game (for example, holes between files). To
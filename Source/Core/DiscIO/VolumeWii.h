@@ -4,14 +4,15 @@
 
 #pragma once
 
+#include <array>
 #include <map>
-#include <mbedtls/aes.h>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/Lazy.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/Filesystem.h"
@@ -33,6 +34,7 @@ public:
   VolumeWii(std::unique_ptr<BlobReader> reader);
   ~VolumeWii();
   bool Read(u64 _Offset, u64 _Length, u8* _pBuffer, const Partition& partition) const override;
+  const u8* GetDirectPointer(u64 offset, u64 length, const Partition& partition) const override;
   std::vector<Partition> GetPartitions() const override;
   Partition GetGamePartition() const override;
   std::optional<u32> GetPartitionType(const Partition& partition) const override;
@@ -70,19 +72,36 @@ protected:
 private:
   struct PartitionDetails
   {
-    Common::Lazy<std::unique_ptr<mbedtls_aes_context>> key;
+    Common::Lazy<std::unique_ptr<Common::AES::Context>> key;
     Common::Lazy<IOS::ES::TicketReader> ticket;
     Common::Lazy<IOS::ES::TMDReader> tmd;
     Common::Lazy<std::unique_ptr<FileSystem>> file_system;
     u32 type;
   };
 
+  struct CachedBlock
+  {
+    u64 offset_on_disc = UINT64_MAX;
+    u64 last_use = 0;
+    std::array<u8, BLOCK_DATA_SIZE> data;
+  };
+
+  // Reads and decrypts num_blocks consecutive blocks straight into out_ptr,
+  // spreading the decryption over several threads for large reads.
+  bool DecryptBlocks(const Common::AES::Context& key, u64 block_offset_on_disc, u64 num_blocks,
+                     u8* out_ptr) const;
+  const CachedBlock* FindCachedBlock(u64 block_offset_on_disc) const;
+  const CachedBlock* GetCachedBlock(const Common::AES::Context& key,
+                                    u64 block_offset_on_disc) const;
+
   std::unique_ptr<BlobReader> m_pReader;
   std::map<Partition, PartitionDetails> m_partitions;
   Partition m_game_partition;
 
-  mutable u64 m_last_decrypted_block;
-  mutable u8 m_last_decrypted_block_data[BLOCK_DATA_SIZE];
+  // Least recently used blocks are evicted first
+  mutable std::vector<CachedBlock> m_block_cache;
+  mutable u64 m_block_cache_tick = 0;
+  mutable std::vector<u8> m_read_buffer;
 };
 
 }  // namespace
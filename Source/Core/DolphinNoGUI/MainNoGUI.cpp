@@ -10,21 +10,31 @@
 #include <string>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
+#include "Common/FileUtil.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/MsgHandler.h"
+#include "Common/ScopeGuard.h"
 
+#include "Core/ARBruteForcer.h"
 #include "Core/Analytics.h"
+#include "Core/Benchmark.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/FifoPlayer/FifoBenchmark.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/Host.h"
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/STM/STM.h"
+#include "Core/Movie.h"
 #include "Core/State.h"
 
 #include "UICommon/CommandLineParse.h"
@@ -349,6 +359,46 @@ class PlatformX11 : public Platform
 };
 #endif
 
+// FIFO player settings from the command line. They can only be applied once a FIFO log is loaded.
+static struct
+{
+  bool set_frame_range = false;
+  u32 first_frame = 0;
+  u32 last_frame = 0;
+  bool set_object_range = false;
+  u32 first_object = 0;
+  u32 last_object = 0;
+  u32 loop_count = 0;
+  bool early_memory_updates = false;
+} s_fifo_options;
+
+static void ApplyFifoOptions()
+{
+  FifoPlayer& player = FifoPlayer::GetInstance();
+  if (!player.GetFile())
+    return;
+
+  if (s_fifo_options.set_frame_range)
+  {
+    player.SetFrameRangeStart(s_fifo_options.first_frame);
+    player.SetFrameRangeEnd(s_fifo_options.last_frame + 1);
+  }
+  if (s_fifo_options.set_object_range)
+  {
+    player.SetObjectRangeStart(s_fifo_options.first_object);
+    player.SetObjectRangeEnd(s_fifo_options.last_object);
+  }
+  player.SetLoopCount(s_fifo_options.loop_count);
+  player.SetEarlyMemoryUpdates(s_fifo_options.early_memory_updates);
+}
+
+// Parses "<first>-<last>"
+static bool ParseRange(const char* str, u32* first, u32* last)
+{
+  char end;
+  return sscanf(str, "%u-%u%c", first, last, &end) == 2 && *first <= *last;
+}
+
 static Platform* GetPlatform()
 {
 #if defined(USE_HEADLESS)
@@ -362,6 +412,68 @@ static Platform* GetPlatform()
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
+  parser->add_option("--benchmark-frames")
+      .action("store")
+      .type("int")
+      .metavar("<frames>")
+      .help("Run unthrottled for the given number of frames, write a benchmark report and exit");
+  parser->add_option("--benchmark-warmup")
+      .action("store")
+      .type("int")
+      .metavar("<frames>")
+      .set_default("0")
+      .help("Frames to run before the benchmark starts measuring (default: %default)");
+  parser->add_option("--benchmark-report")
+      .action("store")
+      .type("string")
+      .metavar("<file>")
+      .help("Path of the JSON benchmark report (default: Logs/Benchmark.json in the user folder)");
+  parser->add_option("--benchmark-savestates")
+      .action("store_true")
+      .help("Save a savestate to memory and load it again after every benchmarked frame, and "
+            "report how long that takes");
+  parser->add_option("--present-interval")
+      .action("store")
+      .type("int")
+      .metavar("<frames>")
+      .help("Only present every Nth frame while running unthrottled. Every frame is still "
+            "emulated and rendered");
+  parser->add_option("--fifo-frames")
+      .action("store")
+      .metavar("<first>-<last>")
+      .help("Frames of a FIFO log to play");
+  parser->add_option("--fifo-objects")
+      .action("store")
+      .metavar("<first>-<last>")
+      .help("Objects of each frame of a FIFO log to draw");
+  parser->add_option("--fifo-loops")
+      .action("store")
+      .type("int")
+      .metavar("<count>")
+      .help("Play the FIFO log frames the given number of times and exit");
+  parser->add_option("--fifo-early-memory-updates")
+      .action("store_true")
+      .help("Apply all memory updates of a FIFO log before playing the first frame");
+  parser->add_option("--fifo-report")
+      .action("store")
+      .type("string")
+      .metavar("<file>")
+      .help("Measure the decoding time of each played FIFO log frame and object and write a JSON "
+            "report");
+  parser->add_option("--bruteforce")
+      .action("store")
+      .metavar("<digit>")
+      .help("Search for Action Replay culling codes by making every function in the game's map "
+            "file return the given value, starting from the savestate in slot 1");
+  parser->add_option("--bruteforce-workers")
+      .action("store")
+      .type("int")
+      .metavar("<count>")
+      .help("Split the culling code search between the given number of processes");
+  parser->add_option("--bruteforce-worker")
+      .action("store")
+      .type("int")
+      .help(optparse::SUPPRESS_HELP);
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
 
@@ -409,6 +521,50 @@ int main(int argc, char* argv[])
   UICommon::SetUserDirectory(user_directory);
   UICommon::Init();
 
+  if (options.is_set("bruteforce"))
+  {
+    ARBruteForcer::ch_code = static_cast<const char*>(options.get("bruteforce"));
+    if (ARBruteForcer::ch_code.size() != 1 ||
+        ARBruteForcer::ch_code.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+    {
+      fprintf(stderr, "Invalid bruteforce value, use a single hex digit\n");
+      return 1;
+    }
+    ARBruteForcer::ch_bruteforce = true;
+    ARBruteForcer::ch_dont_save_settings = true;
+    ARBruteForcer::ch_exit_when_done = true;
+
+    const int workers =
+        options.is_set("bruteforce_workers") ? options.get("bruteforce_workers") : 1;
+    if (workers <= 0)
+    {
+      fprintf(stderr, "Invalid number of bruteforce workers\n");
+      return 1;
+    }
+    ARBruteForcer::ch_worker_count = workers;
+
+    if (options.is_set("bruteforce_worker"))
+    {
+      ARBruteForcer::ch_worker_index = options.get("bruteforce_worker");
+    }
+    else if (workers > 1)
+    {
+      // This process only starts the workers and merges their results
+      const auto* disc = std::get_if<BootParameters::Disc>(&boot->parameters);
+      if (!disc)
+      {
+        fprintf(stderr, "Bruteforce workers can only be used with a disc image\n");
+        return 1;
+      }
+      const bool success =
+          ARBruteForcer::RunWorkerProcesses(std::vector<std::string>(argv, argv + argc), workers,
+                                            disc->volume->GetGameID());
+      UICommon::Shutdown();
+      delete platform;
+      return success ? 0 : 1;
+    }
+  }
+
   Core::SetOnStateChangedCallback([](Core::State state) {
     if (state == Core::State::Uninitialized)
       s_running.Clear();
@@ -425,6 +581,96 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance()->ReportDolphinStart("nogui");
 
+  if (options.is_set("video_backend"))
+    SConfig::GetInstance().m_strVideoBackend = static_cast<const char*>(options.get("video_backend"));
+
+  if (options.is_set("fifo_frames") &&
+      !ParseRange(options.get("fifo_frames"), &s_fifo_options.first_frame,
+                  &s_fifo_options.last_frame))
+  {
+    fprintf(stderr, "Invalid FIFO frame range\n");
+    return 1;
+  }
+  s_fifo_options.set_frame_range = options.is_set("fifo_frames");
+  if (options.is_set("fifo_objects") &&
+      !ParseRange(options.get("fifo_objects"), &s_fifo_options.first_object,
+                  &s_fifo_options.last_object))
+  {
+    fprintf(stderr, "Invalid FIFO object range\n");
+    return 1;
+  }
+  s_fifo_options.set_object_range = options.is_set("fifo_objects");
+  if (options.is_set("fifo_loops"))
+  {
+    const int loops = options.get("fifo_loops");
+    if (loops <= 0)
+    {
+      fprintf(stderr, "Invalid number of FIFO loops\n");
+      return 1;
+    }
+    s_fifo_options.loop_count = loops;
+  }
+  s_fifo_options.early_memory_updates = options.is_set("fifo_early_memory_updates");
+  FifoPlayer::GetInstance().SetFileLoadedCallback(ApplyFifoOptions);
+
+  const bool fifo_report = options.is_set("fifo_report");
+  if (fifo_report)
+    FifoBenchmark::Start(static_cast<const char*>(options.get("fifo_report")));
+
+  if (options.is_set("movie") && !Movie::PlayInput(static_cast<const char*>(options.get("movie"))))
+  {
+    fprintf(stderr, "Could not play the specified movie\n");
+    return 1;
+  }
+
+  if (options.is_set("present_interval"))
+  {
+    const int interval = options.get("present_interval");
+    if (interval <= 0)
+    {
+      fprintf(stderr, "Invalid present interval\n");
+      return 1;
+    }
+    Config::SetCurrent(Config::GFX_FAST_FORWARD_PRESENT_INTERVAL, interval);
+  }
+
+  const bool benchmark = options.is_set("benchmark_frames");
+  if (benchmark)
+  {
+    const int frames = options.get("benchmark_frames");
+    const int warmup_frames = options.get("benchmark_warmup");
+    if (frames <= 0 || warmup_frames < 0)
+    {
+      fprintf(stderr, "Invalid number of benchmark frames\n");
+      return 1;
+    }
+
+    const std::string report_path =
+        options.is_set("benchmark_report") ?
+            static_cast<const char*>(options.get("benchmark_report")) :
+            File::GetUserPath(D_LOGS_IDX) + "Benchmark.json";
+
+    // Disables both the frame limiter and VSync
+    Core::SetIsThrottlerTempDisabled(true);
+    Benchmark::Start(frames, warmup_frames, report_path, options.is_set("benchmark_savestates"));
+  }
+
+  // Looking for HMDs is slow and can start their runtimes, so it's only done when VR is wanted
+  g_force_vr = options.is_set("vr");
+  const bool use_vr = g_force_vr || g_simulate_hmd;
+  if (use_vr)
+    VR_Init();
+  // The video backend also shuts VR down, but not if the game never booted
+  Common::ScopeGuard vr_guard([use_vr] {
+    if (use_vr)
+      VR_Shutdown();
+  });
+  if (g_simulate_hmd && !g_has_simulated_hmd)
+  {
+    fprintf(stderr, "Could not start the simulated HMD\n");
+    return 1;
+  }
+
   if (!BootManager::BootCore(std::move(boot)))
   {
     fprintf(stderr, "Could not boot the specified file\n");
@@ -442,10 +688,18 @@ int main(int argc, char* argv[])
   Core::Stop();
 
   Core::Shutdown();
+
+  // Writes a partial report if emulation stopped before the benchmark was done
+  int exit_code = 0;
+  if (benchmark && !Benchmark::Stop())
+    exit_code = 1;
+  if (fifo_report && !FifoBenchmark::Stop())
+    exit_code = 1;
+
   platform->Shutdown();
   UICommon::Shutdown();
 
   delete platform;
 
-  return 0;
+  return exit_code;
 }
@@ -291,8 +291,10 @@ void GeneralWidget::AddDescriptions()
       QT_TR_NOOP("Show the players' maximum Ping while playing on "
                  "NetPlay.\n\nIf unsure, leave this unchecked.");
   static const char* TR_LOG_RENDERTIME_DESCRIPTION =
-      QT_TR_NOOP("Log the render time of every frame to User/Logs/render_time.txt. Use this "
-                 "feature when you want to measure the performance of Dolphin.\n\nIf "
+      QT_TR_NOOP("Log the render time of every frame to User/Logs/render_time.txt, and write "
+                 "frame time histograms to User/Logs/frame_times.csv and frame_times.json when "
+                 "emulation stops. Use this feature when you want to measure the performance of "
+                 "Dolphin.\n\nIf "
                  "unsure, leave this unchecked.");
   static const char* TR_SHOW_NETPLAY_MESSAGES_DESCRIPTION =
       QT_TR_NOOP("When playing on NetPlay, show chat messages, buffer changes and "
@@ -4,84 +4,73 @@
 
 #include "GameFileCache.h"
 
+#include <optional>
+#include <vector>
+
+#include <QByteArray>
 #include <QDataStream>
-#include <QDir>
-#include <QFileInfo>
 
+#include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
-#include "Core/ConfigManager.h"
-#include "DolphinQt2/Settings.h"
 
-static const int CACHE_VERSION = 4;  // Last changed in PR #6109
+static const int CACHE_VERSION = 6;  // Last changed when moving to GameMetadataCache
 static const int DATASTREAM_VERSION = QDataStream::Qt_5_0;
 
 GameFileCache::GameFileCache()
-    : m_path(QString::fromStdString(File::GetUserPath(D_CACHE_IDX) + "qt_gamefile.cache"))
+    : m_cache(File::GetUserPath(D_CACHE_IDX) + "qt_gamefile.cache", CACHE_VERSION)
 {
 }
 
 bool GameFileCache::IsCached(const QString& path)
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
-
-  return m_gamefiles.contains(path);
+  return m_cache.Contains(path.toStdString());
 }
 
 GameFile GameFileCache::GetFile(const QString& path)
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
+  GameFile file;
+
+  const std::optional<std::vector<u8>> entry = m_cache.Find(path.toStdString());
+  if (!entry)
+    return file;
 
-  return m_gamefiles[path];
+  // The copy outlives the stream, so it doesn't need to be copied again
+  const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(entry->data()),
+                                                  static_cast<int>(entry->size()));
+  QDataStream stream(data);
+  stream.setVersion(DATASTREAM_VERSION);
+  stream >> file;
+  return file;
 }
 
 void GameFileCache::Load()
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
-
-  QFile file(m_path);
-
-  if (!file.open(QIODevice::ReadOnly))
-    return;
-
-  QDataStream stream(&file);
-  stream.setVersion(DATASTREAM_VERSION);
-
-  qint32 cache_version;
-  stream >> cache_version;
-
-  // If the cache file is using an older version, ignore it and create it from scratch
-  if (cache_version != CACHE_VERSION)
-    return;
-
-  stream >> m_gamefiles;
+  m_cache.Load();
 }
 
 void GameFileCache::Save()
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
-
-  QFile file(m_path);
-
-  if (!file.open(QIODevice::WriteOnly))
-    return;
-
-  QDataStream stream(&file);
-  stream.setVersion(DATASTREAM_VERSION);
-
-  stream << static_cast<qint32>(CACHE_VERSION);
-  stream << m_gamefiles;
+  // Only appends the files that have been updated since the last save
+  m_cache.Flush();
 }
 
 void GameFileCache::Update(const GameFile& gamefile)
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
-
-  m_gamefiles[gamefile.GetFilePath()] = gamefile;
+  QByteArray data;
+  {
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(DATASTREAM_VERSION);
+    stream << gamefile;
+  }
+
+  m_cache.Store(gamefile.GetFilePath().toStdString(),
+                std::vector<u8>(data.constBegin(), data.constEnd()));
 }
 
 QList<QString> GameFileCache::GetCached()
 {
-  std::lock_guard<std::mutex> guard(m_mutex);
-
-  return m_gamefiles.keys();
+  QList<QString> paths;
+  for (const std::string& path : m_cache.GetPaths())
+    paths.append(QString::fromStdString(path));
+  return paths;
 }
@@ -4,12 +4,13 @@
 
 #pragma once
 
-#include <QFile>
-
-#include <mutex>
+#include <QList>
+#include <QString>
 
 #include "DolphinQt2/GameList/GameFile.h"
+#include "UICommon/GameMetadataCache.h"
 
+// Stores GameFiles in the shared game metadata cache. Thread-safe.
 class GameFileCache
 {
 public:
@@ -23,8 +24,5 @@ public:
   QList<QString> GetCached();
 
 private:
-  QString m_path;
-
-  QMap<QString, GameFile> m_gamefiles;
-  std::mutex m_mutex;
+  UICommon::GameMetadataCache m_cache;
 };
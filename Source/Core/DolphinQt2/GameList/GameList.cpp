@@ -22,6 +22,7 @@
 #include "Core/Core.h"
 #include "Core/HW/DVD/DVDInterface.h"
 #include "DiscIO/Blob.h"
+#include "DiscIO/DCZBlob.h"
 #include "DiscIO/Enums.h"
 
 #include "DolphinQt2/Config/PropertiesDialog.h"
@@ -171,11 +172,14 @@ void GameList::ShowContextMenu(const QPoint&)
     AddAction(menu, tr("Set as &default ISO"), this, &GameList::SetDefaultISO);
     const auto blob_type = game->GetBlobType();
 
-    if (blob_type == DiscIO::BlobType::GCZ)
+    if (blob_type == DiscIO::BlobType::GCZ || blob_type == DiscIO::BlobType::DCZ)
       AddAction(menu, tr("Decompress ISO..."), this, &GameList::CompressISO);
     else if (blob_type == DiscIO::BlobType::PLAIN)
       AddAction(menu, tr("Compress ISO..."), this, &GameList::CompressISO);
 
+    if (blob_type == DiscIO::BlobType::PLAIN)
+      AddAction(menu, tr("Convert to DCZ..."), this, &GameList::ConvertToDCZ);
+
     QAction* change_disc = AddAction(menu, tr("Change &Disc"), this, &GameList::ChangeDisc);
 
     connect(&Settings::Instance(), &Settings::EmulationStateChanged, change_disc,
@@ -273,7 +277,8 @@ void GameList::CompressISO()
   auto file = GetSelectedGame();
   const auto original_path = file->GetFilePath();
 
-  const bool compressed = (file->GetBlobType() == DiscIO::BlobType::GCZ);
+  const bool compressed = (file->GetBlobType() == DiscIO::BlobType::GCZ ||
+                           file->GetBlobType() == DiscIO::BlobType::DCZ);
 
   if (!compressed && file->GetPlatformID() == DiscIO::Platform::WII_DISC)
   {
@@ -308,7 +313,12 @@ void GameList::CompressISO()
 
   bool good;
 
-  if (compressed)
+  if (file->GetBlobType() == DiscIO::BlobType::DCZ)
+  {
+    good = DiscIO::ConvertDCZToPlain(original_path.toStdString(), dst_path.toStdString(),
+                                     &CompressCB, &progress_dialog);
+  }
+  else if (compressed)
   {
     good = DiscIO::DecompressBlobToFile(original_path.toStdString(), dst_path.toStdString(),
                                         &CompressCB, &progress_dialog);
@@ -332,6 +342,40 @@ void GameList::CompressISO()
   }
 }
 
+void GameList::ConvertToDCZ()
+{
+  auto file = GetSelectedGame();
+  const auto original_path = file->GetFilePath();
+
+  QString dst_path = QFileDialog::getSaveFileName(
+      this, tr("Select where you want to save the compressed image"),
+      QFileInfo(original_path).dir().absoluteFilePath(file->GetGameID()).append(
+          QStringLiteral(".dcz")),
+      tr("DCZ GC/Wii images (*.dcz)"));
+
+  if (dst_path.isEmpty())
+    return;
+
+  QProgressDialog progress_dialog(tr("Compressing..."), tr("Abort"), 0, 100, this);
+  progress_dialog.setWindowModality(Qt::WindowModal);
+
+  const bool good = DiscIO::ConvertToDCZ(
+      original_path.toStdString(), dst_path.toStdString(), DiscIO::GetDefaultDCZCodec(),
+      DiscIO::DCZ_DEFAULT_COMPRESSION_LEVEL, DiscIO::DCZ_DEFAULT_CHUNK_SIZE, &CompressCB,
+      &progress_dialog);
+
+  if (good)
+  {
+    QMessageBox(QMessageBox::Information, tr("Success!"), tr("Successfully compressed image."),
+                QMessageBox::Ok, this)
+        .exec();
+  }
+  else
+  {
+    QErrorMessage(this).showMessage(tr("Dolphin failed to complete the requested action."));
+  }
+}
+
 void GameList::InstallWAD()
 {
   QMessageBox result_dialog(this);
@@ -45,6 +45,7 @@ private:
   void UninstallWAD();
   void ExportWiiSave();
   void CompressISO();
+  void ConvertToDCZ();
   void ChangeDisc();
   void OnHeaderViewChanged();
 
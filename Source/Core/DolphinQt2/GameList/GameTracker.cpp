@@ -14,8 +14,9 @@
 
 static const QStringList game_filters{
     QStringLiteral("*.gcm"),  QStringLiteral("*.iso"), QStringLiteral("*.tgc"),
-    QStringLiteral("*.ciso"), QStringLiteral("*.gcz"), QStringLiteral("*.wbfs"),
-    QStringLiteral("*.wad"),  QStringLiteral("*.elf"), QStringLiteral("*.dol")};
+    QStringLiteral("*.ciso"), QStringLiteral("*.gcz"), QStringLiteral("*.dcz"),
+    QStringLiteral("*.wbfs"), QStringLiteral("*.wad"), QStringLiteral("*.elf"),
+    QStringLiteral("*.dol")};
 
 GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
 {
@@ -24,8 +25,6 @@ GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
   connect(this, &QFileSystemWatcher::fileChanged, this, &GameTracker::UpdateFile);
 
   cache.Load();
-
-  m_load_thread.Reset([this](const QString& path) { LoadGame(path); });
 }
 
 void GameTracker::AddDirectory(const QString& dir)
@@ -73,7 +72,7 @@ void GameTracker::UpdateDirectory(const QString& dir)
     {
       addPath(path);
       m_tracked_files[path] = QSet<QString>{dir};
-      m_load_thread.EmplaceItem(path);
+      m_load_pool.Schedule([this, path] { LoadGame(path); });
     }
   }
 
@@ -119,7 +118,7 @@ void GameTracker::UpdateFile(const QString& file)
     GameRemoved(file);
     addPath(file);
 
-    m_load_thread.EmplaceItem(file);
+    m_load_pool.Schedule([this, file] { LoadGame(file); });
   }
   else if (removePath(file))
   {
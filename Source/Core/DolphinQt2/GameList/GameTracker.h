@@ -10,11 +10,11 @@
 #include <QSharedPointer>
 #include <QString>
 
-#include "Common/WorkQueueThread.h"
+#include "Common/WorkerPool.h"
 #include "DolphinQt2/GameList/GameFile.h"
 #include "DolphinQt2/GameList/GameFileCache.h"
 
-// Watches directories and loads GameFiles in a separate thread.
+// Watches directories and loads GameFiles on a pool of worker threads.
 // To use this, just add directories using AddDirectory, and listen for the
 // GameLoaded and GameRemoved signals.
 class GameTracker final : public QFileSystemWatcher
@@ -39,8 +39,9 @@ private:
 
   // game path -> directories that track it
   QMap<QString, QSet<QString>> m_tracked_files;
-  Common::WorkQueueThread<QString> m_load_thread;
   GameFileCache cache;
+  // Declared after the cache, so that it finishes loading before the cache is destroyed
+  Common::WorkerPool m_load_pool{"game loader"};
 };
 
 Q_DECLARE_METATYPE(QSharedPointer<GameFile>)
@@ -459,7 +459,14 @@ void FifoPlayerDlg::OnBeginSearch(wxCommandEvent& event)
   int const frame_idx = m_framesList->GetSelection();
   FifoPlayer& player = FifoPlayer::GetInstance();
   const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-  const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+  const auto fifo_frame_ptr = player.GetFile()->GetFrame(frame_idx);
+  if (!fifo_frame_ptr)
+  {
+    m_numResultsText->SetLabel(_("Failed to read the frame from the FIFO log"));
+    return;
+  }
+
+  const FifoFrameInfo& fifo_frame = *fifo_frame_ptr;
 
   // TODO: Support searching through the last object... How do we know were the cmd data ends?
   // TODO: Support searching for bit patterns
@@ -620,10 +627,13 @@ void FifoPlayerDlg::OnObjectListSelectionChanged(wxCommandEvent& event)
 
   m_objectCmdList->Clear();
   m_objectCmdOffsets.clear();
-  if (frame_idx != -1 && object_idx != -1)
+  const auto fifo_frame_ptr = frame_idx != -1 && object_idx != -1 ?
+                                  player.GetFile()->GetFrame(frame_idx) :
+                                  nullptr;
+  if (fifo_frame_ptr)
   {
     const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-    const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+    const FifoFrameInfo& fifo_frame = *fifo_frame_ptr;
     const u8* objectdata_start = &fifo_frame.fifoData[frame.objectStarts[object_idx]];
     const u8* objectdata_end = &fifo_frame.fifoData[frame.objectEnds[object_idx]];
     u8* objectdata = (u8*)objectdata_start;
@@ -781,7 +791,14 @@ void FifoPlayerDlg::OnObjectCmdListSelectionChanged(wxCommandEvent& event)
 
   FifoPlayer& player = FifoPlayer::GetInstance();
   const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-  const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+  const auto fifo_frame_ptr = player.GetFile()->GetFrame(frame_idx);
+  if (!fifo_frame_ptr)
+  {
+    m_objectCmdInfo->SetLabel(wxEmptyString);
+    return;
+  }
+
+  const FifoFrameInfo& fifo_frame = *fifo_frame_ptr;
   const u8* cmddata =
       &fifo_frame.fifoData[frame.objectStarts[object_idx]] + m_objectCmdOffsets[event.GetInt()];
 
@@ -933,7 +950,7 @@ wxString FifoPlayerDlg::CreateRecordingFifoSizeLabel() const
   {
     size_t fifoBytes = 0;
     for (size_t i = 0; i < file->GetFrameCount(); ++i)
-      fifoBytes += file->GetFrame(i).fifoData.size();
+      fifoBytes += file->GetFifoData(i)->size();
 
     return wxString::Format(_("%zu FIFO bytes"), fifoBytes);
   }
@@ -950,8 +967,8 @@ wxString FifoPlayerDlg::CreateRecordingMemSizeLabel() const
     size_t memBytes = 0;
     for (size_t frameNum = 0; frameNum < file->GetFrameCount(); ++frameNum)
     {
-      const std::vector<MemoryUpdate>& memUpdates = file->GetFrame(frameNum).memoryUpdates;
-      for (const auto& memUpdate : memUpdates)
+      const auto frame = file->GetFrame(frameNum);
+      for (const auto& memUpdate : frame->memoryUpdates)
         memBytes += memUpdate.data.size();
     }
 
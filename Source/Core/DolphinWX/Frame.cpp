@@ -45,7 +45,6 @@
 #include "Common/Version.h"
 
 #include "Core/Config/GraphicsSettings.h"
-#include "Core/ARBruteForcer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/HW/DVD/DVDInterface.h"
@@ -169,9 +168,6 @@ bool CRenderFrame::IsValidSavestateDropped(const std::string& filepath)
 #ifdef _WIN32
 WXLRESULT CRenderFrame::MSWWindowProc(WXUINT nMsg, WXWPARAM wParam, WXLPARAM lParam)
 {
-  if (ARBruteForcer::ch_bruteforce)
-    ARBruteForcer::ARBruteForceDriver();
-
   switch (nMsg)
   {
   case WM_SYSCOMMAND:
@@ -286,6 +286,7 @@ private:
   void OnPlayRecording(wxCommandEvent& event);
   void OnStopRecording(wxCommandEvent& event);
   void OnRecordExport(wxCommandEvent& event);
+  void OnSeekRecording(wxCommandEvent& event);
   void OnRecordReadOnly(wxCommandEvent& event);
   void OnTASInput(wxCommandEvent& event);
   void OnTogglePauseMovie(wxCommandEvent& event);
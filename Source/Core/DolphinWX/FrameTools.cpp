@@ -2,9 +2,11 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cinttypes>
+#include <climits>
 #include <cstdarg>
 #include <cstdio>
 #include <future>
@@ -18,6 +20,7 @@
 #include <wx/filefn.h>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
+#include <wx/numdlg.h>
 #include <wx/panel.h>
 #include <wx/progdlg.h>
 #include <wx/statusbr.h>
@@ -163,6 +166,7 @@ void CFrame::BindMenuBarEvents()
   Bind(wxEVT_MENU, &CFrame::OnPlayRecording, this, IDM_PLAY_RECORD);
   Bind(wxEVT_MENU, &CFrame::OnStopRecording, this, IDM_STOP_RECORD);
   Bind(wxEVT_MENU, &CFrame::OnRecordExport, this, IDM_RECORD_EXPORT);
+  Bind(wxEVT_MENU, &CFrame::OnSeekRecording, this, IDM_SEEK_RECORDING);
   Bind(wxEVT_MENU, &CFrame::OnRecordReadOnly, this, IDM_RECORD_READ_ONLY);
   Bind(wxEVT_MENU, &CFrame::OnTASInput, this, IDM_TAS_INPUT);
   Bind(wxEVT_MENU, &CFrame::OnTogglePauseMovie, this, IDM_TOGGLE_PAUSE_MOVIE);
@@ -366,7 +370,7 @@ void CFrame::DoOpen(bool Boot)
   wxString path = wxFileSelector(
       _("Select the file to load"), wxEmptyString, wxEmptyString, wxEmptyString,
       _("All GC/Wii files (elf, dol, gcm, iso, tgc, wbfs, ciso, gcz, wad, dff)") +
-          wxString::Format("|*.elf;*.dol;*.gcm;*.iso;*.tgc;*.wbfs;*.ciso;*.gcz;*.wad;*.dff|%s",
+          wxString::Format("|*.elf;*.dol;*.gcm;*.iso;*.tgc;*.wbfs;*.ciso;*.gcz;*.dcz;*.wad;*.dff|%s",
                            wxGetTranslation(wxALL_FILES)),
       wxFD_OPEN | wxFD_FILE_MUST_EXIST, this);
 
@@ -556,6 +560,19 @@ void CFrame::OnRecordExport(wxCommandEvent& WXUNUSED(event))
   DoRecordingSave();
 }
 
+void CFrame::OnSeekRecording(wxCommandEvent& WXUNUSED(event))
+{
+  const long frame = wxGetNumberFromUser(
+      _("Movies that were recorded with keyframes seek by loading the closest keyframe."),
+      _("Frame:"), _("Seek to Frame"), static_cast<long>(Movie::GetCurrentFrame()), 0,
+      static_cast<long>(std::min<u64>(Movie::GetTotalFrames(), LONG_MAX)), this);
+  if (frame < 0)
+    return;
+
+  if (!Movie::SeekToFrame(static_cast<u64>(frame)))
+    WxUtils::ShowErrorDialog(_("Seeking to that frame requires a movie keyframe before it."));
+}
+
 void CFrame::OnPlay(wxCommandEvent& event)
 {
   if (Core::IsRunning())
@@ -1105,6 +1122,7 @@ void CFrame::DoRecordingSave()
     return;
 
   Movie::SaveRecording(WxStrToStr(path));
+  Movie::SaveKeyframes(WxStrToStr(path));
 
   if (!paused)
     DoPause();
@@ -1787,7 +1805,11 @@ void CFrame::OnBruteForce(wxCommandEvent& event)
   ARBruteForcer::ch_bruteforce = true;
   NOTICE_LOG(VR, "Starting");
   if (running)
+  {
+    // The video backend only begins the search when it starts
+    ARBruteForcer::BeginSearch();
     Core::PauseAndLock(false, was_unpaused);
+  }
   else
     BootGame("");
   NOTICE_LOG(VR, "Bruteforcer Started");
@@ -1951,6 +1973,7 @@ void CFrame::UpdateGUI()
   GetMenuBar()->FindItem(IDM_PLAY_RECORD)->Enable(!Initialized);
   GetMenuBar()->FindItem(IDM_STOP_RECORD)->Enable(Movie::IsMovieActive());
   GetMenuBar()->FindItem(IDM_RECORD_EXPORT)->Enable(Movie::IsMovieActive());
+  GetMenuBar()->FindItem(IDM_SEEK_RECORDING)->Enable(Movie::IsPlayingInput());
   GetMenuBar()->FindItem(IDM_FRAMESTEP)->Enable(Running || Paused);
   GetMenuBar()->FindItem(IDM_SCREENSHOT)->Enable(Running || Paused);
   GetMenuBar()->FindItem(IDM_TOGGLE_FULLSCREEN)->Enable(Running || Paused);
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
@@ -37,6 +38,7 @@
 #endif
 
 #include "Common/CDUtils.h"
+#include "Common/ChunkFile.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileSearch.h"
@@ -45,6 +47,7 @@
 #include "Common/StringUtil.h"
 #include "Common/SysConf.h"
 #include "Common/Thread.h"
+#include "Common/WorkerPool.h"
 #include "Core/Boot/Boot.h"
 #include "Core/Config/NetplaySettings.h"
 #include "Core/ConfigManager.h"
@@ -54,6 +57,7 @@
 #include "Core/Movie.h"
 #include "Core/TitleDatabase.h"
 #include "DiscIO/Blob.h"
+#include "DiscIO/DCZBlob.h"
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Volume.h"
@@ -65,6 +69,7 @@
 #include "DolphinWX/Main.h"
 #include "DolphinWX/NetPlay/NetPlayLauncher.h"
 #include "DolphinWX/WxUtils.h"
+#include "UICommon/GameMetadataCache.h"
 
 struct CompressionProgress final
 {
@@ -82,7 +87,7 @@ public:
   wxProgressDialog* dialog;
 };
 
-static constexpr u32 CACHE_REVISION = 6;  // Last changed in PR 6109
+static constexpr u32 CACHE_REVISION = 8;  // Last changed when moving to GameMetadataCache
 
 static bool sorted = false;
 
@@ -280,6 +285,7 @@ GameListCtrl::GameListCtrl(bool disable_scanning, wxWindow* parent, const wxWind
   Bind(wxEVT_MENU, &GameListCtrl::OnExportSave, this, IDM_EXPORT_SAVE);
   Bind(wxEVT_MENU, &GameListCtrl::OnSetDefaultISO, this, IDM_SET_DEFAULT_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnCompressISO, this, IDM_COMPRESS_ISO);
+  Bind(wxEVT_MENU, &GameListCtrl::OnConvertToDCZ, this, IDM_CONVERT_TO_DCZ);
   Bind(wxEVT_MENU, &GameListCtrl::OnMultiCompressISO, this, IDM_MULTI_COMPRESS_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnMultiDecompressISO, this, IDM_MULTI_DECOMPRESS_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnDeleteISO, this, IDM_DELETE_ISO);
@@ -291,12 +297,15 @@ GameListCtrl::GameListCtrl(bool disable_scanning, wxWindow* parent, const wxWind
 
   wxTheApp->Bind(DOLPHIN_EVT_LOCAL_INI_CHANGED, &GameListCtrl::OnLocalIniModified, this);
 
+  m_metadata_cache = std::make_unique<UICommon::GameMetadataCache>(
+      File::GetUserPath(D_CACHE_IDX) + "wx_gamelist_vr.cache", CACHE_REVISION);
+
   if (!disable_scanning)
   {
     m_scan_thread = std::thread([&] {
       Common::SetCurrentThreadName("gamelist scanner");
 
-      if (SyncCacheFile(false))
+      if (LoadCacheFile())
         QueueEvent(new wxCommandEvent(DOLPHIN_EVT_REFRESH_GAMELIST));
 
       // Always do an initial scan to catch new files and perform the more expensive per-file
@@ -707,74 +716,51 @@ void GameListCtrl::SetColors()
   }
 }
 
-void GameListCtrl::DoState(PointerWrap* p, u32 size)
+static std::vector<u8> SerializeItem(GameListItem* item)
 {
-  struct
-  {
-    u32 Revision;
-    u32 ExpectedSize;
-  } header = {CACHE_REVISION, size};
-  p->Do(header);
-  if (p->GetMode() == PointerWrap::MODE_READ)
-  {
-    if (header.Revision != CACHE_REVISION || header.ExpectedSize != size)
-    {
-      p->SetMode(PointerWrap::MODE_MEASURE);
-      return;
-    }
-  }
-  p->DoEachElement(m_cached_files, [](PointerWrap& state, std::shared_ptr<GameListItem>& elem) {
-    if (state.GetMode() == PointerWrap::MODE_READ)
-    {
-      elem = std::make_shared<GameListItem>();
-    }
-    elem->DoState(state);
-  });
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  item->DoState(p);
+
+  std::vector<u8> buffer(reinterpret_cast<size_t>(ptr));
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  item->DoState(p);
+  return buffer;
 }
 
-bool GameListCtrl::SyncCacheFile(bool write)
+bool GameListCtrl::LoadCacheFile()
 {
-  std::string filename(File::GetUserPath(D_CACHE_IDX) + "wx_gamelist_vr.cache");
-  const char* open_mode = write ? "wb" : "rb";
-  File::IOFile f(filename, open_mode);
-  if (!f)
+  if (!m_metadata_cache->Load())
     return false;
-  bool success = false;
-  if (write)
-  {
-    // Measure the size of the buffer.
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(&p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-
-    // Then actually do the write.
-    std::vector<u8> buffer(buffer_size);
-    ptr = &buffer[0];
-    p.SetMode(PointerWrap::MODE_WRITE);
-    DoState(&p, buffer_size);
-    if (f.WriteBytes(buffer.data(), buffer.size()))
-      success = true;
-  }
-  else
-  {
-    std::vector<u8> buffer(f.GetSize());
-    if (buffer.size() && f.ReadBytes(buffer.data(), buffer.size()))
+
+  // Building the banners takes most of the time, so the items are read in parallel
+  const std::vector<std::string> paths = m_metadata_cache->GetPaths();
+  std::vector<std::shared_ptr<GameListItem>> files(paths.size());
+  Common::WorkerPool pool("gamelist scanner");
+  pool.ParallelFor(paths.size(), [&](size_t i) {
+    std::optional<std::vector<u8>> entry = m_metadata_cache->Find(paths[i]);
+    if (!entry)
+      return;
+
+    u8* ptr = entry->data();
+    PointerWrap p(&ptr, PointerWrap::MODE_READ);
+    auto file = std::make_shared<GameListItem>();
+    file->DoState(p);
+    if (p.GetMode() == PointerWrap::MODE_READ && ptr == entry->data() + entry->size() &&
+        file->GetFileName() == paths[i])
     {
-      u8* ptr = buffer.data();
-      PointerWrap p(&ptr, PointerWrap::MODE_READ);
-      DoState(&p, buffer.size());
-      if (p.GetMode() == PointerWrap::MODE_READ)
-        success = true;
+      files[i] = std::move(file);
     }
-  }
-  if (!success)
+  });
+
+  std::unique_lock<std::mutex> lk(m_cache_mutex);
+  for (auto& file : files)
   {
-    // If some file operation failed, try to delete the probably-corrupted cache
-    f.Close();
-    File::Delete(filename);
+    if (file)
+      m_cached_files.push_back(std::move(file));
   }
-  return success;
+  return !m_cached_files.empty();
 }
 
 void GameListCtrl::RescanList()
@@ -789,7 +775,7 @@ void GameListCtrl::RescanList()
   post_status(_("Scanning..."));
 
   const std::vector<std::string> search_extensions = {".gcm",  ".tgc", ".iso", ".ciso", ".gcz",
-                                                      ".wbfs", ".wad", ".dol", ".elf"};
+                                                      ".dcz",  ".wbfs", ".wad", ".dol", ".elf"};
   // TODO This could process paths iteratively as they are found
   auto search_results = Common::DoFileSearch(SConfig::GetInstance().m_ISOFolder, search_extensions,
                                              SConfig::GetInstance().m_RecursiveISOFolder);
@@ -813,19 +799,47 @@ void GameListCtrl::RescanList()
   std::set_difference(search_results.cbegin(), search_results.cend(), cached_paths.cbegin(),
                       cached_paths.cend(), std::back_inserter(new_paths));
 
+  // Files that have been modified since they were scanned are scanned again
+  std::vector<std::string> kept_paths;
+  std::set_intersection(cached_paths.cbegin(), cached_paths.cend(), search_results.cbegin(),
+                        search_results.cend(), std::back_inserter(kept_paths));
+  Common::WorkerPool pool("gamelist scanner");
+  std::vector<u8> up_to_date(kept_paths.size());
+  pool.ParallelFor(kept_paths.size(),
+                   [&](size_t i) { up_to_date[i] = m_metadata_cache->IsUpToDate(kept_paths[i]); });
+  std::vector<std::string> changed_paths;
+  for (size_t i = 0; i < kept_paths.size(); ++i)
+  {
+    if (!up_to_date[i])
+      changed_paths.push_back(std::move(kept_paths[i]));
+  }
+  new_paths.insert(new_paths.end(), changed_paths.begin(), changed_paths.end());
+
   // Reload the TitleDatabase
   {
     std::unique_lock<std::mutex> lk(m_title_database_mutex);
     m_title_database = {};
   }
 
-  // For now, only scan new_paths. This could cause false negatives (file actively being written),
-  // but otherwise should be fine.
+  // Items are created (which opens each volume) on a worker pool, outside of the lock
+  std::vector<std::shared_ptr<GameListItem>> new_files(new_paths.size());
+  pool.ParallelFor(new_paths.size(), [&](size_t i) {
+    auto file = std::make_shared<GameListItem>(new_paths[i]);
+    if (file->IsValid())
+    {
+      m_metadata_cache->Store(new_paths[i], SerializeItem(file.get()));
+      new_files[i] = std::move(file);
+    }
+    else
+    {
+      m_metadata_cache->Remove(new_paths[i]);
+    }
+  });
+
   bool cache_changed = false;
   {
     std::unique_lock<std::mutex> lk(m_cache_mutex);
-    for (const auto& path : removed_paths)
-    {
+    auto remove_file = [&](const std::string& path) {
       auto it = std::find_if(m_cached_files.cbegin(), m_cached_files.cend(),
                              [&path](const std::shared_ptr<GameListItem>& file) {
                                return file->GetFileName() == path;
@@ -835,11 +849,27 @@ void GameListCtrl::RescanList()
         cache_changed = true;
         m_cached_files.erase(it);
       }
+    };
+    for (const auto& path : removed_paths)
+      remove_file(path);
+    // Their new items have already been stored in the metadata cache
+    for (const auto& path : changed_paths)
+      remove_file(path);
+  }
+  // Also drops the entries of files that weren't in the list anymore because it was purged
+  for (const auto& path : m_metadata_cache->GetPaths())
+  {
+    if (!std::binary_search(search_results.cbegin(), search_results.cend(), path))
+    {
+      cache_changed = true;
+      m_metadata_cache->Remove(path);
     }
-    for (const auto& path : new_paths)
+  }
+  {
+    std::unique_lock<std::mutex> lk(m_cache_mutex);
+    for (auto& file : new_files)
     {
-      auto file = std::make_shared<GameListItem>(path);
-      if (file->IsValid())
+      if (file)
       {
         cache_changed = true;
         m_cached_files.push_back(std::move(file));
@@ -855,17 +885,21 @@ void GameListCtrl::RescanList()
   // If any cached files need updates, apply the updates to a copy and delete the original - this
   // makes the UI thread's use of cached files safe. Note however, it is assumed that RefreshList
   // will not iterate m_cached_files while the scan thread is modifying the list itself.
-  bool refresh_needed = false;
+  std::atomic<bool> refresh_needed{false};
   {
     std::unique_lock<std::mutex> lk(m_cache_mutex);
+    std::vector<std::shared_ptr<GameListItem>*> files;
     for (auto& file : m_cached_files)
-    {
+      files.push_back(&file);
+
+    pool.ParallelFor(files.size(), [&](size_t i) {
+      std::shared_ptr<GameListItem>& file = *files[i];
       bool emu_state_changed = file->EmuStateChanged();
       bool banner_changed = file->BannerChanged();
       bool custom_title_changed = file->CustomNameChanged(m_title_database);
       if (emu_state_changed || banner_changed || custom_title_changed)
       {
-        cache_changed = refresh_needed = true;
+        refresh_needed = true;
         auto copy = std::make_shared<GameListItem>(*file);
         if (emu_state_changed)
           copy->EmuStateCommit();
@@ -873,18 +907,22 @@ void GameListCtrl::RescanList()
           copy->BannerCommit();
         if (custom_title_changed)
           copy->CustomNameCommit();
+        m_metadata_cache->Store(copy->GetFileName(), SerializeItem(copy.get()));
         file = std::move(copy);
       }
-    }
+    });
   }
   // Only post UI event to update the displayed list if something actually changed
   if (refresh_needed)
+  {
+    cache_changed = true;
     QueueEvent(new wxCommandEvent(DOLPHIN_EVT_REFRESH_GAMELIST));
+  }
 
   post_status("");
 
   if (cache_changed)
-    SyncCacheFile(true);
+    m_metadata_cache->Flush();
 }
 
 void GameListCtrl::OnRefreshGameList(wxCommandEvent& WXUNUSED(event))
@@ -1195,10 +1233,13 @@ void GameListCtrl::OnRightClick(wxMouseEvent& event)
 
       if (platform == DiscIO::Platform::GAMECUBE_DISC || platform == DiscIO::Platform::WII_DISC)
       {
-        if (selected_iso->GetBlobType() == DiscIO::BlobType::GCZ)
+        const DiscIO::BlobType blob_type = selected_iso->GetBlobType();
+        if (blob_type == DiscIO::BlobType::GCZ || blob_type == DiscIO::BlobType::DCZ)
           popupMenu.Append(IDM_COMPRESS_ISO, _("Decompress ISO..."));
-        else if (selected_iso->GetBlobType() == DiscIO::BlobType::PLAIN)
+        else if (blob_type == DiscIO::BlobType::PLAIN)
           popupMenu.Append(IDM_COMPRESS_ISO, _("Compress ISO..."));
+        if (blob_type == DiscIO::BlobType::PLAIN)
+          popupMenu.Append(IDM_CONVERT_TO_DCZ, _("Convert to DCZ..."));
 
         wxMenuItem* changeDiscItem = popupMenu.Append(IDM_LIST_CHANGE_DISC, _("Change &Disc"));
         changeDiscItem->Enable(Core::IsRunning());
@@ -1521,7 +1562,8 @@ void GameListCtrl::OnCompressISO(wxCommandEvent& WXUNUSED(event))
   if (!iso)
     return;
 
-  bool is_compressed = iso->GetBlobType() == DiscIO::BlobType::GCZ;
+  const bool is_dcz = iso->GetBlobType() == DiscIO::BlobType::DCZ;
+  bool is_compressed = iso->GetBlobType() == DiscIO::BlobType::GCZ || is_dcz;
   wxString path;
 
   std::string FileName, FilePath, FileExtension;
@@ -1568,7 +1610,10 @@ void GameListCtrl::OnCompressISO(wxCommandEvent& WXUNUSED(event))
                             wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME |
                                 wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME | wxPD_SMOOTH);
 
-    if (is_compressed)
+    if (is_dcz)
+      all_good =
+          DiscIO::ConvertDCZToPlain(iso->GetFileName(), WxStrToStr(path), &CompressCB, &dialog);
+    else if (is_compressed)
       all_good =
           DiscIO::DecompressBlobToFile(iso->GetFileName(), WxStrToStr(path), &CompressCB, &dialog);
     else
@@ -1583,6 +1628,50 @@ void GameListCtrl::OnCompressISO(wxCommandEvent& WXUNUSED(event))
   m_scan_trigger.Set();
 }
 
+void GameListCtrl::OnConvertToDCZ(wxCommandEvent& WXUNUSED(event))
+{
+  const GameListItem* iso = GetSelectedISO();
+  if (!iso)
+    return;
+
+  std::string FileName, FilePath, FileExtension;
+  SplitPath(iso->GetFileName(), &FilePath, &FileName, &FileExtension);
+
+  wxString path;
+  do
+  {
+    path = wxFileSelector(_("Save DCZ image"), StrToWxStr(FilePath),
+                          StrToWxStr(FileName) + ".dcz", wxEmptyString,
+                          _("All DCZ GC/Wii ISO files (dcz)") +
+                              wxString::Format("|*.dcz|%s", wxGetTranslation(wxALL_FILES)),
+                          wxFD_SAVE, this);
+    if (!path)
+      return;
+  } while (
+      wxFileExists(path) &&
+      wxMessageBox(wxString::Format(_("The file %s already exists.\nDo you wish to replace it?"),
+                                    path.c_str()),
+                   _("Confirm File Overwrite"), wxYES_NO) == wxNO);
+
+  bool all_good = false;
+
+  {
+    wxProgressDialog dialog(_("Compressing ISO"), _("Working..."), 1000, this,
+                            wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME |
+                                wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME | wxPD_SMOOTH);
+
+    all_good = DiscIO::ConvertToDCZ(iso->GetFileName(), WxStrToStr(path),
+                                    DiscIO::GetDefaultDCZCodec(),
+                                    DiscIO::DCZ_DEFAULT_COMPRESSION_LEVEL,
+                                    DiscIO::DCZ_DEFAULT_CHUNK_SIZE, &CompressCB, &dialog);
+  }
+
+  if (!all_good)
+    WxUtils::ShowErrorDialog(_("Dolphin was unable to complete the requested action."));
+
+  m_scan_trigger.Set();
+}
+
 void GameListCtrl::OnChangeDisc(wxCommandEvent& WXUNUSED(event))
 {
   const GameListItem* iso = GetSelectedISO();
@@ -13,11 +13,15 @@
 #include <wx/listctrl.h>
 #include <wx/tipwin.h>
 
-#include "Common/ChunkFile.h"
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "DolphinWX/ISOFile.h"
 
+namespace UICommon
+{
+class GameMetadataCache;
+}
+
 class wxEmuStateTip : public wxTipWindow
 {
 public:
@@ -81,8 +85,7 @@ private:
   void SetColors();
   void RefreshList();
   void RescanList();
-  void DoState(PointerWrap* p, u32 size = 0);
-  bool SyncCacheFile(bool write);
+  bool LoadCacheFile();
   std::vector<const GameListItem*> GetAllSelectedISOs() const;
 
   // events
@@ -104,6 +107,7 @@ private:
   void OnSetDefaultISO(wxCommandEvent& event);
   void OnDeleteISO(wxCommandEvent& event);
   void OnCompressISO(wxCommandEvent& event);
+  void OnConvertToDCZ(wxCommandEvent& event);
   void OnMultiCompressISO(wxCommandEvent& event);
   void OnMultiDecompressISO(wxCommandEvent& event);
   void OnChangeDisc(wxCommandEvent& event);
@@ -127,6 +131,7 @@ private:
 
   // Actual backing GameListItems are maintained in a background thread and cached to file
   std::list<std::shared_ptr<GameListItem>> m_cached_files;
+  std::unique_ptr<UICommon::GameMetadataCache> m_metadata_cache;
   // Locks the list, not the contents
   std::mutex m_cache_mutex;
   Core::TitleDatabase m_title_database;
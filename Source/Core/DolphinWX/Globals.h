@@ -82,6 +82,7 @@ enum
   IDM_PLAY_RECORD,
   IDM_STOP_RECORD,
   IDM_RECORD_EXPORT,
+  IDM_SEEK_RECORDING,
   IDM_RECORD_READ_ONLY,
   IDM_TAS_INPUT,
   IDM_TOGGLE_PAUSE_MOVIE,
@@ -314,6 +315,7 @@ enum
   IDM_SET_DEFAULT_ISO,
   IDM_DELETE_ISO,
   IDM_COMPRESS_ISO,
+  IDM_CONVERT_TO_DCZ,
   IDM_START_NETPLAY,
   IDM_MULTI_COMPRESS_ISO,
   IDM_MULTI_DECOMPRESS_ISO,
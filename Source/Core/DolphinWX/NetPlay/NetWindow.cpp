@@ -259,11 +259,18 @@ wxSizer* NetPlayDialog::CreateBottomGUI(wxWindow* parent)
 
     m_copy_wii_save = new wxCheckBox(parent, wxID_ANY, _("Load Wii Save"));
 
+    m_rollback = new wxCheckBox(parent, wxID_ANY, _("Rollback"));
+    m_rollback->SetToolTip(_("Predicts the inputs of the other players instead of waiting for "
+                             "them, and rolls back when the prediction was wrong. This allows a "
+                             "smaller buffer, but needs a fast enough savestate round trip. "
+                             "GameCube controllers only."));
+
     bottom_szr->Add(m_start_btn, 0, wxALIGN_CENTER_VERTICAL);
     bottom_szr->Add(buffer_lbl, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, space5);
     bottom_szr->Add(padbuf_spin, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, space5);
     bottom_szr->Add(m_memcard_write, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, space5);
     bottom_szr->Add(m_copy_wii_save, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, space5);
+    bottom_szr->Add(m_rollback, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, space5);
     bottom_szr->AddSpacer(space5);
   }
 
@@ -328,6 +335,7 @@ void NetPlayDialog::GetNetSettings(NetSettings& settings)
   settings.m_OCFactor = instance.m_OCFactor;
   settings.m_EXIDevice[0] = instance.m_EXIDevice[0];
   settings.m_EXIDevice[1] = instance.m_EXIDevice[1];
+  settings.m_Rollback = m_rollback->GetValue();
 }
 
 std::string NetPlayDialog::FindGame(const std::string& target_game)
@@ -410,6 +418,7 @@ void NetPlayDialog::OnMsgStartGame()
     m_start_btn->Disable();
     m_memcard_write->Disable();
     m_copy_wii_save->Disable();
+    m_rollback->Disable();
     m_game_btn->Disable();
     m_player_config_btn->Disable();
   }
@@ -426,6 +435,7 @@ void NetPlayDialog::OnMsgStopGame()
     m_start_btn->Enable();
     m_memcard_write->Enable();
     m_copy_wii_save->Enable();
+    m_rollback->Enable();
     m_game_btn->Enable();
     m_player_config_btn->Enable();
   }
@@ -256,8 +256,10 @@ static wxString show_netplay_ping_desc =
     wxTRANSLATE("Show the players' maximum Ping while playing on "
                 "NetPlay.\n\nIf unsure, leave this unchecked.");
 static wxString log_render_time_to_file_desc =
-    wxTRANSLATE("Log the render time of every frame to User/Logs/render_time.txt. Use this "
-                "feature when you want to measure the performance of Dolphin.\n\nIf "
+    wxTRANSLATE("Log the render time of every frame to User/Logs/render_time.txt, and write "
+                "frame time histograms to User/Logs/frame_times.csv and frame_times.json when "
+                "emulation stops. Use this feature when you want to measure the performance of "
+                "Dolphin.\n\nIf "
                 "unsure, leave this unchecked.");
 static wxString show_stats_desc =
     wxTRANSLATE("Show various rendering statistics.\n\nIf unsure, leave this unchecked.");
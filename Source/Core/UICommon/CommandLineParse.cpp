@@ -11,9 +11,12 @@
 
 #include "Common/Config/Config.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 #include "Common/Version.h"
 #include "Core/Config/MainSettings.h"
 #include "UICommon/CommandLineParse.h"
+#include "VideoCommon/VR.h"
+#include "VideoCommon/VRSimulated.h"
 
 namespace CommandLineParse
 {
@@ -110,10 +113,35 @@ std::unique_ptr<optparse::OptionParser> CreateParser(ParserOptions options)
   // -oculus option to use Oculus instead of SteamVR, and to force virtual reality on
   parser->add_option("--oculus").action("store_true").help("Use Oculus instead of SteamVR, and force VR on");
   parser->add_option("--onehmd").action("store_true").help("Only use a single HMD if multiple are present");
+  // -simulated-hmd option to test and benchmark VR without a headset
+  parser->add_option("--simulated-hmd")
+      .action("store_true")
+      .help("Use a simulated HMD with deterministic head poses instead of a real one, and force VR "
+            "on");
+  parser->add_option("--simulated-hmd-rate")
+      .action("store")
+      .type("int")
+      .metavar("<hz>")
+      .help("Refresh rate of the simulated HMD (default: 90)");
+  parser->add_option("--simulated-hmd-fov")
+      .action("store")
+      .type("float")
+      .metavar("<degrees>")
+      .help("Field of view of each eye of the simulated HMD (default: 100)");
+  parser->add_option("--simulated-hmd-poses")
+      .action("store")
+      .metavar("<file>")
+      .help("Head poses of the simulated HMD. Each line has a time in seconds, yaw, pitch and "
+            "roll in degrees and x, y and z in metres");
   // -force-d3d11 and -force-ogl options like in Oculus Rift unity demos
   // TODO: modify this parser to allow this. Note, wxwidgets had to be modified to allow this
   parser->add_option("--force-d3d11").action("store_true").help("Force use of Direct3D 11 backend");
   parser->add_option("--force-opengl").action("store_true").help("Force use of OpenGL backend");
+  parser->add_option("--trace")
+      .action("store")
+      .metavar("<file>")
+      .help("Record a timeline of the emulation threads from boot to shutdown, and write it to a "
+            "Chrome trace file");
   parser->add_option("--bruteforce").action("store").help("Return value for brute forcing Action Replay culling codes (needs save state 1 and map file)");
 
   return parser;
@@ -130,6 +158,23 @@ optparse::Values& ParseArguments(optparse::OptionParser* parser, int argc, char*
         config_args, static_cast<const char*>(options.get("video_backend")),
         static_cast<const char*>(options.get("audio_emulation"))));
   }
+
+  // The frontends call VR_Init when a game starts
+  if (options.is_set("simulated_hmd"))
+  {
+    VRSimulated::Settings settings;
+    if (options.is_set("simulated_hmd_rate"))
+      settings.refresh_rate = options.get("simulated_hmd_rate");
+    if (options.is_set("simulated_hmd_fov"))
+      settings.fov = options.get("simulated_hmd_fov");
+    if (options.is_set("simulated_hmd_poses"))
+      settings.pose_script = static_cast<const char*>(options.get("simulated_hmd_poses"));
+    VRSimulated::SetSettings(settings);
+    g_simulate_hmd = true;
+  }
+
+  if (options.is_set("trace"))
+    Common::Trace::SetSessionFile(static_cast<const char*>(options.get("trace")));
   return options;
 }
 }
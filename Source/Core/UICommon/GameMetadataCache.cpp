@@ -0,0 +1,371 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "UICommon/GameMetadataCache.h"
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <xxhash.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace UICommon
+{
+namespace
+{
+constexpr u32 CACHE_MAGIC = 0x434d4744;  // "DGMC"
+constexpr u32 CACHE_VERSION = 1;
+
+// Marks a record that removes an entry
+constexpr u32 REMOVED_RECORD = UINT32_MAX;
+
+// Rewriting a small cache file isn't worth it
+constexpr u64 MIN_DEAD_BYTES_FOR_REWRITE = 1024 * 1024;
+
+#pragma pack(push, 1)
+
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 revision;
+  u32 reserved;
+};
+
+// Followed by the path and the data
+struct RecordHeader
+{
+  u32 path_size;
+  u32 data_size;
+  u64 file_size;
+  s64 modification_time;
+  // Records that were being written when Dolphin stopped fail this check and end the file
+  u64 checksum;
+};
+
+#pragma pack(pop)
+
+u64 ComputeChecksum(const RecordHeader& record, const u8* path, const u8* data)
+{
+  u64 seed = record.file_size ^ static_cast<u64>(record.modification_time) ^ record.data_size;
+  if (record.data_size != REMOVED_RECORD)
+    seed = XXH64(data, record.data_size, seed);
+  return XXH64(path, record.path_size, seed);
+}
+
+void AppendRecord(const std::string& path, const GameMetadataCache::Entry* entry,
+                  std::vector<u8>* buffer)
+{
+  RecordHeader record = {};
+  record.path_size = static_cast<u32>(path.size());
+  record.data_size = entry ? entry->size : REMOVED_RECORD;
+  if (entry)
+  {
+    record.file_size = entry->file_size;
+    record.modification_time = entry->modification_time;
+  }
+  record.checksum = ComputeChecksum(record, reinterpret_cast<const u8*>(path.data()),
+                                    entry ? entry->data : nullptr);
+
+  const u8* record_bytes = reinterpret_cast<const u8*>(&record);
+  buffer->insert(buffer->end(), record_bytes, record_bytes + sizeof(record));
+  buffer->insert(buffer->end(), path.begin(), path.end());
+  if (entry)
+    buffer->insert(buffer->end(), entry->data, entry->data + entry->size);
+}
+
+u64 GetRecordSize(const std::string& path, const GameMetadataCache::Entry& entry)
+{
+  return sizeof(RecordHeader) + path.size() + entry.size;
+}
+}  // Anonymous namespace
+
+GameMetadataCache::GameMetadataCache(const std::string& path, u32 revision)
+    : m_path(path), m_revision(revision)
+{
+}
+
+GameMetadataCache::~GameMetadataCache() = default;
+
+bool GameMetadataCache::Load()
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+  return LoadLocked();
+}
+
+bool GameMetadataCache::LoadLocked()
+{
+  m_entries.clear();
+  m_dirty.clear();
+  m_mapping.Unmap();
+  m_append_offset = 0;
+  m_dead_bytes = 0;
+  m_live_bytes = 0;
+
+  File::IOFile file(m_path, "rb");
+  if (!file)
+    return false;
+
+  const u64 size = file.GetSize();
+  if (size < sizeof(FileHeader) || !m_mapping.Map(file, 0, size))
+    return false;
+
+  const u8* const base = m_mapping.GetData();
+  FileHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+      header.revision != m_revision)
+  {
+    m_mapping.Unmap();
+    return false;
+  }
+
+  u64 offset = sizeof(FileHeader);
+  while (size - offset >= sizeof(RecordHeader))
+  {
+    RecordHeader record;
+    std::memcpy(&record, base + offset, sizeof(record));
+
+    const bool removed = record.data_size == REMOVED_RECORD;
+    const u64 record_size =
+        sizeof(RecordHeader) + record.path_size + (removed ? 0 : record.data_size);
+    if (record_size > size - offset)
+      break;
+
+    const u8* path_bytes = base + offset + sizeof(RecordHeader);
+    const u8* data = path_bytes + record.path_size;
+    if (ComputeChecksum(record, path_bytes, data) != record.checksum)
+    {
+      WARN_LOG(COMMON, "Ignoring the end of the damaged game list cache %s", m_path.c_str());
+      break;
+    }
+
+    std::string path(reinterpret_cast<const char*>(path_bytes), record.path_size);
+    auto it = m_entries.find(path);
+    if (it != m_entries.end())
+    {
+      const u64 replaced_size = GetRecordSize(path, it->second.entry);
+      m_live_bytes -= replaced_size;
+      m_dead_bytes += replaced_size;
+      m_entries.erase(it);
+    }
+
+    if (removed)
+    {
+      m_dead_bytes += record_size;
+    }
+    else
+    {
+      StoredEntry& stored = m_entries[std::move(path)];
+      stored.entry = {record.file_size, record.modification_time, data, record.data_size};
+      m_live_bytes += record_size;
+    }
+
+    offset += record_size;
+  }
+
+  m_append_offset = offset;
+  return true;
+}
+
+bool GameMetadataCache::Flush()
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  if (m_append_offset != 0 && m_dirty.empty())
+    return true;
+
+  if (m_append_offset == 0 ||
+      (m_dead_bytes > m_live_bytes && m_dead_bytes >= MIN_DEAD_BYTES_FOR_REWRITE))
+  {
+    return RewriteLocked();
+  }
+
+  return AppendLocked();
+}
+
+bool GameMetadataCache::AppendLocked()
+{
+  std::vector<u8> buffer;
+  for (const std::string& path : m_dirty)
+  {
+    auto it = m_entries.find(path);
+    const Entry* entry = it != m_entries.end() ? &it->second.entry : nullptr;
+    const size_t old_size = buffer.size();
+    AppendRecord(path, entry, &buffer);
+
+    if (entry)
+      m_live_bytes += buffer.size() - old_size;
+    else
+      m_dead_bytes += buffer.size() - old_size;
+  }
+
+  // Anything after the last valid record is overwritten
+  File::IOFile file(m_path, "r+b");
+  if (!file || !file.Seek(m_append_offset, SEEK_SET) ||
+      !file.WriteBytes(buffer.data(), buffer.size()))
+  {
+    ERROR_LOG(COMMON, "Failed to update the game list cache %s", m_path.c_str());
+    return RewriteLocked();
+  }
+
+  m_append_offset += buffer.size();
+  m_dirty.clear();
+  return true;
+}
+
+bool GameMetadataCache::RewriteLocked()
+{
+  const std::string temp_path = m_path + ".tmp";
+  {
+    File::IOFile file(temp_path, "wb");
+    if (!file)
+    {
+      ERROR_LOG(COMMON, "Failed to write the game list cache %s", temp_path.c_str());
+      return false;
+    }
+
+    FileHeader header = {};
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.revision = m_revision;
+    file.WriteBytes(&header, sizeof(header));
+
+    std::vector<u8> buffer;
+    for (const auto& stored : m_entries)
+    {
+      buffer.clear();
+      AppendRecord(stored.first, &stored.second.entry, &buffer);
+      file.WriteBytes(buffer.data(), buffer.size());
+    }
+
+    if (!file.IsGood() || !file.Close())
+    {
+      ERROR_LOG(COMMON, "Failed to write the game list cache %s", temp_path.c_str());
+      File::Delete(temp_path);
+      return false;
+    }
+  }
+
+  // The entries point into the mapping until the new file has been loaded. Windows doesn't
+  // allow replacing a file that is mapped.
+  m_mapping.Unmap();
+  const bool renamed = File::Rename(temp_path, m_path);
+  if (!renamed)
+    File::Delete(temp_path);
+
+  // If the rename failed, the changes are lost and will be scanned again
+  return LoadLocked() && renamed;
+}
+
+std::vector<std::string> GameMetadataCache::GetPaths() const
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  std::vector<std::string> paths;
+  paths.reserve(m_entries.size());
+  for (const auto& stored : m_entries)
+    paths.push_back(stored.first);
+  return paths;
+}
+
+bool GameMetadataCache::Contains(const std::string& path) const
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+  return m_entries.count(path) != 0;
+}
+
+std::optional<std::vector<u8>> GameMetadataCache::Find(const std::string& path) const
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  auto it = m_entries.find(path);
+  if (it == m_entries.end())
+    return std::nullopt;
+
+  const Entry& entry = it->second.entry;
+  return std::vector<u8>(entry.data, entry.data + entry.size);
+}
+
+bool GameMetadataCache::IsUpToDate(const std::string& path) const
+{
+  u64 file_size;
+  s64 modification_time;
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+      return false;
+    file_size = it->second.entry.file_size;
+    modification_time = it->second.entry.modification_time;
+  }
+
+  // Not locked, since stat can be slow on network drives
+  const File::FileInfo info(path);
+  return info.Exists() && info.GetSize() == file_size &&
+         info.GetModificationTime() == modification_time;
+}
+
+void GameMetadataCache::Store(const std::string& path, std::vector<u8> data)
+{
+  // Taken before locking, since stat can be slow on network drives
+  const File::FileInfo info(path);
+
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  auto it = m_entries.find(path);
+  if (it != m_entries.end() && !m_dirty.count(path))
+  {
+    const u64 replaced_size = GetRecordSize(path, it->second.entry);
+    m_live_bytes -= replaced_size;
+    m_dead_bytes += replaced_size;
+  }
+
+  StoredEntry& stored = m_entries[path];
+  stored.owned_data = std::move(data);
+  stored.entry = {info.GetSize(), info.GetModificationTime(), stored.owned_data.data(),
+                  static_cast<u32>(stored.owned_data.size())};
+  m_dirty.insert(path);
+}
+
+void GameMetadataCache::Remove(const std::string& path)
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  auto it = m_entries.find(path);
+  if (it == m_entries.end())
+    return;
+
+  if (!m_dirty.count(path))
+  {
+    const u64 replaced_size = GetRecordSize(path, it->second.entry);
+    m_live_bytes -= replaced_size;
+    m_dead_bytes += replaced_size;
+  }
+
+  m_entries.erase(it);
+  m_dirty.insert(path);
+}
+
+void GameMetadataCache::Clear()
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+
+  m_entries.clear();
+  m_dirty.clear();
+  m_mapping.Unmap();
+  // The whole file is replaced on the next flush
+  m_append_offset = 0;
+  m_dead_bytes = 0;
+  m_live_bytes = 0;
+}
+
+}  // namespace UICommon
@@ -0,0 +1,92 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MappedFile.h"
+
+// A cache of the metadata that the game lists extract from game files, keyed by path.
+//
+// The metadata of each file is an opaque blob that is serialized by the game list that uses the
+// cache, along with the size and modification time that the file had when it was scanned. The
+// cache file is memory-mapped when it is loaded, so loading it doesn't copy the entries. Changes
+// are appended to the end of the cache file when it is flushed, and the file is only rewritten
+// once most of it consists of replaced entries.
+//
+// All functions are thread-safe, so entries can be stored from several scanning threads. Since a
+// flush can replace the mapping at any time, lookups return copies of the data.
+
+namespace UICommon
+{
+class GameMetadataCache final
+{
+public:
+  // A cache file that was written with a different revision is discarded.
+  GameMetadataCache(const std::string& path, u32 revision);
+  ~GameMetadataCache();
+
+  GameMetadataCache(const GameMetadataCache&) = delete;
+  GameMetadataCache& operator=(const GameMetadataCache&) = delete;
+
+  // Replaces the entries with the ones from the cache file. Returns false if the file is
+  // missing or unusable.
+  bool Load();
+  // Writes the changes made since the last Load or Flush.
+  bool Flush();
+
+  std::vector<std::string> GetPaths() const;
+  bool Contains(const std::string& path) const;
+  // Returns a copy of the data stored for path, or std::nullopt if path isn't in the cache
+  std::optional<std::vector<u8>> Find(const std::string& path) const;
+  // Returns true if path is in the cache and the file hasn't changed since it was stored.
+  bool IsUpToDate(const std::string& path) const;
+
+  void Store(const std::string& path, std::vector<u8> data);
+  void Remove(const std::string& path);
+  void Clear();
+
+  struct Entry
+  {
+    u64 file_size;
+    s64 modification_time;
+    const u8* data;
+    u32 size;
+  };
+
+private:
+  struct StoredEntry
+  {
+    Entry entry;
+    // Empty if the data lives in the mapping
+    std::vector<u8> owned_data;
+  };
+
+  bool LoadLocked();
+  bool AppendLocked();
+  bool RewriteLocked();
+
+  std::string m_path;
+  u32 m_revision;
+
+  mutable std::mutex m_lock;
+  File::MappedFile m_mapping;
+  std::map<std::string, StoredEntry> m_entries;
+  // Paths that have been stored or removed since the last Load or Flush
+  std::set<std::string> m_dirty;
+  // Where the next record is appended, or 0 if the file has to be rewritten
+  u64 m_append_offset = 0;
+  // Size of the records in the file that have been replaced or removed
+  u64 m_dead_bytes = 0;
+  u64 m_live_bytes = 0;
+};
+
+}  // namespace UICommon
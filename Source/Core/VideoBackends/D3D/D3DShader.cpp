@@ -9,6 +9,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 #include "Core/ARBruteForcer.h"
 #include "Core/Core.h"
 #include "VideoBackends/D3D/D3DBase.h"
@@ -33,6 +34,8 @@ ID3D11VertexShader* CreateVertexShaderFromByteCode(const void* bytecode, size_t
 // code->bytecode
 bool CompileVertexShader(const std::string& code, D3DBlob** blob)
 {
+  Common::Trace::ScopedZone trace_zone("Shader compile");
+
   ID3D10Blob* shaderBuffer = nullptr;
   ID3D10Blob* errorBuffer = nullptr;
 
@@ -62,9 +65,9 @@ bool CompileVertexShader(const std::string& code, D3DBlob** blob)
 
     if (ARBruteForcer::ch_bruteforce)
       Core::KillDolphinAndRestart();
-
-    PanicAlert("Failed to compile vertex shader: %s\nDebug info (%s):\n%s", filename.c_str(),
-               D3D::VertexShaderVersionString(), (const char*)errorBuffer->GetBufferPointer());
+    else
+      PanicAlert("Failed to compile vertex shader: %s\nDebug info (%s):\n%s", filename.c_str(),
+                 D3D::VertexShaderVersionString(), (const char*)errorBuffer->GetBufferPointer());
 
     *blob = nullptr;
     errorBuffer->Release();
@@ -92,6 +95,8 @@ ID3D11GeometryShader* CreateGeometryShaderFromByteCode(const void* bytecode, siz
 bool CompileGeometryShader(const std::string& code, D3DBlob** blob,
                            const D3D_SHADER_MACRO* pDefines)
 {
+  Common::Trace::ScopedZone trace_zone("Shader compile");
+
   ID3D10Blob* shaderBuffer = nullptr;
   ID3D10Blob* errorBuffer = nullptr;
 
@@ -151,6 +156,8 @@ ID3D11PixelShader* CreatePixelShaderFromByteCode(const void* bytecode, size_t le
 // code->bytecode
 bool CompilePixelShader(const std::string& code, D3DBlob** blob, const D3D_SHADER_MACRO* pDefines)
 {
+  Common::Trace::ScopedZone trace_zone("Shader compile");
+
   ID3D10Blob* shaderBuffer = nullptr;
   ID3D10Blob* errorBuffer = nullptr;
 
@@ -180,9 +187,9 @@ bool CompilePixelShader(const std::string& code, D3DBlob** blob, const D3D_SHADE
 
     if (ARBruteForcer::ch_bruteforce)
       Core::KillDolphinAndRestart();
-
-    PanicAlert("Failed to compile pixel shader: %s\nDebug info (%s):\n%s", filename.c_str(),
-               D3D::PixelShaderVersionString(), (const char*)errorBuffer->GetBufferPointer());
+    else
+      PanicAlert("Failed to compile pixel shader: %s\nDebug info (%s):\n%s", filename.c_str(),
+                 D3D::PixelShaderVersionString(), (const char*)errorBuffer->GetBufferPointer());
 
     *blob = nullptr;
     errorBuffer->Release();
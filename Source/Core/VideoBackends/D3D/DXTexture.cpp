@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -22,6 +23,7 @@
 
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace DX11
 {
@@ -118,7 +120,7 @@ bool DXTexture::Save(const std::string& filename, unsigned int level)
   D3D::context->CopySubresourceRegion(staging_texture, 0, 0, 0, 0, m_texture->GetTex(),
                                       D3D11CalcSubresource(level, 0, m_config.levels), &src_box);
 
-  // Map the staging texture to client memory, and encode it as a .png image.
+  // Map the staging texture to client memory, and queue a copy to be encoded as a .png image.
   D3D11_MAPPED_SUBRESOURCE map;
   hr = D3D::context->Map(staging_texture, 0, D3D11_MAP_READ, 0, &map);
   if (FAILED(hr))
@@ -128,12 +130,14 @@ bool DXTexture::Save(const std::string& filename, unsigned int level)
     return false;
   }
 
-  bool encode_result =
-      TextureToPng(reinterpret_cast<u8*>(map.pData), map.RowPitch, filename, mip_width, mip_height);
+  const u8* pixels = reinterpret_cast<const u8*>(map.pData);
+  std::vector<u8> data(pixels, pixels + map.RowPitch * mip_height);
   D3D::context->Unmap(staging_texture, 0);
   staging_texture->Release();
 
-  return encode_result;
+  QueueTextureToPng(std::move(data), map.RowPitch, filename, mip_width, mip_height, true,
+                    g_ActiveConfig.iPNGCompressionLevel);
+  return true;
 }
 
 void DXTexture::CopyRectangleFromTexture(const AbstractTexture* source,
@@ -199,7 +199,8 @@ static void TeardownDeviceObjects()
   s_gx_state_cache.Clear();
 }
 
-static void CreateScreenshotTexture()
+// Returns false if the texture couldn't be created while brute forcing
+static bool CreateScreenshotTexture()
 {
   // We can't render anything outside of the backbuffer anyway, so use the backbuffer size as the
   // screenshot buffer size.
@@ -211,9 +212,12 @@ static void CreateScreenshotTexture()
   if (hr != S_OK && ARBruteForcer::ch_bruteforce)
   {
     Core::KillDolphinAndRestart();
+    s_screenshot_texture = nullptr;
+    return false;
   }
   CHECK(hr == S_OK, "Create screenshot staging texture");
   D3D::SetDebugObjectName(s_screenshot_texture, "staging screenshot texture");
+  return true;
 }
 
 static D3D11_BOX GetScreenshotSourceBox(const TargetRectangle& targetRc)
@@ -291,7 +295,7 @@ Renderer::Renderer() : ::Renderer(D3D::GetBackBufferWidth(), D3D::GetBackBufferH
   // begin searching
   if (ARBruteForcer::ch_bruteforce)
   {
-    ARBruteForcer::ch_begin_search = true;
+    ARBruteForcer::BeginSearch();
     NOTICE_LOG(VR, "begin searching");
   }
 }
@@ -794,8 +798,169 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
     return;
   }
 
+  // The EFB has been rendered, which is all that later frames depend on. Frames that aren't
+  // presented in fast-forward mode still do the bookkeeping at the end of the frame below.
   ResetAPIState();
+  if (!IsPresentationSkipped())
+    DrawScreen(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma, xfbSourceList, xfbCount);
+  D3D::EndFrame();
+
+  g_texture_cache->Cleanup(frameCount);
+
+  if (g_has_hmd)
+  {
+    if (g_Config.bLowPersistence != g_ActiveConfig.bLowPersistence ||
+        g_Config.bDynamicPrediction != g_ActiveConfig.bDynamicPrediction ||
+        (g_Config.iMirrorPlayer == VR_PLAYER_NONE) !=
+            (g_ActiveConfig.iMirrorPlayer == VR_PLAYER_NONE) ||
+        (g_Config.iMirrorStyle == VR_MIRROR_DISABLED) !=
+            (g_ActiveConfig.iMirrorStyle == VR_MIRROR_DISABLED))
+    {
+      VR_ConfigureHMDPrediction();
+    }
+
+    if (g_Config.bOrientationTracking != g_ActiveConfig.bOrientationTracking ||
+        g_Config.bMagYawCorrection != g_ActiveConfig.bMagYawCorrection ||
+        g_Config.bPositionTracking != g_ActiveConfig.bPositionTracking)
+    {
+      VR_ConfigureHMDTracking();
+    }
+
+    if (g_Config.bChromatic != g_ActiveConfig.bChromatic ||
+        g_Config.bTimewarp != g_ActiveConfig.bTimewarp ||
+        g_Config.bVignette != g_ActiveConfig.bVignette ||
+        g_Config.bNoRestore != g_ActiveConfig.bNoRestore ||
+        g_Config.bFlipVertical != g_ActiveConfig.bFlipVertical ||
+        g_Config.bSRGB != g_ActiveConfig.bSRGB ||
+        g_Config.bOverdrive != g_ActiveConfig.bOverdrive ||
+        g_Config.bHqDistortion != g_ActiveConfig.bHqDistortion || g_fov_changed)
+    {
+      VR_ConfigureHMD();
+    }
+  }
+
+  // VR layer debugging, sometimes layers need to flash.
+  g_Config.iFlashState++;
+  if (g_Config.iFlashState >= 10)
+    g_Config.iFlashState = 0;
+
+  // Enable configuration changes
+  UpdateActiveConfig();
+  // VR Real XFB isn't implemented yet, so always disable it for VR
+  if (g_has_hmd && g_ActiveConfig.bEnableVR)
+  {
+    g_ActiveConfig.bUseRealXFB = false;
+    // always stretch to fit
+    g_ActiveConfig.iAspectRatio = 3;
+  }
+  g_texture_cache->OnConfigChanged(g_ActiveConfig);
+  VertexShaderCache::RetreiveAsyncShaders();
+  if (g_has_hmd && g_ActiveConfig.bEnableVR && !g_ActiveConfig.bAsynchronousTimewarp)
+    VR_BeginFrame();
+
+  SetWindowSize(fbStride, fbHeight);
+
+  bool window_resized = CheckForResize();
+  const bool fullscreen = D3D::GetFullscreenState();
+  const bool fs_changed = s_last_fullscreen_mode != fullscreen;
+
+  bool xfbchanged = s_last_xfb_mode != g_ActiveConfig.bUseRealXFB;
+
+  if (FramebufferManagerBase::LastXfbWidth() != fbStride ||
+      FramebufferManagerBase::LastXfbHeight() != fbHeight)
+  {
+    xfbchanged = true;
+    unsigned int xfb_w = (fbStride < 1 || fbStride > MAX_XFB_WIDTH) ? MAX_XFB_WIDTH : fbStride;
+    unsigned int xfb_h = (fbHeight < 1 || fbHeight > MAX_XFB_HEIGHT) ? MAX_XFB_HEIGHT : fbHeight;
+    FramebufferManagerBase::SetLastXfbWidth(xfb_w);
+    FramebufferManagerBase::SetLastXfbHeight(xfb_h);
+  }
+
+  // Flip/present backbuffer to frontbuffer here
+  if (!g_has_hmd && !IsPresentationSkipped())
+    D3D::Present();
+
+  VR_NewVRFrame();
+
+  // Resize the back buffers NOW to avoid flickering
+  if (CalculateTargetSize() || xfbchanged || window_resized || fs_changed ||
+      s_last_multisamples != g_ActiveConfig.iMultisamples ||
+      s_last_stereo_mode != (g_ActiveConfig.iStereoMode > 0))
+  {
+    s_last_xfb_mode = g_ActiveConfig.bUseRealXFB;
+    s_last_multisamples = g_ActiveConfig.iMultisamples;
+    s_last_fullscreen_mode = fullscreen;
+    PixelShaderCache::InvalidateMSAAShaders();
+
+    if (window_resized || fs_changed)
+    {
+      // TODO: Aren't we still holding a reference to the back buffer right now?
+      D3D::Reset();
+      SAFE_RELEASE(s_screenshot_texture);
+      SAFE_RELEASE(s_3d_vision_texture);
+      m_backbuffer_width = D3D::GetBackBufferWidth();
+      m_backbuffer_height = D3D::GetBackBufferHeight();
+    }
+
+    UpdateDrawRectangle();
+
+    s_last_stereo_mode = g_ActiveConfig.iStereoMode > 0;
+
+    D3D::context->OMSetRenderTargets(1, &D3D::GetBackBuffer()->GetRTV(), nullptr);
+
+    if (g_ActiveConfig.bAsynchronousTimewarp)
+      g_vr_lock.lock();
+    g_framebuffer_manager.reset();
+    g_framebuffer_manager = std::make_unique<FramebufferManager>(m_target_width, m_target_height);
+
+    constexpr std::array<float, 4> clear_color{{0.f, 0.f, 0.f, 1.f}};
+    D3D::context->ClearRenderTargetView(FramebufferManager::GetEFBColorTexture()->GetRTV(),
+                                        clear_color.data());
+    D3D::context->ClearDepthStencilView(FramebufferManager::GetEFBDepthTexture()->GetDSV(),
+                                        D3D11_CLEAR_DEPTH, 0.f, 0);
+    if (g_ActiveConfig.bAsynchronousTimewarp)
+      g_vr_lock.unlock();
+  }
+  else if (g_has_hmd && !g_ActiveConfig.bDontClearScreen)
+  {
+    // cegli - clearing the screen here causes flickering in games that fake 60fps by only actually
+    // updating
+    // the entire screen once every 2 frames.  They rely on the fact that nothing is cleared on the
+    // fake frame.
+    // An example of this is Beyond Good and Evil. Removing it aligns D3D with OGL, but adds the
+    // same smearing
+    // problem OGL has in the BG&E menu.  Without clearing the screen, some games like PM: TTYD have
+    // smearing
+    // around the edges.  How does OGL handle this gracefully?
+    // To Do: Figure out the best thing to do here.
+
+
+    // VR Clear screen before every frame
+    float clear_col[4] = {0.f, 0.f, 0.f, 1.f};
+    D3D::context->ClearRenderTargetView(FramebufferManager::GetEFBColorTexture()->GetRTV(),
+                                        clear_col);
+    D3D::context->ClearDepthStencilView(FramebufferManager::GetEFBDepthTexture()->GetDSV(),
+                                        D3D11_CLEAR_DEPTH, 0.f, 0);
+  }
 
+  if (CheckForHostConfigChanges())
+  {
+    VertexShaderCache::Reload();
+    GeometryShaderCache::Reload();
+    PixelShaderCache::Reload();
+  }
+
+  // begin next frame
+  RestoreAPIState();
+  D3D::BeginFrame();
+  FramebufferManager::BindEFBRenderTarget();
+  SetViewport();
+}
+
+void Renderer::DrawScreen(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
+                          const EFBRectangle& rc, u64 ticks, float Gamma,
+                          const XFBSourceBase* const* xfbSourceList, u32 xfbCount)
+{
   // Prepare to copy the XFBs to our backbuffer
   UpdateDrawRectangle();
   TargetRectangle targetRc = GetTargetRectangle();
@@ -1140,11 +1305,8 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 
 // Dump frames
 #if defined(HAVE_FFMPEG)
-  if (IsFrameDumping())
+  if (IsFrameDumping() && (s_screenshot_texture || CreateScreenshotTexture()))
   {
-    if (!s_screenshot_texture)
-      CreateScreenshotTexture();
-
     D3D11_BOX source_box = GetScreenshotSourceBox(targetRc);
     unsigned int source_width = source_box.right - source_box.left;
     unsigned int source_height = source_box.bottom - source_box.top;
@@ -1157,7 +1319,6 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
     AVIDump::Frame state = AVIDump::FetchState(ticks);
     DumpFrameData(reinterpret_cast<const u8*>(map.pData), source_width, source_height, map.RowPitch,
                   state);
-    FinishFrameData();
 
     D3D::context->Unmap(s_screenshot_texture, 0);
   }
@@ -1174,157 +1335,6 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 
     OSD::DrawMessages();
   }
-  D3D::EndFrame();
-
-  g_texture_cache->Cleanup(frameCount);
-
-  if (g_has_hmd)
-  {
-    if (g_Config.bLowPersistence != g_ActiveConfig.bLowPersistence ||
-        g_Config.bDynamicPrediction != g_ActiveConfig.bDynamicPrediction ||
-        (g_Config.iMirrorPlayer == VR_PLAYER_NONE) !=
-            (g_ActiveConfig.iMirrorPlayer == VR_PLAYER_NONE) ||
-        (g_Config.iMirrorStyle == VR_MIRROR_DISABLED) !=
-            (g_ActiveConfig.iMirrorStyle == VR_MIRROR_DISABLED))
-    {
-      VR_ConfigureHMDPrediction();
-    }
-
-    if (g_Config.bOrientationTracking != g_ActiveConfig.bOrientationTracking ||
-        g_Config.bMagYawCorrection != g_ActiveConfig.bMagYawCorrection ||
-        g_Config.bPositionTracking != g_ActiveConfig.bPositionTracking)
-    {
-      VR_ConfigureHMDTracking();
-    }
-
-    if (g_Config.bChromatic != g_ActiveConfig.bChromatic ||
-        g_Config.bTimewarp != g_ActiveConfig.bTimewarp ||
-        g_Config.bVignette != g_ActiveConfig.bVignette ||
-        g_Config.bNoRestore != g_ActiveConfig.bNoRestore ||
-        g_Config.bFlipVertical != g_ActiveConfig.bFlipVertical ||
-        g_Config.bSRGB != g_ActiveConfig.bSRGB ||
-        g_Config.bOverdrive != g_ActiveConfig.bOverdrive ||
-        g_Config.bHqDistortion != g_ActiveConfig.bHqDistortion || g_fov_changed)
-    {
-      VR_ConfigureHMD();
-    }
-  }
-
-  // VR layer debugging, sometimes layers need to flash.
-  g_Config.iFlashState++;
-  if (g_Config.iFlashState >= 10)
-    g_Config.iFlashState = 0;
-
-  // Enable configuration changes
-  UpdateActiveConfig();
-  // VR Real XFB isn't implemented yet, so always disable it for VR
-  if (g_has_hmd && g_ActiveConfig.bEnableVR)
-  {
-    g_ActiveConfig.bUseRealXFB = false;
-    // always stretch to fit
-    g_ActiveConfig.iAspectRatio = 3;
-  }
-  g_texture_cache->OnConfigChanged(g_ActiveConfig);
-  VertexShaderCache::RetreiveAsyncShaders();
-  if (g_has_hmd && g_ActiveConfig.bEnableVR && !g_ActiveConfig.bAsynchronousTimewarp)
-    VR_BeginFrame();
-
-  SetWindowSize(fbStride, fbHeight);
-
-  bool window_resized = CheckForResize();
-  const bool fullscreen = D3D::GetFullscreenState();
-  const bool fs_changed = s_last_fullscreen_mode != fullscreen;
-
-  bool xfbchanged = s_last_xfb_mode != g_ActiveConfig.bUseRealXFB;
-
-  if (FramebufferManagerBase::LastXfbWidth() != fbStride ||
-      FramebufferManagerBase::LastXfbHeight() != fbHeight)
-  {
-    xfbchanged = true;
-    unsigned int xfb_w = (fbStride < 1 || fbStride > MAX_XFB_WIDTH) ? MAX_XFB_WIDTH : fbStride;
-    unsigned int xfb_h = (fbHeight < 1 || fbHeight > MAX_XFB_HEIGHT) ? MAX_XFB_HEIGHT : fbHeight;
-    FramebufferManagerBase::SetLastXfbWidth(xfb_w);
-    FramebufferManagerBase::SetLastXfbHeight(xfb_h);
-  }
-
-  // Flip/present backbuffer to frontbuffer here
-  if (!g_has_hmd)
-    D3D::Present();
-
-  VR_NewVRFrame();
-
-  // Resize the back buffers NOW to avoid flickering
-  if (CalculateTargetSize() || xfbchanged || window_resized || fs_changed ||
-      s_last_multisamples != g_ActiveConfig.iMultisamples ||
-      s_last_stereo_mode != (g_ActiveConfig.iStereoMode > 0))
-  {
-    s_last_xfb_mode = g_ActiveConfig.bUseRealXFB;
-    s_last_multisamples = g_ActiveConfig.iMultisamples;
-    s_last_fullscreen_mode = fullscreen;
-    PixelShaderCache::InvalidateMSAAShaders();
-
-    if (window_resized || fs_changed)
-    {
-      // TODO: Aren't we still holding a reference to the back buffer right now?
-      D3D::Reset();
-      SAFE_RELEASE(s_screenshot_texture);
-      SAFE_RELEASE(s_3d_vision_texture);
-      m_backbuffer_width = D3D::GetBackBufferWidth();
-      m_backbuffer_height = D3D::GetBackBufferHeight();
-    }
-
-    UpdateDrawRectangle();
-
-    s_last_stereo_mode = g_ActiveConfig.iStereoMode > 0;
-
-    D3D::context->OMSetRenderTargets(1, &D3D::GetBackBuffer()->GetRTV(), nullptr);
-
-    if (g_ActiveConfig.bAsynchronousTimewarp)
-      g_vr_lock.lock();
-    g_framebuffer_manager.reset();
-    g_framebuffer_manager = std::make_unique<FramebufferManager>(m_target_width, m_target_height);
-
-    D3D::context->ClearRenderTargetView(FramebufferManager::GetEFBColorTexture()->GetRTV(),
-                                        clear_color.data());
-    D3D::context->ClearDepthStencilView(FramebufferManager::GetEFBDepthTexture()->GetDSV(),
-                                        D3D11_CLEAR_DEPTH, 0.f, 0);
-    if (g_ActiveConfig.bAsynchronousTimewarp)
-      g_vr_lock.unlock();
-  }
-  else if (g_has_hmd && !g_ActiveConfig.bDontClearScreen)
-  {
-    // cegli - clearing the screen here causes flickering in games that fake 60fps by only actually
-    // updating
-    // the entire screen once every 2 frames.  They rely on the fact that nothing is cleared on the
-    // fake frame.
-    // An example of this is Beyond Good and Evil. Removing it aligns D3D with OGL, but adds the
-    // same smearing
-    // problem OGL has in the BG&E menu.  Without clearing the screen, some games like PM: TTYD have
-    // smearing
-    // around the edges.  How does OGL handle this gracefully?
-    // To Do: Figure out the best thing to do here.
-
-
-    // VR Clear screen before every frame
-    float clear_col[4] = {0.f, 0.f, 0.f, 1.f};
-    D3D::context->ClearRenderTargetView(FramebufferManager::GetEFBColorTexture()->GetRTV(),
-                                        clear_col);
-    D3D::context->ClearDepthStencilView(FramebufferManager::GetEFBDepthTexture()->GetDSV(),
-                                        D3D11_CLEAR_DEPTH, 0.f, 0);
-  }
-
-  if (CheckForHostConfigChanges())
-  {
-    VertexShaderCache::Reload();
-    GeometryShaderCache::Reload();
-    PixelShaderCache::Reload();
-  }
-
-  // begin next frame
-  RestoreAPIState();
-  D3D::BeginFrame();
-  FramebufferManager::BindEFBRenderTarget();
-  SetViewport();
 }
 
 // ALWAYS call RestoreAPIState for each ResetAPIState call you're doing
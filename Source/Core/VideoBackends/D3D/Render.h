@@ -8,6 +8,7 @@
 #include "VideoCommon/RenderBase.h"
 
 enum class EFBAccessType;
+struct XFBSourceBase;
 
 namespace DX11
 {
@@ -60,5 +61,12 @@ public:
 
   void BlitScreen(TargetRectangle src, TargetRectangle dst, D3DTexture2D* src_texture,
                          u32 src_width, u32 src_height, float Gamma);
+
+private:
+  // Draws the frame to the window or the HMD, and dumps it. Skipped for frames that aren't
+  // presented.
+  void DrawScreen(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc,
+                  u64 ticks, float Gamma, const XFBSourceBase* const* xfbSourceList,
+                  u32 xfbCount);
 };
 }
@@ -81,6 +81,8 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsBitfield = false;
   g_Config.backend_info.bSupportsDynamicSamplerIndexing = false;
   g_Config.backend_info.bSupportsBPTCTextures = false;
+  // Every peek draws and reads back a single pixel
+  g_Config.backend_info.bSupportsCachedEFBPeeks = false;
 
   IDXGIFactory* factory = nullptr;
   IDXGIAdapter* ad;
@@ -6,6 +6,7 @@
 
 #include "VideoBackends/Null/Render.h"
 
+#include "VideoCommon/VR.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace Null
@@ -39,6 +40,7 @@ TargetRectangle Renderer::ConvertEFBRectangle(const EFBRectangle& rc)
 void Renderer::SwapImpl(u32, u32, u32, u32, const EFBRectangle&, u64, float)
 {
   UpdateActiveConfig();
+  VR_NewVRFrame();
 }
 
 }  // namespace Null
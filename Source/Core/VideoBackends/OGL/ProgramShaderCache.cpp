@@ -16,6 +16,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Timer.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
@@ -362,6 +363,8 @@ SHADER* ProgramShaderCache::SetUberShader(PrimitiveType primitive_type,
 bool ProgramShaderCache::CompileShader(SHADER& shader, const std::string& vcode,
                                        const std::string& pcode, const std::string& gcode)
 {
+  Common::Trace::ScopedZone trace_zone("Shader compile");
+
 #if defined(_DEBUG) || defined(DEBUGFAST)
   if (g_ActiveConfig.iLog & CONF_SAVESHADERS)
   {
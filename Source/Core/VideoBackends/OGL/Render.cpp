@@ -44,6 +44,7 @@
 #endif
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/EFBPeekCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -725,7 +726,7 @@ Renderer::Renderer()
   // begin searching
   if (ARBruteForcer::ch_bruteforce)
   {
-    ARBruteForcer::ch_begin_search = true;
+    ARBruteForcer::BeginSearch();
     NOTICE_LOG(VR, "begin searching GL");
   }
 
@@ -838,7 +839,6 @@ Renderer::Renderer()
 Renderer::~Renderer()
 {
   FlushFrameDump();
-  FinishFrameData();
   DestroyFrameDumpResources();
 }
 
@@ -929,6 +929,8 @@ void Renderer::SetScissorRect(const EFBRectangle& rc)
 
 void ClearEFBCache()
 {
+  // Everything that drops the EFB color and depth caches can also change what peeks see
+  EFBPeekCache::Invalidate();
   if (!s_efbCacheIsCleared)
   {
     s_efbCacheIsCleared = true;
@@ -1503,8 +1505,238 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
     return;
   }
 
-  eyesFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // The EFB has been rendered, which is all that later frames depend on. Frames that aren't
+  // presented in fast-forward mode still do the bookkeeping at the end of the frame below.
   ResetAPIState();
+  if (!IsPresentationSkipped())
+    DrawScreen(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, xfbSourceList, xfbCount);
+
+  // Finish up the current frame, print some stats
+
+  SetWindowSize(fbStride, fbHeight);
+
+  GLInterface->Update();  // just updates the render window position and the backbuffer size
+
+  bool xfbchanged = s_last_xfb_mode != g_ActiveConfig.bUseRealXFB;
+
+  if (FramebufferManagerBase::LastXfbWidth() != fbStride ||
+      FramebufferManagerBase::LastXfbHeight() != fbHeight)
+  {
+    xfbchanged = true;
+    unsigned int const last_w =
+        (fbStride < 1 || fbStride > MAX_XFB_WIDTH) ? MAX_XFB_WIDTH : fbStride;
+    unsigned int const last_h =
+        (fbHeight < 1 || fbHeight > MAX_XFB_HEIGHT) ? MAX_XFB_HEIGHT : fbHeight;
+    FramebufferManagerBase::SetLastXfbWidth(last_w);
+    FramebufferManagerBase::SetLastXfbHeight(last_h);
+  }
+
+  bool window_resized = false;
+  int window_width = static_cast<int>(std::max(GLInterface->GetBackBufferWidth(), 1u));
+  int window_height = static_cast<int>(std::max(GLInterface->GetBackBufferHeight(), 1u));
+  if (window_width != m_backbuffer_width || window_height != m_backbuffer_height)
+  {
+    window_resized = true;
+    m_backbuffer_width = window_width;
+    m_backbuffer_height = window_height;
+  }
+
+  bool target_size_changed = CalculateTargetSize();
+  bool stencil_buffer_enabled =
+      static_cast<FramebufferManager*>(g_framebuffer_manager.get())->HasStencilBuffer();
+
+  bool fb_needs_update = target_size_changed ||
+                         s_last_multisamples != g_ActiveConfig.iMultisamples ||
+                         stencil_buffer_enabled != BoundingBox::NeedsStencilBuffer() ||
+                         s_last_stereo_mode != (g_ActiveConfig.iStereoMode > 0);
+
+  if (xfbchanged || window_resized || fb_needs_update)
+  {
+    s_last_xfb_mode = g_ActiveConfig.bUseRealXFB;
+    UpdateDrawRectangle();
+  }
+  if (fb_needs_update)
+  {
+    s_last_stereo_mode = g_ActiveConfig.iStereoMode > 0;
+    s_last_multisamples = g_ActiveConfig.iMultisamples;
+    s_MSAASamples = s_last_multisamples;
+
+    if (s_MSAASamples > 1 && s_MSAASamples > g_ogl_config.max_samples)
+    {
+      s_MSAASamples = g_ogl_config.max_samples;
+      OSD::AddMessage(
+          StringFromFormat("%d Anti Aliasing samples selected, but only %d supported by your GPU.",
+                           s_last_multisamples, g_ogl_config.max_samples),
+          10000);
+    }
+
+    if (g_ActiveConfig.bAsynchronousTimewarp)
+      g_vr_lock.lock();
+    g_framebuffer_manager.reset();
+    g_framebuffer_manager = std::make_unique<FramebufferManager>(
+        m_target_width, m_target_height, s_MSAASamples, BoundingBox::NeedsStencilBuffer());
+    glFinish();
+    if (g_ActiveConfig.bAsynchronousTimewarp)
+      g_vr_lock.unlock();
+    BoundingBox::SetTargetSizeChanged(m_target_width, m_target_height);
+  }
+
+  if (g_has_rift && window_resized)
+  {
+    // Ensure Rift framebuffer matches window size
+    VR_ConfigureHMD();
+  }
+
+  // ---------------------------------------------------------------------
+  const bool present_to_window =
+      !(g_has_hmd && g_ActiveConfig.bEnableVR) && !IsPresentationSkipped();
+  if (present_to_window)
+  {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Reset viewport for drawing text
+    glViewport(0, 0, GLInterface->GetBackBufferWidth(), GLInterface->GetBackBufferHeight());
+
+    DrawDebugText();
+
+    // Do our OSD callbacks
+    OSD::DoCallbacks(OSD::CallbackType::OnFrame);
+    OSD::DrawMessages();
+  }
+#ifdef ANDROID
+  if (m_surface_needs_change.IsSet())
+  {
+    GLInterface->UpdateHandle(m_new_surface_handle);
+    GLInterface->UpdateSurface();
+    m_new_surface_handle = nullptr;
+    m_surface_needs_change.Clear();
+    m_surface_changed.Set();
+  }
+#endif
+
+  // Copy the rendered frame to the real window
+  if (present_to_window)
+    GLInterface->Swap();
+
+  VR_NewVRFrame();
+
+  // Clear framebuffer
+  if (g_has_hmd && g_ActiveConfig.bEnableVR)
+  {
+    if (!g_ActiveConfig.bDontClearScreen)
+    {
+      FramebufferManager::SetFramebuffer(0);
+      glClearDepth(1);
+      glClearColor(0, 0, 0, 0);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+  }
+  else if (!IsPresentationSkipped())
+  {
+    // The EFB is still bound when nothing was drawn to the window
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+
+  if (s_vsync != g_ActiveConfig.IsVSync())
+  {
+    s_vsync = g_ActiveConfig.IsVSync();
+    if (!DriverDetails::HasBug(DriverDetails::BUG_BROKEN_VSYNC))
+      GLInterface->SwapInterval(s_vsync);
+  }
+
+  // Clean out old stuff from caches. It's not worth it to clean out the shader caches.
+  g_texture_cache->Cleanup(frameCount);
+  ProgramShaderCache::RetrieveAsyncShaders();
+
+  if (g_has_hmd)
+  {
+    if (g_Config.bLowPersistence != g_ActiveConfig.bLowPersistence ||
+        g_Config.bDynamicPrediction != g_ActiveConfig.bDynamicPrediction ||
+        (g_Config.iMirrorPlayer == VR_PLAYER_NONE) !=
+            (g_ActiveConfig.iMirrorPlayer == VR_PLAYER_NONE) ||
+        (g_Config.iMirrorStyle == VR_MIRROR_DISABLED) !=
+            (g_ActiveConfig.iMirrorStyle == VR_MIRROR_DISABLED))
+    {
+      VR_ConfigureHMDPrediction();
+    }
+
+    if (g_Config.bOrientationTracking != g_ActiveConfig.bOrientationTracking ||
+        g_Config.bMagYawCorrection != g_ActiveConfig.bMagYawCorrection ||
+        g_Config.bPositionTracking != g_ActiveConfig.bPositionTracking)
+    {
+      VR_ConfigureHMDTracking();
+    }
+
+    if (g_Config.bChromatic != g_ActiveConfig.bChromatic ||
+        g_Config.bTimewarp != g_ActiveConfig.bTimewarp ||
+        g_Config.bVignette != g_ActiveConfig.bVignette ||
+        g_Config.bNoRestore != g_ActiveConfig.bNoRestore ||
+        g_Config.bFlipVertical != g_ActiveConfig.bFlipVertical ||
+        g_Config.bSRGB != g_ActiveConfig.bSRGB ||
+        g_Config.bOverdrive != g_ActiveConfig.bOverdrive ||
+        g_Config.bHqDistortion != g_ActiveConfig.bHqDistortion || g_fov_changed)
+    {
+      VR_ConfigureHMD();
+    }
+
+    // To do: Probably not the right place for these.  Why do they update for D3D automatically, but
+    // not for OpenGL?
+    g_ActiveConfig.iExtraTimewarpedFrames = g_Config.iExtraTimewarpedFrames;
+    g_ActiveConfig.iExtraVideoLoops = g_Config.iExtraVideoLoops;
+    g_ActiveConfig.iExtraVideoLoopsDivider = g_Config.iExtraVideoLoopsDivider;
+    g_ActiveConfig.fTimeWarpTweak = g_Config.fTimeWarpTweak;
+  }
+
+  // Render to the framebuffer.
+  FramebufferManager::SetFramebuffer(0);
+
+  RestoreAPIState();
+
+  g_Config.iSaveTargetId = 0;
+
+  int old_anisotropy = g_ActiveConfig.iMaxAnisotropy;
+  // VR layer debugging, sometimes layers need to flash.
+  g_Config.iFlashState++;
+  if (g_Config.iFlashState >= 10)
+    g_Config.iFlashState = 0;
+
+  UpdateActiveConfig();
+  // VR Real XFB isn't implemented yet, so always disable it for VR
+  if (g_has_hmd && g_ActiveConfig.bEnableVR)
+  {
+    g_ActiveConfig.bUseRealXFB = false;
+    // always stretch to fit
+    g_ActiveConfig.iAspectRatio = 3;
+  }
+  g_texture_cache->OnConfigChanged(g_ActiveConfig);
+  if (g_has_hmd && g_ActiveConfig.bEnableVR && !g_ActiveConfig.bAsynchronousTimewarp)
+  {
+    VR_BeginFrame();
+  }
+
+  if (old_anisotropy != g_ActiveConfig.iMaxAnisotropy)
+    g_sampler_cache->Clear();
+
+  // Invalidate shader cache when the host config changes.
+  if (CheckForHostConfigChanges())
+    ProgramShaderCache::Reload();
+
+  // For testing zbuffer targets.
+  // Renderer::SetZBufferRender();
+  // SaveTexture("tex.png", GL_TEXTURE_2D, s_FakeZTarget,
+  //	      GetTargetWidth(), GetTargetHeight());
+
+  // Invalidate EFB cache
+  ClearEFBCache();
+}
+
+void Renderer::DrawScreen(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
+                          const EFBRectangle& rc, u64 ticks,
+                          const XFBSourceBase* const* xfbSourceList, u32 xfbCount)
+{
+  eyesFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
   UpdateDrawRectangle();
   TargetRectangle flipped_trc = GetTargetRectangle();
@@ -1906,223 +2138,6 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
     WARN_LOG(VR, "ch_take_screenshot = %d", ARBruteForcer::ch_take_screenshot);
 
   DumpFrame(flipped_trc, ticks);
-
-  // Finish up the current frame, print some stats
-
-  SetWindowSize(fbStride, fbHeight);
-
-  GLInterface->Update();  // just updates the render window position and the backbuffer size
-
-  bool xfbchanged = s_last_xfb_mode != g_ActiveConfig.bUseRealXFB;
-
-  if (FramebufferManagerBase::LastXfbWidth() != fbStride ||
-      FramebufferManagerBase::LastXfbHeight() != fbHeight)
-  {
-    xfbchanged = true;
-    unsigned int const last_w =
-        (fbStride < 1 || fbStride > MAX_XFB_WIDTH) ? MAX_XFB_WIDTH : fbStride;
-    unsigned int const last_h =
-        (fbHeight < 1 || fbHeight > MAX_XFB_HEIGHT) ? MAX_XFB_HEIGHT : fbHeight;
-    FramebufferManagerBase::SetLastXfbWidth(last_w);
-    FramebufferManagerBase::SetLastXfbHeight(last_h);
-  }
-
-  bool window_resized = false;
-  int window_width = static_cast<int>(std::max(GLInterface->GetBackBufferWidth(), 1u));
-  int window_height = static_cast<int>(std::max(GLInterface->GetBackBufferHeight(), 1u));
-  if (window_width != m_backbuffer_width || window_height != m_backbuffer_height)
-  {
-    window_resized = true;
-    m_backbuffer_width = window_width;
-    m_backbuffer_height = window_height;
-  }
-
-  bool target_size_changed = CalculateTargetSize();
-  bool stencil_buffer_enabled =
-      static_cast<FramebufferManager*>(g_framebuffer_manager.get())->HasStencilBuffer();
-
-  bool fb_needs_update = target_size_changed ||
-                         s_last_multisamples != g_ActiveConfig.iMultisamples ||
-                         stencil_buffer_enabled != BoundingBox::NeedsStencilBuffer() ||
-                         s_last_stereo_mode != (g_ActiveConfig.iStereoMode > 0);
-
-  if (xfbchanged || window_resized || fb_needs_update)
-  {
-    s_last_xfb_mode = g_ActiveConfig.bUseRealXFB;
-    UpdateDrawRectangle();
-  }
-  if (fb_needs_update)
-  {
-    s_last_stereo_mode = g_ActiveConfig.iStereoMode > 0;
-    s_last_multisamples = g_ActiveConfig.iMultisamples;
-    s_MSAASamples = s_last_multisamples;
-
-    if (s_MSAASamples > 1 && s_MSAASamples > g_ogl_config.max_samples)
-    {
-      s_MSAASamples = g_ogl_config.max_samples;
-      OSD::AddMessage(
-          StringFromFormat("%d Anti Aliasing samples selected, but only %d supported by your GPU.",
-                           s_last_multisamples, g_ogl_config.max_samples),
-          10000);
-    }
-
-    if (g_ActiveConfig.bAsynchronousTimewarp)
-      g_vr_lock.lock();
-    g_framebuffer_manager.reset();
-    g_framebuffer_manager = std::make_unique<FramebufferManager>(
-        m_target_width, m_target_height, s_MSAASamples, BoundingBox::NeedsStencilBuffer());
-    glFinish();
-    if (g_ActiveConfig.bAsynchronousTimewarp)
-      g_vr_lock.unlock();
-    BoundingBox::SetTargetSizeChanged(m_target_width, m_target_height);
-  }
-
-  if (g_has_rift && window_resized)
-  {
-    // Ensure Rift framebuffer matches window size
-    VR_ConfigureHMD();
-  }
-
-  // ---------------------------------------------------------------------
-  if (!(g_has_hmd && g_ActiveConfig.bEnableVR))
-  {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Reset viewport for drawing text
-    glViewport(0, 0, GLInterface->GetBackBufferWidth(), GLInterface->GetBackBufferHeight());
-
-    DrawDebugText();
-
-    // Do our OSD callbacks
-    OSD::DoCallbacks(OSD::CallbackType::OnFrame);
-    OSD::DrawMessages();
-  }
-#ifdef ANDROID
-  if (m_surface_needs_change.IsSet())
-  {
-    GLInterface->UpdateHandle(m_new_surface_handle);
-    GLInterface->UpdateSurface();
-    m_new_surface_handle = nullptr;
-    m_surface_needs_change.Clear();
-    m_surface_changed.Set();
-  }
-#endif
-
-  // Copy the rendered frame to the real window
-  if (!(g_has_hmd && g_ActiveConfig.bEnableVR))
-    GLInterface->Swap();
-
-  VR_NewVRFrame();
-
-  // Clear framebuffer
-  if (g_has_hmd && g_ActiveConfig.bEnableVR)
-  {
-    if (!g_ActiveConfig.bDontClearScreen)
-    {
-      FramebufferManager::SetFramebuffer(0);
-      glClearDepth(1);
-      glClearColor(0, 0, 0, 0);
-      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    }
-  }
-  else
-  {
-    glClearColor(0, 0, 0, 0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  }
-
-  if (s_vsync != g_ActiveConfig.IsVSync())
-  {
-    s_vsync = g_ActiveConfig.IsVSync();
-    if (!DriverDetails::HasBug(DriverDetails::BUG_BROKEN_VSYNC))
-      GLInterface->SwapInterval(s_vsync);
-  }
-
-  // Clean out old stuff from caches. It's not worth it to clean out the shader caches.
-  g_texture_cache->Cleanup(frameCount);
-  ProgramShaderCache::RetrieveAsyncShaders();
-
-  if (g_has_hmd)
-  {
-    if (g_Config.bLowPersistence != g_ActiveConfig.bLowPersistence ||
-        g_Config.bDynamicPrediction != g_ActiveConfig.bDynamicPrediction ||
-        (g_Config.iMirrorPlayer == VR_PLAYER_NONE) !=
-            (g_ActiveConfig.iMirrorPlayer == VR_PLAYER_NONE) ||
-        (g_Config.iMirrorStyle == VR_MIRROR_DISABLED) !=
-            (g_ActiveConfig.iMirrorStyle == VR_MIRROR_DISABLED))
-    {
-      VR_ConfigureHMDPrediction();
-    }
-
-    if (g_Config.bOrientationTracking != g_ActiveConfig.bOrientationTracking ||
-        g_Config.bMagYawCorrection != g_ActiveConfig.bMagYawCorrection ||
-        g_Config.bPositionTracking != g_ActiveConfig.bPositionTracking)
-    {
-      VR_ConfigureHMDTracking();
-    }
-
-    if (g_Config.bChromatic != g_ActiveConfig.bChromatic ||
-        g_Config.bTimewarp != g_ActiveConfig.bTimewarp ||
-        g_Config.bVignette != g_ActiveConfig.bVignette ||
-        g_Config.bNoRestore != g_ActiveConfig.bNoRestore ||
-        g_Config.bFlipVertical != g_ActiveConfig.bFlipVertical ||
-        g_Config.bSRGB != g_ActiveConfig.bSRGB ||
-        g_Config.bOverdrive != g_ActiveConfig.bOverdrive ||
-        g_Config.bHqDistortion != g_ActiveConfig.bHqDistortion || g_fov_changed)
-    {
-      VR_ConfigureHMD();
-    }
-
-    // To do: Probably not the right place for these.  Why do they update for D3D automatically, but
-    // not for OpenGL?
-    g_ActiveConfig.iExtraTimewarpedFrames = g_Config.iExtraTimewarpedFrames;
-    g_ActiveConfig.iExtraVideoLoops = g_Config.iExtraVideoLoops;
-    g_ActiveConfig.iExtraVideoLoopsDivider = g_Config.iExtraVideoLoopsDivider;
-    g_ActiveConfig.fTimeWarpTweak = g_Config.fTimeWarpTweak;
-  }
-
-  // Render to the framebuffer.
-  FramebufferManager::SetFramebuffer(0);
-
-  RestoreAPIState();
-
-  g_Config.iSaveTargetId = 0;
-
-  int old_anisotropy = g_ActiveConfig.iMaxAnisotropy;
-  // VR layer debugging, sometimes layers need to flash.
-  g_Config.iFlashState++;
-  if (g_Config.iFlashState >= 10)
-    g_Config.iFlashState = 0;
-
-  UpdateActiveConfig();
-  // VR Real XFB isn't implemented yet, so always disable it for VR
-  if (g_has_hmd && g_ActiveConfig.bEnableVR)
-  {
-    g_ActiveConfig.bUseRealXFB = false;
-    // always stretch to fit
-    g_ActiveConfig.iAspectRatio = 3;
-  }
-  g_texture_cache->OnConfigChanged(g_ActiveConfig);
-  if (g_has_hmd && g_ActiveConfig.bEnableVR && !g_ActiveConfig.bAsynchronousTimewarp)
-  {
-    VR_BeginFrame();
-  }
-
-  if (old_anisotropy != g_ActiveConfig.iMaxAnisotropy)
-    g_sampler_cache->Clear();
-
-  // Invalidate shader cache when the host config changes.
-  if (CheckForHostConfigChanges())
-    ProgramShaderCache::Reload();
-
-  // For testing zbuffer targets.
-  // Renderer::SetZBufferRender();
-  // SaveTexture("tex.png", GL_TEXTURE_2D, s_FakeZTarget,
-  //	      GetTargetWidth(), GetTargetHeight());
-
-  // Invalidate EFB cache
-  ClearEFBCache();
 }
 
 void Renderer::DrawFrame(GLuint framebuffer, const TargetRectangle& target_rc,
@@ -2236,7 +2251,6 @@ void Renderer::FlushFrameDump()
   if (!m_last_frame_exported)
     return;
 
-  FinishFrameData();
   glBindBuffer(GL_PIXEL_PACK_BUFFER, m_frame_dumping_pbo[0]);
   m_frame_pbo_is_mapped[0] = true;
   void* data = glMapBufferRange(
@@ -129,6 +129,10 @@ private:
 
   void BlitScreen(TargetRectangle src, TargetRectangle dst, GLuint src_texture, int src_width,
                   int src_height);
+  // Draws the frame to the window or the HMD, and dumps it. Skipped for frames that aren't
+  // presented.
+  void DrawScreen(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc,
+                  u64 ticks, const XFBSourceBase* const* xfbSourceList, u32 xfbCount);
 
   void FlushFrameDump();
   void DumpFrame(const TargetRectangle& flipped_trc, u64 ticks);
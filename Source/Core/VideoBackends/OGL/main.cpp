@@ -105,6 +105,8 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsDepthClamp = true;
   g_Config.backend_info.bSupportsST3CTextures = false;
   g_Config.backend_info.bSupportsBPTCTextures = false;
+  // Peeks are answered from 64x64 blocks which are read back once
+  g_Config.backend_info.bSupportsCachedEFBPeeks = true;
 
   g_Config.backend_info.Adapters.clear();
 
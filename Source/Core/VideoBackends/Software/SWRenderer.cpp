@@ -120,6 +120,13 @@ void SWRenderer::AsyncTimewarpDraw()
 void SWRenderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
                           const EFBRectangle& rc, u64 ticks, float Gamma)
 {
+  if (IsPresentationSkipped())
+  {
+    UpdateActiveConfig();
+    VR_NewVRFrame();
+    return;
+  }
+
   if (g_ActiveConfig.bUseXFB)
   {
     EfbInterface::yuv422_packed* xfb = (EfbInterface::yuv422_packed*)Memory::GetPointer(xfbAddr);
@@ -135,7 +142,6 @@ void SWRenderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
   {
     AVIDump::Frame state = AVIDump::FetchState(ticks);
     DumpFrameData(GetCurrentColorTexture(), fbWidth, fbHeight, fbWidth * 4, state);
-    FinishFrameData();
   }
 
   OSD::DoCallbacks(OSD::CallbackType::OnFrame);
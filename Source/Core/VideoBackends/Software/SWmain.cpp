@@ -123,6 +123,7 @@ void VideoSoftware::InitBackendInfo()
   g_Config.backend_info.bSupportsGPUTextureDecoding = false;
   g_Config.backend_info.bSupportsST3CTextures = false;
   g_Config.backend_info.bSupportsBPTCTextures = false;
+  g_Config.backend_info.bSupportsCachedEFBPeeks = true;
 
   // aamodes
   g_Config.backend_info.AAModes = {1};
@@ -530,7 +530,8 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
   // If MSAA is enabled, and we're not using XFB, we need to resolve the EFB framebuffer before
   // rendering the final image to the screen, or dumping the frame. This is because we can't resolve
   // an image within a render pass, which will have already started by the time it is used.
-  TransitionBuffersForSwap(scaled_efb_rect, xfb_sources, xfb_count);
+  if (!IsPresentationSkipped())
+    TransitionBuffersForSwap(scaled_efb_rect, xfb_sources, xfb_count);
 
   // Render the frame dump image if enabled.
   if (IsFrameDumping())
@@ -554,8 +555,9 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
   // be a race, as the image may not have been consumed yet).
   g_command_buffer_mgr->PrepareToSubmitCommandBuffer();
 
-  // Draw to the screen if we have a swap chain.
-  if (m_swap_chain)
+  // Draw to the screen if we have a swap chain. Frames that aren't presented in fast-forward mode
+  // still have to be submitted, so that the next frame starts with a new command buffer.
+  if (m_swap_chain && !IsPresentationSkipped())
   {
     DrawScreen(scaled_efb_rect, xfb_addr, xfb_sources, xfb_count, fb_width, fb_stride, fb_height);
 
@@ -907,13 +909,8 @@ void Renderer::WriteFrameDumpImage(size_t index)
 
 StagingTexture2D* Renderer::PrepareFrameDumpImage(u32 width, u32 height, u64 ticks)
 {
-  // Ensure the last frame that was sent to the frame dump has completed encoding before we send
-  // the next image to it.
-  FinishFrameData();
-
   // If the last image hasn't been written to the frame dump yet, write it now.
-  // This is necessary so that the worker thread is no more than one frame behind, and the pointer
-  // (which is actually the buffer) is safe for us to re-use next time.
+  // This is necessary so that the readback buffer is safe for us to re-use next time.
   if (m_frame_dump_images[m_current_frame_dump_image].pending)
     WriteFrameDumpImage(m_current_frame_dump_image);
 
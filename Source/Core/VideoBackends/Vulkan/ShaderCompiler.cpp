@@ -21,6 +21,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 
 #include "VideoCommon/VideoConfig.h"
 
@@ -107,6 +108,8 @@ bool CompileShaderToSPV(SPIRVCodeVector* out_code, EShLanguage stage, const char
                         const char* source_code, size_t source_code_length, const char* header,
                         size_t header_length)
 {
+  Common::Trace::ScopedZone trace_zone("Shader compile");
+
   if (!InitializeGlslang())
     return false;
 
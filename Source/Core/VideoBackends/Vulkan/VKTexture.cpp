@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <vector>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -23,6 +24,7 @@
 
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace Vulkan
 {
@@ -156,15 +158,17 @@ bool VKTexture::Save(const std::string& filename, unsigned int level)
     return false;
   }
 
-  // Write texture out to file.
+  // Copy the texture out, and queue it to be written to file.
   // It's okay to throw this texture away immediately, since we're done with it, and
   // we blocked until the copy completed on the GPU anyway.
-  bool result = TextureToPng(reinterpret_cast<u8*>(staging_texture->GetMapPointer()),
-                             static_cast<u32>(staging_texture->GetRowStride()), filename,
-                             level_width, level_height);
+  const u8* pixels = reinterpret_cast<const u8*>(staging_texture->GetMapPointer());
+  const int row_stride = static_cast<int>(staging_texture->GetRowStride());
+  std::vector<u8> data(pixels, pixels + row_stride * level_height);
 
   staging_texture->Unmap();
-  return result;
+  QueueTextureToPng(std::move(data), row_stride, filename, level_width, level_height, true,
+                    g_ActiveConfig.iPNGCompressionLevel);
+  return true;
 }
 
 void VKTexture::CopyTextureRectangle(const MathUtil::Rectangle<int>& dst_rect,
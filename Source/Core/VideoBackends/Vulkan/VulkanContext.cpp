@@ -238,6 +238,7 @@ void VulkanContext::PopulateBackendInfo(VideoConfig* config)
   config->backend_info.bSupportsDynamicSamplerIndexing = true;        // Assumed support.
   config->backend_info.bSupportsInternalResolutionFrameDumps = true;  // Assumed support.
   config->backend_info.bSupportsPostProcessing = true;                // Assumed support.
+  config->backend_info.bSupportsCachedEFBPeeks = true;                // EFB is read back whole.
   config->backend_info.bSupportsDualSourceBlend = false;              // Dependent on features.
   config->backend_info.bSupportsGeometryShaders = false;              // Dependent on features.
   config->backend_info.bSupportsGSInstancing = false;                 // Dependent on features.
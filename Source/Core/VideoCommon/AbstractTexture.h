@@ -17,6 +17,7 @@ public:
   explicit AbstractTexture(const TextureConfig& c);
   virtual ~AbstractTexture();
   virtual void Bind(unsigned int stage) = 0;
+  // Reads back the level, and queues it to be written as a PNG file
   virtual bool Save(const std::string& filename, unsigned int level);
 
   virtual void CopyRectangleFromTexture(const AbstractTexture* source,
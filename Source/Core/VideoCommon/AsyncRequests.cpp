@@ -67,21 +67,21 @@ void AsyncRequests::PullEventsInternal()
   }
 }
 
-void AsyncRequests::PushEvent(const AsyncRequests::Event& event, bool blocking)
+bool AsyncRequests::PushEvent(const AsyncRequests::Event& event, bool blocking)
 {
   std::unique_lock<std::mutex> lock(m_mutex);
 
   if (m_passthrough)
   {
     HandleEvent(event);
-    return;
+    return true;
   }
 
   m_empty.Clear();
   m_wake_me_up_again |= blocking;
 
   if (!m_enable)
-    return;
+    return false;
 
   m_queue.push(event);
 
@@ -90,6 +90,7 @@ void AsyncRequests::PushEvent(const AsyncRequests::Event& event, bool blocking)
   {
     m_cond.wait(lock, [this] { return m_queue.empty(); });
   }
+  return true;
 }
 
 void AsyncRequests::SetEnable(bool enable)
@@ -135,6 +136,22 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
     *e.efb_peek.data = g_renderer->AccessEFB(EFBAccessType::PeekZ, e.efb_peek.x, e.efb_peek.y, 0);
     break;
 
+  case Event::EFB_PEEK_COLOR_TILE:
+  case Event::EFB_PEEK_Z_TILE:
+  {
+    // Only used with backends which keep the EFB readback around between accesses, so every
+    // pixel after the first is cheap
+    const EFBAccessType type =
+        e.type == Event::EFB_PEEK_COLOR_TILE ? EFBAccessType::PeekColor : EFBAccessType::PeekZ;
+    u32* data = e.efb_peek_tile.data;
+    for (u32 y = e.efb_peek_tile.y; y < e.efb_peek_tile.y + e.efb_peek_tile.height; ++y)
+    {
+      for (u32 x = e.efb_peek_tile.x; x < e.efb_peek_tile.x + e.efb_peek_tile.width; ++x)
+        *data++ = g_renderer->AccessEFB(type, x, y, 0);
+    }
+  }
+  break;
+
   case Event::SWAP_EVENT:
     g_renderer->Swap(e.swap_event.xfbAddr, e.swap_event.fbWidth, e.swap_event.fbStride,
                      e.swap_event.fbHeight, rc, e.time);
@@ -25,6 +25,8 @@ public:
       EFB_POKE_Z,
       EFB_PEEK_COLOR,
       EFB_PEEK_Z,
+      EFB_PEEK_COLOR_TILE,
+      EFB_PEEK_Z_TILE,
       SWAP_EVENT,
       BBOX_READ,
       PERF_QUERY,
@@ -47,6 +49,15 @@ public:
         u32* data;
       } efb_peek;
 
+      struct
+      {
+        u16 x;
+        u16 y;
+        u16 width;
+        u16 height;
+        u32* data;
+      } efb_peek_tile;
+
       struct
       {
         u32 xfbAddr;
@@ -74,7 +85,8 @@ public:
     if (!m_empty.IsSet())
       PullEventsInternal();
   }
-  void PushEvent(const Event& event, bool blocking = false);
+  // Returns false if the event was dropped because requests are disabled
+  bool PushEvent(const Event& event, bool blocking = false);
   void SetEnable(bool enable);
   void SetPassthrough(bool enable);
 
@@ -7,6 +7,7 @@
 
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/EFBPeekCache.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -215,6 +216,7 @@ void ClearScreen(const EFBRectangle& rc, bool frame_just_rendered)
     }
     else
     {
+      EFBPeekCache::Invalidate();
       g_renderer->ClearScreen(rc, colorEnable, alphaEnable, zEnable, color, z);
       g_new_frame_tracker_for_efb_skip = false;
     }
@@ -223,6 +225,9 @@ void ClearScreen(const EFBRectangle& rc, bool frame_just_rendered)
 
 void OnPixelFormatChange()
 {
+  // Peeked values are converted according to the pixel format
+  EFBPeekCache::Invalidate();
+
   int convtype = -1;
 
   // TODO : Check for Z compression format change
@@ -312,7 +312,10 @@ void GatherPipeBursted()
   Fifo::RunGpu();
 
   if (ARBruteForcer::ch_bruteforce && !(fifo.CPReadWriteDistance <= fifo.CPEnd - fifo.CPBase))
+  {
     Core::KillDolphinAndRestart();
+    return;
+  }
 
   _assert_msg_(COMMANDPROCESSOR, fifo.CPReadWriteDistance <= fifo.CPEnd - fifo.CPBase,
                "FIFO is overflowed by GatherPipe !\nCPU thread is too fast!");
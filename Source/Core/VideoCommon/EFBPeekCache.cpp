@@ -0,0 +1,65 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/EFBPeekCache.h"
+
+#include <algorithm>
+
+#include "VideoCommon/VideoBackendBase.h"
+
+std::atomic<u32> EFBPeekCache::s_generation{1};
+
+void EFBPeekCache::SetTileSize(u32 size)
+{
+  size = std::min<u32>(size, EFB_WIDTH);
+  if (size == m_tile_size)
+    return;
+
+  m_tile_size = size;
+  for (std::vector<Tile>& tiles : m_tiles)
+    tiles.clear();
+  if (size == 0)
+    return;
+
+  m_tiles_per_row = (EFB_WIDTH + size - 1) / size;
+  const u32 tiles_per_column = (EFB_HEIGHT + size - 1) / size;
+  for (std::vector<Tile>& tiles : m_tiles)
+    tiles.resize(m_tiles_per_row * tiles_per_column);
+}
+
+u32 EFBPeekCache::Peek(EFBAccessType type, u32 x, u32 y, const ReadTileFunction& read_tile)
+{
+  const u32 tile_x = x / m_tile_size;
+  const u32 tile_y = y / m_tile_size;
+  Tile& tile = m_tiles[type == EFBAccessType::PeekColor][tile_y * m_tiles_per_row + tile_x];
+
+  const int size = static_cast<int>(m_tile_size);
+  EFBRectangle rect;
+  rect.left = tile_x * size;
+  rect.top = tile_y * size;
+  rect.right = std::min<int>(rect.left + size, EFB_WIDTH);
+  rect.bottom = std::min<int>(rect.top + size, EFB_HEIGHT);
+
+  // Read before the request, so a change made while it's waiting makes the tile stale
+  const u32 generation = s_generation.load();
+  if (tile.generation != generation)
+  {
+    tile.values.resize(rect.GetWidth() * rect.GetHeight());
+    if (!read_tile(type, rect, tile.values.data()))
+    {
+      tile.generation = 0;
+      return 0;
+    }
+    tile.generation = generation;
+  }
+
+  return tile.values[(y - rect.top) * rect.GetWidth() + (x - rect.left)];
+}
+
+void EFBPeekCache::Invalidate()
+{
+  // Skip 0 on overflow, as that marks tiles which were never read back
+  if (++s_generation == 0)
+    ++s_generation;
+}
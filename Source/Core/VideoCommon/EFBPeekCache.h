@@ -0,0 +1,52 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/VideoCommon.h"
+
+enum class EFBAccessType;
+
+// Answers EFB peeks on the CPU thread from square tiles of the EFB, which are read back with a
+// single request to the GPU thread. Games that peek many pixels in a row, like lens flare
+// visibility checks, then only wait for the GPU thread once per tile. Everything that can change
+// the EFB contents must call Invalidate.
+class EFBPeekCache
+{
+public:
+  // Reads the peek values of every pixel of the rectangle, row by row. Returns false if the
+  // values couldn't be read.
+  using ReadTileFunction =
+      std::function<bool(EFBAccessType type, const EFBRectangle& rect, u32* values)>;
+
+  // Changes the width and height of the tiles, dropping the cached tiles if it differs
+  void SetTileSize(u32 size);
+  u32 GetTileSize() const { return m_tile_size; }
+  // The tile size must not be 0. Returns 0 if the tile couldn't be read, which isn't cached.
+  u32 Peek(EFBAccessType type, u32 x, u32 y, const ReadTileFunction& read_tile);
+
+  // Can be called from any thread
+  static void Invalidate();
+
+private:
+  struct Tile
+  {
+    std::vector<u32> values;
+    // The value of s_generation when the tile was read back, 0 if it never was
+    u32 generation = 0;
+  };
+
+  u32 m_tile_size = 0;
+  u32 m_tiles_per_row = 0;
+  // Depth tiles, then color tiles
+  std::array<std::vector<Tile>, 2> m_tiles;
+
+  static std::atomic<u32> s_generation;
+};
@@ -2,17 +2,88 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <string>
 
+#include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
 #include "Common/Timer.h"
+#include "Common/Version.h"
+#include "Core/Benchmark.h"
+#include "Core/ConfigManager.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoConfig.h"
 
 static constexpr u64 FPS_REFRESH_INTERVAL = 250000;
 
+static const char* const TIMING_NAMES[] = {"frame", "cpu_thread", "gpu_thread", "present"};
+static_assert(ArraySize(TIMING_NAMES) == static_cast<size_t>(FPSCounter::Timing::NumTimings),
+              "Every timing needs a name");
+
+void FrameTimeHistogram::Add(u64 time_us)
+{
+  m_buckets[GetBucket(time_us)]++;
+  m_count++;
+  m_total_us += time_us;
+  m_max_us = std::max(m_max_us, time_us);
+}
+
+void FrameTimeHistogram::Remove(u64 time_us)
+{
+  m_buckets[GetBucket(time_us)]--;
+  m_count--;
+  m_total_us -= time_us;
+
+  // The other durations aren't stored, so the largest one that is left can only be bounded by the
+  // start of its bucket. This is rare, since it only happens when the largest duration is removed.
+  if (time_us >= m_max_us)
+  {
+    m_max_us = 0;
+    for (u32 i = NUM_BUCKETS; i > 0; --i)
+    {
+      if (m_buckets[i - 1])
+      {
+        m_max_us = static_cast<u64>(i - 1) * BUCKET_WIDTH_US;
+        break;
+      }
+    }
+  }
+}
+
+void FrameTimeHistogram::Clear()
+{
+  *this = {};
+}
+
+double FrameTimeHistogram::GetMeanMs() const
+{
+  return m_count ? m_total_us / 1000.0 / m_count : 0.0;
+}
+
+double FrameTimeHistogram::GetPercentileMs(double percentile) const
+{
+  if (!m_count)
+    return 0.0;
+
+  const u32 rank =
+      std::max(static_cast<u32>(std::ceil(percentile * m_count / 100)), static_cast<u32>(1));
+  u32 seen = 0;
+  for (u32 i = 0; i < NUM_BUCKETS - 1; ++i)
+  {
+    seen += m_buckets[i];
+    if (seen >= rank)
+      return (i + 1) * BUCKET_WIDTH_US / 1000.0;
+  }
+  return GetMaxMs();
+}
+
 FPSCounter::FPSCounter()
 {
   m_last_time = Common::Timer::GetTimeUs();
@@ -26,13 +97,49 @@ void FPSCounter::LogRenderTimeToFile(u64 val)
   m_bench_file << std::fixed << std::setprecision(8) << (val / 1000.0) << std::endl;
 }
 
-void FPSCounter::Update()
+void FPSCounter::AddTime(Timing timing, u64 time_us)
+{
+  m_histograms[static_cast<size_t>(timing)].Add(time_us);
+}
+
+void FPSCounter::AddRecentFrameTime(u64 time_us)
+{
+  if (m_recent_frames.GetCount() == RECENT_FRAMES)
+    m_recent_frames.Remove(m_recent_frame_times[m_recent_frame_index]);
+
+  const u32 stored_time = static_cast<u32>(
+      std::min<u64>(time_us, std::numeric_limits<u32>::max()));
+  m_recent_frame_times[m_recent_frame_index] = stored_time;
+  m_recent_frames.Add(stored_time);
+  m_recent_frame_index = (m_recent_frame_index + 1) % RECENT_FRAMES;
+}
+
+void FPSCounter::Update(u64 present_time_us)
 {
   u64 time = Common::Timer::GetTimeUs();
   u64 diff = time - m_last_time;
   if (g_ActiveConfig.bLogRenderTimeToFile)
     LogRenderTimeToFile(diff);
 
+  // Zero if the CPU time of the thread is unknown
+  const u64 cpu_thread_time = Benchmark::GetCPUThreadCPUTime();
+  const u64 gpu_thread_time = Benchmark::GetCurrentThreadCPUTime();
+
+  // The first frame only marks the start of the measurements
+  if (m_has_previous_frame)
+  {
+    AddTime(Timing::Frame, diff);
+    AddTime(Timing::Present, present_time_us);
+    if (cpu_thread_time && m_last_cpu_thread_time && cpu_thread_time >= m_last_cpu_thread_time)
+      AddTime(Timing::CPUThread, (cpu_thread_time - m_last_cpu_thread_time) / 1000);
+    if (gpu_thread_time && m_last_gpu_thread_time)
+      AddTime(Timing::GPUThread, (gpu_thread_time - m_last_gpu_thread_time) / 1000);
+    AddRecentFrameTime(diff);
+  }
+  m_has_previous_frame = true;
+  m_last_cpu_thread_time = cpu_thread_time;
+  m_last_gpu_thread_time = gpu_thread_time;
+
   m_frame_counter++;
   m_time_since_update += diff;
   m_last_time = time;
@@ -42,5 +149,84 @@ void FPSCounter::Update()
     m_fps = m_frame_counter / (m_time_since_update / 1000000.0);
     m_frame_counter = 0;
     m_time_since_update = 0;
+
+    const double one_percent_low_ms = m_recent_frames.GetPercentileMs(99);
+    const double point_one_percent_low_ms = m_recent_frames.GetPercentileMs(99.9);
+    m_one_percent_low_fps =
+        one_percent_low_ms > 0 ? static_cast<float>(1000 / one_percent_low_ms) : 0;
+    m_point_one_percent_low_fps =
+        point_one_percent_low_ms > 0 ? static_cast<float>(1000 / point_one_percent_low_ms) : 0;
+  }
+}
+
+bool FPSCounter::ExportHistograms(const std::string& path) const
+{
+  const FrameTimeHistogram& frames = GetHistogram(Timing::Frame);
+  if (!frames.GetCount())
+    return false;
+
+  // Only the buckets up to the last one that is used by any of the histograms are written
+  u32 num_buckets = 0;
+  for (const FrameTimeHistogram& histogram : m_histograms)
+  {
+    const auto& buckets = histogram.GetBuckets();
+    for (u32 i = num_buckets; i < FrameTimeHistogram::NUM_BUCKETS; ++i)
+    {
+      if (buckets[i])
+        num_buckets = i + 1;
+    }
+  }
+
+  std::string csv = "bucket_start_ms";
+  for (const char* name : TIMING_NAMES)
+    csv += StringFromFormat(",%s", name);
+  csv += "\n";
+  for (u32 i = 0; i < num_buckets; ++i)
+  {
+    csv += StringFromFormat("%.1f", i * FrameTimeHistogram::BUCKET_WIDTH_US / 1000.0);
+    for (const FrameTimeHistogram& histogram : m_histograms)
+      csv += StringFromFormat(",%u", histogram.GetBuckets()[i]);
+    csv += "\n";
+  }
+
+  const SConfig& config = SConfig::GetInstance();
+  const double frame_ms = frames.GetMeanMs();
+  const double one_percent_low_ms = frames.GetPercentileMs(99);
+  const double point_one_percent_low_ms = frames.GetPercentileMs(99.9);
+
+  std::string json = "{\n";
+  json += StringFromFormat("  \"build\": \"%s\",\n",
+                           Benchmark::EscapeJSON(Common::scm_desc_str).c_str());
+  json += StringFromFormat("  \"game_id\": \"%s\",\n",
+                           Benchmark::EscapeJSON(config.GetGameID()).c_str());
+  json += StringFromFormat(
+      "  \"video_backend\": \"%s\",\n",
+      Benchmark::EscapeJSON(g_video_backend ? g_video_backend->GetName() : std::string()).c_str());
+  json += StringFromFormat("  \"cpu_core\": %d,\n", config.iCPUCore);
+  json += StringFromFormat("  \"dual_core\": %s,\n", config.bCPUThread ? "true" : "false");
+  json += StringFromFormat("  \"efb_scale\": %d,\n", g_ActiveConfig.iEFBScale);
+  json += StringFromFormat("  \"vsync\": %s,\n", g_ActiveConfig.bVSync ? "true" : "false");
+  json += StringFromFormat("  \"frames\": %u,\n", frames.GetCount());
+  json += StringFromFormat("  \"average_fps\": %.4f,\n", frame_ms > 0 ? 1000 / frame_ms : 0.0);
+  json += StringFromFormat("  \"one_percent_low_fps\": %.4f,\n",
+                           one_percent_low_ms > 0 ? 1000 / one_percent_low_ms : 0.0);
+  json += StringFromFormat("  \"point_one_percent_low_fps\": %.4f,\n",
+                           point_one_percent_low_ms > 0 ? 1000 / point_one_percent_low_ms : 0.0);
+  json += StringFromFormat("  \"bucket_width_ms\": %.1f,\n",
+                           FrameTimeHistogram::BUCKET_WIDTH_US / 1000.0);
+  json += "  \"timings\": {\n";
+  for (size_t i = 0; i < m_histograms.size(); ++i)
+  {
+    const FrameTimeHistogram& histogram = m_histograms[i];
+    json += StringFromFormat("    \"%s\": {\"frames\": %u, \"mean_ms\": %.4f, \"p50_ms\": %.1f, "
+                             "\"p99_ms\": %.1f, \"p99.9_ms\": %.1f, \"max_ms\": %.4f}%s\n",
+                             TIMING_NAMES[i], histogram.GetCount(), histogram.GetMeanMs(),
+                             histogram.GetPercentileMs(50), histogram.GetPercentileMs(99),
+                             histogram.GetPercentileMs(99.9), histogram.GetMaxMs(),
+                             i + 1 < m_histograms.size() ? "," : "");
   }
+  json += "  }\n}\n";
+
+  return File::WriteStringToFile(csv, path + ".csv") &&
+         File::WriteStringToFile(json, path + ".json");
 }
@@ -4,26 +4,106 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <fstream>
+#include <string>
 
 #include "Common/CommonTypes.h"
 
+// Counts durations in fixed buckets: 0.1 ms wide up to 100 ms, and one bucket for anything longer.
+// Adding and removing a duration is constant time, so it can also count a sliding window.
+class FrameTimeHistogram final
+{
+public:
+  static constexpr u32 BUCKET_WIDTH_US = 100;
+  static constexpr u32 NUM_BUCKETS = 1001;
+
+  void Add(u64 time_us);
+  // Removes a duration that was added before
+  void Remove(u64 time_us);
+  void Clear();
+
+  u32 GetCount() const { return m_count; }
+  double GetMeanMs() const;
+  // The largest duration added since the last Clear. Once the largest duration has been removed,
+  // this is the start of the highest used bucket instead.
+  double GetMaxMs() const { return m_max_us / 1000.0; }
+  // Nearest-rank percentile, rounded up to the end of its bucket. Durations in the last bucket are
+  // reported as GetMaxMs.
+  double GetPercentileMs(double percentile) const;
+  const std::array<u32, NUM_BUCKETS>& GetBuckets() const { return m_buckets; }
+
+private:
+  static u32 GetBucket(u64 time_us)
+  {
+    return static_cast<u32>(std::min<u64>(time_us / BUCKET_WIDTH_US, NUM_BUCKETS - 1));
+  }
+
+  std::array<u32, NUM_BUCKETS> m_buckets{};
+  u32 m_count = 0;
+  u64 m_total_us = 0;
+  u64 m_max_us = 0;
+};
+
 class FPSCounter
 {
 public:
+  enum class Timing
+  {
+    // Wall time between two presented frames
+    Frame,
+    // CPU time used by the emulated CPU thread during the frame
+    CPUThread,
+    // CPU time used by the thread that presents frames, which includes presenting it
+    GPUThread,
+    // Wall time spent presenting the frame
+    Present,
+    NumTimings
+  };
+
   // Initializes the FPS counter.
   FPSCounter();
 
-  // Called when a frame is rendered (updated every second).
-  void Update();
+  // Called when a frame is presented (FPS and lows are updated every 250 ms).
+  void Update(u64 present_time_us);
 
   float GetFPS() const { return m_fps; }
+  // FPS at the 99th and 99.9th percentile frame time of the last RECENT_FRAMES frames
+  float GetOnePercentLowFPS() const { return m_one_percent_low_fps; }
+  float GetPointOnePercentLowFPS() const { return m_point_one_percent_low_fps; }
+
+  // Histograms of all frames since the counter was created
+  const FrameTimeHistogram& GetHistogram(Timing timing) const
+  {
+    return m_histograms[static_cast<size_t>(timing)];
+  }
+
+  // Writes the histograms to <path>.csv and a summary with the settings to <path>.json
+  bool ExportHistograms(const std::string& path) const;
+
 private:
+  static constexpr u32 RECENT_FRAMES = 2048;
+
   u64 m_last_time = 0;
   u64 m_time_since_update = 0;
   u32 m_frame_counter = 0;
   float m_fps = 0;
   std::ofstream m_bench_file;
 
+  bool m_has_previous_frame = false;
+  u64 m_last_cpu_thread_time = 0;
+  u64 m_last_gpu_thread_time = 0;
+  std::array<FrameTimeHistogram, static_cast<size_t>(Timing::NumTimings)> m_histograms;
+
+  FrameTimeHistogram m_recent_frames;
+  std::array<u32, RECENT_FRAMES> m_recent_frame_times{};
+  u32 m_recent_frame_index = 0;
+  float m_one_percent_low_fps = 0;
+  float m_point_one_percent_low_fps = 0;
+
   void LogRenderTimeToFile(u64 val);
+  void AddTime(Timing timing, u64 time_us);
+  void AddRecentFrameTime(u64 time_us);
 };
@@ -15,6 +15,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Trace.h"
 
 #include "Core/ARBruteForcer.h"
 #include "Core/ConfigManager.h"
@@ -84,8 +85,6 @@ static Common::Event s_sync_wakeup_event;
 
 void DoState(PointerWrap& p)
 {
-  if (!s_video_buffer && ARBruteForcer::ch_bruteforce)
-    Core::KillDolphinAndRestart();
   p.DoArray(s_video_buffer, FIFO_SIZE);
   u8* write_ptr = s_video_buffer_write_ptr;
   p.DoPointer(write_ptr, s_video_buffer);
@@ -132,6 +131,11 @@ void Init()
   s_sync_ticks.store(0);
 }
 
+bool IsInitialized()
+{
+  return s_video_buffer != nullptr;
+}
+
 void Shutdown()
 {
   if (s_gpu_mainloop.IsRunning())
@@ -337,6 +341,8 @@ void RunGpuLoop()
         if (!s_emu_running_state.IsSet())
           return;
 
+        Common::Trace::ScopedZone trace_zone("Fifo::RunGpuLoop");
+
         if (s_use_deterministic_gpu_thread)
         {
           AsyncRequests::GetInstance()->PullEvents();
@@ -369,6 +375,7 @@ void RunGpuLoop()
           AsyncRequests::GetInstance()->PullEvents();
 
           CommandProcessor::SetCPStatusFromGPU();
+          Common::Trace::Counter("FIFO bytes pending", fifo.CPReadWriteDistance);
 
           // check if we are able to run this buffer
           while (!CommandProcessor::IsInterruptWaiting() && fifo.bFF_GPReadEnable &&
@@ -13,6 +13,7 @@ namespace Fifo
 {
 void Init();
 void Shutdown();
+bool IsInitialized();
 void Prepare();  // Must be called from the CPU thread.
 void DoState(PointerWrap& f);
 void PauseAndLock(bool doLock, bool unpauseOnUnlock);
@@ -2,17 +2,38 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/WorkerPool.h"
 #include "VideoCommon/ImageWrite.h"
 #include "png.h"
 
+namespace
+{
+// Images waiting to be encoded are held in memory, so stop queuing more at some point
+constexpr size_t MAX_QUEUED_PNG_BYTES = 256 * 1024 * 1024;
+
+std::mutex s_png_lock;
+std::condition_variable s_png_dequeued;
+std::unique_ptr<Common::WorkerPool> s_png_workers;
+size_t s_queued_png_bytes = 0;
+std::unordered_set<std::string> s_claimed_png_filenames;
+}  // Anonymous namespace
+
 bool SaveData(const std::string& filename, const std::string& data)
 {
   std::ofstream f;
@@ -35,7 +56,7 @@ data      : This is an array of RGBA with 8 bits per channel. 4 bytes for each p
 row_stride: Determines the amount of bytes per row of pixels.
 */
 bool TextureToPng(const u8* data, int row_stride, const std::string& filename, int width,
-                  int height, bool saveAlpha)
+                  int height, bool saveAlpha, int compression_level)
 {
   if (!data)
     return false;
@@ -90,6 +111,15 @@ bool TextureToPng(const u8* data, int row_stride, const std::string& filename, i
 
   png_init_io(png_ptr, fp.GetHandle());
 
+  if (compression_level >= 0)
+  {
+    png_set_compression_level(png_ptr, std::min(compression_level, 9));
+    // Trying every filter on every row takes a good part of the encoding time, and isn't worth it
+    // when speed was asked for
+    if (compression_level <= 3)
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+  }
+
   // Write header (8 bit color depth)
   png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
                PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
@@ -144,3 +174,65 @@ finalise:
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+
+void QueueTextureToPng(std::vector<u8> data, int row_stride, const std::string& filename,
+                       int width, int height, bool save_alpha, int compression_level,
+                       std::function<void(std::vector<u8>)> release)
+{
+  const size_t size = data.size();
+  std::unique_lock<std::mutex> lk(s_png_lock);
+  // A single image larger than the limit is still allowed once the queue is empty
+  s_png_dequeued.wait(lk, [size] {
+    return s_queued_png_bytes == 0 || s_queued_png_bytes + size <= MAX_QUEUED_PNG_BYTES;
+  });
+  s_queued_png_bytes += size;
+
+  if (!s_png_workers)
+  {
+    // Leave some threads to the emulation, which is still running while images are dumped
+    const u32 num_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    s_png_workers = std::make_unique<Common::WorkerPool>("PNG Encoder", num_threads);
+  }
+
+  s_png_workers->Schedule([data = std::move(data), row_stride, filename, width, height,
+                           save_alpha, compression_level, release = std::move(release)]() mutable {
+    const size_t data_size = data.size();
+    TextureToPng(data.data(), row_stride, filename, width, height, save_alpha, compression_level);
+    if (release)
+      release(std::move(data));
+
+    {
+      std::lock_guard<std::mutex> guard(s_png_lock);
+      s_queued_png_bytes -= data_size;
+    }
+    s_png_dequeued.notify_all();
+  });
+}
+
+void WaitForQueuedPngs()
+{
+  std::unique_lock<std::mutex> lk(s_png_lock);
+  s_png_dequeued.wait(lk, [] { return s_queued_png_bytes == 0; });
+}
+
+bool ClaimPngFilename(const std::string& filename)
+{
+  std::lock_guard<std::mutex> lk(s_png_lock);
+  if (!s_claimed_png_filenames.insert(filename).second)
+    return false;
+
+  return !File::Exists(filename);
+}
+
+void FlushQueuedPngs()
+{
+  std::unique_ptr<Common::WorkerPool> workers;
+  {
+    std::lock_guard<std::mutex> lk(s_png_lock);
+    workers = std::move(s_png_workers);
+    s_claimed_png_filenames.clear();
+  }
+
+  if (workers)
+    workers->WaitForIdle();
+}
@@ -4,9 +4,26 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
+#include <vector>
 #include "Common/CommonTypes.h"
 
 bool SaveData(const std::string& filename, const std::string& data);
+// A compression level of -1 uses the zlib default
 bool TextureToPng(const u8* data, int row_stride, const std::string& filename, int width,
-                  int height, bool saveAlpha = true);
+                  int height, bool saveAlpha = true, int compression_level = -1);
+
+// Encodes the image with TextureToPng on a pool of background threads. Blocks while too much image
+// data is waiting to be encoded. If release is set, it's called with the data on the encoding
+// thread once the image is written, so that the buffer can be reused.
+void QueueTextureToPng(std::vector<u8> data, int row_stride, const std::string& filename,
+                       int width, int height, bool save_alpha, int compression_level,
+                       std::function<void(std::vector<u8>)> release = {});
+// Waits for all queued images to be written.
+void WaitForQueuedPngs();
+// Returns true the first time it's called for a file that doesn't exist yet, so that images which
+// are generated repeatedly, like dumped textures, are only read back and encoded once.
+bool ClaimPngFilename(const std::string& filename);
+// Waits for all queued images to be written, and forgets the claimed file names.
+void FlushQueuedPngs();
@@ -9,13 +9,17 @@
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
+#include "Core/ARBruteForcer.h"
+#include "Core/Core.h"
 #include "Core/Host.h"
 #include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/EFBPeekCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
+#include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -23,6 +27,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -30,6 +35,8 @@
 #include "VideoCommon/VideoState.h"
 
 static Common::Flag s_FifoShuttingDown;
+// Only used on the CPU thread
+static EFBPeekCache s_efb_peek_cache;
 
 static volatile struct
 {
@@ -79,6 +86,9 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
 
   if (type == EFBAccessType::PokeColor || type == EFBAccessType::PokeZ)
   {
+    // The poke is applied later, but following peeks must not see the old value
+    EFBPeekCache::Invalidate();
+
     AsyncRequests::Event e;
     e.type = type == EFBAccessType::PokeColor ? AsyncRequests::Event::EFB_POKE_COLOR :
                                                 AsyncRequests::Event::EFB_POKE_Z;
@@ -89,10 +99,28 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
     AsyncRequests::GetInstance()->PushEvent(e, false);
     return 0;
   }
+  else if (g_ActiveConfig.backend_info.bSupportsCachedEFBPeeks &&
+           g_ActiveConfig.iEFBPeekTileSize > 0)
+  {
+    s_efb_peek_cache.SetTileSize(g_ActiveConfig.iEFBPeekTileSize);
+    return s_efb_peek_cache.Peek(type, x, y, [](EFBAccessType tile_type, const EFBRectangle& rect,
+                                                u32* values) {
+      AsyncRequests::Event e;
+      e.type = tile_type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR_TILE :
+                                                       AsyncRequests::Event::EFB_PEEK_Z_TILE;
+      e.time = 0;
+      e.efb_peek_tile.x = rect.left;
+      e.efb_peek_tile.y = rect.top;
+      e.efb_peek_tile.width = rect.GetWidth();
+      e.efb_peek_tile.height = rect.GetHeight();
+      e.efb_peek_tile.data = values;
+      return AsyncRequests::GetInstance()->PushEvent(e, true);
+    });
+  }
   else
   {
     AsyncRequests::Event e;
-    u32 result;
+    u32 result = 0;
     e.type = type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR :
                                                 AsyncRequests::Event::EFB_PEEK_Z;
     e.time = 0;
@@ -210,6 +238,7 @@ void VideoBackendBase::ShutdownShared()
   m_initialized = false;
 
   Fifo::Shutdown();
+  FlushQueuedPngs();
 }
 
 void VideoBackendBase::CleanupShared()
@@ -229,6 +258,15 @@ void VideoBackendBase::DoState(PointerWrap& p)
     p.SetMode(PointerWrap::MODE_VERIFY);
   }
 
+  // A brute forced code can fault while the video backend is shut down. Abort before any video
+  // state is loaded, so the rollback never sees a partially loaded state.
+  if (ARBruteForcer::ch_bruteforce && (!Fifo::IsInitialized() || !g_vertex_manager))
+  {
+    Core::KillDolphinAndRestart();
+    p.SetMode(PointerWrap::MODE_VERIFY);
+    return;
+  }
+
   VideoCommon_DoState(p);
   p.DoMarker("VideoCommon");
 
@@ -239,6 +277,7 @@ void VideoBackendBase::DoState(PointerWrap& p)
   if (p.GetMode() == PointerWrap::MODE_READ)
   {
     m_invalid = true;
+    EFBPeekCache::Invalidate();
 
     // Clear all caches that touch RAM
     // (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
@@ -15,12 +15,16 @@
 // when they are called. The reason is that the vertex format affects the sizes of the vertices.
 
 #include "VideoCommon/OpcodeDecoding.h"
+#include <chrono>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/Trace.h"
 #include "Core/ARBruteForcer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/FifoPlayer/FifoBenchmark.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/BPMemory.h"
@@ -28,6 +32,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/OpcodeReplay.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VR.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -96,14 +101,14 @@ void Shutdown()
   {
     g_opcode_replay_frame = false;
     g_opcode_replay_log_frame = false;
-    timewarp_logentries.clear();
-    timewarp_logentries.resize(0);
   }
+  OpcodeReplay::Shutdown();
 }
 
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
 {
+  Common::Trace::ScopedZone trace_zone("OpcodeDecoder::Run");
   u32 totalCycles = 0;
   u8* opcodeStart;
 
@@ -121,34 +126,12 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
   //		);
   //}
 
-  if (g_opcode_replay_log_frame && !g_opcode_replay_frame && !recursive_call &&
-      (skipped_opcode_replay_count >= (int)g_ActiveConfig.iExtraVideoLoopsDivider))
-  {
-    timewarp_logentries.push_back(TimewarpLogEntry{src, is_preprocess});
+  // Commands in display lists are recorded inline, as they are decoded
+  const bool record = !is_preprocess && OpcodeReplay::IsRecording();
 
-    if (in_display_list)
-    {
-      PanicAlert("A display list call was recorded in the opcode replay buffer!");
-    }
-
-    // s_pCurBufferPointer_log.push_back(VertexManager::s_pCurBufferPointer);
-    // s_pEndBufferPointer_log.push_back(VertexManager::s_pEndBufferPointer);
-    // s_pBaseBufferPointer_log.push_back(VertexManager::s_pBaseBufferPointer);
-
-    // if (CPBase_log.size() < 1)
-    //{
-    // SCPFifoStruct &fifo = CommandProcessor::fifo;
-
-    // CPBase_log.push_back((u32)fifo.CPBase);
-    // CPEnd_log.push_back((u32)fifo.CPEnd);
-    // CPHiWatermark_log.push_back(fifo.CPHiWatermark);
-    // CPLoWatermark_log.push_back(fifo.CPLoWatermark);
-    // CPReadWriteDistance_log.push_back((u32)fifo.CPReadWriteDistance);
-    // CPWritePointer_log.push_back((u32)fifo.CPWritePointer);
-    // CPReadPointer_log.push_back((u32)fifo.CPReadPointer);
-    // CPBreakpoint_log.push_back((u32)fifo.CPBreakpoint);
-    //}
-  }
+  // Display lists are part of the command that calls them
+  const bool benchmark = !is_preprocess && !in_display_list && FifoBenchmark::IsActive();
+  FifoBenchmark::DecodeScope benchmark_scope(benchmark);
 
   while (true)
   {
@@ -178,6 +161,10 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
       u8 sub_cmd = src.Read<u8>();
       u32 value = src.Read<u32>();
       LoadCPReg(sub_cmd, value, is_preprocess);
+      if (record)
+        OpcodeReplay::RecordCPReg(sub_cmd, value);
+      if (benchmark)
+        FifoBenchmark::OnRegisterLoad();
       if (!is_preprocess)
         INCSTAT(stats.thisFrame.numCPLoads);
     }
@@ -196,6 +183,10 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
       {
         u32 xf_address = Cmd2 & 0xFFFF;
         LoadXFReg(transfer_size, xf_address, src);
+        if (record)
+          OpcodeReplay::RecordXFReg(xf_address, transfer_size, src.GetPointer());
+        if (benchmark)
+          FifoBenchmark::OnRegisterLoad();
 
         INCSTAT(stats.thisFrame.numXFLoads);
       }
@@ -220,9 +211,18 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
         goto end;
       totalCycles += 6;
       if (is_preprocess)
+      {
         PreprocessIndexedXF(src.Read<u32>(), refarray);
+      }
       else
-        LoadIndexedXF(src.Read<u32>(), refarray);
+      {
+        u32 value = src.Read<u32>();
+        LoadIndexedXF(value, refarray);
+        if (record)
+          OpcodeReplay::RecordIndexedXF(value);
+      }
+      if (benchmark)
+        FifoBenchmark::OnRegisterLoad();
       break;
 
     case GX_CMD_CALL_DL:
@@ -273,7 +273,11 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
         else
         {
           LoadBPReg(bp_cmd);
+          if (record)
+            OpcodeReplay::RecordBPReg(bp_cmd);
           INCSTAT(stats.thisFrame.numBPLoads);
+          if (benchmark)
+            FifoBenchmark::OnRegisterLoad();
         }
       }
       break;
@@ -286,6 +290,14 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
         if (src.size() < 2)
           goto end;
         u16 num_vertices = src.Read<u16>();
+
+        std::chrono::steady_clock::time_point vertex_load_start;
+        if (benchmark)
+        {
+          FifoBenchmark::OnPrimitive();
+          vertex_load_start = std::chrono::steady_clock::now();
+        }
+
         int bytes = VertexLoaderManager::RunVertices(
             cmd_byte & GX_VAT_MASK,  // Vertex loader index (0 - 7)
             (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src,
@@ -294,6 +306,15 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list, bool recursive_call)
         if (bytes < 0)
           goto end;
 
+        if (benchmark)
+        {
+          FifoBenchmark::AddVertexLoadTime(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - vertex_load_start)
+                  .count(),
+              num_vertices);
+        }
+
         src.Skip(bytes);
 
         // 4 GPU ticks per vertex, 3 CPU ticks per GPU tick
@@ -0,0 +1,186 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/OpcodeReplay.h"
+
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/Fifo.h"
+#include "VideoCommon/VR.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace OpcodeReplay
+{
+namespace
+{
+enum class CommandType : u8
+{
+  CPReg,
+  XFReg,
+  BPReg,
+  Draw
+};
+
+struct Command
+{
+  CommandType type;
+  u8 sub_cmd;
+  u16 size;
+  // The register value, the XF address or the BP command
+  u32 value;
+  // Index into s_xf_data or s_draws
+  u32 index;
+};
+
+struct Draw
+{
+  NativeVertexFormat* format;
+  u32 components;
+  u32 stride;
+  u32 count;
+  int primitive;
+  size_t vertex_offset;
+  // The zfreeze reference slope is calculated from the last vertices of the draw
+  float position_cache[3][4];
+  u32 position_matrix_index[4];
+};
+
+std::vector<Command> s_commands;
+std::vector<u32> s_xf_data;
+std::vector<Draw> s_draws;
+std::vector<u8> s_vertex_data;
+}  // Anonymous namespace
+
+bool IsRecording()
+{
+  return g_opcode_replay_log_frame && !g_opcode_replay_frame &&
+         skipped_opcode_replay_count >= static_cast<int>(g_ActiveConfig.iExtraVideoLoopsDivider);
+}
+
+void RecordCPReg(u8 sub_cmd, u32 value)
+{
+  s_commands.push_back({CommandType::CPReg, sub_cmd, 0, value, 0});
+}
+
+void RecordXFReg(u32 address, u32 transfer_size, const u8* data)
+{
+  const size_t index = s_xf_data.size();
+  s_xf_data.resize(index + transfer_size);
+  std::memcpy(&s_xf_data[index], data, transfer_size * sizeof(u32));
+  s_commands.push_back({CommandType::XFReg, 0, static_cast<u16>(transfer_size), address,
+                        static_cast<u32>(index)});
+}
+
+void RecordIndexedXF(u32 val)
+{
+  const u32 address = val & 0xFFF;
+  const u32 size = ((val >> 12) & 0xF) + 1;
+
+  // Replayed like a normal XF load, so the data is stored big endian
+  const u32* xf_data = reinterpret_cast<const u32*>(&xfmem) + address;
+  const size_t index = s_xf_data.size();
+  for (u32 i = 0; i < size; ++i)
+    s_xf_data.push_back(Common::swap32(xf_data[i]));
+  s_commands.push_back(
+      {CommandType::XFReg, 0, static_cast<u16>(size), address, static_cast<u32>(index)});
+}
+
+void RecordBPReg(u32 bp_cmd)
+{
+  // Tokens and draw done signal the CPU, which must only happen once per real frame
+  switch (bp_cmd >> 24)
+  {
+  case BPMEM_SETDRAWDONE:
+  case BPMEM_PE_TOKEN_ID:
+  case BPMEM_PE_TOKEN_INT_ID:
+    return;
+  }
+
+  s_commands.push_back({CommandType::BPReg, 0, 0, bp_cmd, 0});
+}
+
+void RecordDraw(int primitive, u32 count, NativeVertexFormat* format, u32 components, u32 stride,
+                const u8* vertices)
+{
+  Draw draw;
+  draw.format = format;
+  draw.components = components;
+  draw.stride = stride;
+  draw.count = count;
+  draw.primitive = primitive;
+  draw.vertex_offset = s_vertex_data.size();
+  std::memcpy(draw.position_cache, VertexLoaderManager::position_cache,
+              sizeof(draw.position_cache));
+  std::memcpy(draw.position_matrix_index, VertexLoaderManager::position_matrix_index,
+              sizeof(draw.position_matrix_index));
+
+  s_vertex_data.insert(s_vertex_data.end(), vertices, vertices + count * stride);
+  s_commands.push_back({CommandType::Draw, 0, 0, 0, static_cast<u32>(s_draws.size())});
+  s_draws.push_back(draw);
+}
+
+void Replay()
+{
+  for (const Command& command : s_commands)
+  {
+    switch (command.type)
+    {
+    case CommandType::CPReg:
+      LoadCPReg(command.sub_cmd, command.value, false);
+      break;
+
+    case CommandType::XFReg:
+    {
+      u8* data = reinterpret_cast<u8*>(&s_xf_data[command.index]);
+      LoadXFReg(command.size, command.value, DataReader(data, data + command.size * sizeof(u32)));
+      break;
+    }
+
+    case CommandType::BPReg:
+      LoadBPReg(command.value);
+      break;
+
+    case CommandType::Draw:
+    {
+      if (Fifo::WillSkipCurrentFrame())
+        break;
+
+      const Draw& draw = s_draws[command.index];
+      std::memcpy(VertexLoaderManager::position_cache, draw.position_cache,
+                  sizeof(draw.position_cache));
+      std::memcpy(VertexLoaderManager::position_matrix_index, draw.position_matrix_index,
+                  sizeof(draw.position_matrix_index));
+      VertexLoaderManager::SubmitVertices(draw.primitive, draw.count, draw.format,
+                                          draw.components, draw.stride,
+                                          s_vertex_data.data() + draw.vertex_offset);
+      break;
+    }
+    }
+  }
+}
+
+void Clear()
+{
+  s_commands.clear();
+  s_xf_data.clear();
+  s_draws.clear();
+  s_vertex_data.clear();
+}
+
+void Shutdown()
+{
+  s_commands = {};
+  s_xf_data = {};
+  s_draws = {};
+  s_vertex_data = {};
+}
+}  // namespace OpcodeReplay
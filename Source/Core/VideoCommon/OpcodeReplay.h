@@ -0,0 +1,39 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class NativeVertexFormat;
+
+// The opcode replay buffer draws a frame again with new head tracking, to fill the refresh rate
+// of the HMD when the game runs slower.
+//
+// Instead of keeping the FIFO data of a frame and decoding it again, the GPU thread records the
+// commands of the frame as they are decoded: register loads with their data, display lists
+// inlined, and draws with their vertices already converted to the native vertex format. Replaying
+// a frame applies the register loads again and submits the converted vertices directly to the
+// vertex manager, without parsing the FIFO, running vertex loaders or matching hide object codes.
+namespace OpcodeReplay
+{
+// True while the commands that are decoded on the GPU thread should be recorded
+bool IsRecording();
+
+void RecordCPReg(u8 sub_cmd, u32 value);
+// The data of XF loads is big endian, as in the FIFO
+void RecordXFReg(u32 address, u32 transfer_size, const u8* data);
+// Records the XF memory that an indexed load has just written
+void RecordIndexedXF(u32 val);
+void RecordBPReg(u32 bp_cmd);
+void RecordDraw(int primitive, u32 count, NativeVertexFormat* format, u32 components, u32 stride,
+                const u8* vertices);
+
+// Applies the recorded commands again. g_opcode_replay_frame must be set.
+void Replay();
+// Discards the recorded commands, but keeps the memory for the next frame
+void Clear();
+// Frees the recorded commands. The native vertex formats they point to are about to be destroyed.
+void Shutdown();
+}  // namespace OpcodeReplay
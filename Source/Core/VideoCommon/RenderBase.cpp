@@ -19,8 +19,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -40,6 +42,7 @@
 #include "Common/Timer.h"
 
 #include "Core/ARBruteForcer.h"
+#include "Core/Benchmark.h"
 #include "Core/Config/SYSCONFSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -56,6 +59,7 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/EFBPeekCache.h"
 #include "VideoCommon/FPSCounter.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/ImageWrite.h"
@@ -116,6 +120,9 @@ Renderer::~Renderer()
   ShutdownFrameDumping();
   if (m_frame_dump_thread.joinable())
     m_frame_dump_thread.join();
+
+  if (g_ActiveConfig.bLogRenderTimeToFile)
+    m_fps_counter.ExportHistograms(File::GetUserPath(D_LOGS_IDX) + "frame_times");
 }
 
 void Renderer::RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStride, u32 fbHeight,
@@ -375,7 +382,9 @@ void Renderer::DrawDebugText()
       }
       else
       {
-        final_cyan += StringFromFormat("FPS: %.2f", m_fps_counter.GetFPS());
+        final_cyan += StringFromFormat("FPS: %.2f (1%% low: %.1f, 0.1%% low: %.1f)",
+                                       m_fps_counter.GetFPS(), m_fps_counter.GetOnePercentLowFPS(),
+                                       m_fps_counter.GetPointOnePercentLowFPS());
       }
     }
 
@@ -788,15 +797,23 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   g_final_screen_region = rc;
   VRCalculateIRPointer();
 
+  m_skip_presentation = ShouldSkipPresentation();
+
   // TODO: merge more generic parts into VideoCommon
+  const u64 present_start_time = Common::Timer::GetTimeUs();
   SwapImpl(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma);
+  // The backends may clear or reuse the EFB for the next frame
+  EFBPeekCache::Invalidate();
 
   if (m_xfb_written && !g_opcode_replay_frame)
-    m_fps_counter.Update();
+    m_fps_counter.Update(Common::Timer::GetTimeUs() - present_start_time);
 
   frameCount++;
   GFX_DEBUGGER_PAUSE_AT(NEXT_FRAME, true);
 
+  if (!g_opcode_replay_frame)
+    Benchmark::OnFramePresented();
+
   // Begin new frame
   // Set default viewport and scissor, for the clear to work correctly
   // New frame
@@ -808,6 +825,28 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   m_xfb_written = false;
 }
 
+// While emulation is unthrottled, only every Nth frame is presented. Everything that the guest
+// can observe is still emulated, so this doesn't affect determinism.
+bool Renderer::ShouldSkipPresentation()
+{
+  const int interval = g_ActiveConfig.iFastForwardPresentInterval;
+  const bool unthrottled =
+      Core::GetIsThrottlerTempDisabled() || SConfig::GetInstance().m_EmulationSpeed <= 0.0f;
+  // HMD runtimes expect every frame that was begun to be presented
+  if (interval <= 1 || !unthrottled || IsFrameDumping() || g_opcode_replay_frame ||
+      (g_has_hmd && g_ActiveConfig.bEnableVR))
+  {
+    m_frames_since_present = 0;
+    return false;
+  }
+
+  if (++m_frames_since_present < static_cast<u32>(interval))
+    return true;
+
+  m_frames_since_present = 0;
+  return false;
+}
+
 bool Renderer::IsFrameDumping()
 {
   if (m_screenshot_request.IsSet())
@@ -825,37 +864,85 @@ void Renderer::ShutdownFrameDumping()
   if (!m_frame_dump_thread_running.IsSet())
     return;
 
-  FinishFrameData();
+  // The frames that are still queued are written before the thread exits
+  std::lock_guard<std::mutex> lk(m_frame_dump_lock);
   m_frame_dump_thread_running.Clear();
-  m_frame_dump_start.Set();
+  m_frame_dump_queued.notify_one();
 }
 
 void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state,
                              bool swap_upside_down)
 {
-  FinishFrameData();
-
-  m_frame_dump_config = FrameDumpConfig{data, w, h, stride, swap_upside_down, state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
       m_frame_dump_thread.join();
+
+    m_frame_dump_frames_written = 0;
+    m_frame_dump_frames_dropped = 0;
+    m_frame_dump_lag_us = 0;
+    m_frame_dump_max_lag_us = 0;
+    m_frame_dump_write_us = 0;
+    m_frame_dump_blocked_us = 0;
+
     m_frame_dump_thread_running.Set();
     m_frame_dump_thread = std::thread(&Renderer::RunFrameDumps, this);
   }
 
-  m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
-}
+  const bool screenshot = m_screenshot_request.TestAndClear();
+  const size_t max_queued = static_cast<size_t>(std::max(g_ActiveConfig.iFrameDumpQueueDepth, 1));
+  std::vector<u8> buffer;
+  {
+    std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+    if (m_frame_dump_queue.size() >= max_queued)
+    {
+      // Screenshots are never dropped
+      if (g_ActiveConfig.bFrameDumpDropFrames && !screenshot)
+      {
+        ++m_frame_dump_frames_dropped;
+        return;
+      }
 
-void Renderer::FinishFrameData()
-{
-  if (!m_frame_dump_frame_running)
-    return;
+      const u64 start = Common::Timer::GetTimeUs();
+      m_frame_dump_dequeued.wait(lk, [&] { return m_frame_dump_queue.size() < max_queued; });
+      m_frame_dump_blocked_us += Common::Timer::GetTimeUs() - start;
+    }
+
+    if (!m_frame_dump_free_buffers.empty())
+    {
+      buffer = std::move(m_frame_dump_free_buffers.back());
+      m_frame_dump_free_buffers.pop_back();
+    }
+  }
+
+  // Only the copy happens on this thread. Upside down frames are flipped while copying.
+  const size_t row_size = static_cast<size_t>(w) * 4;
+  buffer.resize(row_size * h);
+  for (int y = 0; y < h; ++y)
+  {
+    const int source_row = swap_upside_down ? h - 1 - y : y;
+    std::memcpy(&buffer[row_size * y], data + static_cast<ptrdiff_t>(stride) * source_row,
+                row_size);
+  }
+
+  FrameDumpConfig config{std::move(buffer),
+                         w,
+                         h,
+                         static_cast<int>(row_size),
+                         state,
+                         SConfig::GetInstance().m_DumpFrames,
+                         screenshot,
+                         Common::Timer::GetTimeUs(),
+                         g_ActiveConfig.iPNGCompressionLevel};
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+    m_frame_dump_queue.push_back(std::move(config));
+    SETSTAT(stats.frameDumpQueueSize, m_frame_dump_queue.size());
+  }
+  m_frame_dump_queued.notify_one();
 
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  SETSTAT(stats.numFrameDumpsDropped, m_frame_dump_frames_dropped.load());
+  SETSTAT_FT(stats.frameDumpLagMs, m_frame_dump_lag_us.load() / 1000.0f);
 }
 
 void Renderer::RunFrameDumps()
@@ -863,6 +950,7 @@ void Renderer::RunFrameDumps()
   Common::SetCurrentThreadName("FrameDumping");
   bool dump_to_avi = !g_ActiveConfig.bDumpFramesAsImages;
   bool frame_dump_started = false;
+  bool frame_dump_failed = false;
 
 // If Dolphin was compiled without libav, we only support dumping to images.
 #if !defined(HAVE_FFMPEG)
@@ -876,25 +964,29 @@ void Renderer::RunFrameDumps()
 
   while (true)
   {
-    m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
-      break;
-
-    auto config = m_frame_dump_config;
-
-    if (config.upside_down)
+    FrameDumpConfig config;
     {
-      config.data = config.data + (config.height - 1) * config.stride;
-      config.stride = -config.stride;
+      std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_queued.wait(lk, [this] {
+        return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+      });
+      if (m_frame_dump_queue.empty())
+        break;
+
+      config = std::move(m_frame_dump_queue.front());
+      m_frame_dump_queue.pop_front();
     }
+    m_frame_dump_dequeued.notify_one();
+
+    const u64 write_start = Common::Timer::GetTimeUs();
 
     // Save screenshot
-    if (m_screenshot_request.TestAndClear())
+    if (config.screenshot)
     {
       std::lock_guard<std::mutex> lk(m_screenshot_lock);
 
-      if (TextureToPng(config.data, config.stride, m_screenshot_name, config.width, config.height,
-                       false))
+      if (TextureToPng(config.data.data(), config.stride, m_screenshot_name, config.width,
+                       config.height, false))
         OSD::AddMessage("Screenshot saved to " + m_screenshot_name);
 
       // Reset settings
@@ -902,7 +994,8 @@ void Renderer::RunFrameDumps()
       m_screenshot_completed.Set();
     }
 
-    if (SConfig::GetInstance().m_DumpFrames)
+    // The frames that were queued before frame dumping was stopped are still written
+    if (config.dump && !frame_dump_failed)
     {
       if (!frame_dump_started)
       {
@@ -913,7 +1006,10 @@ void Renderer::RunFrameDumps()
 
         // Stop frame dumping if we fail to start.
         if (!frame_dump_started)
+        {
           SConfig::GetInstance().m_DumpFrames = false;
+          frame_dump_failed = true;
+        }
       }
 
       // If we failed to start frame dumping, don't write a frame.
@@ -926,14 +1022,41 @@ void Renderer::RunFrameDumps()
       }
     }
 
-    m_frame_dump_done.Set();
+    const u64 now = Common::Timer::GetTimeUs();
+    const u64 lag = now - config.queue_time_us;
+    m_frame_dump_write_us += now - write_start;
+    m_frame_dump_lag_us = lag;
+    if (lag > m_frame_dump_max_lag_us)
+      m_frame_dump_max_lag_us = lag;
+    ++m_frame_dump_frames_written;
+
+    // Images that are still being encoded give their buffer back later
+    if (!config.data.empty())
+    {
+      std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_free_buffers.push_back(std::move(config.data));
+    }
   }
 
+  // The encoding threads must not return buffers once the renderer can be destroyed
+  if (frame_dump_started && !dump_to_avi)
+    WaitForQueuedPngs();
+
+  std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+  m_frame_dump_free_buffers.clear();
+
   if (frame_dump_started)
   {
     // No additional cleanup is needed when dumping to images.
     if (dump_to_avi)
       StopFrameDumpToAVI();
+
+    const u32 written = m_frame_dump_frames_written;
+    NOTICE_LOG(VIDEO, "Frame dumping: %u frames written (%.2f ms each), %u dropped, %.1f ms lag "
+                      "at most, %.1f ms spent waiting for the queue",
+               written, written ? m_frame_dump_write_us / 1000.0 / written : 0.0,
+               m_frame_dump_frames_dropped.load(), m_frame_dump_max_lag_us / 1000.0,
+               m_frame_dump_blocked_us / 1000.0);
   }
 }
 
@@ -946,7 +1069,7 @@ bool Renderer::StartFrameDumpToAVI(const FrameDumpConfig& config)
 
 void Renderer::DumpFrameToAVI(const FrameDumpConfig& config)
 {
-  AVIDump::AddFrame(config.data, config.width, config.height, config.stride, config.state);
+  AVIDump::AddFrame(config.data.data(), config.width, config.height, config.stride, config.state);
 }
 
 void Renderer::StopFrameDumpToAVI()
@@ -996,10 +1119,15 @@ bool Renderer::StartFrameDumpToImage(const FrameDumpConfig& config)
   return true;
 }
 
-void Renderer::DumpFrameToImage(const FrameDumpConfig& config)
+void Renderer::DumpFrameToImage(FrameDumpConfig& config)
 {
   std::string filename = GetFrameDumpNextImageFileName();
-  TextureToPng(config.data, config.stride, filename, config.width, config.height, false);
+  // The buffer is given back to the frame dump once the image is written
+  QueueTextureToPng(std::move(config.data), config.stride, filename, config.width, config.height,
+                    false, config.png_compression_level, [this](std::vector<u8> buffer) {
+                      std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+                      m_frame_dump_free_buffers.push_back(std::move(buffer));
+                    });
   m_frame_dump_image_counter++;
 }
 
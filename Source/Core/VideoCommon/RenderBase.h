@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -138,6 +140,9 @@ public:
             float Gamma = 1.0f);
   virtual void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
                         const EFBRectangle& rc, u64 ticks, float Gamma = 1.0f) = 0;
+  // True if SwapImpl should finish the frame without presenting it. The frame has still been
+  // rendered, since later EFB copies and peeks depend on it.
+  bool IsPresentationSkipped() const { return m_skip_presentation; }
 
   PEControl::PixelFormat GetPrevPixelFormat() const { return m_prev_efb_format; }
   void StorePixelFormat(PEControl::PixelFormat new_format) { m_prev_efb_format = new_format; }
@@ -157,9 +162,10 @@ protected:
   void RecordVideoMemory();
 
   bool IsFrameDumping();
+  // Copies the frame into a queue that is encoded on the frame dumping thread, so the data can be
+  // reused as soon as this returns. Blocks or drops the frame when the queue is full.
   void DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state,
                      bool swap_upside_down = false);
-  void FinishFrameData();
 
   Common::Flag m_screenshot_request;
   Common::Event m_screenshot_completed;
@@ -179,6 +185,7 @@ protected:
   int m_last_efb_scale = 0;
   TargetRectangle m_target_rectangle = {};
   bool m_xfb_written = false;
+  bool m_skip_presentation = false;
 
   FPSCounter m_fps_counter;
 
@@ -196,6 +203,7 @@ protected:
 
 private:
   void RunFrameDumps();
+  bool ShouldSkipPresentation();
   void ShutdownFrameDumping();
 
   PEControl::PixelFormat m_prev_efb_format = PEControl::INVALID_FMT;
@@ -208,22 +216,44 @@ private:
   int m_last_window_request_width = 0;
   int m_last_window_request_height = 0;
 
+  // Frames since the last one that was presented in fast-forward mode
+  u32 m_frames_since_present = 0;
+
   // frame dumping
-  std::thread m_frame_dump_thread;
-  Common::Event m_frame_dump_start;
-  Common::Event m_frame_dump_done;
-  Common::Flag m_frame_dump_thread_running;
-  u32 m_frame_dump_image_counter = 0;
-  bool m_frame_dump_frame_running = false;
   struct FrameDumpConfig
   {
-    const u8* data;
+    // Top-down RGBA rows, stride bytes apart
+    std::vector<u8> data;
     int width;
     int height;
     int stride;
-    bool upside_down;
     AVIDump::Frame state;
-  } m_frame_dump_config;
+    bool dump;
+    bool screenshot;
+    u64 queue_time_us;
+    // Read here, since the frame dumping thread can't read the active config
+    int png_compression_level;
+  };
+
+  std::thread m_frame_dump_thread;
+  Common::Flag m_frame_dump_thread_running;
+  u32 m_frame_dump_image_counter = 0;
+
+  std::mutex m_frame_dump_lock;
+  std::condition_variable m_frame_dump_queued;
+  std::condition_variable m_frame_dump_dequeued;
+  std::deque<FrameDumpConfig> m_frame_dump_queue;
+  // Buffers of frames that were already written, reused to avoid reallocating every frame
+  std::vector<std::vector<u8>> m_frame_dump_free_buffers;
+
+  // Frame dump statistics, reset when the frame dumping thread starts
+  std::atomic<u32> m_frame_dump_frames_written{0};
+  std::atomic<u32> m_frame_dump_frames_dropped{0};
+  // Time between queueing the last frame and finishing writing it
+  std::atomic<u64> m_frame_dump_lag_us{0};
+  std::atomic<u64> m_frame_dump_max_lag_us{0};
+  std::atomic<u64> m_frame_dump_write_us{0};
+  u64 m_frame_dump_blocked_us = 0;
 
   // NOTE: The methods below are called on the framedumping thread.
   bool StartFrameDumpToAVI(const FrameDumpConfig& config);
@@ -231,7 +261,8 @@ private:
   void StopFrameDumpToAVI();
   std::string GetFrameDumpNextImageFileName() const;
   bool StartFrameDumpToImage(const FrameDumpConfig& config);
-  void DumpFrameToImage(const FrameDumpConfig& config);
+  // Takes the pixel data of the frame, to encode it in the background
+  void DumpFrameToImage(FrameDumpConfig& config);
 };
 
 extern std::unique_ptr<Renderer> g_renderer;
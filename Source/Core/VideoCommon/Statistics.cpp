@@ -68,6 +68,11 @@ std::string Statistics::ToString()
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
+  str += StringFromFormat("Projection cache hits: %i\n", stats.numProjectionCacheHits);
+  str += StringFromFormat("Projection cache misses: %i\n", stats.numProjectionCacheMisses);
+  str += StringFromFormat("Frame dump queue: %i, dropped: %i, lag: %.1f ms\n",
+                          stats.frameDumpQueueSize, stats.numFrameDumpsDropped,
+                          stats.frameDumpLagMs);
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
 
@@ -19,6 +19,15 @@ struct Statistics
 
   int numVertexLoaders;
 
+  int numProjectionCacheHits;
+  int numProjectionCacheMisses;
+
+  // Frames copied but not yet encoded, frames dropped because the queue was full, and the time
+  // between copying the last written frame and finishing writing it
+  int frameDumpQueueSize;
+  int numFrameDumpsDropped;
+  float frameDumpLagMs;
+
   float proj_0, proj_1, proj_2, proj_3, proj_4, proj_5;
   float gproj_0, gproj_1, gproj_2, gproj_3, gproj_4, gproj_5;
   float gproj_6, gproj_7, gproj_8, gproj_9, gproj_10, gproj_11, gproj_12, gproj_13, gproj_14,
@@ -18,8 +18,10 @@
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FifoPlayer/FifoBenchmark.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
@@ -28,6 +30,7 @@
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
 #include "VideoCommon/Statistics.h"
@@ -437,10 +440,6 @@ void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, uns
 {
   std::string szDir = File::GetUserPath(D_DUMPTEXTURES_IDX) + SConfig::GetInstance().GetGameID();
 
-  // make sure that the directory exists
-  if (!File::IsDirectory(szDir))
-    File::CreateDir(szDir);
-
   if (is_arbitrary)
   {
     basename += "_arb";
@@ -453,8 +452,15 @@ void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, uns
 
   std::string filename = szDir + "/" + basename + ".png";
 
-  if (!File::Exists(filename))
-    entry->texture->Save(filename, level);
+  // Textures are loaded again and again, so skip the readback for ones already dumped or queued
+  if (!ClaimPngFilename(filename))
+    return;
+
+  // make sure that the directory exists
+  if (!File::IsDirectory(szDir))
+    File::CreateDir(szDir);
+
+  entry->texture->Save(filename, level);
 }
 
 static u32 CalculateLevelSize(u32 level_0_size, u32 level)
@@ -622,6 +628,8 @@ private:
 
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
+  FifoBenchmark::ScopedTextureLoadTimer benchmark_timer;
+
   // if this stage was not invalidated by changes to texture registers, keep the current texture
   if (IsValidBindPoint(stage) && bound_textures[stage])
   {
@@ -889,6 +897,9 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
     InvalidateTexture(oldest_entry);
   }
 
+  // Everything from here on loads a texture which isn't in the cache
+  Common::Trace::ScopedZone trace_zone("Texture load");
+
   std::shared_ptr<HiresTexture> hires_tex;
   if (g_ActiveConfig.bHiresTextures)
   {
@@ -19,10 +19,11 @@
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/WiimoteEmu/HydraTLayer.h"
-#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/OpcodeReplay.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/VR.h"
 #include "VideoCommon/VROculus.h"
+#include "VideoCommon/VRSimulated.h"
 
 const char* scm_vr_sdk_str = SCM_OCULUS_STR;
 
@@ -112,8 +113,9 @@ bool g_vr_needs_endframe = false;
 
 bool g_vr_should_swap_buffers = true, g_vr_dont_vsync = false;
 
-bool g_force_vr = false, g_prefer_openvr = false, g_one_hmd = false;
+bool g_force_vr = false, g_prefer_openvr = false, g_one_hmd = false, g_simulate_hmd = false;
 bool g_has_hmd = false, g_has_two_hmds = false, g_has_rift = false, g_has_vr920 = false, g_has_openvr = false, g_openvr_is_vive = true, g_openvr_is_rift = false;
+bool g_has_simulated_hmd = false;
 bool g_is_direct_mode = false, g_is_nes = false;
 bool g_new_tracking_frame = true;
 bool g_new_frame_tracker_for_efb_skip = true;
@@ -146,8 +148,6 @@ float g_vr_ir_x = 0, g_vr_ir_y = 0, g_vr_ir_z = 0;
 
 ControllerStyle vr_left_controller = CS_HYDRA_LEFT, vr_right_controller = CS_HYDRA_RIGHT;
 
-std::vector<TimewarpLogEntry> timewarp_logentries;
-
 bool g_opcode_replay_enabled = false;
 bool g_new_frame_just_rendered = false;
 bool g_first_pass = true;
@@ -628,6 +628,30 @@ bool InitVR920VR()
   return false;
 }
 
+bool InitSimulatedVR()
+{
+  if (!VRSimulated::Init())
+    return false;
+
+  const VRSimulated::Settings& settings = VRSimulated::GetSettings();
+  g_has_simulated_hmd = true;
+  g_has_hmd = true;
+  g_hmd_device_name = "Simulated HMD";
+  // There is no display to put a window on
+  g_hmd_window_width = 0;
+  g_hmd_window_height = 0;
+  g_hmd_refresh_rate = settings.refresh_rate;
+  g_vr_must_motion_blur = false;
+  g_vr_has_dynamic_predict = false;
+  g_vr_has_configure_rendering = false;
+  g_vr_has_configure_tracking = false;
+  g_vr_has_hq_distortion = false;
+  g_vr_should_swap_buffers = true;
+  g_vr_has_timewarp_tweak = false;
+  g_vr_has_asynchronous_timewarp = false;
+  return true;
+}
+
 void VR_Init()
 {
   g_has_hmd = false;
@@ -635,11 +659,17 @@ void VR_Init()
   g_hmd_device_name = nullptr;
   g_has_openvr = false;
   g_has_rift = false;
+  g_has_simulated_hmd = false;
 #ifdef _WIN32
   g_hmd_luid = nullptr;
 #endif
 
-  if (g_prefer_openvr)
+  if (g_simulate_hmd)
+  {
+    // Real HMDs are ignored, so that runs only depend on the simulated one
+    InitSimulatedVR();
+  }
+  else if (g_prefer_openvr)
   {
     InitOpenVR();
     if (!(g_has_openvr && g_one_hmd))
@@ -711,6 +741,12 @@ void VR_StopRendering()
 
 void VR_Shutdown()
 {
+  if (g_has_simulated_hmd)
+  {
+    VRSimulated::Shutdown();
+    g_has_simulated_hmd = false;
+    g_has_hmd = false;
+  }
 #ifdef HAVE_OPENVR
   if (g_has_openvr && m_pHMD)
   {
@@ -729,6 +765,7 @@ void VR_Shutdown()
       ovrHmd_SetEnabledCaps(hmd, ovrHmdCap_DisplayOff);
 #endif
     ovrHmd_Destroy(hmd);
+    hmd = nullptr;
     g_has_rift = false;
     g_has_hmd = false;
     g_is_direct_mode = false;
@@ -1041,11 +1078,27 @@ void UpdateVuzixHeadTracking()
 }
 #endif
 
+void UpdateSimulatedHeadTracking()
+{
+  const VRSimulated::Pose pose = VRSimulated::GetNextPose();
+  Matrix33 m, yp, yawm, pitchm, rollm;
+  Matrix33::RotateY(yawm, DEGREES_TO_RADIANS(pose.yaw));
+  Matrix33::RotateX(pitchm, DEGREES_TO_RADIANS(pose.pitch));
+  Matrix33::Multiply(pitchm, yawm, yp);
+  Matrix33::RotateZ(rollm, DEGREES_TO_RADIANS(pose.roll));
+  Matrix33::Multiply(rollm, yp, m);
+  Matrix44::LoadMatrix33(g_head_tracking_matrix, m);
+  for (int i = 0; i < 3; ++i)
+    g_head_tracking_position[i] = -pose.position[i];
+}
+
 void VR_UpdateHeadTrackingIfNeeded()
 {
   if (g_new_tracking_frame)
   {
     g_new_tracking_frame = false;
+    if (g_has_simulated_hmd)
+      UpdateSimulatedHeadTracking();
 #ifdef _WIN32
     if (g_has_vr920 && Vuzix_GetTracking)
       UpdateVuzixHeadTracking();
@@ -1078,7 +1131,11 @@ void VR_GetProjectionHalfTan(float& hmd_halftan)
   }
   else
 #endif
-      if (g_has_openvr)
+      if (g_has_simulated_hmd)
+  {
+    hmd_halftan = tan(DEGREES_TO_RADIANS(VRSimulated::GetSettings().fov / 2));
+  }
+  else if (g_has_openvr)
   {
     // rough approximation, can't be bothered to work this out properly
     hmd_halftan = tan(DEGREES_TO_RADIANS(100.0f / 2));
@@ -1132,6 +1189,19 @@ void VR_GetProjectionMatrices(Matrix44& left_eye, Matrix44& right_eye, float zne
   }
   else
 #endif
+      if (g_has_simulated_hmd)
+  {
+    Matrix44::LoadIdentity(left_eye);
+    left_eye.data[10] = -znear / (zfar - znear);
+    left_eye.data[11] = -zfar * znear / (zfar - znear);
+    left_eye.data[14] = -1.0f;
+    left_eye.data[15] = 0.0f;
+    // Symmetric, with the same FOV horizontally and vertically
+    left_eye.data[0 * 4 + 0] = 1.0f / tan(DEGREES_TO_RADIANS(VRSimulated::GetSettings().fov / 2));
+    left_eye.data[1 * 4 + 1] = left_eye.data[0 * 4 + 0];
+    Matrix44::Set(right_eye, left_eye.data);
+  }
+  else
   {
     Matrix44::LoadIdentity(left_eye);
     left_eye.data[10] = -znear / (zfar - znear);
@@ -1192,6 +1262,14 @@ void VR_GetEyePos(float* posLeft, float* posRight)
   }
   else
 #endif
+      if (g_has_simulated_hmd)
+  {
+    posLeft[0] = VRSimulated::GetSettings().ipd / 2;
+    posRight[0] = -posLeft[0];
+    posLeft[1] = posRight[1] = 0;
+    posLeft[2] = posRight[2] = 0;
+  }
+  else
   {
     // assume 64mm IPD
     posLeft[0] = 0.032f;
@@ -1203,6 +1281,12 @@ void VR_GetEyePos(float* posLeft, float* posRight)
 
 void VR_GetFovTextureSize(int* width, int* height)
 {
+  if (g_has_simulated_hmd)
+  {
+    *width = VRSimulated::GetSettings().texture_width;
+    *height = VRSimulated::GetSettings().texture_height;
+    return;
+  }
 #if defined(OVR_MAJOR_VERSION)
   if (g_has_rift)
   {
@@ -2369,35 +2453,7 @@ void OpcodeReplayBuffer()
         ++extra_video_loops_count;
         skipped_opcode_replay_count = 0;
 
-        for (TimewarpLogEntry& entry : timewarp_logentries)
-        {
-          // VertexManager::s_pCurBufferPointer = s_pCurBufferPointer_log.at(i);
-          // VertexManager::s_pEndBufferPointer = s_pEndBufferPointer_log.at(i);
-          // VertexManager::s_pBaseBufferPointer = s_pBaseBufferPointer_log.at(i);
-
-          // if (i == 0)
-          //{
-          // SCPFifoStruct &fifo = CommandProcessor::fifo;
-
-          // fifo.CPBase = CPBase_log.at(i);
-          // fifo.CPEnd = CPEnd_log.at(i);
-          // fifo.CPHiWatermark = CPHiWatermark_log.at(i);
-          // fifo.CPLoWatermark = CPLoWatermark_log.at(i);
-          // fifo.CPReadWriteDistance = CPReadWriteDistance_log.at(i);
-          // fifo.CPWritePointer = CPWritePointer_log.at(i);
-          // fifo.CPReadPointer = CPReadPointer_log.at(i);
-          // fifo.CPBreakpoint = CPBreakpoint_log.at(i);
-          //}
-
-          if (entry.is_preprocess_log)
-          {
-            OpcodeDecoder::Run<true>(entry.timewarp_log, nullptr, false);
-          }
-          else
-          {
-            OpcodeDecoder::Run<false>(entry.timewarp_log, nullptr, false);
-          }
-        }
+        OpcodeReplay::Replay();
       }
       else
       {
@@ -2425,17 +2481,13 @@ void OpcodeReplayBuffer()
       // s_pEndBufferPointer_log.resize(0);
       // s_pBaseBufferPointer_log.clear();
       // s_pBaseBufferPointer_log.resize(0);
-      timewarp_logentries.clear();
-      timewarp_logentries.resize(0);
+      OpcodeReplay::Clear();
     }
   }
   else
   {
     if (g_opcode_replay_enabled)
-    {
-      timewarp_logentries.clear();
-      timewarp_logentries.resize(0);
-    }
+      OpcodeReplay::Clear();
     g_opcode_replay_enabled = false;
     g_opcode_replay_log_frame = false;
   }
@@ -2568,30 +2620,14 @@ void OpcodeReplayBufferInline()
     skipped_opcode_replay_count = 0;
 
     for (int num_extra_frames = 0; num_extra_frames < extra_video_loops; ++num_extra_frames)
-    {
-      for (TimewarpLogEntry& entry : timewarp_logentries)
-      {
-        if (entry.is_preprocess_log)
-        {
-          OpcodeDecoder::Run<true>(entry.timewarp_log, nullptr, false);
-        }
-        else
-        {
-          OpcodeDecoder::Run<false>(entry.timewarp_log, nullptr, false);
-        }
-      }
-    }
-    timewarp_logentries.clear();
-    timewarp_logentries.resize(0);
+      OpcodeReplay::Replay();
+    OpcodeReplay::Clear();
     g_opcode_replay_frame = false;
   }
   else
   {
     if (g_opcode_replay_enabled)
-    {
-      timewarp_logentries.clear();
-      timewarp_logentries.resize(0);
-    }
+      OpcodeReplay::Clear();
     g_opcode_replay_enabled = false;
     g_opcode_replay_log_frame = false;
   }
@@ -195,8 +195,10 @@ void OpcodeReplayBuffer();
 void OpcodeReplayBufferInline();
 
 // HMD description and capabilities
-extern bool g_force_vr, g_prefer_openvr, g_one_hmd;
+// g_simulate_hmd uses VRSimulated instead of a real HMD. Set its settings before VR_Init.
+extern bool g_force_vr, g_prefer_openvr, g_one_hmd, g_simulate_hmd;
 extern bool g_has_hmd, g_has_two_hmds, g_has_rift, g_has_vr920, g_has_openvr, g_openvr_is_vive, g_openvr_is_rift;
+extern bool g_has_simulated_hmd;
 extern bool g_is_direct_mode, g_is_nes;
 extern bool g_vr_cant_motion_blur, g_vr_must_motion_blur;
 extern bool g_vr_needs_endframe, g_vr_needs_DXGIFactory1, g_vr_can_disable_hsw,
@@ -234,12 +236,6 @@ extern bool g_vr_has_ir;
 extern float g_vr_ir_x, g_vr_ir_y, g_vr_ir_z;
 
 // Opcode Replay Buffer
-struct TimewarpLogEntry
-{
-  DataReader timewarp_log;
-  bool is_preprocess_log;
-};
-extern std::vector<TimewarpLogEntry> timewarp_logentries;
 extern bool g_opcode_replay_enabled;
 extern bool g_new_frame_just_rendered;
 extern bool g_first_pass;
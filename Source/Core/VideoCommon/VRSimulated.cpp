@@ -0,0 +1,161 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/VRSimulated.h"
+
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <sstream>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace VRSimulated
+{
+namespace
+{
+Settings s_settings;
+PoseScript s_script;
+// Number of poses returned since Init
+u64 s_pose_count = 0;
+
+constexpr double TWO_PI = 6.28318530717958647692;
+
+float Lerp(float a, float b, float t)
+{
+  return a + (b - a) * t;
+}
+
+float Wave(double time, double period, float amplitude)
+{
+  return amplitude * static_cast<float>(std::sin(TWO_PI * time / period));
+}
+}  // Anonymous namespace
+
+bool PoseScript::Load(const std::string& text)
+{
+  m_keyframes.clear();
+
+  std::istringstream stream(text);
+  stream.imbue(std::locale::classic());
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    const size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#')
+      continue;
+
+    std::istringstream line_stream(line);
+    line_stream.imbue(std::locale::classic());
+    Keyframe keyframe;
+    Pose& pose = keyframe.pose;
+    if (!(line_stream >> keyframe.time >> pose.yaw >> pose.pitch >> pose.roll >>
+          pose.position[0] >> pose.position[1] >> pose.position[2]) ||
+        keyframe.time < 0 || (!m_keyframes.empty() && keyframe.time <= m_keyframes.back().time))
+    {
+      m_keyframes.clear();
+      return false;
+    }
+    m_keyframes.push_back(keyframe);
+  }
+
+  return true;
+}
+
+bool PoseScript::LoadFile(const std::string& path)
+{
+  std::string text;
+  return File::ReadFileToString(path, text) && Load(text);
+}
+
+Pose PoseScript::GetPose(double time) const
+{
+  if (m_keyframes.empty())
+    return {};
+
+  const double duration = m_keyframes.back().time;
+  if (duration > 0)
+    time = std::fmod(time, duration);
+  if (time <= m_keyframes.front().time)
+    return m_keyframes.front().pose;
+
+  const auto next = std::upper_bound(
+      m_keyframes.begin(), m_keyframes.end(), time,
+      [](double value, const Keyframe& keyframe) { return value < keyframe.time; });
+  if (next == m_keyframes.end())
+    return m_keyframes.back().pose;
+
+  const Keyframe& previous = *(next - 1);
+  const float t = static_cast<float>((time - previous.time) / (next->time - previous.time));
+  Pose pose;
+  pose.yaw = Lerp(previous.pose.yaw, next->pose.yaw, t);
+  pose.pitch = Lerp(previous.pose.pitch, next->pose.pitch, t);
+  pose.roll = Lerp(previous.pose.roll, next->pose.roll, t);
+  for (int i = 0; i < 3; ++i)
+    pose.position[i] = Lerp(previous.pose.position[i], next->pose.position[i], t);
+  return pose;
+}
+
+Pose GetDefaultPose(double time)
+{
+  Pose pose;
+  pose.yaw = Wave(time, 8.0, 30.0f);
+  pose.pitch = Wave(time, 5.0, 10.0f);
+  pose.roll = Wave(time, 7.0, 5.0f);
+  pose.position[0] = Wave(time, 6.0, 0.05f);
+  pose.position[1] = Wave(time, 4.0, 0.02f);
+  pose.position[2] = Wave(time, 9.0, 0.03f);
+  return pose;
+}
+
+void SetSettings(const Settings& settings)
+{
+  s_settings = settings;
+}
+
+const Settings& GetSettings()
+{
+  return s_settings;
+}
+
+bool Init()
+{
+  if (s_settings.refresh_rate <= 0 || s_settings.fov <= 0 || s_settings.fov >= 180 ||
+      s_settings.texture_width <= 0 || s_settings.texture_height <= 0)
+  {
+    ERROR_LOG(VR, "Invalid simulated HMD settings");
+    return false;
+  }
+
+  if (s_settings.pose_script.empty())
+  {
+    s_script = {};
+  }
+  else if (!s_script.LoadFile(s_settings.pose_script) || s_script.IsEmpty())
+  {
+    ERROR_LOG(VR, "Could not load the simulated HMD pose script %s",
+              s_settings.pose_script.c_str());
+    return false;
+  }
+
+  s_pose_count = 0;
+  NOTICE_LOG(VR, "Simulated HMD: %d Hz, %.0f degrees FOV, %dx%d per eye%s",
+             s_settings.refresh_rate, s_settings.fov, s_settings.texture_width,
+             s_settings.texture_height, s_script.IsEmpty() ? "" : ", scripted poses");
+  return true;
+}
+
+void Shutdown()
+{
+  s_script = {};
+}
+
+Pose GetNextPose()
+{
+  const double time = static_cast<double>(s_pose_count++) / s_settings.refresh_rate;
+  return s_script.IsEmpty() ? GetDefaultPose(time) : s_script.GetPose(time);
+}
+}  // namespace VRSimulated
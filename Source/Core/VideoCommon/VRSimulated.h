@@ -0,0 +1,73 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A software stand-in for an HMD, so the VR code paths can be profiled and tested without a
+// headset. It reports a fixed field of view and render target size, and produces a deterministic
+// sequence of head poses: the pose of the Nth tracking update is the pose at N / refresh rate
+// seconds, either from a pose script or from a built-in slow head movement.
+namespace VRSimulated
+{
+struct Settings
+{
+  int refresh_rate = 90;
+  // Horizontal and vertical field of view of each eye, in degrees
+  float fov = 100.0f;
+  // Size of the render target of each eye, in pixels
+  int texture_width = 1332;
+  int texture_height = 1586;
+  float ipd = 0.064f;
+  // Text file with one keyframe per line: time in seconds, yaw, pitch and roll in degrees, and x,
+  // y and z in metres. The script loops. Empty to use the built-in head movement.
+  std::string pose_script;
+};
+
+struct Pose
+{
+  // Degrees right, degrees down and degrees anticlockwise
+  float yaw = 0;
+  float pitch = 0;
+  float roll = 0;
+  // Metres right, up and backwards from the centre
+  float position[3] = {};
+};
+
+class PoseScript final
+{
+public:
+  // Returns false if a line can't be parsed, or the times don't increase
+  bool Load(const std::string& text);
+  bool LoadFile(const std::string& path);
+
+  bool IsEmpty() const { return m_keyframes.empty(); }
+  // Interpolates linearly between the keyframes, looping after the last one
+  Pose GetPose(double time) const;
+
+private:
+  struct Keyframe
+  {
+    double time;
+    Pose pose;
+  };
+
+  std::vector<Keyframe> m_keyframes;
+};
+
+// The pose of the built-in head movement: slow, out of phase turns and sways around the centre
+Pose GetDefaultPose(double time);
+
+// Must be called before VR_Init
+void SetSettings(const Settings& settings);
+const Settings& GetSettings();
+
+bool Init();
+void Shutdown();
+
+// Returns the pose for the next refresh of the simulated display
+Pose GetNextPose();
+}  // namespace VRSimulated
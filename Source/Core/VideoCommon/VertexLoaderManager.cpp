@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -17,11 +18,13 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/HW/Memmap.h"
+#include "Core/HideObjectEngine.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/OpcodeReplay.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VR.h"
 #include "VideoCommon/VertexLoaderBase.h"
@@ -38,6 +41,10 @@ float position_cache[3][4];
 u32 position_matrix_index[4];
 
 static NativeVertexFormatMap s_native_vertex_map;
+
+// The hide object codes as last fetched by the GPU thread
+static std::shared_ptr<const HideObjectEngine::Matcher> s_hide_object_matcher;
+static u32 s_hide_object_generation = 0;
 static NativeVertexFormat* s_current_vtx_fmt;
 u32 g_current_components;
 
@@ -252,6 +259,18 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
+static void SetCurrentVertexFormat(NativeVertexFormat* format, u32 components)
+{
+  // If the native vertex format changed, force a flush.
+  if (format != s_current_vtx_fmt || components != g_current_components)
+  {
+    g_vertex_manager->Flush();
+  }
+  s_current_vtx_fmt = format;
+  g_current_components = components;
+  VertexShaderManager::SetVertexFormat(components);
+}
+
 int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool skip_drawing,
                 bool is_preprocess)
 {
@@ -301,30 +320,19 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
     return size;
 
   // Hide Objects Code code
-  if (!m_LocalCoreStartupParameter.hide_objects_updating)
+  const u32 hide_object_generation = HideObjectEngine::GetMatcherGeneration();
+  if (hide_object_generation != s_hide_object_generation)
   {
-    m_LocalCoreStartupParameter.hide_objects_done = false;
-    for (const SkipEntry& entry : m_LocalCoreStartupParameter.object_removal_codes)
-    {
-      // Set lock so codes can be enabled/disabled in game without crashes.
-      if (!memcmp(src.GetPointer(), entry.data(), entry.size()))
-      {
-        // Data didn't match, try next object_removal_code
-        return size;
-      }
-    }
+    s_hide_object_generation = hide_object_generation;
+    s_hide_object_matcher = HideObjectEngine::GetMatcher();
   }
-  m_LocalCoreStartupParameter.hide_objects_done = true;
-
-  // If the native vertex format changed, force a flush.
-  if (loader->m_native_vertex_format != s_current_vtx_fmt ||
-      loader->m_native_components != g_current_components)
+  if (s_hide_object_matcher && !s_hide_object_matcher->IsEmpty() &&
+      s_hide_object_matcher->Matches(src.GetPointer()))
   {
-    g_vertex_manager->Flush();
+    return size;
   }
-  s_current_vtx_fmt = loader->m_native_vertex_format;
-  g_current_components = loader->m_native_components;
-  VertexShaderManager::SetVertexFormat(loader->m_native_components);
+
+  SetCurrentVertexFormat(loader->m_native_vertex_format, loader->m_native_components);
 
   // if cull mode is CULL_ALL, tell VertexManager to skip triangles and quads.
   // They still need to go through vertex loading, because we need to calculate a zfreeze refrence
@@ -336,6 +344,12 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
 
   count = loader->RunVertices(src, dst, count);
 
+  if (OpcodeReplay::IsRecording())
+  {
+    OpcodeReplay::RecordDraw(primitive, count, s_current_vtx_fmt, g_current_components,
+                             loader->m_native_vtx_decl.stride, dst.GetPointer());
+  }
+
   IndexGenerator::AddIndices(primitive, count);
 
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
@@ -345,6 +359,27 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   return size;
 }
 
+void SubmitVertices(int primitive, u32 count, NativeVertexFormat* format, u32 components,
+                    u32 stride, const u8* vertices)
+{
+  if (!count)
+    return;
+
+  SetCurrentVertexFormat(format, components);
+
+  bool cullall = (bpmem.genMode.cullmode == GenMode::CULL_ALL && primitive < 5);
+
+  DataReader dst = g_vertex_manager->PrepareForAdditionalData(primitive, count, stride, cullall);
+  std::memcpy(dst.GetPointer(), vertices, count * stride);
+
+  IndexGenerator::AddIndices(primitive, count);
+
+  g_vertex_manager->FlushData(count, stride);
+
+  ADDSTAT(stats.thisFrame.numPrims, count);
+  INCSTAT(stats.thisFrame.numPrimitiveJoins);
+}
+
 NativeVertexFormat* GetCurrentVertexFormat()
 {
   return s_current_vtx_fmt;
@@ -396,9 +431,11 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
 
   case 0x90:
     if (ARBruteForcer::ch_bruteforce && (sub_cmd & 0x0F) >= 8)
+    {
       Core::KillDolphinAndRestart();
-    else
-      _assert_((sub_cmd & 0x0F) < 8);
+      break;
+    }
+    _assert_((sub_cmd & 0x0F) < 8);
     state->vtx_attr[sub_cmd & 7].g2.Hex = value;
     state->attr_dirty[sub_cmd & 7] = true;
     break;
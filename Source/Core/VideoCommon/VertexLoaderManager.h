@@ -38,6 +38,10 @@ NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool skip_drawing,
                 bool is_preprocess);
 
+// Draws vertices that have already been converted to a native vertex format
+void SubmitVertices(int primitive, u32 count, NativeVertexFormat* format, u32 components,
+                    u32 stride, const u8* vertices);
+
 // For debugging
 std::string VertexLoadersToString();
 
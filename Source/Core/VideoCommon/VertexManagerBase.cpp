@@ -14,13 +14,12 @@
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
 
-#include "Core/ARBruteForcer.h"
-#include "Core/Core.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/EFBPeekCache.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
@@ -391,6 +390,7 @@ void VertexManagerBase::Flush()
 
     if (PerfQueryBase::ShouldEmulate())
       g_perf_query->EnableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
+    EFBPeekCache::Invalidate();
     g_vertex_manager->vFlush();
     if (PerfQueryBase::ShouldEmulate())
       g_perf_query->DisableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
@@ -417,8 +417,6 @@ int VertexManagerBase::GetNumberOfVertices()
 void VertexManagerBase::DoState(PointerWrap& p)
 {
   p.Do(m_zslope);
-  if (!g_vertex_manager && ARBruteForcer::ch_bruteforce)
-    Core::KillDolphinAndRestart();
   g_vertex_manager->vDoState(p);
 }
 
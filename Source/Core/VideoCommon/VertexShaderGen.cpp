@@ -26,7 +26,11 @@ VertexShaderUid GetVertexShaderUid()
   if (ARBruteForcer::ch_bruteforce)
   {
     if (bpmem.genMode.numtexgens != xfmem.numTexGen.numTexGens || bpmem.genMode.numcolchans != xfmem.numChan.numColorChans)
+    {
+      // The counts can be out of range, so the empty shader is used until the code is rolled back
       Core::KillDolphinAndRestart();
+      return out;
+    }
   }
   else
   {
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <cfloat>
 #include <cmath>
 #include <cstring>
@@ -140,11 +142,103 @@ const char* GetViewportTypeName(ViewportType v)
   }
 }
 
+namespace
+{
+// The projection constants only depend on these values during a frame. Head tracking and the
+// configuration only change between frames, when the cache is cleared. The widest 3D projection
+// can also change during a frame, for example in the Metroid Prime layer detection.
+struct ProjectionCacheKey
+{
+  u32 projection_type;
+  u32 raw_projection[6];
+  u32 viewport[6];
+  u32 viewport_type;
+  u32 metroid_layer;
+  u32 skybox;
+  u32 flashing;
+  u32 free_look;
+  u32 view_translation[3];
+  u32 view_rotation[2];
+  u32 widest_3d[4];
+
+  bool operator==(const ProjectionCacheKey& other) const
+  {
+    return std::memcmp(this, &other, sizeof(ProjectionCacheKey)) == 0;
+  }
+};
+
+struct ProjectionCacheEntry
+{
+  ProjectionCacheKey key;
+  float projection_matrix[16];
+  std::array<float4, 4> projection;
+  float4 eye_projection[2][4];
+  float4 stereoparams;
+  bool layer_on_top;
+  bool hmd_projection;
+  // Whether this is a real 3D projection for the HMD, see s_real_3d_projection
+  bool real_3d;
+};
+
+constexpr size_t PROJECTION_CACHE_SIZE = 32;
+std::array<ProjectionCacheEntry, PROJECTION_CACHE_SIZE> s_projection_cache;
+size_t s_projection_cache_size = 0;
+size_t s_projection_cache_next = 0;
+// Set by CalculateProjectionConstants for real 3D projections for the HMD. The first of them in a
+// frame reads the game camera, so they are only taken from the cache once that has happened.
+bool s_real_3d_projection = false;
+
+template <typename T>
+u32 BitCast(T value)
+{
+  static_assert(sizeof(T) == sizeof(u32), "Cache key values must be 32 bits");
+  u32 result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+ProjectionCacheKey GetProjectionCacheKey()
+{
+  ProjectionCacheKey key;
+  key.projection_type = xfmem.projection.type;
+  for (size_t i = 0; i < ArraySize(key.raw_projection); ++i)
+    key.raw_projection[i] = BitCast(xfmem.projection.rawProjection[i]);
+  const Viewport& v = xfmem.viewport;
+  key.viewport[0] = BitCast(v.wd);
+  key.viewport[1] = BitCast(v.ht);
+  key.viewport[2] = BitCast(v.zRange);
+  key.viewport[3] = BitCast(v.xOrig);
+  key.viewport[4] = BitCast(v.yOrig);
+  key.viewport[5] = BitCast(v.farZ);
+  key.viewport_type = g_viewport_type;
+  key.metroid_layer = g_metroid_layer;
+  key.skybox = g_is_skybox;
+  key.flashing = (debug_projNum - 1) == g_ActiveConfig.iSelectedLayer;
+  key.free_look = bFreeLookChanged;
+  for (size_t i = 0; i < ArraySize(key.view_translation); ++i)
+    key.view_translation[i] = BitCast(s_fViewTranslationVector[i]);
+  for (size_t i = 0; i < ArraySize(key.view_rotation); ++i)
+    key.view_rotation[i] = BitCast(s_fViewRotation[i]);
+  key.widest_3d[0] = BitCast(vr_widest_3d_HFOV);
+  key.widest_3d[1] = BitCast(vr_widest_3d_VFOV);
+  key.widest_3d[2] = BitCast(vr_widest_3d_zNear);
+  key.widest_3d[3] = BitCast(vr_widest_3d_zFar);
+  return key;
+}
+
+void ClearProjectionCache()
+{
+  s_projection_cache_size = 0;
+  s_projection_cache_next = 0;
+}
+}  // Anonymous namespace
+
 //#pragma optimize("", off)
 
 void ClearDebugProj()
 {  // VR
   bFrameChanged = true;
+  ClearProjectionCache();
 
   debug_newScene = debug_nextScene;
   if (debug_newScene)
@@ -798,6 +892,7 @@ void VertexShaderManager::Dirty()
   // Any constants that can changed based on settings should be re-calculated
   bProjectionChanged = true;
   bFrameChanged = true;
+  ClearProjectionCache();
 
   dirty = true;
 }
@@ -1069,6 +1164,93 @@ void VertexShaderManager::SetViewportConstants()
 }
 
 void VertexShaderManager::SetProjectionConstants()
+{
+  // The layers of a new scene are logged while they are calculated
+  const bool use_cache = !debug_newScene;
+  ProjectionCacheKey key;
+  const ProjectionCacheEntry* cached = nullptr;
+  if (use_cache)
+  {
+    key = GetProjectionCacheKey();
+    for (size_t i = 0; i < s_projection_cache_size; ++i)
+    {
+      if (s_projection_cache[i].key == key &&
+          (!s_projection_cache[i].real_3d || g_vr_had_3D_already))
+      {
+        cached = &s_projection_cache[i];
+        break;
+      }
+    }
+  }
+
+  bool hmd_projection;
+  if (cached)
+  {
+    INCSTAT(stats.numProjectionCacheHits);
+    std::memcpy(g_fProjectionMatrix, cached->projection_matrix, sizeof(g_fProjectionMatrix));
+    constants.projection = cached->projection;
+    std::memcpy(constants_eye_projection, cached->eye_projection,
+                sizeof(constants_eye_projection));
+    GeometryShaderManager::constants.stereoparams = cached->stereoparams;
+    m_layer_on_top = cached->layer_on_top;
+    hmd_projection = cached->hmd_projection;
+    dirty = true;
+    GeometryShaderManager::dirty = true;
+  }
+  else
+  {
+    s_real_3d_projection = false;
+    hmd_projection = CalculateProjectionConstants();
+    if (use_cache)
+    {
+      INCSTAT(stats.numProjectionCacheMisses);
+      ProjectionCacheEntry& entry = s_projection_cache[s_projection_cache_next];
+      s_projection_cache_next = (s_projection_cache_next + 1) % PROJECTION_CACHE_SIZE;
+      s_projection_cache_size = std::min(s_projection_cache_size + 1, PROJECTION_CACHE_SIZE);
+
+      entry.key = key;
+      std::memcpy(entry.projection_matrix, g_fProjectionMatrix, sizeof(g_fProjectionMatrix));
+      entry.projection = constants.projection;
+      std::memcpy(entry.eye_projection, constants_eye_projection, sizeof(entry.eye_projection));
+      entry.stereoparams = GeometryShaderManager::constants.stereoparams;
+      entry.layer_on_top = m_layer_on_top;
+      entry.hmd_projection = hmd_projection;
+      entry.real_3d = s_real_3d_projection;
+    }
+  }
+
+  // The texture matrix and lighting constants are only updated with HMD projections
+  if (!hmd_projection)
+    return;
+
+  if (bTexMtxInfoChanged)
+  {
+    bTexMtxInfoChanged = false;
+    constants.xfmem_dualTexInfo = xfmem.dualTexTrans.enabled;
+    for (size_t i = 0; i < ArraySize(xfmem.texMtxInfo); i++)
+      constants.xfmem_pack1[i][0] = xfmem.texMtxInfo[i].hex;
+    for (size_t i = 0; i < ArraySize(xfmem.postMtxInfo); i++)
+      constants.xfmem_pack1[i][1] = xfmem.postMtxInfo[i].hex;
+
+    dirty = true;
+  }
+
+  if (bLightingConfigChanged)
+  {
+    bLightingConfigChanged = false;
+
+    for (size_t i = 0; i < 2; i++)
+    {
+      constants.xfmem_pack1[i][2] = xfmem.color[i].hex;
+      constants.xfmem_pack1[i][3] = xfmem.alpha[i].hex;
+    }
+    constants.xfmem_numColorChans = xfmem.numChan.numColorChans;
+
+    dirty = true;
+  }
+}
+
+bool VertexShaderManager::CalculateProjectionConstants()
 {
   // Transformations must be applied in the following order for VR:
   // HUD
@@ -1275,7 +1457,7 @@ void VertexShaderManager::SetProjectionConstants()
     memset(constants.projection.data(), 0, 4 * 16);
     memset(constants_eye_projection[0], 0, 2 * 4 * 16);
     memset(GeometryShaderManager::constants.stereoparams.data(), 0, 4 * 4);
-    return;
+    return false;
   }
   // don't do anything fancy for rendering to a texture
   // render exactly as we are told, and in mono
@@ -1293,7 +1475,7 @@ void VertexShaderManager::SetProjectionConstants()
         GeometryShaderManager::constants.stereoparams[1] = 0;
     GeometryShaderManager::constants.stereoparams[2] =
         GeometryShaderManager::constants.stereoparams[3] = 0;
-    return;
+    return false;
   }
   else if (!g_has_hmd || !g_ActiveConfig.bEnableVR)
   {
@@ -1346,7 +1528,7 @@ void VertexShaderManager::SetProjectionConstants()
           (float)(g_ActiveConfig.iStereoConvergence *
                   (g_ActiveConfig.iStereoConvergencePercentage / 100.0f));
     }
-    return;
+    return false;
   }
   // This was already copied from the fullscreen EFB.
   // Which makes it already correct for the HMD's FOV.
@@ -1372,7 +1554,7 @@ void VertexShaderManager::SetProjectionConstants()
         GeometryShaderManager::constants.stereoparams[1] = 0;
     GeometryShaderManager::constants.stereoparams[2] =
         GeometryShaderManager::constants.stereoparams[3] = 0;
-    return;
+    return false;
   }
   // VR HMD 3D projection matrix, needs to include head-tracking
   else
@@ -1413,6 +1595,7 @@ void VertexShaderManager::SetProjectionConstants()
       // Find the game's camera angle and position by looking at the view/model matrix of the first
       // real 3D object drawn.
       // This won't work for all games.
+      s_real_3d_projection = true;
       if (!g_vr_had_3D_already)
       {
         CheckOrientationConstants();
@@ -2095,31 +2278,7 @@ void VertexShaderManager::SetProjectionConstants()
     }
   }
 
-  if (bTexMtxInfoChanged)
-  {
-    bTexMtxInfoChanged = false;
-    constants.xfmem_dualTexInfo = xfmem.dualTexTrans.enabled;
-    for (size_t i = 0; i < ArraySize(xfmem.texMtxInfo); i++)
-      constants.xfmem_pack1[i][0] = xfmem.texMtxInfo[i].hex;
-    for (size_t i = 0; i < ArraySize(xfmem.postMtxInfo); i++)
-      constants.xfmem_pack1[i][1] = xfmem.postMtxInfo[i].hex;
-
-    dirty = true;
-  }
-
-  if (bLightingConfigChanged)
-  {
-    bLightingConfigChanged = false;
-
-    for (size_t i = 0; i < 2; i++)
-    {
-      constants.xfmem_pack1[i][2] = xfmem.color[i].hex;
-      constants.xfmem_pack1[i][3] = xfmem.alpha[i].hex;
-    }
-    constants.xfmem_numColorChans = xfmem.numChan.numColorChans;
-
-    dirty = true;
-  }
+  return true;
 }
 
 void VertexShaderManager::CheckOrientationConstants()
@@ -73,6 +73,11 @@ public:
   static float4 constants_eye_projection[2][4];
   static bool m_layer_on_top;
   static bool dirty;
+
+private:
+  // Called by SetProjectionConstants when the result isn't cached. Returns true if the projection
+  // was calculated for the HMD.
+  static bool CalculateProjectionConstants();
 };
 
 void ScaleRequestedToRendered(EFBRectangle* requested, EFBRectangle* rendered);
@@ -50,6 +50,7 @@ VideoConfig::VideoConfig()
   backend_info.bSupportsInternalResolutionFrameDumps = false;
   backend_info.bSupportsST3CTextures = false;
   backend_info.bSupportsBPTCTextures = false;
+  backend_info.bSupportsCachedEFBPeeks = false;
 
   bEnableValidationLayer = false;
   bBackendMultithreading = true;
@@ -185,6 +186,7 @@ void VideoConfig::Refresh()
   bShowNetPlayPing = Config::Get(Config::GFX_SHOW_NETPLAY_PING);
   bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
   bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
+  iFastForwardPresentInterval = Config::Get(Config::GFX_FAST_FORWARD_PRESENT_INTERVAL);
   bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
   bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
   bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
@@ -200,6 +202,9 @@ void VideoConfig::Refresh()
   sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
+  iFrameDumpQueueDepth = Config::Get(Config::GFX_FRAME_DUMP_QUEUE_DEPTH);
+  bFrameDumpDropFrames = Config::Get(Config::GFX_FRAME_DUMP_DROP_FRAMES);
+  iPNGCompressionLevel = Config::Get(Config::GFX_PNG_COMPRESSION_LEVEL);
   bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
   bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
   bFastDepthCalc = Config::Get(Config::GFX_FAST_DEPTH_CALC);
@@ -262,6 +267,7 @@ void VideoConfig::Refresh()
   iStereoDepthPercentage = Config::Get(Config::GFX_STEREO_DEPTH_PERCENTAGE);
 
   bEFBAccessEnable = Config::Get(Config::GFX_HACK_EFB_ACCESS_ENABLE);
+  iEFBPeekTileSize = Config::Get(Config::GFX_HACK_EFB_PEEK_TILE_SIZE);
   bBBoxEnable = Config::Get(Config::GFX_HACK_BBOX_ENABLE);
   bBBoxPreferStencilImplementation =
       Config::Get(Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION);
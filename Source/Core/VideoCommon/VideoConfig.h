@@ -111,6 +111,8 @@ struct VideoConfig final
   bool bTexFmtOverlayEnable;
   bool bTexFmtOverlayCenter;
   bool bLogRenderTimeToFile;
+  // Only every Nth frame is presented while emulation is unthrottled
+  int iFastForwardPresentInterval;
 
   // Render
   bool bWireFrame;
@@ -128,6 +130,11 @@ struct VideoConfig final
   std::string sDumpFormat;
   std::string sDumpPath;
   bool bInternalResolutionFrameDumps;
+  // Frames waiting to be encoded. When the queue is full, new frames are dropped or wait.
+  int iFrameDumpQueueDepth;
+  bool bFrameDumpDropFrames;
+  // zlib level of dumped textures and frame images, 0-9. Lower levels encode faster.
+  int iPNGCompressionLevel;
   bool bFreeLook;
   bool bBorderlessFullscreen;
   bool bEnableGPUTextureDecoding;
@@ -135,6 +142,8 @@ struct VideoConfig final
 
   // Hacks
   bool bEFBAccessEnable;
+  // Width and height of the EFB blocks CPU peeks are cached in, 0 to read every peek on its own
+  int iEFBPeekTileSize;
   bool bPerfQueriesEnable;
   bool bBBoxEnable;
   bool bBBoxPreferStencilImplementation;  // OpenGL-only, to see how slow it is compared to SSBOs
@@ -367,6 +376,7 @@ struct VideoConfig final
     bool bSupportsBitfield;                // Needed by UberShaders, so must stay in VideoCommon
     bool bSupportsDynamicSamplerIndexing;  // Needed by UberShaders, so must stay in VideoCommon
     bool bSupportsBPTCTextures;
+    bool bSupportsCachedEFBPeeks;  // Peeking a whole tile costs little more than one pixel
   } backend_info;
 
   // Utility
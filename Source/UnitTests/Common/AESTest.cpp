@@ -0,0 +1,50 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+
+using Common::AES::Mode;
+
+TEST(AES, ContextMatchesReference)
+{
+  std::mt19937 rng(0x20171018);
+  std::array<u8, 16> key;
+  std::array<u8, 16> iv;
+  std::vector<u8> plain(0x7C00 + 3 * 16);
+  for (u8& byte : key)
+    byte = static_cast<u8>(rng());
+  for (u8& byte : iv)
+    byte = static_cast<u8>(rng());
+  for (u8& byte : plain)
+    byte = static_cast<u8>(rng());
+
+  const auto encrypt = Common::AES::CreateContext(key.data(), Mode::Encrypt);
+  const auto decrypt = Common::AES::CreateContext(key.data(), Mode::Decrypt);
+
+  // Sizes around the number of blocks that are decrypted at once by the hardware paths
+  for (size_t size : {16, 112, 128, 144, 0x400, 0x7C00, 0x7C00 + 3 * 16})
+  {
+    std::array<u8, 16> reference_iv = iv;
+    const std::vector<u8> reference =
+        Common::AES::Encrypt(key.data(), reference_iv.data(), plain.data(), size);
+
+    std::vector<u8> cipher(size);
+    std::array<u8, 16> next_iv;
+    encrypt->Crypt(iv.data(), next_iv.data(), plain.data(), cipher.data(), size);
+    EXPECT_EQ(reference, cipher) << "size " << size;
+    EXPECT_EQ(reference_iv, next_iv) << "size " << size;
+
+    // In-place decryption
+    decrypt->Crypt(iv.data(), next_iv.data(), cipher.data(), cipher.data(), size);
+    EXPECT_EQ(0, std::memcmp(plain.data(), cipher.data(), size)) << "size " << size;
+    EXPECT_EQ(0, std::memcmp(reference.data() + size - 16, next_iv.data(), 16)) << "size " << size;
+  }
+}
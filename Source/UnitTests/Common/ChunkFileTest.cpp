@@ -0,0 +1,75 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+
+namespace
+{
+struct TestState
+{
+  u32 a = 0x12345678;
+  std::vector<u16> b = {1, 2, 3};
+  bool c = true;
+
+  void DoState(PointerWrap& p)
+  {
+    p.Do(a);
+    p.Do(b);
+    p.Do(c);
+  }
+};
+
+size_t MeasureState(TestState& state)
+{
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  state.DoState(p);
+  return reinterpret_cast<size_t>(ptr);
+}
+}  // Anonymous namespace
+
+TEST(PointerWrap, BoundedWriteFits)
+{
+  TestState state;
+  std::vector<u8> buffer(MeasureState(state));
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, buffer.size(), PointerWrap::MODE_WRITE);
+  state.DoState(p);
+  EXPECT_FALSE(p.HasOverflowed());
+  EXPECT_EQ(PointerWrap::MODE_WRITE, p.GetMode());
+  EXPECT_EQ(buffer.data() + buffer.size(), ptr);
+
+  TestState loaded;
+  loaded.a = 0;
+  loaded.b.clear();
+  loaded.c = false;
+  ptr = buffer.data();
+  PointerWrap read(&ptr, PointerWrap::MODE_READ);
+  loaded.DoState(read);
+  EXPECT_EQ(state.a, loaded.a);
+  EXPECT_EQ(state.b, loaded.b);
+  EXPECT_EQ(state.c, loaded.c);
+}
+
+TEST(PointerWrap, BoundedWriteOverflowMeasures)
+{
+  TestState state;
+  const size_t size = MeasureState(state);
+  // Guard bytes after the buffer must not be touched
+  std::vector<u8> buffer(size + 16, 0xAA);
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, size - 1, PointerWrap::MODE_WRITE);
+  state.DoState(p);
+  EXPECT_TRUE(p.HasOverflowed());
+  EXPECT_EQ(PointerWrap::MODE_MEASURE, p.GetMode());
+  EXPECT_EQ(size, static_cast<size_t>(ptr - buffer.data()));
+  for (size_t i = size - 1; i < buffer.size(); ++i)
+    EXPECT_EQ(0xAA, buffer[i]);
+}
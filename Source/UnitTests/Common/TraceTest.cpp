@@ -0,0 +1,67 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Common/FileUtil.h"
+#include "Common/Trace.h"
+
+namespace
+{
+size_t Count(const std::string& text, const std::string& pattern)
+{
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    ++count;
+  return count;
+}
+}  // Anonymous namespace
+
+TEST(Trace, WritesZonesAndCountersOfEveryThread)
+{
+  const std::string dir = File::CreateTempDir();
+  ASSERT_FALSE(dir.empty());
+  const std::string path = dir + "/trace.json";
+
+  // Not recorded
+  {
+    Common::Trace::ScopedZone zone("Before");
+  }
+
+  Common::Trace::Start();
+  std::thread thread([] {
+    Common::Trace::SetThreadName("Worker");
+    for (int i = 0; i < 5000; ++i)
+    {
+      Common::Trace::ScopedZone zone("Work");
+      Common::Trace::Counter("Index", i);
+    }
+  });
+  {
+    Common::Trace::ScopedZone zone("Wait");
+    thread.join();
+  }
+  ASSERT_TRUE(Common::Trace::Stop(path));
+  EXPECT_FALSE(Common::Trace::IsRecording());
+
+  std::string json;
+  ASSERT_TRUE(File::ReadFileToString(path, json));
+  EXPECT_EQ(0u, Count(json, "\"Before\""));
+  EXPECT_EQ(1u, Count(json, "\"name\":\"Wait\""));
+  EXPECT_EQ(5000u, Count(json, "\"name\":\"Work\""));
+  EXPECT_EQ(5001u, Count(json, "\"ph\":\"E\""));
+  EXPECT_EQ(5000u, Count(json, "\"name\":\"Index\""));
+  EXPECT_EQ(1u, Count(json, "\"args\":{\"name\":\"Worker\"}"));
+
+  // A new recording drops the events of the previous one
+  Common::Trace::Start();
+  ASSERT_TRUE(Common::Trace::Stop(path));
+  ASSERT_TRUE(File::ReadFileToString(path, json));
+  EXPECT_EQ(0u, Count(json, "\"name\":\"Work\""));
+
+  File::DeleteDirRecursively(dir);
+}
@@ -0,0 +1,158 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/DVD/DVDPrefetcher.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/Enums.h"
+#include "DiscIO/Volume.h"
+
+namespace
+{
+constexpr u64 DISC_SIZE = 0x1000000;
+constexpr u64 CACHE_SIZE = 0x400000;
+
+// A disc where every byte is derived from its offset, which counts the reads made from it
+class FakeVolume final : public DiscIO::Volume
+{
+public:
+  bool Read(u64 offset, u64 length, u8* buffer, const DiscIO::Partition& partition) const override
+  {
+    if (offset + length > DISC_SIZE)
+      return false;
+
+    ++reads;
+    bytes_read += length;
+    for (u64 i = 0; i < length; ++i)
+      buffer[i] = ByteAt(offset + i);
+    return true;
+  }
+
+  static u8 ByteAt(u64 offset) { return static_cast<u8>(offset ^ (offset >> 8) ^ (offset >> 16)); }
+
+  const DiscIO::FileSystem* GetFileSystem(const DiscIO::Partition&) const override
+  {
+    return nullptr;
+  }
+  std::string GetGameID(const DiscIO::Partition&) const override { return "FAKE01"; }
+  std::string GetMakerID(const DiscIO::Partition&) const override { return "01"; }
+  std::optional<u16> GetRevision(const DiscIO::Partition&) const override { return 0; }
+  std::string GetInternalName(const DiscIO::Partition&) const override { return {}; }
+  std::vector<u32> GetBanner(int*, int*) const override { return {}; }
+  std::string GetApploaderDate(const DiscIO::Partition&) const override { return {}; }
+  DiscIO::Platform GetVolumeType() const override { return DiscIO::Platform::GAMECUBE_DISC; }
+  DiscIO::Region GetRegion() const override { return DiscIO::Region::NTSC_U; }
+  DiscIO::Country GetCountry(const DiscIO::Partition&) const override
+  {
+    return DiscIO::Country::COUNTRY_USA;
+  }
+  DiscIO::BlobType GetBlobType() const override { return DiscIO::BlobType::PLAIN; }
+  u64 GetSize() const override { return DISC_SIZE; }
+  u64 GetRawSize() const override { return DISC_SIZE; }
+
+  mutable u32 reads = 0;
+  mutable u64 bytes_read = 0;
+};
+
+bool HasExpectedData(const std::vector<u8>& data, u64 offset)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    if (data[i] != FakeVolume::ByteAt(offset + i))
+      return false;
+  }
+  return true;
+}
+
+void RunPendingWork(DVDThread::Prefetcher* prefetcher, const FakeVolume& volume)
+{
+  while (prefetcher->HasPendingWork())
+    prefetcher->DoPendingWork(volume);
+}
+}  // Anonymous namespace
+
+TEST(DVDPrefetcher, SequentialReadsAreServedFromCache)
+{
+  FakeVolume volume;
+  DVDThread::Prefetcher prefetcher;
+  prefetcher.SetDisc(&volume, true, CACHE_SIZE, false);
+
+  std::vector<u8> buffer(0x8000);
+  ASSERT_TRUE(prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0, buffer.size(), buffer.data()));
+  ASSERT_TRUE(
+      prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0x8000, buffer.size(), buffer.data()));
+  EXPECT_TRUE(prefetcher.HasPendingWork());
+  RunPendingWork(&prefetcher, volume);
+  EXPECT_NE(0u, prefetcher.GetStats().prefetched_bytes);
+
+  const u32 reads = volume.reads;
+  ASSERT_TRUE(
+      prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0x10000, buffer.size(), buffer.data()));
+  EXPECT_EQ(reads, volume.reads);
+  EXPECT_EQ(buffer.size(), prefetcher.GetStats().cached_bytes);
+  EXPECT_TRUE(HasExpectedData(buffer, 0x10000));
+}
+
+TEST(DVDPrefetcher, ReadsAcrossCachedAndUncachedChunks)
+{
+  FakeVolume volume;
+  DVDThread::Prefetcher prefetcher;
+  prefetcher.SetDisc(&volume, true, CACHE_SIZE, false);
+
+  std::vector<u8> buffer(0x1000);
+  ASSERT_TRUE(prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0x100000, buffer.size(),
+                              buffer.data()));
+  ASSERT_TRUE(prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0x101000, buffer.size(),
+                              buffer.data()));
+  RunPendingWork(&prefetcher, volume);
+
+  // Starts before the prefetched data and ends inside it
+  std::vector<u8> large_buffer(0x30000);
+  ASSERT_TRUE(prefetcher.Read(volume, DiscIO::PARTITION_NONE, 0xF0000, large_buffer.size(),
+                              large_buffer.data()));
+  EXPECT_TRUE(HasExpectedData(large_buffer, 0xF0000));
+  EXPECT_NE(0u, prefetcher.GetStats().cached_bytes);
+}
+
+TEST(DVDPrefetcher, DisabledPrefetcherReadsDirectly)
+{
+  FakeVolume volume;
+  DVDThread::Prefetcher prefetcher;
+  prefetcher.SetDisc(&volume, false, CACHE_SIZE, false);
+
+  std::vector<u8> buffer(0x8000);
+  for (u64 offset = 0; offset < 0x40000; offset += buffer.size())
+  {
+    ASSERT_TRUE(
+        prefetcher.Read(volume, DiscIO::PARTITION_NONE, offset, buffer.size(), buffer.data()));
+    EXPECT_TRUE(HasExpectedData(buffer, offset));
+  }
+  EXPECT_FALSE(prefetcher.HasPendingWork());
+  EXPECT_EQ(0x40000u, volume.bytes_read);
+}
+
+TEST(DVDPrefetcher, SmallCacheServesLongSequentialReads)
+{
+  FakeVolume volume;
+  DVDThread::Prefetcher prefetcher;
+  prefetcher.SetDisc(&volume, true, 0x100000, false);
+
+  std::vector<u8> buffer(0x10000);
+  for (u64 offset = 0; offset < 0x800000; offset += buffer.size())
+  {
+    ASSERT_TRUE(
+        prefetcher.Read(volume, DiscIO::PARTITION_NONE, offset, buffer.size(), buffer.data()));
+    ASSERT_TRUE(HasExpectedData(buffer, offset));
+    RunPendingWork(&prefetcher, volume);
+  }
+
+  // Sequential reads should mostly hit the cache, even though it is far smaller than the data
+  EXPECT_GT(prefetcher.GetStats().cached_bytes, 0x400000u);
+}
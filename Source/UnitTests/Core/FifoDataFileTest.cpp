@@ -0,0 +1,177 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+
+namespace
+{
+constexpr u32 FRAME_COUNT = 4;
+constexpr size_t PAYLOAD_SIZE = 0x10000;
+// Size of the header and the start of the frame list
+constexpr u64 FRAME_LIST_OFFSET = 128;
+constexpr u64 COMPRESSED_FRAME_SIZE = 64;
+
+class FifoDataFileTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+    m_path = m_dir + "/log.dff";
+
+    std::mt19937 rng(1234);
+    // Incompressible, so that it's stored uncompressed
+    m_random.resize(PAYLOAD_SIZE);
+    for (u8& value : m_random)
+      value = static_cast<u8>(rng());
+    m_pattern.resize(PAYLOAD_SIZE);
+    for (size_t i = 0; i < m_pattern.size(); ++i)
+      m_pattern[i] = static_cast<u8>(i / 0x40);
+
+    m_file.SetIsWii(true);
+    for (u32 i = 0; i < FifoDataFile::BP_MEM_SIZE; ++i)
+      m_file.GetBPMem()[i] = i * 3;
+    m_file.GetTexMem()[0x1234] = 0x56;
+
+    for (u32 i = 0; i < FRAME_COUNT; ++i)
+    {
+      FifoFrameInfo frame;
+      frame.fifoStart = 0x100000 + i;
+      frame.fifoEnd = 0x200000 + i;
+      // The last frame is compressed, the others are too small or incompressible
+      frame.fifoData.resize(i == 0 ? 3 : 0x2000);
+      for (u8& value : frame.fifoData)
+        value = i == FRAME_COUNT - 1 ? static_cast<u8>(0x61 + i) : static_cast<u8>(rng());
+
+      // Every frame uploads the same data several times
+      for (u32 j = 0; j < 4; ++j)
+      {
+        MemoryUpdate update;
+        update.fifoPosition = j * 0x10;
+        update.address = 0x80000000 + j * PAYLOAD_SIZE;
+        update.data = j % 2 ? m_pattern : m_random;
+        update.type = j % 2 ? MemoryUpdate::TEXTURE_MAP : MemoryUpdate::VERTEX_STREAM;
+        frame.memoryUpdates.push_back(std::move(update));
+      }
+
+      m_file.AddFrame(frame);
+    }
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  void ExpectFramesEqual(const FifoFrameInfo& expected, const FifoFrameInfo& actual)
+  {
+    EXPECT_EQ(expected.fifoStart, actual.fifoStart);
+    EXPECT_EQ(expected.fifoEnd, actual.fifoEnd);
+    EXPECT_EQ(expected.fifoData, actual.fifoData);
+    ASSERT_EQ(expected.memoryUpdates.size(), actual.memoryUpdates.size());
+    for (size_t i = 0; i < expected.memoryUpdates.size(); ++i)
+    {
+      EXPECT_EQ(expected.memoryUpdates[i].fifoPosition, actual.memoryUpdates[i].fifoPosition);
+      EXPECT_EQ(expected.memoryUpdates[i].address, actual.memoryUpdates[i].address);
+      EXPECT_EQ(expected.memoryUpdates[i].type, actual.memoryUpdates[i].type);
+      EXPECT_TRUE(expected.memoryUpdates[i].data == actual.memoryUpdates[i].data);
+    }
+  }
+
+  std::string m_dir;
+  std::string m_path;
+  std::vector<u8> m_random;
+  std::vector<u8> m_pattern;
+  FifoDataFile m_file;
+};
+}  // Anonymous namespace
+
+TEST_F(FifoDataFileTest, RoundTrip)
+{
+  ASSERT_TRUE(m_file.Save(m_path));
+
+  // Each distinct payload is only stored once
+  EXPECT_LT(File::GetSize(m_path), FifoDataFile::TEX_MEM_SIZE + 2 * PAYLOAD_SIZE);
+
+  std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(m_path, false);
+  ASSERT_TRUE(loaded);
+  EXPECT_TRUE(loaded->GetIsWii());
+  EXPECT_FALSE(loaded->HasBrokenEFBCopies());
+  for (u32 i = 0; i < FifoDataFile::BP_MEM_SIZE; ++i)
+    EXPECT_EQ(m_file.GetBPMem()[i], loaded->GetBPMem()[i]);
+  EXPECT_EQ(0x56, loaded->GetTexMem()[0x1234]);
+
+  ASSERT_EQ(FRAME_COUNT, loaded->GetFrameCount());
+  for (u32 i = 0; i < FRAME_COUNT; ++i)
+  {
+    const std::shared_ptr<const std::vector<u8>> fifo_data = loaded->GetFifoData(i);
+    ASSERT_TRUE(fifo_data);
+    EXPECT_EQ(m_file.GetFrame(i)->fifoData, *fifo_data);
+
+    const std::shared_ptr<const FifoFrameInfo> frame = loaded->GetFrame(i);
+    ASSERT_TRUE(frame);
+    ExpectFramesEqual(*m_file.GetFrame(i), *frame);
+  }
+
+  // Saving a streamed file reads the frames back from disk
+  const std::string copy_path = m_dir + "/copy.dff";
+  ASSERT_TRUE(loaded->Save(copy_path));
+  std::unique_ptr<FifoDataFile> copy = FifoDataFile::Load(copy_path, false);
+  ASSERT_TRUE(copy);
+  ASSERT_EQ(FRAME_COUNT, copy->GetFrameCount());
+  for (u32 i = 0; i < FRAME_COUNT; ++i)
+    ExpectFramesEqual(*m_file.GetFrame(i), *copy->GetFrame(i));
+}
+
+TEST_F(FifoDataFileTest, FlagsOnly)
+{
+  ASSERT_TRUE(m_file.Save(m_path));
+
+  std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(m_path, true);
+  ASSERT_TRUE(loaded);
+  EXPECT_TRUE(loaded->GetIsWii());
+}
+
+TEST_F(FifoDataFileTest, FailedReadsAreNotCached)
+{
+  ASSERT_TRUE(m_file.Save(m_path));
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(m_path, contents));
+
+  u64 data_offset;
+  {
+    File::IOFile file(m_path, "rb");
+    ASSERT_TRUE(file.Seek(FRAME_LIST_OFFSET + COMPRESSED_FRAME_SIZE, SEEK_SET));
+    ASSERT_TRUE(file.ReadArray(&data_offset, 1));
+  }
+
+  std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(m_path, false);
+  ASSERT_TRUE(loaded);
+
+  // Cut the file off at the data of the second frame
+  {
+    File::IOFile file(m_path, "r+b");
+    ASSERT_TRUE(file.Resize(data_offset));
+  }
+
+  EXPECT_FALSE(loaded->GetFrame(1));
+  EXPECT_FALSE(loaded->GetFrame(1));
+  EXPECT_FALSE(loaded->GetFifoData(1));
+  EXPECT_FALSE(loaded->Save(m_dir + "/copy.dff"));
+  EXPECT_TRUE(loaded->GetFrame(0));
+
+  // The frame is read again once the data is back
+  ASSERT_TRUE(File::WriteStringToFile(contents, m_path));
+  const std::shared_ptr<const FifoFrameInfo> frame = loaded->GetFrame(1);
+  ASSERT_TRUE(frame);
+  ExpectFramesEqual(*m_file.GetFrame(1), *frame);
+}
@@ -0,0 +1,59 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HideObjectEngine.h"
+
+using namespace HideObjectEngine;
+
+namespace
+{
+HideObject MakeCode(std::vector<HideObjectEntry> entries, bool active = true)
+{
+  HideObject code;
+  code.name = "Test";
+  code.entries = std::move(entries);
+  code.active = active;
+  code.user_defined = true;
+  return code;
+}
+}  // Anonymous namespace
+
+TEST(HideObjectEngine, MatchesPrefixOfEachLength)
+{
+  const Matcher matcher({MakeCode({HideObjectEntry(HideObject_16BIT, 0x1234),
+                                   HideObjectEntry(HideObject_32BIT, 0xAABBCCDD)})});
+
+  const u8 short_match[] = {0x12, 0x34, 0x00, 0x00};
+  const u8 long_match[] = {0xAA, 0xBB, 0xCC, 0xDD};
+  const u8 partial[] = {0xAA, 0xBB, 0xCC, 0x00};
+  EXPECT_TRUE(matcher.Matches(short_match));
+  EXPECT_TRUE(matcher.Matches(long_match));
+  EXPECT_FALSE(matcher.Matches(partial));
+}
+
+TEST(HideObjectEngine, UsesUpperValueBeyondEightBytes)
+{
+  HideObjectEntry entry(HideObject_96BIT, 0);
+  entry.value_upper = 0x01020304;
+  entry.value_lower = 0x05060708090A0B0C;
+  const Matcher matcher({MakeCode({entry})});
+
+  const u8 data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C};
+  EXPECT_TRUE(matcher.Matches(data));
+}
+
+TEST(HideObjectEngine, IgnoresInactiveCodes)
+{
+  const Matcher matcher({MakeCode({HideObjectEntry(HideObject_08BIT, 0x42)}, false)});
+
+  const u8 data[] = {0x42};
+  EXPECT_TRUE(matcher.IsEmpty());
+  EXPECT_FALSE(matcher.Matches(data));
+}
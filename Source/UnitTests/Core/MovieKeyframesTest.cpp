@@ -0,0 +1,172 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/MovieKeyframes.h"
+
+namespace
+{
+constexpr u64 INPUT_SIZE = 0x1000;
+
+class MovieKeyframesTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+    // The keyframes are written to a temporary file in the savestate directory while recording
+    File::SetUserPath(D_USER_IDX, m_dir + DIR_SEP);
+    ASSERT_TRUE(File::CreateFullPath(File::GetUserPath(D_STATESAVES_IDX)));
+    m_path = m_dir + "/movie.dtk";
+
+    m_input.resize(INPUT_SIZE);
+    for (size_t i = 0; i < m_input.size(); ++i)
+      m_input[i] = static_cast<u8>(i * 7);
+  }
+
+  void TearDown() override
+  {
+    m_store.Clear();
+    File::DeleteDirRecursively(m_dir);
+  }
+
+  // Keyframe n is captured at frame 10 * n and stores n repeated throughout the state
+  void AddKeyframe(u8 n)
+  {
+    const u64 input_byte = n * 0x100;
+    m_store.Add(n * 10, input_byte, Movie::KeyframeStore::HashInput(m_input.data(), input_byte),
+                std::vector<u8>(0x2000 + n, n));
+  }
+
+  void ExpectState(const Movie::KeyframeStore::Keyframe& keyframe, u8 n)
+  {
+    std::vector<u8> state;
+    ASSERT_TRUE(m_store.ReadState(keyframe, &state));
+    EXPECT_EQ(std::vector<u8>(0x2000 + n, n), state);
+  }
+
+  std::string m_dir;
+  std::string m_path;
+  std::vector<u8> m_input;
+  Movie::KeyframeStore m_store;
+};
+}  // Anonymous namespace
+
+TEST_F(MovieKeyframesTest, FindBefore)
+{
+  Movie::KeyframeStore::Keyframe keyframe;
+  EXPECT_TRUE(m_store.IsEmpty());
+  EXPECT_FALSE(m_store.FindBefore(100, &keyframe));
+
+  for (u8 n = 1; n <= 3; ++n)
+    AddKeyframe(n);
+  EXPECT_FALSE(m_store.IsEmpty());
+
+  EXPECT_FALSE(m_store.FindBefore(9, &keyframe));
+  ASSERT_TRUE(m_store.FindBefore(10, &keyframe));
+  EXPECT_EQ(10u, keyframe.frame);
+  ASSERT_TRUE(m_store.FindBefore(29, &keyframe));
+  EXPECT_EQ(20u, keyframe.frame);
+  ExpectState(keyframe, 2);
+  ASSERT_TRUE(m_store.FindBefore(1000, &keyframe));
+  EXPECT_EQ(30u, keyframe.frame);
+  ExpectState(keyframe, 3);
+}
+
+TEST_F(MovieKeyframesTest, Truncate)
+{
+  for (u8 n = 1; n <= 3; ++n)
+    AddKeyframe(n);
+
+  // Keyframes at the truncation point stay
+  m_store.Truncate(0x200);
+  Movie::KeyframeStore::Keyframe keyframe;
+  ASSERT_TRUE(m_store.FindBefore(1000, &keyframe));
+  EXPECT_EQ(20u, keyframe.frame);
+  ExpectState(keyframe, 2);
+
+  // Recording continues with a new keyframe after the truncated ones
+  AddKeyframe(4);
+  ASSERT_TRUE(m_store.FindBefore(35, &keyframe));
+  EXPECT_EQ(20u, keyframe.frame);
+  ASSERT_TRUE(m_store.FindBefore(40, &keyframe));
+  ExpectState(keyframe, 4);
+
+  m_store.Truncate(0);
+  EXPECT_TRUE(m_store.IsEmpty());
+}
+
+TEST_F(MovieKeyframesTest, SaveLoadRoundTrip)
+{
+  for (u8 n = 1; n <= 3; ++n)
+    AddKeyframe(n);
+  ASSERT_TRUE(m_store.Save(m_path));
+
+  Movie::KeyframeStore loaded;
+  ASSERT_EQ(3u, loaded.Load(m_path, m_input));
+  for (u8 n = 1; n <= 3; ++n)
+  {
+    Movie::KeyframeStore::Keyframe keyframe;
+    ASSERT_TRUE(loaded.FindBefore(n * 10, &keyframe));
+    EXPECT_EQ(n * 10u, keyframe.frame);
+    EXPECT_EQ(n * 0x100u, keyframe.input_byte);
+    std::vector<u8> state;
+    ASSERT_TRUE(loaded.ReadState(keyframe, &state));
+    EXPECT_EQ(std::vector<u8>(0x2000 + n, n), state);
+  }
+
+  // Saving again copies the keyframes from the loaded file, including over itself
+  ASSERT_TRUE(loaded.Save(m_path));
+  Movie::KeyframeStore reloaded;
+  EXPECT_EQ(3u, reloaded.Load(m_path, m_input));
+}
+
+TEST_F(MovieKeyframesTest, LoadRejectsOtherInput)
+{
+  for (u8 n = 1; n <= 3; ++n)
+    AddKeyframe(n);
+  ASSERT_TRUE(m_store.Save(m_path));
+
+  // Only the keyframe captured before the changed input byte still matches
+  std::vector<u8> input = m_input;
+  input[0x150] ^= 0xFF;
+  Movie::KeyframeStore loaded;
+  ASSERT_EQ(1u, loaded.Load(m_path, input));
+  Movie::KeyframeStore::Keyframe keyframe;
+  ASSERT_TRUE(loaded.FindBefore(1000, &keyframe));
+  EXPECT_EQ(10u, keyframe.frame);
+
+  // Keyframes past the end of a shorter movie don't match either
+  input.resize(0x100);
+  EXPECT_EQ(1u, loaded.Load(m_path, input));
+}
+
+TEST_F(MovieKeyframesTest, LoadRejectsBadFiles)
+{
+  Movie::KeyframeStore loaded;
+  EXPECT_EQ(0u, loaded.Load(m_dir + "/missing.dtk", m_input));
+
+  for (u8 n = 1; n <= 3; ++n)
+    AddKeyframe(n);
+  ASSERT_TRUE(m_store.Save(m_path));
+
+  // A keyframe count that doesn't fit in the file
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(m_path, data));
+  data[8] = '\xFF';
+  data[9] = '\xFF';
+  data[10] = '\xFF';
+  data[11] = '\x7F';
+  ASSERT_TRUE(File::WriteStringToFile(data, m_path));
+  EXPECT_EQ(0u, loaded.Load(m_path, m_input));
+  EXPECT_TRUE(loaded.IsEmpty());
+}
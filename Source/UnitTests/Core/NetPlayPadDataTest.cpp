@@ -0,0 +1,110 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "Common/CommonTypes.h"
+#include "Core/NetPlayPadData.h"
+#include "Core/NetPlayProto.h"
+#include "InputCommon/GCPadStatus.h"
+
+namespace
+{
+GCPadStatus MakePad(u16 button, u8 stick_x)
+{
+  GCPadStatus pad = {};
+  pad.button = button;
+  pad.stickX = stick_x;
+  pad.stickY = GCPadStatus::MAIN_STICK_CENTER_Y;
+  return pad;
+}
+}  // Anonymous namespace
+
+TEST(NetPlayPadData, PadRoundTrip)
+{
+  NetPlay::PadDataCodec encoder;
+  NetPlay::PadDataCodec decoder;
+
+  const GCPadStatus pads[] = {MakePad(0, 0x80), MakePad(0, 0x80), MakePad(PAD_BUTTON_A, 0x80),
+                              MakePad(PAD_BUTTON_A, 0x10)};
+  sf::Packet packet;
+  for (const GCPadStatus& pad : pads)
+  {
+    encoder.EncodePad(packet, 1, pad);
+    encoder.EncodePad(packet, 2, pad);
+  }
+
+  for (const GCPadStatus& expected : pads)
+  {
+    for (PadMapping expected_map : {1, 2})
+    {
+      PadMapping map;
+      GCPadStatus pad;
+      ASSERT_TRUE(decoder.DecodePad(packet, &map, &pad));
+      EXPECT_EQ(expected_map, map);
+      EXPECT_EQ(expected.button, pad.button);
+      EXPECT_EQ(expected.stickX, pad.stickX);
+      EXPECT_EQ(expected.stickY, pad.stickY);
+      EXPECT_EQ(expected.triggerLeft, pad.triggerLeft);
+    }
+  }
+  EXPECT_TRUE(packet.endOfPacket());
+}
+
+TEST(NetPlayPadData, UnchangedPadIsCompact)
+{
+  NetPlay::PadDataCodec encoder;
+  sf::Packet packet;
+  encoder.EncodePad(packet, 0, MakePad(PAD_BUTTON_B, 0x40));
+
+  const size_t first_size = packet.getDataSize();
+  encoder.EncodePad(packet, 0, MakePad(PAD_BUTTON_B, 0x40));
+  // The mapping and an empty field mask
+  EXPECT_EQ(first_size + 3, packet.getDataSize());
+}
+
+TEST(NetPlayPadData, WiimoteRepeat)
+{
+  NetPlay::PadDataCodec encoder;
+  NetPlay::PadDataCodec decoder;
+
+  const NetWiimote report = {0xa1, 0x31, 0x00, 0x08, 0x80, 0x80, 0x9a};
+  sf::Packet packet;
+  encoder.EncodeWiimote(packet, 3, report);
+  const size_t first_size = packet.getDataSize();
+  encoder.EncodeWiimote(packet, 3, report);
+  EXPECT_EQ(first_size + 2, packet.getDataSize());
+
+  for (int i = 0; i < 2; ++i)
+  {
+    PadMapping map;
+    NetWiimote decoded;
+    ASSERT_TRUE(decoder.DecodeWiimote(packet, &map, &decoded));
+    EXPECT_EQ(3, map);
+    EXPECT_EQ(report, decoded);
+  }
+}
+
+TEST(NetPlayPadData, RejectsMalformedEntries)
+{
+  NetPlay::PadDataCodec decoder;
+  PadMapping map;
+  GCPadStatus pad;
+  NetWiimote wiimote;
+
+  sf::Packet bad_mapping;
+  bad_mapping << static_cast<PadMapping>(4) << static_cast<u16>(0);
+  EXPECT_FALSE(NetPlay::PadDataCodec::SkipPad(bad_mapping, &map));
+
+  sf::Packet truncated;
+  truncated << static_cast<PadMapping>(0) << static_cast<u16>(1);
+  EXPECT_FALSE(decoder.DecodePad(truncated, &map, &pad));
+
+  // A repeated report needs a previous one
+  sf::Packet repeat;
+  repeat << static_cast<PadMapping>(0) << static_cast<u8>(0);
+  EXPECT_FALSE(decoder.DecodeWiimote(repeat, &map, &wiimote));
+}
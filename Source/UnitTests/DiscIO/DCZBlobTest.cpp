@@ -0,0 +1,322 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/sha1.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+#include "Core/IOS/ES/Formats.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/DCZBlob.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace
+{
+// Not a multiple of the chunk size, so that the last chunk is partial
+constexpr size_t IMAGE_SIZE = 0x123456;
+constexpr u32 CHUNK_SIZE = 0x8000;
+
+constexpr u32 BLOCK_HEADER_SIZE = DiscIO::VolumeWii::BLOCK_HEADER_SIZE;
+constexpr u32 BLOCK_DATA_SIZE = DiscIO::VolumeWii::BLOCK_DATA_SIZE;
+constexpr u32 BLOCK_TOTAL_SIZE = DiscIO::VolumeWii::BLOCK_TOTAL_SIZE;
+constexpr u32 BLOCKS_PER_GROUP = 64;
+
+constexpr u64 PARTITION_OFFSET = 0x50000;
+constexpr u64 PARTITION_DATA_OFFSET = PARTITION_OFFSET + 0x20000;
+// A full hash group, and a partial one whose hashes don't match its data
+constexpr u32 PARTITION_BLOCKS = BLOCKS_PER_GROUP + 6;
+constexpr u64 PARTITION_END = PARTITION_DATA_OFFSET + PARTITION_BLOCKS * BLOCK_TOTAL_SIZE;
+// Followed by data that isn't part of the partition
+constexpr size_t WII_IMAGE_SIZE = PARTITION_END + 0x4000;
+
+void Write32(std::vector<u8>* buffer, u64 offset, u32 value)
+{
+  const u32 swapped = Common::swap32(value);
+  std::memcpy(buffer->data() + offset, &swapped, sizeof(swapped));
+}
+
+// Fills in the H0, H1 and H2 hashes of a group of decrypted blocks.
+// See http://wiibrew.org/wiki/Wii_Disc#Encrypted for the layout.
+void HashGroup(u8* group, u32 num_blocks)
+{
+  u8 h1[BLOCKS_PER_GROUP / 8][8 * 20] = {};
+  u8 h2[8 * 20] = {};
+
+  for (u32 block = 0; block < num_blocks; ++block)
+  {
+    u8* header = group + block * BLOCK_TOTAL_SIZE;
+    for (u32 i = 0; i < 31; ++i)
+      mbedtls_sha1(header + BLOCK_HEADER_SIZE + i * 0x400, 0x400, header + i * 20);
+    mbedtls_sha1(header, 31 * 20, h1[block / 8] + block % 8 * 20);
+  }
+
+  for (u32 subgroup = 0; subgroup * 8 < num_blocks; ++subgroup)
+    mbedtls_sha1(h1[subgroup], sizeof(h1[subgroup]), h2 + subgroup * 20);
+
+  for (u32 block = 0; block < num_blocks; ++block)
+  {
+    u8* header = group + block * BLOCK_TOTAL_SIZE;
+    std::memcpy(header + 0x280, h1[block / 8], sizeof(h1[block / 8]));
+    std::memcpy(header + 0x340, h2, sizeof(h2));
+  }
+}
+
+void EncryptBlocks(u8* blocks, u32 num_blocks, const std::array<u8, 16>& key)
+{
+  mbedtls_aes_context context;
+  mbedtls_aes_init(&context);
+  mbedtls_aes_setkey_enc(&context, key.data(), 128);
+
+  for (u32 i = 0; i < num_blocks; ++i)
+  {
+    u8* block = blocks + i * BLOCK_TOTAL_SIZE;
+    u8 iv[16] = {};
+    mbedtls_aes_crypt_cbc(&context, MBEDTLS_AES_ENCRYPT, BLOCK_HEADER_SIZE, iv, block, block);
+    std::copy_n(block + 0x3D0, sizeof(iv), iv);
+    mbedtls_aes_crypt_cbc(&context, MBEDTLS_AES_ENCRYPT, BLOCK_DATA_SIZE, iv,
+                          block + BLOCK_HEADER_SIZE, block + BLOCK_HEADER_SIZE);
+  }
+
+  mbedtls_aes_free(&context);
+}
+
+class DCZBlobTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+    m_plain_path = m_dir + "/image.iso";
+    m_dcz_path = m_dir + "/image.dcz";
+
+    // Compressible data, incompressible data and zeroes
+    std::mt19937 rng(1234);
+    m_data.resize(IMAGE_SIZE);
+    for (size_t i = 0; i < 0x40000; ++i)
+      m_data[i] = static_cast<u8>(i / 0x100);
+    for (size_t i = 0x40000; i < 0x80000; ++i)
+      m_data[i] = static_cast<u8>(rng());
+    for (size_t i = 0x100000; i < IMAGE_SIZE; ++i)
+      m_data[i] = static_cast<u8>(rng() % 4);
+
+    File::IOFile file(m_plain_path, "wb");
+    ASSERT_TRUE(file.WriteBytes(m_data.data(), m_data.size()));
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  // A disc with one partition whose first hash group has valid hashes
+  void WriteWiiImage()
+  {
+    m_wii_path = m_dir + "/wii.iso";
+    m_wii_image.assign(WII_IMAGE_SIZE, 0);
+    Write32(&m_wii_image, 0x18, 0x5D1C9EA3);
+    Write32(&m_wii_image, 0x40000, 1);
+    Write32(&m_wii_image, 0x40004, 0x40020 >> 2);
+    Write32(&m_wii_image, 0x40020, static_cast<u32>(PARTITION_OFFSET >> 2));
+
+    std::vector<u8> ticket(sizeof(IOS::ES::Ticket));
+    Write32(&ticket, 0, 0x00010001);  // RSA-2048 signature
+    for (size_t i = 0; i < 16; ++i)
+      ticket[offsetof(IOS::ES::Ticket, title_key) + i] = static_cast<u8>(i * 17);
+    Write32(&ticket, offsetof(IOS::ES::Ticket, title_id), 0x00010000);
+    Write32(&ticket, offsetof(IOS::ES::Ticket, title_id) + 4, 0x52414141);
+    std::copy(ticket.begin(), ticket.end(), m_wii_image.begin() + PARTITION_OFFSET);
+    m_title_key = IOS::ES::TicketReader(std::move(ticket)).GetTitleKey();
+
+    Write32(&m_wii_image, PARTITION_OFFSET + 0x2b8,
+            static_cast<u32>((PARTITION_DATA_OFFSET - PARTITION_OFFSET) >> 2));
+    Write32(&m_wii_image, PARTITION_OFFSET + 0x2bc,
+            static_cast<u32>((PARTITION_END - PARTITION_DATA_OFFSET) >> 2));
+
+    // Mostly compressible, with some incompressible blocks
+    std::mt19937 rng(5678);
+    m_wii_decrypted.resize(PARTITION_BLOCKS * BLOCK_DATA_SIZE);
+    for (size_t i = 0; i < m_wii_decrypted.size(); ++i)
+    {
+      const bool random = i / BLOCK_DATA_SIZE % 8 == 3;
+      m_wii_decrypted[i] = random ? static_cast<u8>(rng()) : static_cast<u8>(i / 0x1000);
+    }
+
+    u8* const partition_data = m_wii_image.data() + PARTITION_DATA_OFFSET;
+    for (u32 i = 0; i < PARTITION_BLOCKS; ++i)
+    {
+      std::copy_n(m_wii_decrypted.begin() + i * BLOCK_DATA_SIZE, BLOCK_DATA_SIZE,
+                  partition_data + i * BLOCK_TOTAL_SIZE + BLOCK_HEADER_SIZE);
+    }
+    HashGroup(partition_data, BLOCKS_PER_GROUP);
+    // Like on a scrubbed disc, the hashes of the second group don't match
+    for (u32 i = BLOCKS_PER_GROUP; i < PARTITION_BLOCKS; ++i)
+      std::fill_n(partition_data + i * BLOCK_TOTAL_SIZE, BLOCK_HEADER_SIZE, static_cast<u8>(i));
+    EncryptBlocks(partition_data, PARTITION_BLOCKS, m_title_key);
+
+    for (size_t i = PARTITION_END; i < WII_IMAGE_SIZE; ++i)
+      m_wii_image[i] = static_cast<u8>(rng());
+
+    File::IOFile file(m_wii_path, "wb");
+    ASSERT_TRUE(file.WriteBytes(m_wii_image.data(), m_wii_image.size()));
+  }
+
+  std::string m_dir;
+  std::string m_plain_path;
+  std::string m_dcz_path;
+  std::vector<u8> m_data;
+
+  std::string m_wii_path;
+  std::vector<u8> m_wii_image;
+  std::vector<u8> m_wii_decrypted;
+  std::array<u8, 16> m_title_key;
+};
+}  // Anonymous namespace
+
+TEST_F(DCZBlobTest, RoundTrip)
+{
+  ASSERT_TRUE(DiscIO::ConvertToDCZ(m_plain_path, m_dcz_path, DiscIO::DCZCodec::Deflate, 6,
+                                   CHUNK_SIZE));
+
+  std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(m_dcz_path);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(DiscIO::BlobType::DCZ, reader->GetBlobType());
+  EXPECT_EQ(IMAGE_SIZE, reader->GetDataSize());
+  EXPECT_LT(reader->GetRawSize(), IMAGE_SIZE);
+  EXPECT_FALSE(reader->SupportsReadWiiDecrypted(0));
+
+  // Reads that cross chunk boundaries and reads of single bytes
+  std::vector<u8> buffer(0x10000);
+  for (u64 offset : {u64(0), u64(0x7FF0), u64(0x3FFFF), u64(0xFFFFF), u64(IMAGE_SIZE - 0x10000)})
+  {
+    ASSERT_TRUE(reader->Read(offset, buffer.size(), buffer.data()));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + offset));
+  }
+  u8 byte;
+  ASSERT_TRUE(reader->Read(IMAGE_SIZE - 1, 1, &byte));
+  EXPECT_EQ(m_data.back(), byte);
+  EXPECT_FALSE(reader->Read(IMAGE_SIZE - 1, 2, buffer.data()));
+  reader.reset();
+
+  const std::string restored_path = m_dir + "/restored.iso";
+  ASSERT_TRUE(DiscIO::ConvertDCZToPlain(m_dcz_path, restored_path));
+  std::string restored;
+  ASSERT_TRUE(File::ReadFileToString(restored_path, restored));
+  ASSERT_EQ(m_data.size(), restored.size());
+  EXPECT_TRUE(std::equal(m_data.begin(), m_data.end(), restored.begin(),
+                         [](u8 a, char b) { return a == static_cast<u8>(b); }));
+}
+
+TEST_F(DCZBlobTest, WiiPartitionRoundTrip)
+{
+  WriteWiiImage();
+  ASSERT_TRUE(DiscIO::ConvertToDCZ(m_wii_path, m_dcz_path, DiscIO::DCZCodec::Deflate, 6,
+                                   CHUNK_SIZE));
+
+  DiscIO::DCZHeader header;
+  DiscIO::DCZPartitionEntry partition;
+  {
+    File::IOFile file(m_dcz_path, "rb");
+    ASSERT_TRUE(file.ReadArray(&header, 1));
+    ASSERT_TRUE(file.ReadArray(&partition, 1));
+  }
+  ASSERT_EQ(1u, header.num_partitions);
+  EXPECT_EQ(PARTITION_OFFSET, partition.partition_offset);
+  EXPECT_EQ(m_title_key, partition.title_key);
+  EXPECT_EQ(3u, header.num_regions);
+  // Only the group whose hashes can't be regenerated is stored as an exception
+  EXPECT_EQ(1u, header.num_exceptions);
+
+  std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(m_dcz_path);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(WII_IMAGE_SIZE, reader->GetDataSize());
+  // The partition is compressible once it is decrypted
+  EXPECT_LT(reader->GetRawSize(), WII_IMAGE_SIZE / 2);
+  EXPECT_TRUE(reader->SupportsReadWiiDecrypted(PARTITION_OFFSET));
+  EXPECT_FALSE(reader->SupportsReadWiiDecrypted(0));
+
+  std::vector<u8> buffer(0x10000);
+  for (u64 offset : {u64(0), u64(0x7C00 - 0x10), u64(BLOCKS_PER_GROUP * BLOCK_DATA_SIZE - 0x100),
+                     u64(m_wii_decrypted.size() - buffer.size())})
+  {
+    ASSERT_TRUE(reader->ReadWiiDecrypted(offset, buffer.size(), buffer.data(), PARTITION_OFFSET));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_wii_decrypted.begin() + offset));
+  }
+  EXPECT_FALSE(reader->ReadWiiDecrypted(0, 0x10, buffer.data(), 0));
+
+  // Reads that cross regions, blocks and groups. The encrypted groups are rebuilt from the
+  // regenerated hashes or from the exception table.
+  const u64 group_end = PARTITION_DATA_OFFSET + BLOCKS_PER_GROUP * BLOCK_TOTAL_SIZE;
+  for (u64 offset : {u64(PARTITION_DATA_OFFSET - 0x100), u64(PARTITION_DATA_OFFSET + 0x3F0),
+                     u64(group_end - 0x8010), u64(WII_IMAGE_SIZE - buffer.size())})
+  {
+    ASSERT_TRUE(reader->Read(offset, buffer.size(), buffer.data()));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_wii_image.begin() + offset));
+  }
+
+  std::vector<u8> image(WII_IMAGE_SIZE);
+  ASSERT_TRUE(reader->Read(0, image.size(), image.data()));
+  EXPECT_TRUE(image == m_wii_image);
+  reader.reset();
+
+  const std::string restored_path = m_dir + "/restored.iso";
+  ASSERT_TRUE(DiscIO::ConvertDCZToPlain(m_dcz_path, restored_path));
+  std::string restored;
+  ASSERT_TRUE(File::ReadFileToString(restored_path, restored));
+  ASSERT_EQ(m_wii_image.size(), restored.size());
+  EXPECT_TRUE(std::equal(m_wii_image.begin(), m_wii_image.end(), restored.begin(),
+                         [](u8 a, char b) { return a == static_cast<u8>(b); }));
+}
+
+TEST_F(DCZBlobTest, RejectsCorruptCounts)
+{
+  ASSERT_TRUE(DiscIO::ConvertToDCZ(m_plain_path, m_dcz_path, DiscIO::DCZCodec::LZO, 0,
+                                   CHUNK_SIZE));
+
+  DiscIO::DCZHeader header;
+  {
+    File::IOFile file(m_dcz_path, "rb");
+    ASSERT_TRUE(file.ReadArray(&header, 1));
+  }
+
+  const auto open_with_header = [this](const DiscIO::DCZHeader& modified) {
+    File::IOFile file(m_dcz_path, "r+b");
+    EXPECT_TRUE(file.WriteArray(&modified, 1));
+    file.Close();
+    return DiscIO::CreateBlobReader(m_dcz_path) != nullptr;
+  };
+
+  DiscIO::DCZHeader modified = header;
+  modified.num_regions = 0xFFFFFFFF;
+  EXPECT_FALSE(open_with_header(modified));
+
+  modified = header;
+  modified.num_partitions = 0x10000000;
+  EXPECT_FALSE(open_with_header(modified));
+
+  modified = header;
+  modified.num_exceptions = 0xFFFFFFFF;
+  EXPECT_FALSE(open_with_header(modified));
+
+  modified = header;
+  modified.num_chunks = 0xFFFFFFFF;
+  EXPECT_FALSE(open_with_header(modified));
+
+  modified = header;
+  modified.index_offset = ~0ull;
+  EXPECT_FALSE(open_with_header(modified));
+
+  EXPECT_TRUE(open_with_header(header));
+}
@@ -0,0 +1,90 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include "VideoCommon/EFBPeekCache.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace
+{
+class EFBPeekCacheTest : public testing::Test
+{
+protected:
+  u32 Peek(EFBAccessType type, u32 x, u32 y)
+  {
+    return m_cache.Peek(type, x, y, [this](EFBAccessType, const EFBRectangle& rect, u32* values) {
+      ++m_reads;
+      m_last_rect = rect;
+      if (m_fail_reads)
+        return false;
+      for (int row = rect.top; row < rect.bottom; ++row)
+      {
+        for (int column = rect.left; column < rect.right; ++column)
+          *values++ = row * EFB_WIDTH + column + m_offset;
+      }
+      return true;
+    });
+  }
+
+  EFBPeekCache m_cache;
+  int m_reads = 0;
+  u32 m_offset = 0;
+  bool m_fail_reads = false;
+  EFBRectangle m_last_rect;
+};
+}  // Anonymous namespace
+
+TEST_F(EFBPeekCacheTest, ReadsEachTileOnce)
+{
+  m_cache.SetTileSize(64);
+  EXPECT_EQ(70u * EFB_WIDTH + 10, Peek(EFBAccessType::PeekColor, 10, 70));
+  EXPECT_EQ(127u * EFB_WIDTH + 63, Peek(EFBAccessType::PeekColor, 63, 127));
+  EXPECT_EQ(1, m_reads);
+  EXPECT_EQ(0, m_last_rect.left);
+  EXPECT_EQ(64, m_last_rect.top);
+
+  // Depth is cached separately
+  Peek(EFBAccessType::PeekZ, 10, 70);
+  EXPECT_EQ(2, m_reads);
+}
+
+TEST_F(EFBPeekCacheTest, ClipsTilesToTheEFB)
+{
+  m_cache.SetTileSize(100);
+  EXPECT_EQ(527u * EFB_WIDTH + 639, Peek(EFBAccessType::PeekZ, 639, 527));
+  EXPECT_EQ(600, m_last_rect.left);
+  EXPECT_EQ(640, m_last_rect.right);
+  EXPECT_EQ(500, m_last_rect.top);
+  EXPECT_EQ(528, m_last_rect.bottom);
+}
+
+TEST_F(EFBPeekCacheTest, InvalidateReadsAgain)
+{
+  m_cache.SetTileSize(64);
+  Peek(EFBAccessType::PeekColor, 1, 1);
+
+  m_offset = 5;
+  EFBPeekCache::Invalidate();
+  EXPECT_EQ(EFB_WIDTH + 1 + 5u, Peek(EFBAccessType::PeekColor, 1, 1));
+  EXPECT_EQ(2, m_reads);
+
+  // Changing the tile size drops the cached tiles too
+  m_cache.SetTileSize(32);
+  Peek(EFBAccessType::PeekColor, 1, 1);
+  EXPECT_EQ(3, m_reads);
+}
+
+TEST_F(EFBPeekCacheTest, FailedReadsAreNotCached)
+{
+  m_cache.SetTileSize(64);
+  m_fail_reads = true;
+  EXPECT_EQ(0u, Peek(EFBAccessType::PeekZ, 1, 1));
+  EXPECT_EQ(0u, Peek(EFBAccessType::PeekZ, 1, 1));
+  EXPECT_EQ(2, m_reads);
+
+  m_fail_reads = false;
+  EXPECT_EQ(EFB_WIDTH + 1u, Peek(EFBAccessType::PeekZ, 1, 1));
+  EXPECT_EQ(3, m_reads);
+}
@@ -0,0 +1,56 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include "VideoCommon/FPSCounter.h"
+
+TEST(FrameTimeHistogram, PercentilesRoundUpToBuckets)
+{
+  FrameTimeHistogram histogram;
+  EXPECT_EQ(0.0, histogram.GetPercentileMs(99));
+
+  for (int i = 0; i < 990; ++i)
+    histogram.Add(16650);
+  for (int i = 0; i < 9; ++i)
+    histogram.Add(33350);
+  histogram.Add(250000);
+
+  EXPECT_EQ(1000u, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(16.7, histogram.GetPercentileMs(50));
+  EXPECT_DOUBLE_EQ(16.7, histogram.GetPercentileMs(99));
+  EXPECT_DOUBLE_EQ(33.4, histogram.GetPercentileMs(99.9));
+  // Durations past the last bucket are reported as the largest one
+  EXPECT_DOUBLE_EQ(250.0, histogram.GetPercentileMs(100));
+}
+
+TEST(FrameTimeHistogram, RemoveUndoesAdd)
+{
+  FrameTimeHistogram histogram;
+  histogram.Add(10000);
+  histogram.Add(50000);
+  histogram.Remove(50000);
+
+  EXPECT_EQ(1u, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(10.0, histogram.GetMeanMs());
+  EXPECT_DOUBLE_EQ(10.1, histogram.GetPercentileMs(100));
+  EXPECT_EQ(0u, histogram.GetBuckets()[500]);
+}
+
+TEST(FrameTimeHistogram, RemovingLargestDurationResetsMax)
+{
+  FrameTimeHistogram histogram;
+  histogram.Add(10000);
+  histogram.Add(250000);
+  histogram.Add(150000);
+
+  histogram.Remove(250000);
+  // The remaining long duration is only known to be in the last bucket
+  EXPECT_DOUBLE_EQ(100.0, histogram.GetMaxMs());
+  EXPECT_DOUBLE_EQ(100.0, histogram.GetPercentileMs(100));
+
+  histogram.Remove(150000);
+  EXPECT_DOUBLE_EQ(10.0, histogram.GetMaxMs());
+  EXPECT_DOUBLE_EQ(10.1, histogram.GetPercentileMs(100));
+}
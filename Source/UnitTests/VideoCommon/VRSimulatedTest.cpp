@@ -0,0 +1,48 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include "VideoCommon/VRSimulated.h"
+
+TEST(VRSimulated, PoseScriptInterpolatesAndLoops)
+{
+  VRSimulated::PoseScript script;
+  ASSERT_TRUE(script.Load("# time yaw pitch roll x y z\n"
+                          "0 0 0 0 0 0 0\n"
+                          "\n"
+                          "1 10 -20 4 0.1 0 0\n"
+                          "2 0 0 0 0 0 0\n"));
+
+  VRSimulated::Pose pose = script.GetPose(0.5);
+  EXPECT_FLOAT_EQ(5.0f, pose.yaw);
+  EXPECT_FLOAT_EQ(-10.0f, pose.pitch);
+  EXPECT_FLOAT_EQ(2.0f, pose.roll);
+  EXPECT_FLOAT_EQ(0.05f, pose.position[0]);
+
+  pose = script.GetPose(3.0);
+  EXPECT_FLOAT_EQ(10.0f, pose.yaw);
+  EXPECT_FLOAT_EQ(0.1f, pose.position[0]);
+}
+
+TEST(VRSimulated, PoseScriptRejectsMalformedLines)
+{
+  VRSimulated::PoseScript script;
+  EXPECT_FALSE(script.Load("0 0 0 0 0 0\n"));
+  EXPECT_FALSE(script.Load("1 0 0 0 0 0 0\n0 0 0 0 0 0 0\n"));
+  EXPECT_TRUE(script.IsEmpty());
+}
+
+TEST(VRSimulated, DefaultPoseIsDeterministic)
+{
+  const VRSimulated::Pose start = VRSimulated::GetDefaultPose(0.0);
+  EXPECT_FLOAT_EQ(0.0f, start.yaw);
+  EXPECT_FLOAT_EQ(0.0f, start.position[2]);
+
+  const VRSimulated::Pose a = VRSimulated::GetDefaultPose(1.25);
+  const VRSimulated::Pose b = VRSimulated::GetDefaultPose(1.25);
+  EXPECT_EQ(a.yaw, b.yaw);
+  EXPECT_EQ(a.pitch, b.pitch);
+  EXPECT_NE(0.0f, a.yaw);
+}